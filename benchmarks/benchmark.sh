@@ -5,30 +5,14 @@ set -e
 # Professional benchmarking using hyperfine
 # This script provides trusted performance measurements for yaml2json vs yq vs lq
 
-# Colors for output
-GREEN='\033[0;32m'
-BLUE='\033[0;34m'
-CYAN='\033[0;36m'
-YELLOW='\033[1;33m'
-NC='\033[0m'
+# Shared output helpers
+source "$(dirname "$0")/common.sh"
 
-print_header() {
-    echo -e "${BLUE}================================${NC}"
-    echo -e "${BLUE}$1${NC}"
-    echo -e "${BLUE}================================${NC}"
-}
-
-print_info() {
-    echo -e "${CYAN}$1${NC}"
-}
-
-print_success() {
-    echo -e "${GREEN}$1${NC}"
-}
-
-print_warning() {
-    echo -e "${YELLOW}$1${NC}"
-}
+# Extra yaml2json_gen corpus benchmarked after the standard files, e.g.
+# CORPUS_SIZE=1G CORPUS_ARGS="--escape-ratio 0.01 --block-ratio 0.05" ./benchmark.sh
+CORPUS_SIZE="${CORPUS_SIZE:-}"
+CORPUS_ARGS="${CORPUS_ARGS:-}"
+CORPUS_FILE="generated_${CORPUS_SIZE}.yaml"
 
 # Download lq if not present
 download_lq() {
@@ -97,11 +81,18 @@ generate_test_files() {
     # Generate missing files if any
     if [[ ${#missing_files[@]} -gt 0 ]]; then
         print_warning "⚡ Generating test files..."
-        ./generate_compatible_yaml.sh > /dev/null 2>&1
+        YAML2JSON_GEN_BIN="$YAML2JSON_GEN_BIN" ./generate_compatible_yaml.sh > /dev/null 2>&1
         print_success "✓ Test files generated"
     else
         print_success "✓ Test files already exist"
     fi
+
+    # Regenerated every run: the options may have changed since the last one
+    if [[ -n "$CORPUS_SIZE" ]]; then
+        print_warning "⚡ Generating $CORPUS_FILE..."
+        generate_yaml "$CORPUS_FILE" "$CORPUS_SIZE" $CORPUS_ARGS
+        print_success "✓ $CORPUS_FILE: $(du -h "$CORPUS_FILE" | cut -f1)"
+    fi
 }
 
 # Check if tools are available
@@ -175,6 +166,10 @@ main() {
     # Define test files and names
     local test_files=("small_117kb.yaml" "medium_1mb.yaml" "large_6_5mb.yaml" "very_large_13mb.yaml")
     local test_names=("small" "medium" "large" "very_large")
+    if [[ -n "$CORPUS_SIZE" ]]; then
+        test_files+=("$CORPUS_FILE")
+        test_names+=("generated_${CORPUS_SIZE}")
+    fi
     
     # Run benchmarks
     for i in "${!test_files[@]}"; do
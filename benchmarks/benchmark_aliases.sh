@@ -0,0 +1,91 @@
+#!/bin/bash
+
+set -e
+
+# Alias expansion cost on legitimate configs: CI-style files where every job
+# merges shared defaults with `<<: *anchor`. Compares against the same data
+# with the aliases already expanded, which takes the plain emitter path.
+
+source "$(dirname "$0")/common.sh"
+
+# generate_ci_config <jobs> <output> <expanded:0|1>
+generate_ci_config() {
+    local jobs=$1
+    local output=$2
+    local expanded=$3
+    local i
+
+    {
+        if [ "$expanded" = "0" ]; then
+            cat <<'YAML'
+.defaults: &defaults
+  image: ubuntu:22.04
+  timeout: 30
+  retries: 2
+  tags: [linux, x86_64, docker]
+  variables: &vars
+    CI: "true"
+    LANG: C.UTF-8
+    CACHE_DIR: /cache
+YAML
+        fi
+        for ((i = 0; i < jobs; i++)); do
+            echo "job_$i:"
+            if [ "$expanded" = "0" ]; then
+                echo "  <<: *defaults"
+                echo "  env: *vars"
+            else
+                echo "  image: ubuntu:22.04"
+                echo "  timeout: 30"
+                echo "  retries: 2"
+                echo "  tags: [linux, x86_64, docker]"
+                echo "  variables: {CI: \"true\", LANG: C.UTF-8, CACHE_DIR: /cache}"
+                echo "  env: {CI: \"true\", LANG: C.UTF-8, CACHE_DIR: /cache}"
+            fi
+            echo "  stage: stage_$((i % 5))"
+            echo "  script:"
+            echo "    - make target_$i"
+            echo "    - ./run_tests.sh --shard $i"
+        done
+    } > "$output"
+}
+
+benchmark_aliases() {
+    local jobs=$1
+    local name=$2
+    local merged="ci_${name}_merged.yaml"
+    local flat="ci_${name}_flat.yaml"
+
+    generate_ci_config "$jobs" "$merged" 0
+    generate_ci_config "$jobs" "$flat" 1
+
+    print_header "Alias expansion: $name ($jobs jobs)"
+    print_info "merged: $(wc -c < "$merged") bytes, flat: $(wc -c < "$flat") bytes"
+    if ! cmp -s <("$YAML2JSON_BIN" "$merged" | tail -c +2 | sed 's/^"\.defaults": {[^}]*{[^}]*}},//') \
+                <("$YAML2JSON_BIN" "$flat" | tail -c +2); then
+        print_warning "merged and flat outputs differ"
+    fi
+    echo ""
+
+    hyperfine -N --warmup 3 --runs 20 \
+        --export-json "${name}_aliases_results.json" \
+        --export-markdown "${name}_aliases_results.md" \
+        -n merged "$YAML2JSON_BIN $merged --output /dev/null" \
+        -n flat "$YAML2JSON_BIN $flat --output /dev/null"
+    echo ""
+}
+
+main() {
+    print_header "Alias Expansion Benchmarks"
+    require_tool hyperfine
+    require_yaml2json
+    echo ""
+
+    benchmark_aliases 1000 "small"
+    benchmark_aliases 20000 "medium"
+    benchmark_aliases 100000 "large"
+
+    print_success "✓ Alias benchmark results saved (*_aliases_results.*)"
+}
+
+main "$@"
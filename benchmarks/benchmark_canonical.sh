@@ -0,0 +1,51 @@
+#!/bin/bash
+
+set -e
+
+# Canonical output cost: compact emission vs --canonical (sorted keys) vs
+# --canonical --hash on wide maps (10k+ keys per map, shuffled order).
+
+source "$(dirname "$0")/common.sh"
+
+WIDE_FILE="wide_maps.yaml"
+WIDE_KEYS="${WIDE_KEYS:-20000}"
+WIDE_MAPS="${WIDE_MAPS:-20}"
+
+generate_wide_file() {
+    if [[ -f "$WIDE_FILE" ]]; then
+        return
+    fi
+    print_warning "⚡ Generating $WIDE_FILE ($WIDE_MAPS maps of $WIDE_KEYS keys)..."
+    # Keys share long prefixes (like flattened config paths) and come in
+    # pseudo-random order, so sorting does real work
+    awk -v maps="$WIDE_MAPS" -v keys="$WIDE_KEYS" 'BEGIN {
+        for (m = 0; m < maps; m++) {
+            printf "section_%d:\n", m
+            for (i = 0; i < keys; i++) {
+                k = (i * 7919 + m * 104729) % keys
+                printf "  service.config.entry_%06d: %d\n", k, i
+            }
+        }
+    }' > "$WIDE_FILE"
+    print_success "✓ $WIDE_FILE: $(du -h "$WIDE_FILE" | cut -f1)"
+}
+
+main() {
+    print_header "Canonical Output Benchmarks"
+    require_tool hyperfine
+    require_yaml2json
+    generate_wide_file
+    echo ""
+
+    hyperfine -N --warmup 3 --runs 20 \
+        --export-json "canonical_results.json" \
+        --export-markdown "canonical_results.md" \
+        -n "compact" "$YAML2JSON_BIN $WIDE_FILE --output /dev/null" \
+        -n "--canonical" "$YAML2JSON_BIN --canonical $WIDE_FILE --output /dev/null" \
+        -n "--canonical --hash" "$YAML2JSON_BIN --canonical --hash $WIDE_FILE --output /dev/null"
+    echo ""
+
+    print_success "✓ Canonical output benchmark results saved (canonical_results.*)"
+}
+
+main "$@"
@@ -0,0 +1,36 @@
+#!/bin/bash
+
+set -e
+
+# Cost per document of converting in process through libyaml2json's C API vs
+# spawning the yaml2json executable, on a 1KB config (where fork/exec
+# dominates) and the small and medium corpus files. Needs the
+# yaml2json_capi_bench program built next to yaml2json (YAML2JSON_BUILD_SHARED).
+
+source "$(dirname "$0")/common.sh"
+
+CAPI_BENCH_BIN="${CAPI_BENCH_BIN:-$(dirname "$YAML2JSON_BIN")/yaml2json_capi_bench}"
+ITERATIONS="${CAPI_ITERATIONS:-500}"
+
+main() {
+    print_header "C API vs Spawned CLI"
+    require_yaml2json
+    if [[ ! -x "$CAPI_BENCH_BIN" ]]; then
+        echo "❌ yaml2json_capi_bench not found at $CAPI_BENCH_BIN. Build with -DYAML2JSON_BUILD_SHARED=ON."
+        exit 1
+    fi
+    ensure_test_files
+    generate_tiny_file
+    echo ""
+
+    local file
+    for file in "$TINY_FILE" small_117kb.yaml medium_1mb.yaml; do
+        print_info "$file ($ITERATIONS documents)"
+        "$CAPI_BENCH_BIN" "$file" "$ITERATIONS" "$YAML2JSON_BIN" | tee "${file%.yaml}_capi_results.txt"
+        echo ""
+    done
+
+    print_success "✓ C API benchmark results saved (*_capi_results.txt)"
+}
+
+main "$@"
@@ -0,0 +1,51 @@
+#!/bin/bash
+
+set -e
+
+# --check (parse only, parallel across files) vs full conversion to /dev/null
+# over a directory of many YAML files.
+
+source "$(dirname "$0")/common.sh"
+
+CHECK_DIR="check_corpus"
+CHECK_FILES="${CHECK_FILES:-2000}"
+
+# Fill CHECK_DIR with copies of the small/medium corpus files
+generate_check_corpus() {
+    local i
+    if [[ -d "$CHECK_DIR" && $(ls "$CHECK_DIR" | wc -l) -eq $CHECK_FILES ]]; then
+        return
+    fi
+    rm -rf "$CHECK_DIR"
+    mkdir -p "$CHECK_DIR"
+    for ((i = 0; i < CHECK_FILES; i++)); do
+        if ((i % 10 == 0)); then
+            cp medium_1mb.yaml "$CHECK_DIR/file_$i.yaml"
+        else
+            cp small_117kb.yaml "$CHECK_DIR/file_$i.yaml"
+        fi
+    done
+}
+
+main() {
+    print_header "Validation (--check) Benchmarks"
+    require_tool hyperfine
+    require_yaml2json
+    ensure_test_files
+    generate_check_corpus
+    print_info "$CHECK_FILES files, $(du -sh "$CHECK_DIR" | cut -f1) in $CHECK_DIR/"
+    echo ""
+
+    hyperfine --warmup 1 --runs 5 \
+        --export-json "check_results.json" \
+        --export-markdown "check_results.md" \
+        -n "convert each to /dev/null" \
+            "for f in $CHECK_DIR/*.yaml; do $YAML2JSON_BIN \"\$f\" --output /dev/null; done" \
+        -n "--check -j1" "$YAML2JSON_BIN --check -j1 $CHECK_DIR/*.yaml" \
+        -n "--check (all cores)" "$YAML2JSON_BIN --check $CHECK_DIR/*.yaml"
+    echo ""
+
+    print_success "✓ Check benchmark results saved (check_results.*)"
+}
+
+main "$@"
@@ -0,0 +1,48 @@
+#!/bin/bash
+
+set -e
+
+# Compressed input/output throughput: built-in gzip/zstd handling versus
+# the equivalent external pipeline (zcat | yaml2json | zstd)
+
+source "$(dirname "$0")/common.sh"
+
+benchmark_compressed() {
+    local file=$1
+    local name=$2
+
+    gzip -kf "$file"
+    zstd -qf "$file" -o "$file.zst"
+
+    print_header "Compressed I/O: $name"
+    print_info "Input: $file.gz / $file.zst"
+    echo ""
+
+    hyperfine -N --warmup 3 --runs 20 \
+        --export-json "${name}_compression_results.json" \
+        --export-markdown "${name}_compression_results.md" \
+        -n "builtin gzip -> zstd" "$YAML2JSON_BIN $file.gz --compress=zstd --output /dev/null" \
+        -n "builtin zstd -> zstd" "$YAML2JSON_BIN $file.zst --compress=zstd --output /dev/null" \
+        -n "zcat | yaml2json | zstd" "bash -c 'zcat $file.gz | $YAML2JSON_BIN | zstd -q > /dev/null'" \
+        -n "zstdcat | yaml2json | zstd" "bash -c 'zstdcat $file.zst | $YAML2JSON_BIN | zstd -q > /dev/null'"
+
+    rm -f "$file.gz" "$file.zst"
+    echo ""
+}
+
+main() {
+    print_header "Compressed Input/Output Benchmarks"
+    require_tool hyperfine
+    require_tool zstd
+    require_tool gzip
+    require_yaml2json
+    ensure_test_files
+    echo ""
+
+    benchmark_compressed "medium_1mb.yaml" "medium"
+    benchmark_compressed "very_large_13mb.yaml" "very_large"
+
+    print_success "✓ Compression benchmark results saved (*_compression_results.*)"
+}
+
+main "$@"
@@ -0,0 +1,53 @@
+#!/bin/bash
+
+set -e
+
+# Reading a few fields through the Document API against converting to JSON
+# and parsing it again, on a generated Kubernetes-style manifest with one wide
+# object (yaml2json_document_bench, built next to yaml2json; nlohmann/json is
+# included when it was found at build time). DOCUMENT_MB sets the corpus size.
+
+source "$(dirname "$0")/common.sh"
+
+DOCUMENT_MB="${DOCUMENT_MB:-16}"
+DOCUMENT_BENCH_BIN="${DOCUMENT_BENCH_BIN:-$(dirname "$YAML2JSON_BIN")/yaml2json_document_bench}"
+CORPUS_FILE="manifest_${DOCUMENT_MB}mb.yaml"
+
+generate_corpus() {
+    if [[ -f "$CORPUS_FILE" ]]; then
+        return
+    fi
+    awk -v target=$((DOCUMENT_MB * 1048576)) 'BEGIN {
+        print "apiVersion: apps/v1\nkind: Deployment\nmetadata:\n  name: web\n  labels:"
+        for (i = 0; i < 500; i++) {
+            printf "    label_%d: value_%d\n", i, i
+        }
+        print "spec:\n  replicas: 3\n  template:\n    spec:\n      containers:\n        - name: app\n          image: registry/app:1.2.3\n  items:"
+        for (i = 0; size < target; i++) {
+            record = sprintf("    - {id: %d, name: item_%d, enabled: %s, weight: %d.5}\n", i, i, i % 2 ? "true" : "false", i % 100)
+            printf "%s", record
+            size += length(record)
+        }
+    }' > "$CORPUS_FILE"
+    print_success "✓ $CORPUS_FILE: $(wc -c < "$CORPUS_FILE") bytes"
+}
+
+main() {
+    print_header "Document API Benchmarks"
+    require_yaml2json
+    if [[ ! -x "$DOCUMENT_BENCH_BIN" ]]; then
+        echo "❌ yaml2json_document_bench not found at $DOCUMENT_BENCH_BIN. Please build it first."
+        exit 1
+    fi
+    generate_corpus
+    echo ""
+
+    "$DOCUMENT_BENCH_BIN" "$CORPUS_FILE" 5 \
+        metadata.name metadata.labels.label_499 spec.replicas \
+        spec.template.spec.containers.0.image spec.items.1000.name | tee document_results.txt
+    echo ""
+
+    print_success "✓ Document benchmark results saved (document_results.txt)"
+}
+
+main "$@"
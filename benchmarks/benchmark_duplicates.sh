@@ -0,0 +1,66 @@
+#!/bin/bash
+
+set -e
+
+# Duplicate key detection on worst cases for a quadratic check: one map of
+# 100k+ distinct keys, one where every key repeats, keys sharing a long prefix,
+# and many maps just above the linear-scan threshold. Each file runs without
+# the option and with --duplicate-keys; the cost should stay a flat fraction.
+
+source "$(dirname "$0")/common.sh"
+
+DUP_KEYS="${DUP_KEYS:-200000}"
+
+generate_duplicate_files() {
+    if [[ ! -f dup_distinct.yaml ]]; then
+        awk -v n="$DUP_KEYS" 'BEGIN { for (i = 0; i < n; i++) printf "key_%d: %d\n", i, i }' > dup_distinct.yaml
+    fi
+    if [[ ! -f dup_repeated.yaml ]]; then
+        awk -v n="$DUP_KEYS" 'BEGIN { for (i = 0; i < n; i++) printf "key_%d: %d\n", i % (n / 2), i }' > dup_repeated.yaml
+    fi
+    if [[ ! -f dup_prefix.yaml ]]; then
+        awk -v n="$DUP_KEYS" 'BEGIN {
+            p = "global.deployment.spec.template.spec.containers.env."
+            for (i = 0; i < n; i++) printf "%s%d: %d\n", p, i, i
+        }' > dup_prefix.yaml
+    fi
+    if [[ ! -f dup_small_maps.yaml ]]; then
+        awk -v n="$DUP_KEYS" 'BEGIN {
+            for (m = 0; m < n / 10; m++) {
+                printf "- "
+                for (k = 0; k < 10; k++) printf "%sk%d: %d\n", (k ? "  " : ""), k, m
+            }
+        }' > dup_small_maps.yaml
+    fi
+    print_success "✓ Duplicate key inputs ready ($DUP_KEYS keys each)"
+}
+
+main() {
+    print_header "Duplicate Key Benchmarks"
+    require_tool hyperfine
+    require_yaml2json
+    generate_duplicate_files
+    echo ""
+
+    for name in distinct repeated prefix small_maps; do
+        file="dup_${name}.yaml"
+        print_info "$file"
+        # error stops at the first duplicate, so it only measures files without any
+        error_run=()
+        if [[ "$name" != "repeated" ]]; then
+            error_run=(-n "error" "$YAML2JSON_BIN --duplicate-keys=error $file --output /dev/null")
+        fi
+        hyperfine -N --warmup 3 --runs 20 \
+            --export-json "duplicates_${name}_results.json" \
+            --export-markdown "duplicates_${name}_results.md" \
+            -n "keep" "$YAML2JSON_BIN $file --output /dev/null" \
+            "${error_run[@]}" \
+            -n "last-wins" "$YAML2JSON_BIN --duplicate-keys=last-wins $file --output /dev/null" \
+            -n "first-wins" "$YAML2JSON_BIN --duplicate-keys=first-wins $file --output /dev/null"
+        echo ""
+    done
+
+    print_success "✓ Duplicate key benchmark results saved (duplicates_*_results.*)"
+}
+
+main "$@"
@@ -0,0 +1,53 @@
+#!/bin/bash
+
+set -e
+
+# Output format comparison: JSON vs CBOR vs MessagePack emitted from the same tree.
+# Reports encoded size per format and end-to-end conversion time.
+
+source "$(dirname "$0")/common.sh"
+
+report_sizes() {
+    local file=$1
+    local format size
+    printf "%-10s %12s\n" "format" "bytes"
+    for format in json cbor msgpack; do
+        size=$("$YAML2JSON_BIN" --format "$format" "$file" | wc -c)
+        printf "%-10s %12d\n" "$format" "$size"
+    done
+}
+
+benchmark_formats() {
+    local file=$1
+    local name=$2
+
+    print_header "Output formats: $name"
+    report_sizes "$file"
+    echo ""
+
+    hyperfine -N --warmup 3 --runs 20 \
+        --export-json "${name}_formats_results.json" \
+        --export-markdown "${name}_formats_results.md" \
+        -n json "$YAML2JSON_BIN --format json $file --output /dev/null" \
+        -n cbor "$YAML2JSON_BIN --format cbor $file --output /dev/null" \
+        -n msgpack "$YAML2JSON_BIN --format msgpack $file --output /dev/null"
+    echo ""
+}
+
+main() {
+    print_header "Output Format Benchmarks"
+    require_tool hyperfine
+    require_yaml2json
+    ensure_test_files
+    echo ""
+
+    local test_files=("small_117kb.yaml" "medium_1mb.yaml" "large_6_5mb.yaml" "very_large_13mb.yaml")
+    local test_names=("small" "medium" "large" "very_large")
+    for i in "${!test_files[@]}"; do
+        benchmark_formats "${test_files[$i]}" "${test_names[$i]}"
+    done
+
+    print_success "✓ Format benchmark results saved (*_formats_results.*)"
+}
+
+main "$@"
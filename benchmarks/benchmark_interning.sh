@@ -0,0 +1,61 @@
+#!/bin/bash
+
+set -e
+
+# String interning (--intern-strings) on a generated inventory dump that
+# repeats a few hundred keys and short values, some of which need escaping
+# (paths, quoted labels). Reports parse arena use and emit throughput with
+# and without interning (yaml2json_intern_bench, built next to yaml2json),
+# then end-to-end times. INTERN_MB sets the corpus size.
+
+source "$(dirname "$0")/common.sh"
+
+INTERN_MB="${INTERN_MB:-64}"
+INTERN_BENCH_BIN="${INTERN_BENCH_BIN:-$(dirname "$YAML2JSON_BIN")/yaml2json_intern_bench}"
+CORPUS_FILE="inventory_${INTERN_MB}mb.yaml"
+OUT_FILE="interning_out.json"
+
+generate_corpus() {
+    if [[ -f "$CORPUS_FILE" ]]; then
+        return
+    fi
+    awk -v target=$((INTERN_MB * 1048576)) 'BEGIN {
+        split("eu-west-1 eu-central-1 us-east-1 us-west-2 ap-south-1", regions, " ")
+        split("running stopped pending terminated", states, " ")
+        for (i = 0; size < target; i++) {
+            record = sprintf("- host_%d:\n    region: %s\n    state: %s\n    \"mount\\tpoint\": \"C:\\\\data\\\\vol%d\"\n" \
+                             "    label: \"tier \\\"%s\\\"\"\n    attr_%d: %d\n",
+                             i % 300, regions[i % 5 + 1], states[i % 4 + 1], i % 8, i % 3 ? "gold" : "silver", i % 200, i)
+            printf "%s", record
+            size += length(record)
+        }
+    }' > "$CORPUS_FILE"
+    print_success "✓ $CORPUS_FILE: $(wc -c < "$CORPUS_FILE") bytes"
+}
+
+main() {
+    print_header "String Interning Benchmarks"
+    require_tool hyperfine
+    require_yaml2json
+    if [[ ! -x "$INTERN_BENCH_BIN" ]]; then
+        echo "❌ yaml2json_intern_bench not found at $INTERN_BENCH_BIN. Please build it first."
+        exit 1
+    fi
+    generate_corpus
+    echo ""
+
+    "$INTERN_BENCH_BIN" "$CORPUS_FILE" 5 | tee interning_results.txt
+    echo ""
+
+    hyperfine -N --warmup 1 --runs 10 \
+        --export-json interning_results.json \
+        --export-markdown interning_results.md \
+        -n plain "$YAML2JSON_BIN --buffered-output $CORPUS_FILE $OUT_FILE" \
+        -n interned "$YAML2JSON_BIN --buffered-output --intern-strings $CORPUS_FILE $OUT_FILE"
+    rm -f "$OUT_FILE"
+    echo ""
+
+    print_success "✓ Interning benchmark results saved (interning_results.*)"
+}
+
+main "$@"
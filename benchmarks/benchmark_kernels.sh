@@ -0,0 +1,89 @@
+#!/bin/bash
+
+set -e
+
+# Throughput of each runtime-dispatched kernel variant this CPU supports,
+# forced with YAML2JSON_KERNELS. Runs the standard corpus plus a generated
+# string-heavy file (long block scalars with quotes and escapes), where the
+# JSON string escaping kernel dominates. Reports MB/s per variant.
+
+source "$(dirname "$0")/common.sh"
+
+STRINGS_FILE="strings_8mb.yaml"
+OUT_FILE="kernels_out.json"
+VARIANTS=(scalar sse2 avx2 avx512 neon)
+
+generate_strings_file() {
+    if [[ -f "$STRINGS_FILE" ]]; then
+        return
+    fi
+    awk 'BEGIN {
+        for (i = 0; i < 20000; i++) {
+            printf "doc_%05d:\n  title: \"Entry %d with a \\\"quoted\\\" word\"\n  body: |\n", i, i
+            for (j = 0; j < 4; j++) {
+                printf "    Line %d of entry %d: plain prose long enough to cover several vector widths, C:\\path\\%d\n", j, i, j
+            }
+        }
+    }' > "$STRINGS_FILE"
+    print_success "✓ $STRINGS_FILE: $(wc -c < "$STRINGS_FILE") bytes"
+}
+
+# Variants the binary reports as active when asked for them
+supported_variants() {
+    local variant
+    for variant in "${VARIANTS[@]}"; do
+        if YAML2JSON_KERNELS=$variant "$YAML2JSON_BIN" --version | grep -q "kernels: $variant)"; then
+            echo "$variant"
+        fi
+    done
+}
+
+benchmark_kernels() {
+    local file=$1
+    local name=$2
+    shift 2
+    local variants=("$@")
+
+    print_header "Kernel variants: $name"
+    local args=() variant
+    for variant in "${variants[@]}"; do
+        args+=(-n "$variant" "YAML2JSON_KERNELS=$variant $YAML2JSON_BIN $file $OUT_FILE")
+    done
+    hyperfine --warmup 3 --runs 20 \
+        --export-json "${name}_kernels_results.json" \
+        --export-markdown "${name}_kernels_results.md" \
+        "${args[@]}"
+
+    local bytes
+    bytes=$(wc -c < "$file")
+    printf "%-10s %12s\n" "variant" "MB/s"
+    jq -r --argjson bytes "$bytes" \
+        '.results[] | "\(.command) \($bytes / .mean / 1048576 | floor)"' "${name}_kernels_results.json" |
+        while read -r variant rate; do
+            printf "%-10s %12s\n" "$variant" "$rate"
+        done
+    echo ""
+}
+
+main() {
+    print_header "Runtime-Dispatched Kernel Benchmarks"
+    require_tool hyperfine
+    require_tool jq
+    require_yaml2json
+    ensure_test_files
+    generate_strings_file
+
+    local variants
+    mapfile -t variants < <(supported_variants)
+    print_info "Variants on this CPU: ${variants[*]} (default: $("$YAML2JSON_BIN" --version | sed 's/.*kernels: \(.*\))/\1/'))"
+    echo ""
+
+    benchmark_kernels "$STRINGS_FILE" "strings" "${variants[@]}"
+    benchmark_kernels "large_6_5mb.yaml" "large" "${variants[@]}"
+    benchmark_kernels "very_large_13mb.yaml" "very_large" "${variants[@]}"
+    rm -f "$OUT_FILE"
+
+    print_success "✓ Kernel benchmark results saved (*_kernels_results.*)"
+}
+
+main "$@"
@@ -0,0 +1,50 @@
+#!/bin/bash
+
+set -e
+
+# Cost of ConversionLimits checks on the hot path (target: under 1%).
+# Input/node/arena limits are O(1) checks around ryml's emitter; depth, output
+# and deadline checks run per value in the tree walker, so those are measured on
+# a copy of each file with a leading anchor, which takes the walker either way.
+
+source "$(dirname "$0")/common.sh"
+
+# Generous limits that never trigger on the corpus
+CHEAP_LIMITS="--max-input-bytes=1073741824 --max-nodes=100000000 --max-arena-bytes=1073741824"
+WALKER_LIMITS="$CHEAP_LIMITS --max-depth=1000 --max-output-bytes=4294967296 --timeout=600000"
+
+benchmark_limits() {
+    local file=$1
+    local name=$2
+    local anchored="anchored_${file}"
+
+    { echo "_bench: &bench_anchor 0"; cat "$file"; } > "$anchored"
+
+    print_header "Limit checks: $name"
+    hyperfine -N --warmup 3 --runs 30 \
+        --export-json "${name}_limits_results.json" \
+        --export-markdown "${name}_limits_results.md" \
+        -n "ryml emitter" "$YAML2JSON_BIN $file --output /dev/null" \
+        -n "ryml emitter + limits" "$YAML2JSON_BIN $file --output /dev/null $CHEAP_LIMITS" \
+        -n "walker" "$YAML2JSON_BIN $anchored --output /dev/null" \
+        -n "walker + limits" "$YAML2JSON_BIN $anchored --output /dev/null $WALKER_LIMITS"
+    echo ""
+}
+
+main() {
+    print_header "Resource Limit Benchmarks"
+    require_tool hyperfine
+    require_yaml2json
+    ensure_test_files
+    echo ""
+
+    local test_files=("medium_1mb.yaml" "large_6_5mb.yaml" "very_large_13mb.yaml")
+    local test_names=("medium" "large" "very_large")
+    for i in "${!test_files[@]}"; do
+        benchmark_limits "${test_files[$i]}" "${test_names[$i]}"
+    done
+
+    print_success "✓ Limit benchmark results saved (*_limits_results.*)"
+}
+
+main "$@"
@@ -0,0 +1,58 @@
+#!/bin/bash
+
+set -e
+
+# Layered merge: yaml2json --merge over dozens of large overlapping layers vs
+# converting each layer serially and deep-merging the JSON with jq (`*` is a
+# recursive object merge, the same semantics as --merge-sequences=replace).
+
+source "$(dirname "$0")/common.sh"
+
+MERGE_DIR="merge_layers"
+MERGE_LAYERS="${MERGE_LAYERS:-32}"
+MERGE_SERVICES="${MERGE_SERVICES:-5000}"
+
+generate_layers() {
+    if [[ -d "$MERGE_DIR" ]]; then
+        return
+    fi
+    print_warning "⚡ Generating $MERGE_LAYERS layers of $MERGE_SERVICES services in $MERGE_DIR/..."
+    mkdir -p "$MERGE_DIR"
+    for ((layer = 0; layer < MERGE_LAYERS; layer++)); do
+        # Every layer overrides part of the services and adds keys of its own
+        awk -v layer="$layer" -v n="$MERGE_SERVICES" 'BEGIN {
+            print "services:"
+            for (i = layer % 3; i < n; i += 2) {
+                printf "  svc_%d:\n", i
+                printf "    image: registry/app_%d:v%d\n", i, layer
+                printf "    replicas: %d\n", (i + layer) % 7 + 1
+                printf "    env:\n      LAYER: \"%d\"\n      KEY_%d: value_%d\n", layer, layer, i
+                printf "    ports: [%d, %d]\n", 8000 + i % 100, 9000 + layer
+            }
+            printf "layer_%d: {applied: true}\n", layer
+        }' > "$(printf "%s/%03d.yaml" "$MERGE_DIR" "$layer")"
+    done
+    print_success "✓ $MERGE_DIR: $(du -sh "$MERGE_DIR" | cut -f1)"
+}
+
+main() {
+    print_header "Layered Merge Benchmarks"
+    require_tool hyperfine
+    require_tool jq
+    require_yaml2json
+    generate_layers
+    echo ""
+
+    hyperfine --warmup 2 --runs 10 \
+        --export-json "merge_results.json" \
+        --export-markdown "merge_results.md" \
+        -n "yaml2json --merge" "$YAML2JSON_BIN --merge $MERGE_DIR/*.yaml -o /dev/null" \
+        -n "yaml2json --merge -j 1" "$YAML2JSON_BIN --merge -j 1 $MERGE_DIR/*.yaml -o /dev/null" \
+        -n "serial convert + jq merge" \
+        "for f in $MERGE_DIR/*.yaml; do $YAML2JSON_BIN \$f; echo; done | jq -cs 'reduce .[] as \$x ({}; . * \$x)' > /dev/null"
+    echo ""
+
+    print_success "✓ Layered merge benchmark results saved (merge_results.*)"
+}
+
+main "$@"
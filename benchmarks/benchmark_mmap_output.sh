@@ -0,0 +1,75 @@
+#!/bin/bash
+
+set -e
+
+# Output file writers on a generated multi-hundred-MB document, per output
+# directory and filesystem (default: the current directory and /dev/shm):
+#   writev    default path, write(2) of the output straight from the input
+#   ofstream  --buffered-output, the whole output assembled, then std::ofstream
+#   mmap      --mmap-output, emitted into a mapping sized from the parse tree
+# The same three with --pretty compare ofstream and mmap for a finished string.
+# MMAP_MB sets the input size, MMAP_DIRS the space-separated output directories.
+
+source "$(dirname "$0")/common.sh"
+
+MMAP_MB="${MMAP_MB:-256}"
+MMAP_DIRS="${MMAP_DIRS:-. /dev/shm}"
+BIG_FILE="records_${MMAP_MB}mb.yaml"
+
+generate_big_file() {
+    if [[ -f "$BIG_FILE" ]]; then
+        return
+    fi
+    awk -v target=$((MMAP_MB * 1048576)) 'BEGIN {
+        for (i = 0; size < target; i++) {
+            record = sprintf("- id: %d\n  name: \"record-%d\"\n  tags: [alpha, beta, gamma]\n" \
+                             "  enabled: true\n  description: plain text that is long enough to be written as one run %d\n",
+                             i, i, i)
+            printf "%s", record
+            size += length(record)
+        }
+    }' > "$BIG_FILE"
+    print_success "✓ $BIG_FILE: $(wc -c < "$BIG_FILE") bytes"
+}
+
+benchmark_dir() {
+    local dir=$1
+    local out="$dir/mmap_out.json"
+    local fs
+    fs=$(stat -f -c %T "$dir" 2> /dev/null || echo "unknown")
+    local name
+    name=$(basename "$(realpath "$dir")")
+
+    print_header "Output to $dir ($fs)"
+    hyperfine -N --warmup 1 --runs 10 \
+        --export-json "mmap_${name}_results.json" \
+        --export-markdown "mmap_${name}_results.md" \
+        -n writev "$YAML2JSON_BIN $BIG_FILE $out" \
+        -n ofstream "$YAML2JSON_BIN --buffered-output $BIG_FILE $out" \
+        -n mmap "$YAML2JSON_BIN --mmap-output $BIG_FILE $out" \
+        -n "pretty ofstream" "$YAML2JSON_BIN --pretty $BIG_FILE $out" \
+        -n "pretty mmap" "$YAML2JSON_BIN --pretty --mmap-output $BIG_FILE $out"
+    rm -f "$out"
+    echo ""
+}
+
+main() {
+    print_header "Mapped Output Benchmarks"
+    require_tool hyperfine
+    require_yaml2json
+    generate_big_file
+    echo ""
+
+    local dir
+    for dir in $MMAP_DIRS; do
+        if [[ -d "$dir" && -w "$dir" ]]; then
+            benchmark_dir "$dir"
+        else
+            print_warning "⚠ $dir is not a writable directory - skipped"
+        fi
+    done
+
+    print_success "✓ Mapped output benchmark results saved (mmap_*_results.*)"
+}
+
+main "$@"
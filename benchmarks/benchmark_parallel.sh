@@ -0,0 +1,46 @@
+#!/bin/bash
+
+set -e
+
+# -j N chunked parsing of one huge document: a yaml2json_gen corpus of
+# PARALLEL_SIZE_MB, whose root keys each hold one long sequence of records.
+
+source "$(dirname "$0")/common.sh"
+
+PARALLEL_SIZE_MB="${PARALLEL_SIZE_MB:-1024}"
+PARALLEL_FILE="parallel_${PARALLEL_SIZE_MB}mb.yaml"
+PARALLEL_JOBS="${PARALLEL_JOBS:-1 2 4 8 16}"
+
+# A gigabyte takes a few seconds; the fixed seed keeps runs comparable
+generate_scaled_file() {
+    if [[ -f "$PARALLEL_FILE" ]]; then
+        return
+    fi
+    print_warning "⚡ Generating ${PARALLEL_SIZE_MB}MB $PARALLEL_FILE..."
+    generate_yaml "$PARALLEL_FILE" "${PARALLEL_SIZE_MB}M" --seed 1
+    print_success "✓ $PARALLEL_FILE: $(du -h "$PARALLEL_FILE" | cut -f1)"
+}
+
+main() {
+    print_header "Parallel Chunked Parsing Benchmarks"
+    require_tool hyperfine
+    require_yaml2json
+    generate_scaled_file
+    echo ""
+
+    local args=()
+    local jobs
+    for jobs in $PARALLEL_JOBS; do
+        args+=(-n "-j $jobs" "$YAML2JSON_BIN -j $jobs $PARALLEL_FILE --output /dev/null")
+    done
+
+    hyperfine --warmup 1 --runs 3 \
+        --export-json "parallel_results.json" \
+        --export-markdown "parallel_results.md" \
+        "${args[@]}"
+    echo ""
+
+    print_success "✓ Parallel benchmark results saved (parallel_results.*)"
+}
+
+main "$@"
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""Per-document cost of converting small YAML documents from Python.
+
+Compares the yaml2json extension module with running the yaml2json CLI
+through subprocess and with PyYAML + json, then measures how the module
+scales across threads (the GIL is released while converting).
+Usage: benchmark_python.py <yaml2json binary> <medium file> [documents]
+"""
+
+import concurrent.futures
+import json
+import subprocess
+import sys
+import time
+
+import yaml2json
+
+
+def small_documents(count):
+    return [(b"service:\n  name: api-%d\n  replicas: %d\n  ports: [80, 443]\n"
+             b"env:\n  LOG_LEVEL: info\n  REGION: eu-%d\n") % (i, i % 5, i % 3) for i in range(count)]
+
+
+def timed(label, fn, documents):
+    start = time.perf_counter()
+    for document in documents:
+        fn(document)
+    per_document = (time.perf_counter() - start) / len(documents)
+    print("%-28s %12.1f us/doc" % (label, per_document * 1e6))
+    return per_document
+
+
+def main():
+    binary, medium_file = sys.argv[1], sys.argv[2]
+    count = int(sys.argv[3]) if len(sys.argv) > 3 else 20000
+    documents = small_documents(count)
+
+    module = timed("yaml2json.convert", yaml2json.convert, documents)
+    # Spawning is slow: time a tenth of the documents
+    spawned = timed("subprocess yaml2json", lambda d: subprocess.run([binary], input=d, stdout=subprocess.PIPE,
+                                                                     check=True).stdout, documents[:count // 10])
+    try:
+        import yaml
+        loader = getattr(yaml, "CSafeLoader", yaml.SafeLoader)
+        pyyaml = timed("PyYAML (%s) + json" % loader.__name__,
+                       lambda d: json.dumps(yaml.load(d, Loader=loader)).encode(), documents[:count // 10])
+        print("speedup vs PyYAML: %.1fx" % (pyyaml / module))
+    except ImportError:
+        print("PyYAML not installed - skipped")
+    print("speedup vs subprocess: %.1fx" % (spawned / module))
+    print()
+
+    with open(medium_file, "rb") as f:
+        medium = f.read()
+    rounds = 64
+    print("%-10s %12s %12s" % ("threads", "seconds", "MB/s"))
+    for threads in (1, 2, 4, 8):
+        with concurrent.futures.ThreadPoolExecutor(threads) as pool:
+            start = time.perf_counter()
+            list(pool.map(lambda _: yaml2json.convert(medium), range(rounds)))
+            elapsed = time.perf_counter() - start
+        print("%-10d %12.3f %12.1f" % (threads, elapsed, rounds * len(medium) / elapsed / 1048576))
+
+
+if __name__ == "__main__":
+    main()
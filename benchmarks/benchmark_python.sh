@@ -0,0 +1,35 @@
+#!/bin/bash
+
+set -e
+
+# The yaml2json Python module vs subprocess and PyYAML + json on small
+# documents, plus thread scaling on the medium corpus file. Needs a build with
+# -DYAML2JSON_BUILD_PYTHON=ON; the module is loaded from the yaml2json build
+# directory (PYTHON_MODULE_DIR to override).
+
+source "$(dirname "$0")/common.sh"
+
+PYTHON_MODULE_DIR="${PYTHON_MODULE_DIR:-$(dirname "$YAML2JSON_BIN")}"
+
+main() {
+    print_header "Python Module Benchmarks"
+    require_tool python3
+    require_yaml2json
+    if ! PYTHONPATH="$PYTHON_MODULE_DIR" python3 -c "import yaml2json" 2> /dev/null; then
+        echo "❌ yaml2json Python module not found in $PYTHON_MODULE_DIR. Build with -DYAML2JSON_BUILD_PYTHON=ON."
+        exit 1
+    fi
+    if ! python3 -c "import yaml" 2> /dev/null; then
+        print_warning "⚠ PyYAML not installed (pip install pyyaml) - its comparison is skipped"
+    fi
+    ensure_test_files
+    echo ""
+
+    PYTHONPATH="$PYTHON_MODULE_DIR" python3 "$(dirname "$0")/benchmark_python.py" \
+        "$YAML2JSON_BIN" medium_1mb.yaml "${PYTHON_DOCS:-20000}" | tee python_results.txt
+    echo ""
+
+    print_success "✓ Python benchmark results saved (python_results.txt)"
+}
+
+main "$@"
@@ -0,0 +1,54 @@
+#!/bin/bash
+
+set -e
+
+# Scalar typing cost: --scalars json (pass-through) vs core vs yaml11 on a
+# numeric-dense file (sensor readings: ints, floats, hex, bools, nulls).
+
+source "$(dirname "$0")/common.sh"
+
+NUMERIC_FILE="numeric_dense.yaml"
+NUMERIC_ROWS="${NUMERIC_ROWS:-200000}"
+
+generate_numeric_file() {
+    if [[ -f "$NUMERIC_FILE" ]]; then
+        return
+    fi
+    print_warning "⚡ Generating $NUMERIC_FILE ($NUMERIC_ROWS rows)..."
+    awk -v rows="$NUMERIC_ROWS" 'BEGIN {
+        print "readings:"
+        for (i = 0; i < rows; i++) {
+            printf "  - id: %d\n", 100000 + i
+            printf "    ts: %d\n", 1718000000 + i * 7
+            printf "    temp: %.3f\n", (i % 400) / 10.0 - 5
+            printf "    pressure: %de-2\n", 98000 + (i % 5000)
+            printf "    flags: 0x%X\n", i % 4096
+            printf "    offset: +%d\n", i % 97
+            printf "    ratio: .%d\n", i % 1000
+            printf "    ok: %s\n", (i % 3 == 0) ? "true" : "false"
+            printf "    spare: %s\n", (i % 5 == 0) ? "~" : "null"
+            printf "    samples: [%d, %d, %d.5, %d]\n", i % 13, i % 17, i % 19, i % 23
+        }
+    }' > "$NUMERIC_FILE"
+    print_success "✓ $NUMERIC_FILE: $(du -h "$NUMERIC_FILE" | cut -f1)"
+}
+
+main() {
+    print_header "Scalar Typing Benchmarks"
+    require_tool hyperfine
+    require_yaml2json
+    generate_numeric_file
+    echo ""
+
+    hyperfine -N --warmup 3 --runs 20 \
+        --export-json "scalars_results.json" \
+        --export-markdown "scalars_results.md" \
+        -n "--scalars json" "$YAML2JSON_BIN --scalars json $NUMERIC_FILE --output /dev/null" \
+        -n "--scalars core" "$YAML2JSON_BIN --scalars core $NUMERIC_FILE --output /dev/null" \
+        -n "--scalars yaml11" "$YAML2JSON_BIN --scalars yaml11 $NUMERIC_FILE --output /dev/null"
+    echo ""
+
+    print_success "✓ Scalar typing benchmark results saved (scalars_results.*)"
+}
+
+main "$@"
@@ -0,0 +1,90 @@
+#!/bin/bash
+
+set -e
+
+# Schema validation while parsing vs converting and then validating the JSON
+# with Python's jsonschema. A directory of generated deployment manifests is
+# checked in one run (--check --schema, schema compiled once), converted one by
+# one with --schema, and converted then validated file by file.
+
+source "$(dirname "$0")/common.sh"
+
+SCHEMA_DIR="schema_corpus"
+SCHEMA_FILES="${SCHEMA_FILES:-500}"
+SCHEMA_FILE="deployment.schema.json"
+
+generate_schema_corpus() {
+    cat > "$SCHEMA_FILE" <<'JSON'
+{
+  "type": "object",
+  "required": ["name", "replicas", "containers"],
+  "properties": {
+    "name": {"type": "string", "pattern": "^[a-z][a-z0-9-]*$"},
+    "replicas": {"type": "integer", "minimum": 1},
+    "labels": {"type": "object", "additionalProperties": {"type": "string"}},
+    "containers": {"type": "array", "minItems": 1, "items": {"$ref": "#/$defs/container"}}
+  },
+  "additionalProperties": false,
+  "$defs": {
+    "container": {
+      "type": "object",
+      "required": ["name", "image"],
+      "properties": {
+        "name": {"type": "string"},
+        "image": {"type": "string"},
+        "ports": {"type": "array", "items": {"type": "integer", "maximum": 65535}, "uniqueItems": true},
+        "env": {"type": "array", "items": {"type": "object", "required": ["name", "value"]}}
+      }
+    }
+  }
+}
+JSON
+    if [[ -d "$SCHEMA_DIR" && $(ls "$SCHEMA_DIR" | wc -l) -eq $SCHEMA_FILES ]]; then
+        return
+    fi
+    rm -rf "$SCHEMA_DIR"
+    mkdir -p "$SCHEMA_DIR"
+    awk -v n="$SCHEMA_FILES" -v dir="$SCHEMA_DIR" 'BEGIN {
+        for (f = 0; f < n; f++) {
+            out = sprintf("%s/deploy_%d.yaml", dir, f)
+            printf "name: service-%d\nreplicas: %d\nlabels:\n  tier: backend\n  team: team-%d\ncontainers:\n", f, f % 5 + 1, f % 7 > out
+            for (c = 0; c < 40; c++) {
+                printf "  - name: worker-%d\n    image: registry.local/worker:%d.%d\n    ports: [%d, %d]\n    env:\n", c, f, c, 8000 + c, 9000 + c > out
+                for (e = 0; e < 10; e++) printf "      - {name: VAR_%d, value: \"%d\"}\n", e, e * c > out
+            }
+            close(out)
+        }
+    }'
+}
+
+main() {
+    print_header "Schema Validation Benchmarks"
+    require_tool hyperfine
+    require_yaml2json
+    generate_schema_corpus
+    print_success "✓ $SCHEMA_FILES manifests, $(du -sh "$SCHEMA_DIR" | cut -f1) in $SCHEMA_DIR/"
+    echo ""
+
+    local validate_run=()
+    if python3 -c "import jsonschema" &> /dev/null; then
+        # One interpreter and one compiled validator; each file is converted by yaml2json
+        validate_run=(-n "convert, then jsonschema" \
+            "python3 -c 'import glob, json, jsonschema, subprocess; v = jsonschema.Draft202012Validator(json.load(open(\"$SCHEMA_FILE\"))); [v.validate(json.loads(subprocess.run([\"$YAML2JSON_BIN\", f], capture_output=True, check=True).stdout)) for f in glob.glob(\"$SCHEMA_DIR/*.yaml\")]'")
+    else
+        print_warning "python3 jsonschema not installed (pip install jsonschema); skipping the convert-then-validate run"
+    fi
+
+    hyperfine --warmup 1 --runs 5 \
+        --export-json "schema_results.json" \
+        --export-markdown "schema_results.md" \
+        -n "--check" "$YAML2JSON_BIN --check $SCHEMA_DIR/*.yaml" \
+        -n "--check --schema" "$YAML2JSON_BIN --check --schema $SCHEMA_FILE $SCHEMA_DIR/*.yaml" \
+        -n "convert each with --schema" \
+            "for f in $SCHEMA_DIR/*.yaml; do $YAML2JSON_BIN --schema $SCHEMA_FILE \"\$f\" -o /dev/null; done" \
+        "${validate_run[@]}"
+    echo ""
+
+    print_success "✓ Schema benchmark results saved (schema_results.*)"
+}
+
+main "$@"
@@ -0,0 +1,57 @@
+#!/bin/bash
+
+set -e
+
+# Splitting a kubectl-style dump of thousands of small documents into one
+# JSON file per resource: yaml2json --split-dir (one mapping, documents
+# converted in parallel) vs splitting with csplit and converting each piece,
+# and vs yq's own split mode.
+
+source "$(dirname "$0")/common.sh"
+
+SPLIT_FILE="split_dump.yaml"
+SPLIT_DOCS="${SPLIT_DOCS:-5000}"
+SPLIT_OUT="split_out"
+
+generate_dump() {
+    if [[ -f "$SPLIT_FILE" ]]; then
+        return
+    fi
+    awk -v n="$SPLIT_DOCS" 'BEGIN {
+        split("ConfigMap Service Deployment Secret", kinds, " ")
+        for (i = 0; i < n; i++) {
+            kind = kinds[i % 4 + 1]
+            printf "---\napiVersion: v1\nkind: %s\nmetadata:\n  name: app-%d\n  namespace: ns-%d\n", kind, i, i % 10
+            printf "  labels: {app: app-%d, tier: backend}\nspec:\n  replicas: %d\n  ports:\n", i, i % 5 + 1
+            printf "    - {name: http, port: %d}\n    - {name: metrics, port: 9090}\n", 8000 + i % 100
+        }
+    }' > "$SPLIT_FILE"
+    print_success "✓ $SPLIT_FILE: $SPLIT_DOCS documents, $(du -h "$SPLIT_FILE" | cut -f1)"
+}
+
+main() {
+    print_header "Document Split Benchmarks"
+    require_tool hyperfine
+    require_tool yq
+    require_tool csplit
+    require_yaml2json
+    generate_dump
+    echo ""
+
+    # The output directory is recreated before every run
+    hyperfine --warmup 2 --runs 10 \
+        --prepare "rm -rf $SPLIT_OUT && mkdir $SPLIT_OUT" \
+        --export-json "split_results.json" \
+        --export-markdown "split_results.md" \
+        -n "yaml2json --split-dir" "$YAML2JSON_BIN --split-dir $SPLIT_OUT $SPLIT_FILE" \
+        -n "yaml2json --split-dir -j 1" "$YAML2JSON_BIN --split-dir $SPLIT_OUT -j 1 $SPLIT_FILE" \
+        -n "csplit + yaml2json per file" \
+        "csplit -s -z -f $SPLIT_OUT/doc_ -n 6 $SPLIT_FILE '/^---\$/' '{*}' && for f in $SPLIT_OUT/doc_*; do $YAML2JSON_BIN \$f \$f.json; done" \
+        -n "yq -s" "cd $SPLIT_OUT && yq -o=json -s '.kind + \"-\" + .metadata.name' ../$SPLIT_FILE"
+    echo ""
+
+    rm -rf "$SPLIT_OUT"
+    print_success "✓ Split benchmark results saved (split_results.*)"
+}
+
+main "$@"
@@ -0,0 +1,47 @@
+#!/bin/bash
+
+set -e
+
+# Exec-to-exit time on a 1KB input, where process start-up rather than
+# conversion dominates. The plain `yaml2json in out` form takes the fast path
+# (no CLI parser); the same conversion spelled with options takes the full
+# path. `cat` is the floor for starting any process. Each run's mean is
+# appended to startup_history.csv so regressions show up over time.
+
+source "$(dirname "$0")/common.sh"
+
+HISTORY_FILE="startup_history.csv"
+
+main() {
+    print_header "Start-up Benchmarks (1KB input)"
+    require_tool hyperfine
+    require_tool jq
+    require_yaml2json
+    generate_tiny_file
+    echo ""
+
+    hyperfine -N --warmup 50 --runs 1000 \
+        --export-json "startup_results.json" \
+        --export-markdown "startup_results.md" \
+        -n "cat (process floor)" "cat $TINY_FILE" \
+        -n "yaml2json in out (fast path)" "$YAML2JSON_BIN $TINY_FILE /dev/null" \
+        -n "yaml2json -i in -o out (full CLI)" "$YAML2JSON_BIN -i $TINY_FILE -o /dev/null"
+    echo ""
+
+    # date, commit, linkage, then mean seconds per command
+    local revision linkage
+    revision=$(git -C "$(dirname "$0")" rev-parse --short HEAD 2>/dev/null || echo unknown)
+    linkage=$(file -L "$YAML2JSON_BIN" 2>/dev/null | grep -q "statically linked" && echo static || echo dynamic)
+    if [[ ! -f "$HISTORY_FILE" ]]; then
+        echo "date,commit,linkage,cat,fast_path,full_cli" > "$HISTORY_FILE"
+    fi
+    echo "$(date -u +%Y-%m-%dT%H:%M:%SZ),$revision,$linkage,$(jq -r '[.results[].mean] | map(tostring) | join(",")' startup_results.json)" \
+        >> "$HISTORY_FILE"
+    print_info "History ($HISTORY_FILE):"
+    tail -n 5 "$HISTORY_FILE"
+    echo ""
+
+    print_success "✓ Start-up benchmark results saved (startup_results.*, $HISTORY_FILE)"
+}
+
+main "$@"
@@ -0,0 +1,58 @@
+#!/bin/bash
+
+set -e
+
+# Converting every YAML member of a .tgz bundle: yaml2json --tar (decompress
+# and convert in memory, members in parallel) vs extracting to disk and
+# running yaml2json once per file.
+
+source "$(dirname "$0")/common.sh"
+
+TAR_FILE="bundle.tgz"
+TAR_MEMBERS="${TAR_MEMBERS:-3000}"
+TAR_EXTRACT="tar_extract"
+
+generate_bundle() {
+    if [[ -f "$TAR_FILE" ]]; then
+        return
+    fi
+    local staging="tar_staging"
+    rm -rf "$staging"
+    mkdir -p "$staging/bundle/templates"
+    awk -v n="$TAR_MEMBERS" -v dir="$staging/bundle/templates" 'BEGIN {
+        for (f = 0; f < n; f++) {
+            out = sprintf("%s/resource_%05d.yaml", dir, f)
+            printf "apiVersion: v1\nkind: ConfigMap\nmetadata:\n  name: config-%d\n  labels: {app: bundle}\ndata:\n", f > out
+            for (k = 0; k < 20; k++) printf "  key_%d: value %d of %d\n", k, k, f > out
+            close(out)
+        }
+    }'
+    printf 'name: bundle\nversion: 1.0.0\n' > "$staging/bundle/Chart.yaml"
+    tar -czf "$TAR_FILE" -C "$staging" bundle
+    rm -rf "$staging"
+    print_success "✓ $TAR_FILE: $TAR_MEMBERS members, $(du -h "$TAR_FILE" | cut -f1)"
+}
+
+main() {
+    print_header "Tar Archive Benchmarks"
+    require_tool hyperfine
+    require_tool tar
+    require_yaml2json
+    generate_bundle
+    echo ""
+
+    hyperfine --warmup 2 --runs 10 \
+        --export-json "tar_results.json" \
+        --export-markdown "tar_results.md" \
+        -n "--tar (tar output)" "$YAML2JSON_BIN --tar $TAR_FILE -o /dev/null" \
+        -n "--tar --tar-output ndjson" "$YAML2JSON_BIN --tar --tar-output ndjson $TAR_FILE -o /dev/null" \
+        -n "--tar -j 1" "$YAML2JSON_BIN --tar -j 1 $TAR_FILE -o /dev/null" \
+        -n "extract + per-file yaml2json" \
+        "rm -rf $TAR_EXTRACT && mkdir $TAR_EXTRACT && tar -xzf $TAR_FILE -C $TAR_EXTRACT && find $TAR_EXTRACT -name '*.yaml' | while read -r f; do $YAML2JSON_BIN \"\$f\" \"\${f%.yaml}.json\"; done"
+    echo ""
+
+    rm -rf "$TAR_EXTRACT"
+    print_success "✓ Tar benchmark results saved (tar_results.*)"
+}
+
+main "$@"
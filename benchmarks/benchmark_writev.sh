@@ -0,0 +1,60 @@
+#!/bin/bash
+
+set -e
+
+# Scatter-gather output (default: strings written from the mapped input with
+# writev) vs --buffered-output (whole document assembled in one string first).
+# Reports peak memory per mode and conversion time into a real file.
+
+source "$(dirname "$0")/common.sh"
+
+OUT_FILE="writev_out.json"
+
+# Peak resident set size in KB, using GNU time (gtime on macOS) when available
+peak_rss_kb() {
+    local time_bin
+    for time_bin in /usr/bin/time gtime; do
+        if "$time_bin" -f %M true &> /dev/null; then
+            "$time_bin" -f %M "$@" 2>&1 > /dev/null | tail -1
+            return
+        fi
+    done
+    echo "n/a"
+}
+
+benchmark_writev() {
+    local file=$1
+    local name=$2
+
+    print_header "Scatter-gather output: $name"
+    printf "%-12s %14s\n" "mode" "peak RSS (KB)"
+    printf "%-12s %14s\n" "writev" "$(peak_rss_kb "$YAML2JSON_BIN" "$file" "$OUT_FILE")"
+    printf "%-12s %14s\n" "buffered" "$(peak_rss_kb "$YAML2JSON_BIN" --buffered-output "$file" "$OUT_FILE")"
+    echo ""
+
+    hyperfine -N --warmup 3 --runs 20 \
+        --export-json "${name}_writev_results.json" \
+        --export-markdown "${name}_writev_results.md" \
+        -n writev "$YAML2JSON_BIN $file $OUT_FILE" \
+        -n buffered "$YAML2JSON_BIN --buffered-output $file $OUT_FILE"
+    echo ""
+}
+
+main() {
+    print_header "Scatter-Gather Output Benchmarks"
+    require_tool hyperfine
+    require_yaml2json
+    ensure_test_files
+    echo ""
+
+    local test_files=("small_117kb.yaml" "medium_1mb.yaml" "large_6_5mb.yaml" "very_large_13mb.yaml")
+    local test_names=("small" "medium" "large" "very_large")
+    for i in "${!test_files[@]}"; do
+        benchmark_writev "${test_files[$i]}" "${test_names[$i]}"
+    done
+    rm -f "$OUT_FILE"
+
+    print_success "✓ Scatter-gather benchmark results saved (*_writev_results.*)"
+}
+
+main "$@"
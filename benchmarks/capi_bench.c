@@ -0,0 +1,102 @@
+/*
+ * In-process conversion through libyaml2json vs spawning the yaml2json
+ * executable per document, as services that shell out do today.
+ * Usage: yaml2json_capi_bench <file.yaml> <iterations> <yaml2json binary>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <time.h>
+#include "yaml2json.h"
+
+extern char** environ;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int count_bytes(void* user_data, const char* data, size_t size) {
+    (void)data;
+    *(size_t*)user_data += size;
+    return 0;
+}
+
+static char* read_all(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    char* data;
+    long length;
+    if (file == NULL || fseek(file, 0, SEEK_END) != 0 || (length = ftell(file)) < 0) {
+        return NULL;
+    }
+    rewind(file);
+    data = malloc((size_t)length + 1);
+    if (data == NULL || fread(data, 1, (size_t)length, file) != (size_t)length) {
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+    *size = (size_t)length;
+    return data;
+}
+
+int main(int argc, char** argv) {
+    size_t yaml_size = 0;
+    size_t output = 0;
+    char* yaml;
+    int iterations;
+    int i;
+    double start;
+    double in_process;
+    double spawned;
+    y2j_error error;
+    y2j_converter* converter;
+
+    if (argc != 4 || (iterations = atoi(argv[2])) <= 0) {
+        fprintf(stderr, "usage: %s <file.yaml> <iterations> <yaml2json binary>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if ((yaml = read_all(argv[1], &yaml_size)) == NULL) {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    converter = y2j_converter_new(NULL, &error);
+
+    /* The file is read once: a service already holds the document in memory */
+    start = now_seconds();
+    for (i = 0; i < iterations; ++i) {
+        if (y2j_convert(converter, yaml, yaml_size, count_bytes, &output, &error) != Y2J_OK) {
+            fprintf(stderr, "conversion failed: %s\n", error.message);
+            return EXIT_FAILURE;
+        }
+    }
+    in_process = (now_seconds() - start) / iterations;
+
+    start = now_seconds();
+    for (i = 0; i < iterations; ++i) {
+        char* args[] = {argv[3], argv[1], "/dev/null", NULL};
+        pid_t pid;
+        int status;
+        if (posix_spawn(&pid, argv[3], NULL, NULL, args, environ) != 0 || waitpid(pid, &status, 0) < 0 ||
+            !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "running %s failed\n", argv[3]);
+            return EXIT_FAILURE;
+        }
+    }
+    spawned = (now_seconds() - start) / iterations;
+
+    printf("%-12s %12s %12s\n", "mode", "us/document", "MB/s");
+    printf("%-12s %12.1f %12.1f\n", "in-process", in_process * 1e6, yaml_size / in_process / 1048576.0);
+    printf("%-12s %12.1f %12.1f\n", "spawn CLI", spawned * 1e6, yaml_size / spawned / 1048576.0);
+    printf("speedup: %.1fx\n", spawned / in_process);
+
+    y2j_converter_free(converter);
+    free(yaml);
+    return EXIT_SUCCESS;
+}
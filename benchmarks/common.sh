@@ -0,0 +1,93 @@
+#!/bin/bash
+
+# Helpers shared by the benchmark scripts
+
+# Colors for output
+GREEN='\033[0;32m'
+BLUE='\033[0;34m'
+CYAN='\033[0;36m'
+YELLOW='\033[1;33m'
+NC='\033[0m'
+
+print_header() {
+    echo -e "${BLUE}================================${NC}"
+    echo -e "${BLUE}$1${NC}"
+    echo -e "${BLUE}================================${NC}"
+}
+
+print_info() {
+    echo -e "${CYAN}$1${NC}"
+}
+
+print_success() {
+    echo -e "${GREEN}$1${NC}"
+}
+
+print_warning() {
+    echo -e "${YELLOW}$1${NC}"
+}
+
+# Path to the yaml2json binary under test
+YAML2JSON_BIN="${YAML2JSON_BIN:-../build/yaml2json}"
+
+# Corpus generator (benchmarks/corpus_gen.cpp), built next to yaml2json
+YAML2JSON_GEN_BIN="${YAML2JSON_GEN_BIN:-$(dirname "$YAML2JSON_BIN")/yaml2json_gen}"
+
+require_tool() {
+    if ! command -v "$1" &> /dev/null; then
+        echo "❌ $1 not found. Install with: brew install $1"
+        exit 1
+    fi
+}
+
+require_yaml2json() {
+    if [[ ! -f "$YAML2JSON_BIN" ]]; then
+        echo "❌ yaml2json not found at $YAML2JSON_BIN. Please build it first."
+        exit 1
+    fi
+    print_success "✓ yaml2json: $(realpath "$YAML2JSON_BIN")"
+}
+
+# Write a seeded synthetic corpus: generate_yaml <file> <size> [yaml2json_gen options...]
+# Size is bytes or K/M/G; the same options always produce the same file
+generate_yaml() {
+    local file=$1 size=$2
+    shift 2
+    if [[ ! -x "$YAML2JSON_GEN_BIN" ]]; then
+        echo "❌ yaml2json_gen not found at $YAML2JSON_GEN_BIN. Please build it first."
+        exit 1
+    fi
+    "$YAML2JSON_GEN_BIN" --size "$size" --output "$file" "$@"
+}
+
+# Generate the standard corpus if any file is missing
+ensure_test_files() {
+    local file
+    for file in small_117kb.yaml medium_1mb.yaml large_6_5mb.yaml very_large_13mb.yaml; do
+        if [[ ! -f "$file" ]]; then
+            print_warning "⚡ Generating test files..."
+            YAML2JSON_GEN_BIN="$YAML2JSON_GEN_BIN" ./generate_compatible_yaml.sh > /dev/null 2>&1
+            print_success "✓ Test files generated"
+            return
+        fi
+    done
+}
+
+# A 1KB config, where process start-up rather than conversion dominates
+TINY_FILE="tiny_1kb.yaml"
+
+generate_tiny_file() {
+    if [[ -f "$TINY_FILE" ]]; then
+        return
+    fi
+    awk 'BEGIN {
+        header = "service:\n  name: api\n  replicas: 3\n  ports: [80, 443]\nenv:\n"
+        printf "%s", header
+        for (i = 0; size < 1024 - length(header); i++) {
+            line = sprintf("  VAR_%02d: \"value-%d\"\n", i, i)
+            printf "%s", line
+            size += length(line)
+        }
+    }' > "$TINY_FILE"
+    print_success "✓ $TINY_FILE: $(wc -c < "$TINY_FILE") bytes"
+}
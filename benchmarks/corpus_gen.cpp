@@ -0,0 +1,423 @@
+// Benchmark corpus generator (built as yaml2json_gen). Writes YAML of any size
+// with the shape set by the options: documents of `sections` root keys, each a
+// block sequence of records (maps of about `width` keys) whose values nest up
+// to `depth` levels. Scalar lengths, quoting, escapes, block scalars, anchors
+// and aliases are drawn at the given rates. The output depends only on the
+// options and the seed.
+// Usage: yaml2json_gen --size 1G --width 12 --escape-ratio 0.05 -o corpus.yaml
+
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Shape {
+    uint64_t size = 1 << 20;
+    uint64_t seed = 1;
+    size_t documents = 1;
+    size_t sections = 4;
+    size_t width = 8;
+    size_t depth = 2;
+    double nest_ratio = 0.15;
+    size_t scalar_length = 12;
+    size_t max_scalar_length = 256;
+    double long_ratio = 0.02;
+    double number_ratio = 0.3;
+    double quote_ratio = 0.5;
+    double escape_ratio = 0.0;
+    double block_ratio = 0.0;
+    double anchor_ratio = 0.0;
+};
+
+// splitmix64: fast, and the same sequence on every platform
+class Rng {
+public:
+    explicit Rng(uint64_t seed) : state_(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    double uniform() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+    bool chance(double p) { return p > 0 && uniform() < p; }
+
+    size_t below(size_t n) { return n <= 1 ? 0 : static_cast<size_t>(next() % n); }
+
+private:
+    uint64_t state_;
+};
+
+const char* const kWords[] = {
+    "id", "name", "type", "status", "created", "updated", "owner", "region", "version", "enabled",
+    "count", "total", "score", "weight", "labels", "tags", "config", "metadata", "spec", "limits",
+    "timeout", "retries", "endpoint", "method", "path", "host", "port", "user", "email", "phone",
+    "amount", "currency", "price", "quantity", "category", "priority", "level", "message", "source", "target",
+    "start", "end", "duration", "latency", "size", "checksum", "encoding", "format", "language", "timezone",
+    "country", "city", "street", "postal", "latitude", "longitude", "session", "request", "response", "token",
+    "parent", "children", "notes", "description",
+};
+constexpr size_t kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+
+// Plain scalars start with a letter and a digit, so they never read as
+// numbers, booleans or null under any YAML schema
+const char kPlainChars[] = "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz0123456789_-.   ";
+const char kQuotedChars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 ,.;:/#'()[]{}!?@%&*+=";
+const char* const kEscapes[] = {"\\n", "\\t", "\\\"", "\\\\", "\\u00e9", "\\r", "\\/"};
+constexpr size_t kEscapeCount = sizeof(kEscapes) / sizeof(kEscapes[0]);
+
+class Generator {
+public:
+    Generator(const Shape& shape, std::FILE* out) : shape_(shape), out_(out), rng_(shape.seed) {
+        size_t keys = std::max<size_t>(kWordCount, shape.width * 2);
+        for (size_t i = 0; i < keys; ++i) {
+            std::string key = kWords[i % kWordCount];
+            if (i >= kWordCount) {
+                key += "_" + std::to_string(i / kWordCount);
+            }
+            keys_.push_back(key);
+        }
+        buf_.reserve(kFlushBytes + 64 * 1024);
+    }
+
+    uint64_t run() {
+        uint64_t per_document = std::max<uint64_t>(shape_.size / std::max<size_t>(shape_.documents, 1), 1);
+        for (size_t d = 0; d < std::max<size_t>(shape_.documents, 1); ++d) {
+            if (shape_.documents > 1) {
+                buf_ += "---\n";
+            }
+            anchors_.clear();
+            document(per_document);
+        }
+        flush();
+        return written_;
+    }
+
+private:
+    static constexpr size_t kFlushBytes = 1 << 20;
+
+    uint64_t produced() const { return written_ + buf_.size(); }
+
+    void flush() {
+        if (!buf_.empty() && std::fwrite(buf_.data(), 1, buf_.size(), out_) != buf_.size()) {
+            std::perror("yaml2json_gen: write failed");
+            std::exit(EXIT_FAILURE);
+        }
+        written_ += buf_.size();
+        buf_.clear();
+    }
+
+    void document(uint64_t target) {
+        uint64_t start = produced();
+        size_t sections = std::max<size_t>(shape_.sections, 1);
+        for (size_t s = 0; s < sections; ++s) {
+            buf_ += "section_";
+            buf_ += kWords[s % kWordCount];
+            if (s >= kWordCount) {
+                buf_ += "_" + std::to_string(s / kWordCount);
+            }
+            buf_ += ":\n";
+            // Every section gets its share; the last one runs up to the target
+            uint64_t section_end = start + target * (s + 1) / sections;
+            do {
+                buf_ += "  - ";
+                map_body(4, 0, true, true);
+                if (buf_.size() >= kFlushBytes) {
+                    flush();
+                }
+            } while (produced() < section_end);
+        }
+    }
+
+    size_t jittered_width() {
+        size_t width = std::max<size_t>(shape_.width, 1);
+        return std::max<size_t>(1, width - width / 4 + rng_.below(width / 2 + 1));
+    }
+
+    void indent(size_t n) { buf_.append(n, ' '); }
+
+    // Keys are a run of the pool from a random start: distinct within a map
+    void map_body(size_t at, size_t depth, bool inline_first, bool aliases) {
+        size_t width = jittered_width();
+        size_t first = rng_.below(keys_.size());
+        for (size_t i = 0; i < width; ++i) {
+            if (i > 0 || !inline_first) {
+                indent(at);
+            }
+            buf_ += keys_[(first + i) % keys_.size()];
+            buf_ += ':';
+            value(at, depth, aliases);
+        }
+    }
+
+    void sequence_body(size_t at, size_t depth, bool aliases) {
+        size_t items = 1 + rng_.below(std::max<size_t>(shape_.width, 1));
+        for (size_t i = 0; i < items; ++i) {
+            indent(at);
+            buf_ += '-';
+            if (depth < shape_.depth && rng_.chance(shape_.nest_ratio)) {
+                buf_ += ' ';
+                map_body(at + 2, depth + 1, true, aliases);
+            } else {
+                scalar(at + 2);
+            }
+        }
+    }
+
+    // Value of a key at column `at`, written after its colon
+    void value(size_t at, size_t depth, bool aliases) {
+        if (aliases && !anchors_.empty() && rng_.chance(shape_.anchor_ratio)) {
+            buf_ += " *a";
+            append_uint(anchors_[rng_.below(anchors_.size())]);
+            buf_ += '\n';
+            return;
+        }
+        // Anchored values hold no aliases, so expanding them stays linear
+        // Names are taken up front: values nested inside may be anchored too
+        bool anchored = rng_.chance(shape_.anchor_ratio);
+        size_t anchor = 0;
+        if (anchored) {
+            anchor = next_anchor_++;
+            buf_ += " &a";
+            append_uint(anchor);
+        }
+        if (depth < shape_.depth && rng_.chance(shape_.nest_ratio)) {
+            buf_ += '\n';
+            if (rng_.chance(0.5)) {
+                map_body(at + 2, depth + 1, false, aliases && !anchored);
+            } else {
+                sequence_body(at + 2, depth + 1, aliases && !anchored);
+            }
+        } else {
+            scalar(at + 2);
+        }
+        if (anchored) {
+            anchors_.push_back(anchor);
+            if (anchors_.size() > 256) {
+                anchors_.erase(anchors_.begin());
+            }
+        }
+    }
+
+    size_t string_length() {
+        double mean = static_cast<double>(std::max<size_t>(shape_.scalar_length, 2));
+        if (rng_.chance(shape_.long_ratio)) {
+            mean *= 10;
+        }
+        // Exponentially distributed around the mean: mostly short, a long tail
+        double length = -std::log(1.0 - rng_.uniform()) * mean;
+        return std::clamp<size_t>(static_cast<size_t>(length), 2, std::max<size_t>(shape_.max_scalar_length, 2));
+    }
+
+    // A scalar after "key:" or "-"; block scalar lines go at column `content`
+    void scalar(size_t content) {
+        buf_ += ' ';
+        if (rng_.chance(shape_.number_ratio)) {
+            number();
+        } else if (rng_.chance(shape_.block_ratio)) {
+            block(content);
+            return;
+        } else if (rng_.chance(shape_.quote_ratio)) {
+            quoted(string_length());
+        } else {
+            plain(string_length());
+        }
+        buf_ += '\n';
+    }
+
+    void number() {
+        uint64_t r = rng_.next();
+        switch (r % 8) {
+            case 0: buf_ += (r & 8) ? "true" : "false"; break;
+            case 1: buf_ += "null"; break;
+            case 2:
+            case 3:
+                append_uint((r >> 8) % 100000);
+                buf_ += '.';
+                append_uint((r >> 32) % 100);
+                break;
+            default:
+                if (r & 16) {
+                    buf_ += '-';
+                }
+                append_uint((r >> 8) % 10000000);
+                break;
+        }
+    }
+
+    void append_uint(uint64_t value) {
+        char digits[20];
+        size_t n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        while (n > 0) {
+            buf_ += digits[--n];
+        }
+    }
+
+    void plain(size_t length) {
+        buf_ += static_cast<char>('a' + rng_.below(26));
+        buf_ += static_cast<char>('0' + rng_.below(10));
+        fill(length - 2, kPlainChars, sizeof(kPlainChars) - 1);
+        // A trailing blank would be dropped by the parser
+        while (buf_.back() == ' ') {
+            buf_.back() = 'z';
+        }
+    }
+
+    void quoted(size_t length) {
+        buf_ += '"';
+        if (shape_.escape_ratio <= 0) {
+            fill(length, kQuotedChars, sizeof(kQuotedChars) - 1);
+        } else {
+            for (size_t i = 0; i < length; ++i) {
+                if (rng_.chance(shape_.escape_ratio)) {
+                    buf_ += kEscapes[rng_.below(kEscapeCount)];
+                } else {
+                    buf_ += kQuotedChars[rng_.below(sizeof(kQuotedChars) - 1)];
+                }
+            }
+        }
+        buf_ += '"';
+    }
+
+    void block(size_t content) {
+        buf_ += rng_.chance(0.5) ? "|\n" : ">\n";
+        size_t lines = 2 + rng_.below(5);
+        for (size_t i = 0; i < lines; ++i) {
+            indent(content);
+            buf_ += static_cast<char>('A' + rng_.below(26));
+            fill(string_length(), kQuotedChars, sizeof(kQuotedChars) - 1);
+            buf_ += '\n';
+        }
+    }
+
+    // Ten characters per random draw
+    void fill(size_t length, const char* chars, size_t count) {
+        while (length > 0) {
+            uint64_t r = rng_.next();
+            for (int i = 0; i < 10 && length > 0; ++i, --length) {
+                buf_ += chars[(r & 63) % count];
+                r >>= 6;
+            }
+        }
+    }
+
+    const Shape& shape_;
+    std::FILE* out_;
+    Rng rng_;
+    std::vector<std::string> keys_;
+    std::vector<size_t> anchors_;
+    size_t next_anchor_ = 0;
+    std::string buf_;
+    uint64_t written_ = 0;
+};
+
+// "512", "64K", "1.5M", "2G" (binary units)
+bool parse_size(const std::string& text, uint64_t& size) {
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || value < 0) {
+        return false;
+    }
+    std::string unit(end);
+    double scale = 1;
+    if (unit == "K" || unit == "k" || unit == "KB" || unit == "kb") {
+        scale = 1024.0;
+    } else if (unit == "M" || unit == "m" || unit == "MB" || unit == "mb") {
+        scale = 1024.0 * 1024.0;
+    } else if (unit == "G" || unit == "g" || unit == "GB" || unit == "gb") {
+        scale = 1024.0 * 1024.0 * 1024.0;
+    } else if (!unit.empty()) {
+        return false;
+    }
+    size = static_cast<uint64_t>(value * scale);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CLI::App app{"Deterministic YAML corpus generator for yaml2json benchmarks"};
+
+    Shape shape;
+    std::string size_text = "1M";
+    std::string output_file;
+    bool stats = false;
+
+    app.add_option("-o,--output", output_file, "Output file (default: stdout)");
+    app.add_option("-s,--size", size_text, "Approximate output size: bytes or K/M/G (default 1M)");
+    app.add_option("--seed", shape.seed, "Random seed; equal seeds and options give equal output");
+    app.add_option("--documents", shape.documents, "Documents in the stream, separated by ---")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--sections", shape.sections, "Root keys per document, each a sequence of records")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--width", shape.width, "Mean keys per map (default 8)")->check(CLI::PositiveNumber);
+    app.add_option("--depth", shape.depth, "Max nesting below a record (default 2)");
+    app.add_option("--nest-ratio", shape.nest_ratio, "Share of values that are nested maps or sequences")
+        ->check(CLI::Range(0.0, 1.0));
+    app.add_option("--scalar-length", shape.scalar_length, "Mean string length (exponential, default 12)")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--max-scalar-length", shape.max_scalar_length, "Longest string (default 256)")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--long-ratio", shape.long_ratio, "Share of strings drawn with 10x the mean length")
+        ->check(CLI::Range(0.0, 1.0));
+    app.add_option("--number-ratio", shape.number_ratio, "Share of scalars that are numbers, booleans or null")
+        ->check(CLI::Range(0.0, 1.0));
+    app.add_option("--quote-ratio", shape.quote_ratio, "Share of strings that are double-quoted")
+        ->check(CLI::Range(0.0, 1.0));
+    app.add_option("--escape-ratio", shape.escape_ratio, "Chance per character of an escape in quoted strings")
+        ->check(CLI::Range(0.0, 1.0));
+    app.add_option("--block-ratio", shape.block_ratio, "Share of strings written as | or > block scalars")
+        ->check(CLI::Range(0.0, 1.0));
+    app.add_option("--anchor-ratio", shape.anchor_ratio, "Share of values anchored, and of values that are aliases")
+        ->check(CLI::Range(0.0, 1.0));
+    app.add_flag("--stats", stats, "Print bytes written and throughput to stderr");
+
+    try {
+        app.parse(argc, argv);
+    } catch (const CLI::ParseError& e) {
+        return app.exit(e);
+    }
+    if (!parse_size(size_text, shape.size)) {
+        std::fprintf(stderr, "yaml2json_gen: invalid size '%s'\n", size_text.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::FILE* out = stdout;
+    if (!output_file.empty()) {
+        out = std::fopen(output_file.c_str(), "wb");
+        if (out == nullptr) {
+            std::fprintf(stderr, "yaml2json_gen: cannot create '%s': %s\n", output_file.c_str(), std::strerror(errno));
+            return EXIT_FAILURE;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Generator generator(shape, out);
+    uint64_t bytes = generator.run();
+    if (out != stdout ? std::fclose(out) != 0 : std::fflush(out) != 0) {
+        std::perror("yaml2json_gen: write failed");
+        return EXIT_FAILURE;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (stats) {
+        std::fprintf(stderr, "%llu bytes in %.3f s (%.0f MB/s)\n", static_cast<unsigned long long>(bytes), seconds,
+                     static_cast<double>(bytes) / 1048576.0 / std::max(seconds, 1e-9));
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,183 @@
+// Reading a few fields of a YAML document: Document lookups against
+// converting to JSON and parsing that with a JSON library (rapidyaml's JSON
+// parser, and nlohmann/json when built with YAML2JSON_BENCH_NLOHMANN).
+// Usage: yaml2json_document_bench <file.yaml> [iterations] [path...]
+// A path is dot separated, numbers index arrays: spec.containers.0.image.
+// Without paths the first member is followed three levels down.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Document.h"
+#include "FileReader.h"
+#include "YamlToJsonConverter.h"
+
+#ifdef YAML2JSON_BENCH_NLOHMANN
+    #include <nlohmann/json.hpp>
+#endif
+
+using namespace yaml2json;
+
+namespace {
+
+using Path = std::vector<std::string>;
+
+Path split_path(const std::string& text) {
+    Path path;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t dot = text.find('.', start);
+        if (dot == std::string::npos) {
+            dot = text.size();
+        }
+        path.push_back(text.substr(start, dot - start));
+        start = dot + 1;
+    }
+    return path;
+}
+
+bool is_index(const std::string& segment) {
+    return !segment.empty() && segment.find_first_not_of("0123456789") == std::string::npos;
+}
+
+// Scalar text at the end of the path, or the path's JSON if it ends at a container
+std::string lookup(const Document& doc, const Path& path) {
+    NodeRef node = doc.root();
+    for (const std::string& segment : path) {
+        node = is_index(segment) && node.is_array() ? node[std::stoul(segment)] : node[segment];
+    }
+    if (!node) {
+        return "";
+    }
+    return node.is_object() || node.is_array() ? node.json() : std::string(node.text());
+}
+
+std::string lookup(const ryml::Tree& tree, const Path& path) {
+    if (tree.size() == 0) {
+        return "";
+    }
+    ryml::id_type node = tree.root_id();
+    for (const std::string& segment : path) {
+        if (tree.is_map(node)) {
+            node = tree.find_child(node, ryml::csubstr(segment.data(), segment.size()));
+        } else if (tree.is_seq(node) && is_index(segment)) {
+            node = tree.child(node, static_cast<ryml::id_type>(std::stoul(segment)));
+        } else {
+            return "";
+        }
+        if (node == ryml::NONE) {
+            return "";
+        }
+    }
+    return tree.has_val(node) ? std::string(tree.val(node).str, tree.val(node).len) : "{}";
+}
+
+#ifdef YAML2JSON_BENCH_NLOHMANN
+std::string lookup(const nlohmann::json& json, const Path& path) {
+    const nlohmann::json* node = &json;
+    for (const std::string& segment : path) {
+        if (node->is_object()) {
+            auto it = node->find(segment);
+            if (it == node->end()) {
+                return "";
+            }
+            node = &*it;
+        } else if (node->is_array() && is_index(segment) && std::stoul(segment) < node->size()) {
+            node = &(*node)[std::stoul(segment)];
+        } else {
+            return "";
+        }
+    }
+    return node->is_string() ? node->get<std::string>() : node->dump();
+}
+#endif
+
+Path default_path(const Document& doc) {
+    Path path;
+    NodeRef node = doc.root();
+    while (path.size() < 3 && node.size() > 0) {
+        NodeRef first = *node.begin();
+        path.push_back(node.is_array() ? "0" : std::string(first.key()));
+        node = first;
+    }
+    return path;
+}
+
+double seconds(int iterations, const std::function<size_t()>& run, size_t& found) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        found = run();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <file.yaml> [iterations] [path...]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 5;
+    if (iterations <= 0) {
+        iterations = 1;
+    }
+
+    FileContent input = FileReader::read_file(argv[1]);
+    std::string_view yaml(input.data(), input.size());
+
+    std::vector<Path> paths;
+    for (int i = 3; i < argc; ++i) {
+        paths.push_back(split_path(argv[i]));
+    }
+    if (paths.empty()) {
+        paths.push_back(default_path(Document::parse(yaml)));
+    }
+
+    std::printf("input:              %zu bytes, %zu lookups\n", input.size(), paths.size());
+
+    size_t found = 0;
+    double document = seconds(iterations, [&] {
+        Document doc = Document::parse(yaml);
+        size_t bytes = 0;
+        for (const Path& path : paths) {
+            bytes += lookup(doc, path).size();
+        }
+        return bytes;
+    }, found);
+    std::printf("document:           %8.2f ms  (%zu bytes found)\n", document * 1e3, found);
+
+    double ryml_json = seconds(iterations, [&] {
+        std::string copy(yaml);
+        std::string json = YamlToJsonConverter::convert(&copy[0], copy.size());
+        ryml::Tree tree;
+        ryml::parse_json_in_place(ryml::substr(&json[0], json.size()), &tree);
+        size_t bytes = 0;
+        for (const Path& path : paths) {
+            bytes += lookup(tree, path).size();
+        }
+        return bytes;
+    }, found);
+    std::printf("convert + ryml:     %8.2f ms  (%.2fx)\n", ryml_json * 1e3, ryml_json / document);
+
+#ifdef YAML2JSON_BENCH_NLOHMANN
+    double nlohmann_json = seconds(iterations, [&] {
+        std::string copy(yaml);
+        std::string json = YamlToJsonConverter::convert(&copy[0], copy.size());
+        nlohmann::json parsed = nlohmann::json::parse(json);
+        size_t bytes = 0;
+        for (const Path& path : paths) {
+            bytes += lookup(parsed, path).size();
+        }
+        return bytes;
+    }, found);
+    std::printf("convert + nlohmann: %8.2f ms  (%.2fx)\n", nlohmann_json * 1e3, nlohmann_json / document);
+#else
+    std::printf("convert + nlohmann: not built (nlohmann/json not found)\n");
+#endif
+    return EXIT_SUCCESS;
+}
@@ -2,11 +2,43 @@
 
 set -e
 
+# The standard corpus. With yaml2json_gen built (benchmarks/corpus_gen.cpp) the
+# files come from it with fixed seeds in well under a second; without it the
+# shell loops below write them.
+YAML2JSON_GEN_BIN="${YAML2JSON_GEN_BIN:-../build/yaml2json_gen}"
+
+print_sizes() {
+  echo ""
+  echo "All benchmark YAML files generated successfully!"
+  echo "File sizes:"
+  for file in *.yaml; do
+    size=$(stat -f%z "$file" 2>/dev/null || stat -c%s "$file")
+    size_kb=$((size / 1024))
+    size_mb=$((size_kb / 1024))
+    if [ $size_mb -gt 0 ]; then
+      echo "  $(basename "$file"): ${size_mb}.$(((size_kb % 1024) / 100))MB (${size} bytes)"
+    else
+      echo "  $(basename "$file"): ${size_kb}KB (${size} bytes)"
+    fi
+  done
+}
+
 echo "Generating YAML files compatible with yaml2json, yq, and lq..."
 
 # Clean up old files
 rm -f *.yaml
 
+if [ -x "$YAML2JSON_GEN_BIN" ]; then
+  # Plain block style only (no anchors, escapes or block scalars) so every tool reads it
+  "$YAML2JSON_GEN_BIN" --seed 1 --size 117K --output small_117kb.yaml
+  "$YAML2JSON_GEN_BIN" --seed 2 --size 1M --output medium_1mb.yaml
+  "$YAML2JSON_GEN_BIN" --seed 3 --size 6.5M --output large_6_5mb.yaml
+  "$YAML2JSON_GEN_BIN" --seed 4 --size 13M --output very_large_13mb.yaml
+  print_sizes
+  exit 0
+fi
+echo "yaml2json_gen not found at $YAML2JSON_GEN_BIN; generating with shell loops (slow)"
+
 # Small file (~25KB) - basic structures only
 cat > small_117kb.yaml << 'EOF'
 # Small YAML file for performance testing
@@ -216,16 +248,4 @@ done
 
 echo "Generated very_large_13mb.yaml ($(stat -f%z very_large_13mb.yaml 2>/dev/null || stat -c%s very_large_13mb.yaml) bytes)"
 
-echo ""
-echo "All benchmark YAML files generated successfully!"
-echo "File sizes:"
-for file in *.yaml; do
-  size=$(stat -f%z "$file" 2>/dev/null || stat -c%s "$file")
-  size_kb=$((size / 1024))
-  size_mb=$((size_kb / 1024))
-  if [ $size_mb -gt 0 ]; then
-    echo "  $(basename "$file"): ${size_mb}.$(((size_kb % 1024) / 100))MB (${size} bytes)"
-  else
-    echo "  $(basename "$file"): ${size_kb}KB (${size} bytes)"
-  fi
-done 
\ No newline at end of file
+print_sizes
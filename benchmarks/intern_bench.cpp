@@ -0,0 +1,95 @@
+// Parse arena use and JSON emit throughput of one document with and without
+// string interning (ConversionOptions::intern_strings).
+// Usage: yaml2json_intern_bench <file.yaml> [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include "FileReader.h"
+#include "JsonEmitter.h"
+#include "StringInterner.h"
+#include "YamlToJsonConverter.h"
+
+using namespace yaml2json;
+
+namespace {
+
+// Bytes of keys and values the parser copied into the arena (scalars it had
+// to filter), in total and counting each distinct string once
+void arena_strings(const ryml::Tree& tree, size_t& total, size_t& distinct) {
+    std::unordered_set<std::string_view> seen;
+    total = 0;
+    distinct = 0;
+    auto count = [&](ryml::csubstr s) {
+        if (s.len > 0 && tree.in_arena(s)) {
+            total += s.len;
+            if (seen.insert(std::string_view(s.str, s.len)).second) {
+                distinct += s.len;
+            }
+        }
+    };
+    for (ryml::id_type id = 0; id < tree.capacity(); ++id) {
+        if (tree.has_key(id)) {
+            count(tree.key(id));
+        }
+        if (tree.has_val(id)) {
+            count(tree.val(id));
+        }
+    }
+}
+
+double emit_seconds(const ryml::Tree& tree, bool interning, int iterations, size_t& size,
+                    size_t& unique, size_t& hits) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        JsonEmitter emitter(tree, ConversionLimits{});
+        emitter.set_interning(interning);
+        std::string json;
+        json.reserve(size);
+        emitter.emit(json);
+        size = json.size();
+        if (const StringInterner* interner = emitter.interner()) {
+            unique = interner->size();
+            hits = interner->hits();
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <file.yaml> [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 5;
+    if (iterations <= 0) {
+        iterations = 1;
+    }
+
+    FileContent input = FileReader::read_file(argv[1]);
+    ryml::Tree tree = YamlToJsonConverter::parse_yaml(input.mutable_data(), input.size(), argv[1]);
+
+    size_t total = 0;
+    size_t distinct = 0;
+    arena_strings(tree, total, distinct);
+    std::printf("input:             %zu bytes, %zu nodes\n", input.size(), static_cast<size_t>(tree.size()));
+    std::printf("arena:             %zu bytes used, %zu reserved\n", tree.arena_size(), tree.arena_capacity());
+    std::printf("arena strings:     %zu bytes, %zu distinct\n\n", total, distinct);
+
+    size_t size = 0;
+    size_t unique = 0;
+    size_t hits = 0;
+    double plain = emit_seconds(tree, false, iterations, size, unique, hits);
+    double interned = emit_seconds(tree, true, iterations, size, unique, hits);
+    double mb = static_cast<double>(size) / 1048576.0;
+    std::printf("%-12s %10s %10s\n", "emit", "ms", "MB/s");
+    std::printf("%-12s %10.1f %10.1f\n", "plain", plain * 1e3, mb / plain);
+    std::printf("%-12s %10.1f %10.1f\n", "interned", interned * 1e3, mb / interned);
+    std::printf("interned strings:  %zu distinct, %zu reuses\n", unique, hits);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,54 @@
+#!/bin/bash
+
+set -e
+
+# Training workload for a YAML2JSON_PGO=generate build, run by the pgo-train
+# target: converts the generate_compatible_yaml.sh corpora with the option
+# sets that matter in production, so the profile reflects real hot paths.
+# Usage: pgo_train.sh <yaml2json binary> <profile directory>
+
+source "$(dirname "$0")/common.sh"
+
+YAML2JSON_BIN="${1:-$YAML2JSON_BIN}"
+YAML2JSON_GEN_BIN="$(dirname "$YAML2JSON_BIN")/yaml2json_gen"
+PROFILE_DIR="${2:-pgo-profiles}"
+GENERATOR="$(cd "$(dirname "$0")" && pwd)/generate_compatible_yaml.sh"
+
+main() {
+    print_header "PGO Training Run"
+    require_yaml2json
+
+    # The generator writes into the current directory: keep the corpus apart
+    local corpus="$PROFILE_DIR/corpus"
+    mkdir -p "$corpus"
+    (cd "$corpus" && YAML2JSON_GEN_BIN="$YAML2JSON_GEN_BIN" "$GENERATOR" > /dev/null)
+    # Escapes, block scalars, anchors and document markers, which the standard files leave out
+    if [[ -x "$YAML2JSON_GEN_BIN" ]]; then
+        generate_yaml "$corpus/mixed_2mb.yaml" 2M --documents 3 --escape-ratio 0.02 --block-ratio 0.05 \
+            --anchor-ratio 0.02
+    fi
+    print_success "✓ Corpus generated in $corpus"
+
+    local file
+    for file in "$corpus"/*.yaml; do
+        print_info "Training on $(basename "$file")"
+        "$YAML2JSON_BIN" "$file" /dev/null
+        "$YAML2JSON_BIN" -i "$file" -o /dev/null --pretty
+        "$YAML2JSON_BIN" -i "$file" -o /dev/null --canonical --scalars core
+        "$YAML2JSON_BIN" -i "$file" -o /dev/null --format cbor
+        "$YAML2JSON_BIN" -i "$file" -o /dev/null -j 0
+        "$YAML2JSON_BIN" --check "$file"
+    done
+
+    # Clang writes raw profiles that must be merged before the "use" build
+    if compgen -G "$PROFILE_DIR/*.profraw" > /dev/null; then
+        require_tool llvm-profdata
+        llvm-profdata merge -o "$PROFILE_DIR/default.profdata" "$PROFILE_DIR"/*.profraw
+        print_success "✓ Merged $PROFILE_DIR/default.profdata"
+    fi
+
+    rm -rf "$corpus"
+    print_success "✓ Profiles written to $PROFILE_DIR; reconfigure with -DYAML2JSON_PGO=use and rebuild"
+}
+
+main "$@"
@@ -0,0 +1,96 @@
+#include "FuzzBudget.h"
+#include <sanitizer/allocator_interface.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace yaml2json {
+
+namespace {
+
+// Called from inside malloc: must not allocate
+std::atomic<uint64_t> allocations{0};
+std::atomic<uint64_t> allocated_bytes{0};
+
+void on_malloc(const volatile void*, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void on_free(const volatile void*) {}
+
+void read_env(const char* name, double& value) {
+    if (const char* text = std::getenv(name)) {
+        value = std::strtod(text, nullptr);
+    }
+}
+
+void read_env(const char* name, uint64_t& value) {
+    if (const char* text = std::getenv(name)) {
+        value = std::strtoull(text, nullptr, 10);
+    }
+}
+
+FuzzBudget budget;
+std::chrono::steady_clock::time_point started;
+uint64_t allocations_at_start = 0;
+uint64_t bytes_at_start = 0;
+
+uint64_t limit(double per_byte, uint64_t minimum, size_t bytes) {
+    return minimum + static_cast<uint64_t>(per_byte * static_cast<double>(bytes));
+}
+
+} // namespace
+
+FuzzBudget FuzzBudget::from_environment() {
+    FuzzBudget result;
+    read_env("YAML2JSON_FUZZ_NS_PER_BYTE", result.ns_per_byte);
+    read_env("YAML2JSON_FUZZ_MIN_NS", result.min_ns);
+    read_env("YAML2JSON_FUZZ_ALLOCS_PER_BYTE", result.allocs_per_byte);
+    read_env("YAML2JSON_FUZZ_MIN_ALLOCS", result.min_allocs);
+    read_env("YAML2JSON_FUZZ_BYTES_PER_BYTE", result.bytes_per_byte);
+    read_env("YAML2JSON_FUZZ_MIN_BYTES", result.min_bytes);
+    return result;
+}
+
+void FuzzMeter::install() {
+    budget = FuzzBudget::from_environment();
+    if (__sanitizer_install_malloc_and_free_hooks(on_malloc, on_free) == 0) {
+        std::fprintf(stderr, "FuzzMeter: no sanitizer allocator hooks; build with -fsanitize=address\n");
+        std::abort();
+    }
+}
+
+void FuzzMeter::begin() {
+    allocations_at_start = allocations.load(std::memory_order_relaxed);
+    bytes_at_start = allocated_bytes.load(std::memory_order_relaxed);
+    started = std::chrono::steady_clock::now();
+}
+
+void FuzzMeter::end(const char* target, size_t input_bytes, size_t output_bytes) {
+    uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - started).count());
+    uint64_t count = allocations.load(std::memory_order_relaxed) - allocations_at_start;
+    uint64_t bytes = allocated_bytes.load(std::memory_order_relaxed) - bytes_at_start;
+
+    size_t moved = input_bytes + output_bytes;
+    uint64_t max_ns = limit(budget.ns_per_byte, budget.min_ns, moved);
+    uint64_t max_count = limit(budget.allocs_per_byte, budget.min_allocs, input_bytes);
+    uint64_t max_bytes = limit(budget.bytes_per_byte, budget.min_bytes, moved);
+    if (ns <= max_ns && count <= max_count && bytes <= max_bytes) {
+        return;
+    }
+    std::fprintf(stderr,
+                 "==%s== over budget: %zu bytes in, %zu bytes out\n"
+                 "  time:        %llu ns (limit %llu)\n"
+                 "  allocations: %llu (limit %llu)\n"
+                 "  allocated:   %llu bytes (limit %llu)\n",
+                 target, input_bytes, output_bytes,
+                 static_cast<unsigned long long>(ns), static_cast<unsigned long long>(max_ns),
+                 static_cast<unsigned long long>(count), static_cast<unsigned long long>(max_count),
+                 static_cast<unsigned long long>(bytes), static_cast<unsigned long long>(max_bytes));
+    std::abort();
+}
+
+} // namespace yaml2json
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace yaml2json {
+
+// Cost limits for one fuzz input, scaled by its size. An input that runs
+// longer or allocates more than the limit aborts the fuzzer like a crash, so
+// libFuzzer saves it as an artifact and minimizes it. Time and bytes
+// allocated are allowed per byte read plus written (pretty-printing deep
+// nesting writes far more than it reads, and must); the allocation count is
+// per byte read only. Every limit can be overridden from the environment.
+struct FuzzBudget {
+    // YAML2JSON_FUZZ_NS_PER_BYTE / YAML2JSON_FUZZ_MIN_NS
+    double ns_per_byte = 2000.0;
+    uint64_t min_ns = 50'000'000;
+
+    // YAML2JSON_FUZZ_ALLOCS_PER_BYTE / YAML2JSON_FUZZ_MIN_ALLOCS
+    double allocs_per_byte = 1.0;
+    uint64_t min_allocs = 2000;
+
+    // YAML2JSON_FUZZ_BYTES_PER_BYTE / YAML2JSON_FUZZ_MIN_BYTES
+    double bytes_per_byte = 256.0;
+    uint64_t min_bytes = 64ull << 20;
+
+    // Defaults with the environment's overrides applied
+    static FuzzBudget from_environment();
+};
+
+// Measures one input from begin() to end(). Allocations are counted through
+// the sanitizer allocator hooks, so memory rapidyaml takes with malloc counts
+// as well as operator new; the fuzzers must be built with a sanitizer.
+class FuzzMeter {
+public:
+    // Install the allocation hooks and read the budget (from LLVMFuzzerInitialize)
+    static void install();
+
+    static void begin();
+
+    // Abort with a report when the input went over budget
+    static void end(const char* target, size_t input_bytes, size_t output_bytes);
+};
+
+} // namespace yaml2json
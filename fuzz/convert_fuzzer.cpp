@@ -0,0 +1,33 @@
+// libFuzzer target for YamlToJsonConverter::convert with the default options,
+// as the CLI runs it. Beyond crashes and sanitizer reports it aborts on inputs
+// that blow the FuzzBudget (see run_fuzzer.sh).
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "ErrorHandler.h"
+#include "FuzzBudget.h"
+#include "YamlToJsonConverter.h"
+
+using namespace yaml2json;
+
+extern "C" int LLVMFuzzerInitialize(int*, char***) {
+    setup_error_handlers();
+    FuzzMeter::install();
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    // Parsing is in place and rewrites quoted and folded scalars, so it gets a
+    // copy: libFuzzer aborts a target that writes to its input
+    std::string yaml(reinterpret_cast<const char*>(data), size);
+    size_t output = 0;
+    FuzzMeter::begin();
+    try {
+        output = YamlToJsonConverter::convert(&yaml[0], yaml.size()).size();
+    } catch (const ConversionError&) {
+        // Rejecting an input is fine; taking too long to do so is not
+    }
+    FuzzMeter::end("convert", size, output);
+    return 0;
+}
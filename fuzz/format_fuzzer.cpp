@@ -0,0 +1,25 @@
+// libFuzzer target for JsonFormatter: pretty-prints and compacts arbitrary
+// text, which need not be valid JSON. Aborts on crashes and on inputs that
+// blow the FuzzBudget (see run_fuzzer.sh).
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "FuzzBudget.h"
+#include "JsonFormatter.h"
+
+using namespace yaml2json;
+
+extern "C" int LLVMFuzzerInitialize(int*, char***) {
+    FuzzMeter::install();
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string json(reinterpret_cast<const char*>(data), size);
+    FuzzMeter::begin();
+    size_t output = JsonFormatter::pretty_print(json).size();
+    output += JsonFormatter::compact(json).size();
+    FuzzMeter::end("format", size, output);
+    return 0;
+}
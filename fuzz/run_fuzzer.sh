@@ -0,0 +1,39 @@
+#!/bin/bash
+
+set -e
+
+# Run a fuzz target seeded with tests/test_data (the slow/ regression inputs
+# included). Crashes and over-budget inputs are saved under $BUILD_DIR/fuzz-findings;
+# once minimized and fixed, copy them to tests/test_data/slow so the unit tests
+# replay them.
+# Usage: fuzz/run_fuzzer.sh <convert|format> [seconds] [libFuzzer flags...]
+# Build: cmake -S . -B build-fuzz -DCMAKE_C_COMPILER=clang -DCMAKE_CXX_COMPILER=clang++ \
+#            -DYAML2JSON_BUILD_FUZZERS=ON && cmake --build build-fuzz
+
+REPO_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+BUILD_DIR="${BUILD_DIR:-$REPO_DIR/build-fuzz}"
+
+TARGET="${1:?usage: run_fuzzer.sh <convert|format> [seconds] [libFuzzer flags...]}"
+SECONDS_TO_RUN="${2:-600}"
+shift $(($# < 2 ? $# : 2))
+
+FUZZER="$BUILD_DIR/yaml2json_${TARGET}_fuzzer"
+if [[ ! -x "$FUZZER" ]]; then
+    echo "❌ $FUZZER not found. Build with -DYAML2JSON_BUILD_FUZZERS=ON first."
+    exit 1
+fi
+
+CORPUS="$BUILD_DIR/fuzz-corpus/$TARGET"
+FINDINGS="$BUILD_DIR/fuzz-findings/$TARGET"
+mkdir -p "$CORPUS" "$FINDINGS"
+
+# libFuzzer's own -timeout is a backstop well above the per-byte time budget;
+# the first directory collects new coverage, the seed directory stays untouched
+"$FUZZER" "$CORPUS" "$REPO_DIR/tests/test_data" \
+    -max_total_time="$SECONDS_TO_RUN" \
+    -max_len=65536 \
+    -timeout=60 \
+    -rss_limit_mb=4096 \
+    -artifact_prefix="$FINDINGS/" \
+    -print_final_stats=1 \
+    "$@"
@@ -0,0 +1,148 @@
+#ifndef YAML2JSON_H
+#define YAML2JSON_H
+
+/*
+ * C interface of libyaml2json, for embedding the converter in other languages
+ * without spawning the yaml2json executable.
+ *
+ * ABI: functions are only ever added. y2j_options starts with its own size,
+ * so a library reads the options of programs built against older headers;
+ * y2j_error has a fixed layout and needs no freeing.
+ *
+ * Threads: a converter is immutable once created. Any number of threads may
+ * convert with the same converter at the same time; each call needs its own
+ * y2j_error. y2j_converter_free must not race with conversions using it.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #ifdef Y2J_BUILDING_LIBRARY
+        #define Y2J_API __declspec(dllexport)
+    #else
+        #define Y2J_API __declspec(dllimport)
+    #endif
+#else
+    #define Y2J_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Raised when the C interface changes incompatibly; compare with
+ * y2j_abi_version(). Fields are only ever appended to y2j_options, and its
+ * struct_size tells the library which of them the caller's header had (the
+ * rest keep their defaults), so appending one does not raise it.
+ */
+#define Y2J_ABI_VERSION 1
+
+typedef enum y2j_status {
+    Y2J_OK = 0,
+    Y2J_ERR_INVALID_ARGUMENT = 1, /* null pointer, unknown enum value, bad options */
+    Y2J_ERR_PARSE = 2,            /* invalid YAML, duplicate key, schema violation, ... */
+    Y2J_ERR_LIMIT = 3,            /* a limit of the options was exceeded */
+    Y2J_ERR_BUFFER_TOO_SMALL = 4, /* y2j_convert_to_buffer: see its out_size */
+    Y2J_ERR_CALLBACK = 5,         /* the output callback returned non-zero */
+    Y2J_ERR_NO_MEMORY = 6,
+    Y2J_ERR_INTERNAL = 7
+} y2j_status;
+
+typedef enum y2j_format {
+    Y2J_FORMAT_JSON = 0,
+    Y2J_FORMAT_CBOR = 1,
+    Y2J_FORMAT_MSGPACK = 2
+} y2j_format;
+
+typedef enum y2j_scalars {
+    Y2J_SCALARS_JSON = 0,  /* JSON literals pass through, everything else is a string */
+    Y2J_SCALARS_CORE = 1,  /* YAML 1.2 core schema */
+    Y2J_SCALARS_YAML11 = 2 /* YAML 1.1: yes/no/on/off, 0b1010, 017, 1_000 */
+} y2j_scalars;
+
+typedef enum y2j_duplicate_keys {
+    Y2J_DUPLICATE_KEYS_KEEP = 0,
+    Y2J_DUPLICATE_KEYS_ERROR = 1,
+    Y2J_DUPLICATE_KEYS_LAST_WINS = 2,
+    Y2J_DUPLICATE_KEYS_FIRST_WINS = 3
+} y2j_duplicate_keys;
+
+/* Converter settings; fill with y2j_options_init, then change fields. Limits of 0 mean unlimited */
+typedef struct y2j_options {
+    size_t struct_size;          /* sizeof(y2j_options), set by y2j_options_init */
+    int32_t format;              /* y2j_format */
+    int32_t scalars;             /* y2j_scalars */
+    int32_t duplicate_keys;      /* y2j_duplicate_keys */
+    int32_t canonical;           /* non-zero: sorted keys, no whitespace (JSON only) */
+    size_t max_input_bytes;
+    size_t max_nodes;
+    size_t max_arena_bytes;
+    size_t max_output_bytes;
+    size_t max_depth;
+    double max_alias_expansion;  /* emitted nodes per parsed node (default 100) */
+    uint32_t timeout_ms;         /* per conversion */
+    size_t threads;              /* chunks of one large document: 1 = serial (default), 0 = all cores */
+    const char* schema;          /* JSON Schema text to validate against, or NULL; copied */
+    /* Appended fields: older callers' struct_size ends before them */
+    int32_t intern_strings;      /* non-zero: escape repeated short strings once (JSON only) */
+} y2j_options;
+
+/* Error details of a failed call. Line and column are 1-based, 0 when unknown */
+typedef struct y2j_error {
+    y2j_status status;
+    size_t line;
+    size_t column;
+    char message[256]; /* NUL-terminated, truncated to fit */
+} y2j_error;
+
+typedef struct y2j_converter y2j_converter;
+
+/*
+ * Receives the output in pieces, in order; data is only valid during the
+ * call. Return 0 to continue, anything else to stop the conversion with
+ * Y2J_ERR_CALLBACK.
+ */
+typedef int (*y2j_output_fn)(void* user_data, const char* data, size_t size);
+
+/* Value of Y2J_ABI_VERSION the library was built with */
+Y2J_API int y2j_abi_version(void);
+
+/* Default options */
+Y2J_API void y2j_options_init(y2j_options* options);
+
+/*
+ * Create a converter (options may be NULL for the defaults); NULL on failure,
+ * with error filled in. A schema that does not compile fails with Y2J_ERR_PARSE.
+ */
+Y2J_API y2j_converter* y2j_converter_new(const y2j_options* options, y2j_error* error);
+
+/* Destroy a converter; NULL is ignored */
+Y2J_API void y2j_converter_free(y2j_converter* converter);
+
+/*
+ * Convert one YAML buffer (not modified, need not be NUL-terminated) and
+ * stream the output to `out`. On failure, output already passed to the
+ * callback is incomplete and should be discarded. error may be NULL.
+ */
+Y2J_API y2j_status y2j_convert(const y2j_converter* converter, const char* yaml, size_t yaml_size,
+                               y2j_output_fn out, void* user_data, y2j_error* error);
+
+/*
+ * Convert into a caller-provided buffer. *out_size receives the output size;
+ * if it exceeds capacity the call returns Y2J_ERR_BUFFER_TOO_SMALL, the buffer
+ * holds the first capacity bytes, and *out_size is the capacity needed.
+ * The output is not NUL-terminated.
+ */
+Y2J_API y2j_status y2j_convert_to_buffer(const y2j_converter* converter, const char* yaml, size_t yaml_size,
+                                         char* out, size_t capacity, size_t* out_size, y2j_error* error);
+
+/* Static description of a status code */
+Y2J_API const char* y2j_status_string(y2j_status status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YAML2JSON_H */
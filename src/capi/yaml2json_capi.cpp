@@ -0,0 +1,273 @@
+#include "yaml2json.h"
+#include "ErrorHandler.h"
+#include "JsonSchema.h"
+#include "OutputSink.h"
+#include "YamlToJsonConverter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+
+using namespace yaml2json;
+
+struct y2j_converter {
+    ConversionOptions options;
+    uint32_t timeout_ms = 0;
+};
+
+namespace {
+
+// Inputs are parsed in place, so each thread converts from its own copy;
+// the copy is kept between calls unless it grew large
+constexpr size_t kMaxRetainedInput = 1 << 20;
+
+// Fills a thread's input copy and releases it afterwards if it grew large
+class InputCopy {
+public:
+    InputCopy(std::string& input, const char* data, size_t size) : input_(input) { input_.assign(data, size); }
+    InputCopy(const InputCopy&) = delete;
+    InputCopy& operator=(const InputCopy&) = delete;
+
+    ~InputCopy() {
+        if (input_.capacity() > kMaxRetainedInput) {
+            std::string().swap(input_);
+        }
+    }
+
+private:
+    std::string& input_;
+};
+
+// Thrown through the emitter when the output callback asks to stop
+struct CallbackStopped {};
+
+class CallbackSink : public OutputSink {
+public:
+    CallbackSink(y2j_output_fn fn, void* user_data) : fn_(fn), user_data_(user_data) {}
+
+    void write(const char* data, size_t size) override {
+        if (size > 0 && fn_(user_data_, data, size) != 0) {
+            throw CallbackStopped{};
+        }
+    }
+
+private:
+    y2j_output_fn fn_;
+    void* user_data_;
+};
+
+// Fills the caller's buffer and keeps counting once it is full
+class BufferSink : public OutputSink {
+public:
+    BufferSink(char* out, size_t capacity) : out_(out), capacity_(capacity) {}
+
+    void write(const char* data, size_t size) override {
+        if (size_ < capacity_) {
+            std::memcpy(out_ + size_, data, std::min(size, capacity_ - size_));
+        }
+        size_ += size;
+    }
+
+    size_t size() const { return size_; }
+
+private:
+    char* out_;
+    size_t capacity_;
+    size_t size_ = 0;
+};
+
+void set_error(y2j_error* error, y2j_status status, const std::string& message, size_t line = 0,
+               size_t column = 0) {
+    if (error == nullptr) {
+        return;
+    }
+    error->status = status;
+    error->line = line;
+    error->column = column;
+    size_t n = std::min(message.size(), sizeof(error->message) - 1);
+    std::memcpy(error->message, message.data(), n);
+    error->message[n] = '\0';
+}
+
+void clear_error(y2j_error* error) {
+    if (error != nullptr) {
+        error->status = Y2J_OK;
+        error->line = 0;
+        error->column = 0;
+        error->message[0] = '\0';
+    }
+}
+
+// Run a conversion, turning every exception into a status: none may cross the C boundary
+template <typename Fn>
+y2j_status guarded(y2j_error* error, Fn&& fn) {
+    try {
+        fn();
+        clear_error(error);
+        return Y2J_OK;
+    } catch (const CallbackStopped&) {
+        set_error(error, Y2J_ERR_CALLBACK, "Output callback stopped the conversion");
+        return Y2J_ERR_CALLBACK;
+    } catch (const LimitExceededError& e) {
+        set_error(error, Y2J_ERR_LIMIT, e.detail(), e.location().line, e.location().column);
+        return Y2J_ERR_LIMIT;
+    } catch (const ConversionError& e) {
+        set_error(error, Y2J_ERR_PARSE, e.detail(), e.location().line, e.location().column);
+        return Y2J_ERR_PARSE;
+    } catch (const std::bad_alloc&) {
+        set_error(error, Y2J_ERR_NO_MEMORY, "Out of memory");
+        return Y2J_ERR_NO_MEMORY;
+    } catch (const std::exception& e) {
+        set_error(error, Y2J_ERR_INTERNAL, e.what());
+        return Y2J_ERR_INTERNAL;
+    } catch (...) {
+        set_error(error, Y2J_ERR_INTERNAL, "Unknown error");
+        return Y2J_ERR_INTERNAL;
+    }
+}
+
+bool to_options(const y2j_options& in, ConversionOptions& out) {
+    switch (in.format) {
+        case Y2J_FORMAT_JSON: out.format = OutputFormat::Json; break;
+        case Y2J_FORMAT_CBOR: out.format = OutputFormat::Cbor; break;
+        case Y2J_FORMAT_MSGPACK: out.format = OutputFormat::MsgPack; break;
+        default: return false;
+    }
+    switch (in.scalars) {
+        case Y2J_SCALARS_JSON: out.scalars = ScalarTyping::Json; break;
+        case Y2J_SCALARS_CORE: out.scalars = ScalarTyping::Core; break;
+        case Y2J_SCALARS_YAML11: out.scalars = ScalarTyping::Yaml11; break;
+        default: return false;
+    }
+    switch (in.duplicate_keys) {
+        case Y2J_DUPLICATE_KEYS_KEEP: out.duplicate_keys = DuplicateKeys::Keep; break;
+        case Y2J_DUPLICATE_KEYS_ERROR: out.duplicate_keys = DuplicateKeys::Error; break;
+        case Y2J_DUPLICATE_KEYS_LAST_WINS: out.duplicate_keys = DuplicateKeys::LastWins; break;
+        case Y2J_DUPLICATE_KEYS_FIRST_WINS: out.duplicate_keys = DuplicateKeys::FirstWins; break;
+        default: return false;
+    }
+    out.canonical = in.canonical != 0;
+    out.limits.max_input_bytes = in.max_input_bytes;
+    out.limits.max_nodes = in.max_nodes;
+    out.limits.max_arena_bytes = in.max_arena_bytes;
+    out.limits.max_output_bytes = in.max_output_bytes;
+    out.limits.max_depth = in.max_depth;
+    out.limits.max_alias_expansion = in.max_alias_expansion;
+    out.threads = in.threads;
+    out.intern_strings = in.intern_strings != 0;
+    return true;
+}
+
+y2j_status convert_with(const y2j_converter* converter, const char* yaml, size_t yaml_size, OutputSink& sink,
+                        y2j_error* error) {
+    return guarded(error, [&] {
+        thread_local std::string input;
+        InputCopy copy(input, yaml, yaml_size);
+
+        ConversionOptions options = converter->options;
+        if (converter->timeout_ms > 0) {
+            options.limits.deadline = ConversionLimits::Clock::now() + std::chrono::milliseconds(converter->timeout_ms);
+        }
+        YamlToJsonConverter::convert_to(&input[0], input.size(), "", options, sink);
+    });
+}
+
+} // namespace
+
+extern "C" {
+
+int y2j_abi_version(void) {
+    return Y2J_ABI_VERSION;
+}
+
+void y2j_options_init(y2j_options* options) {
+    if (options == nullptr) {
+        return;
+    }
+    std::memset(options, 0, sizeof(*options));
+    options->struct_size = sizeof(*options);
+    options->max_alias_expansion = ConversionLimits{}.max_alias_expansion;
+    options->threads = 1;
+}
+
+y2j_converter* y2j_converter_new(const y2j_options* options, y2j_error* error) {
+    y2j_options settings;
+    y2j_options_init(&settings);
+    if (options != nullptr) {
+        // Options from older headers are shorter: the fields they lack keep their defaults
+        if (options->struct_size < sizeof(size_t) || options->struct_size > sizeof(settings)) {
+            set_error(error, Y2J_ERR_INVALID_ARGUMENT, "Unsupported y2j_options size");
+            return nullptr;
+        }
+        std::memcpy(&settings, options, options->struct_size);
+    }
+
+    ConversionOptions converted;
+    if (!to_options(settings, converted)) {
+        set_error(error, Y2J_ERR_INVALID_ARGUMENT, "Unknown format, scalar typing or duplicate key policy");
+        return nullptr;
+    }
+
+    y2j_converter* converter = nullptr;
+    guarded(error, [&] {
+        std::unique_ptr<y2j_converter> created(new y2j_converter);
+        created->options = converted;
+        created->timeout_ms = settings.timeout_ms;
+        if (settings.schema != nullptr) {
+            created->options.schema = JsonSchema::compile(settings.schema, "schema");
+        }
+        converter = created.release();
+    });
+    return converter;
+}
+
+void y2j_converter_free(y2j_converter* converter) {
+    delete converter;
+}
+
+y2j_status y2j_convert(const y2j_converter* converter, const char* yaml, size_t yaml_size, y2j_output_fn out,
+                       void* user_data, y2j_error* error) {
+    if (converter == nullptr || (yaml == nullptr && yaml_size > 0) || out == nullptr) {
+        set_error(error, Y2J_ERR_INVALID_ARGUMENT, "Converter, input and callback must not be null");
+        return Y2J_ERR_INVALID_ARGUMENT;
+    }
+    CallbackSink sink(out, user_data);
+    return convert_with(converter, yaml, yaml_size, sink, error);
+}
+
+y2j_status y2j_convert_to_buffer(const y2j_converter* converter, const char* yaml, size_t yaml_size, char* out,
+                                 size_t capacity, size_t* out_size, y2j_error* error) {
+    if (converter == nullptr || (yaml == nullptr && yaml_size > 0) || (out == nullptr && capacity > 0) ||
+        out_size == nullptr) {
+        set_error(error, Y2J_ERR_INVALID_ARGUMENT, "Converter, input, buffer and out_size must not be null");
+        return Y2J_ERR_INVALID_ARGUMENT;
+    }
+    BufferSink sink(out, capacity);
+    y2j_status status = convert_with(converter, yaml, yaml_size, sink, error);
+    *out_size = status == Y2J_OK ? sink.size() : 0;
+    if (status == Y2J_OK && sink.size() > capacity) {
+        set_error(error, Y2J_ERR_BUFFER_TOO_SMALL,
+                  "Output of " + std::to_string(sink.size()) + " bytes exceeds the buffer of " +
+                      std::to_string(capacity) + " bytes");
+        return Y2J_ERR_BUFFER_TOO_SMALL;
+    }
+    return status;
+}
+
+const char* y2j_status_string(y2j_status status) {
+    switch (status) {
+        case Y2J_OK: return "ok";
+        case Y2J_ERR_INVALID_ARGUMENT: return "invalid argument";
+        case Y2J_ERR_PARSE: return "conversion error";
+        case Y2J_ERR_LIMIT: return "limit exceeded";
+        case Y2J_ERR_BUFFER_TOO_SMALL: return "output buffer too small";
+        case Y2J_ERR_CALLBACK: return "stopped by output callback";
+        case Y2J_ERR_NO_MEMORY: return "out of memory";
+        case Y2J_ERR_INTERNAL: return "internal error";
+    }
+    return "unknown status";
+}
+
+} // extern "C"
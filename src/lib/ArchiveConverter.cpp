@@ -0,0 +1,139 @@
+#include "ArchiveConverter.h"
+#include "ErrorHandler.h"
+#include "JsonEmitter.h"
+#include "JsonFormatter.h"
+#include "TarArchive.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include "YamlToJsonConverter.h"
+#include <algorithm>
+
+namespace yaml2json {
+
+namespace {
+
+bool ends_with(const std::string& s, const char* suffix, size_t suffix_size) {
+    return s.size() >= suffix_size && s.compare(s.size() - suffix_size, suffix_size, suffix) == 0;
+}
+
+// One NDJSON line per document of the member
+void append_records(const ryml::Tree& tree, const ConversionOptions& options, const std::string& path,
+                    std::string& out) {
+    if (tree.size() == 0) {
+        return;
+    }
+    std::vector<ryml::id_type> documents;
+    ryml::id_type root = tree.root_id();
+    if (tree.is_stream(root)) {
+        for (ryml::id_type doc = tree.first_child(root); doc != ryml::NONE; doc = tree.next_sibling(doc)) {
+            documents.push_back(doc);
+        }
+    } else {
+        documents.push_back(root);
+    }
+
+    JsonEmitter emitter(tree, options);
+    ryml::csubstr member(path.data(), path.size());
+    for (size_t i = 0; i < documents.size(); ++i) {
+        out += "{\"path\":";
+        JsonEmitter::append_string(out, member);
+        out += ",\"document\":";
+        out += std::to_string(i);
+        out += ",\"value\":";
+        emitter.emit_node(documents[i], out);
+        out += "}\n";
+    }
+}
+
+} // namespace
+
+bool ArchiveConverter::is_yaml_path(const std::string& path) {
+    return ends_with(path, ".yaml", 5) || ends_with(path, ".yml", 4);
+}
+
+std::string ArchiveConverter::output_path(const std::string& path, OutputFormat format) {
+    size_t dot = path.rfind('.');
+    std::string stem = dot == std::string::npos ? path : path.substr(0, dot);
+    switch (format) {
+        case OutputFormat::Cbor:
+            return stem + ".cbor";
+        case OutputFormat::MsgPack:
+            return stem + ".msgpack";
+        case OutputFormat::Json:
+            break;
+    }
+    return stem + ".json";
+}
+
+std::string ArchiveConverter::convert(char* data, size_t size, const std::string& archive_name,
+                                      const ConversionOptions& options, const ArchiveOptions& archive,
+                                      std::vector<std::string>& errors) {
+    setup_error_handlers();
+
+    if (!TarArchive::looks_like_tar(data, size)) {
+        throw ConversionError("'" + archive_name + "' is not a tar archive");
+    }
+    std::vector<TarMember> members = TarArchive::members(data, size);
+    members.erase(std::remove_if(members.begin(), members.end(),
+                                 [](const TarMember& m) { return !is_yaml_path(m.path); }),
+                  members.end());
+
+    // Members are small: each is converted serially, the members in parallel
+    ConversionOptions member_options = options;
+    member_options.threads = 1;
+
+    std::vector<std::string> outputs(members.size());
+    std::vector<std::string> failures(members.size());
+    auto convert_one = [&](size_t i) {
+        const TarMember& member = members[i];
+        std::string name = archive_name + ":" + member.path;
+        TraceSpan span("member", name);
+        try {
+            ryml::Tree tree = YamlToJsonConverter::parse_tree(data + member.offset, member.size, name,
+                                                              member_options);
+            if (archive.output == ArchiveOutput::Ndjson) {
+                append_records(tree, member_options, member.path, outputs[i]);
+            } else {
+                outputs[i] = YamlToJsonConverter::emit(tree, member_options);
+                if (archive.pretty && options.format == OutputFormat::Json) {
+                    outputs[i] = JsonFormatter::pretty_print(outputs[i]);
+                }
+            }
+        } catch (const ConversionError& e) {
+            failures[i] = format_machine_error(e, name);
+        } catch (const std::exception& e) {
+            failures[i] = name + ":0:0: " + e.what();
+        }
+    };
+
+    // The calling thread converts members too
+    size_t threads = options.threads == 0 ? ThreadPool::default_threads() : options.threads;
+    size_t workers = std::min(threads, members.size());
+    if (workers <= 1) {
+        for (size_t i = 0; i < members.size(); ++i) {
+            convert_one(i);
+        }
+    } else {
+        ThreadPool pool(workers - 1);
+        pool.parallel_for(members.size(), convert_one);
+    }
+
+    std::string out;
+    for (size_t i = 0; i < members.size(); ++i) {
+        if (!failures[i].empty()) {
+            errors.push_back(std::move(failures[i]));
+        } else if (archive.output == ArchiveOutput::Ndjson) {
+            out += outputs[i];
+        } else {
+            TarArchive::append_file(out, output_path(members[i].path, options.format), outputs[i].data(),
+                                    outputs[i].size());
+        }
+        std::string().swap(outputs[i]);
+    }
+    if (archive.output == ArchiveOutput::Tar) {
+        TarArchive::finish(out);
+    }
+    return out;
+}
+
+} // namespace yaml2json
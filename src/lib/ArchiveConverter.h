@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "ConversionOptions.h"
+
+namespace yaml2json {
+
+// What an archive conversion produces
+enum class ArchiveOutput {
+    Tar,    // a tar of the converted members, .yaml/.yml renamed to the output format's extension
+    Ndjson  // one line per document: {"path":"<member>","document":<n>,"value":<json>}
+};
+
+struct ArchiveOptions {
+    ArchiveOutput output = ArchiveOutput::Tar;
+    bool pretty = false;  // indent JSON members of a tar output
+};
+
+// Converts every *.yaml / *.yml member of a tar archive held in memory (gzip
+// and zstd are already undone by FileReader) without extracting anything.
+// Members are parsed in place inside the archive buffer on options.threads
+// threads (0 = all cores); the output keeps archive order.
+class ArchiveConverter {
+public:
+    // Convert the archive and return the tar or NDJSON output. A member that
+    // fails to convert is left out and its error, formatted as
+    // "archive:member:line:col: message", is appended to `errors`; other
+    // members are still converted. Throws ConversionError if the input is not
+    // a tar archive or is damaged
+    static std::string convert(char* data, size_t size, const std::string& archive_name,
+                               const ConversionOptions& options, const ArchiveOptions& archive,
+                               std::vector<std::string>& errors);
+
+    // Whether a member path names a YAML file
+    static bool is_yaml_path(const std::string& path);
+
+    // Member path in the output tar: the YAML extension replaced by .json, .cbor or .msgpack
+    static std::string output_path(const std::string& path, OutputFormat format);
+};
+
+} // namespace yaml2json
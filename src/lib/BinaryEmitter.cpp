@@ -0,0 +1,374 @@
+#include "BinaryEmitter.h"
+#include "ErrorHandler.h"
+#include "JsonEmitter.h"
+#include "ScalarClassifier.h"
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace yaml2json {
+
+namespace {
+
+// Big-endian writer over the output buffer
+class ByteWriter {
+public:
+    explicit ByteWriter(std::string& out) : out_(out) {}
+
+    void u8(uint8_t v) { out_ += static_cast<char>(v); }
+
+    void u16(uint16_t v) {
+        char b[2] = {static_cast<char>(v >> 8), static_cast<char>(v)};
+        out_.append(b, 2);
+    }
+
+    void u32(uint32_t v) {
+        char b[4] = {static_cast<char>(v >> 24), static_cast<char>(v >> 16),
+                     static_cast<char>(v >> 8), static_cast<char>(v)};
+        out_.append(b, 4);
+    }
+
+    void u64(uint64_t v) {
+        u32(static_cast<uint32_t>(v >> 32));
+        u32(static_cast<uint32_t>(v));
+    }
+
+    void f32(float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        u32(bits);
+    }
+
+    void f64(double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        u64(bits);
+    }
+
+    void bytes(ryml::csubstr s) { out_.append(s.str, s.len); }
+
+private:
+    std::string& out_;
+};
+
+// The clock is read once per this many encoded values (power of two), as in JsonEmitter
+constexpr size_t kDeadlineCheckInterval = 4096;
+
+// Doubles that survive a float round trip are stored in 4 bytes (NaN included)
+bool fits_float(double v) {
+    return v != v || static_cast<double>(static_cast<float>(v)) == v;
+}
+
+class CborEncoder {
+public:
+    explicit CborEncoder(std::string& out) : w_(out) {}
+
+    void begin_map(size_t n) { head(5, n); }
+    void begin_seq(size_t n) { head(4, n); }
+    void end_container() {}
+    void string(ryml::csubstr s) { head(3, s.len); w_.bytes(s); }
+    void null() { w_.u8(0xf6); }
+    void boolean(bool v) { w_.u8(v ? 0xf5 : 0xf4); }
+
+    void integer(bool negative, uint64_t magnitude) {
+        // Major type 1 encodes -1 - n
+        if (negative) {
+            head(1, magnitude - 1);
+        } else {
+            head(0, magnitude);
+        }
+    }
+
+    void real(double v) {
+        if (fits_float(v)) {
+            w_.u8(0xfa);
+            w_.f32(static_cast<float>(v));
+        } else {
+            w_.u8(0xfb);
+            w_.f64(v);
+        }
+    }
+
+private:
+    void head(uint8_t major, uint64_t value) {
+        uint8_t mt = static_cast<uint8_t>(major << 5);
+        if (value < 24) {
+            w_.u8(static_cast<uint8_t>(mt | value));
+        } else if (value <= 0xff) {
+            w_.u8(mt | 24);
+            w_.u8(static_cast<uint8_t>(value));
+        } else if (value <= 0xffff) {
+            w_.u8(mt | 25);
+            w_.u16(static_cast<uint16_t>(value));
+        } else if (value <= 0xffffffffu) {
+            w_.u8(mt | 26);
+            w_.u32(static_cast<uint32_t>(value));
+        } else {
+            w_.u8(mt | 27);
+            w_.u64(value);
+        }
+    }
+
+    ByteWriter w_;
+};
+
+class MsgPackEncoder {
+public:
+    explicit MsgPackEncoder(std::string& out) : w_(out) {}
+
+    void begin_map(size_t n) {
+        if (n < 16) {
+            w_.u8(static_cast<uint8_t>(0x80 | n));
+        } else if (n <= 0xffff) {
+            w_.u8(0xde);
+            w_.u16(static_cast<uint16_t>(n));
+        } else {
+            w_.u8(0xdf);
+            w_.u32(static_cast<uint32_t>(n));
+        }
+    }
+
+    void begin_seq(size_t n) {
+        if (n < 16) {
+            w_.u8(static_cast<uint8_t>(0x90 | n));
+        } else if (n <= 0xffff) {
+            w_.u8(0xdc);
+            w_.u16(static_cast<uint16_t>(n));
+        } else {
+            w_.u8(0xdd);
+            w_.u32(static_cast<uint32_t>(n));
+        }
+    }
+
+    void end_container() {}
+
+    void string(ryml::csubstr s) {
+        if (s.len < 32) {
+            w_.u8(static_cast<uint8_t>(0xa0 | s.len));
+        } else if (s.len <= 0xff) {
+            w_.u8(0xd9);
+            w_.u8(static_cast<uint8_t>(s.len));
+        } else if (s.len <= 0xffff) {
+            w_.u8(0xda);
+            w_.u16(static_cast<uint16_t>(s.len));
+        } else {
+            w_.u8(0xdb);
+            w_.u32(static_cast<uint32_t>(s.len));
+        }
+        w_.bytes(s);
+    }
+
+    void null() { w_.u8(0xc0); }
+    void boolean(bool v) { w_.u8(v ? 0xc3 : 0xc2); }
+
+    void integer(bool negative, uint64_t magnitude) {
+        if (!negative) {
+            if (magnitude < 128) {
+                w_.u8(static_cast<uint8_t>(magnitude));
+            } else if (magnitude <= 0xff) {
+                w_.u8(0xcc);
+                w_.u8(static_cast<uint8_t>(magnitude));
+            } else if (magnitude <= 0xffff) {
+                w_.u8(0xcd);
+                w_.u16(static_cast<uint16_t>(magnitude));
+            } else if (magnitude <= 0xffffffffu) {
+                w_.u8(0xce);
+                w_.u32(static_cast<uint32_t>(magnitude));
+            } else {
+                w_.u8(0xcf);
+                w_.u64(magnitude);
+            }
+            return;
+        }
+
+        // int64 covers magnitudes up to 2^63; beyond that only a double fits
+        if (magnitude > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + 1) {
+            real(-static_cast<double>(magnitude));
+            return;
+        }
+        int64_t v = magnitude == static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + 1
+            ? std::numeric_limits<int64_t>::min()
+            : -static_cast<int64_t>(magnitude);
+        if (v >= -32) {
+            w_.u8(static_cast<uint8_t>(v));
+        } else if (v >= std::numeric_limits<int8_t>::min()) {
+            w_.u8(0xd0);
+            w_.u8(static_cast<uint8_t>(v));
+        } else if (v >= std::numeric_limits<int16_t>::min()) {
+            w_.u8(0xd1);
+            w_.u16(static_cast<uint16_t>(v));
+        } else if (v >= std::numeric_limits<int32_t>::min()) {
+            w_.u8(0xd2);
+            w_.u32(static_cast<uint32_t>(v));
+        } else {
+            w_.u8(0xd3);
+            w_.u64(static_cast<uint64_t>(v));
+        }
+    }
+
+    void real(double v) {
+        if (fits_float(v)) {
+            w_.u8(0xca);
+            w_.f32(static_cast<float>(v));
+        } else {
+            w_.u8(0xcb);
+            w_.f64(v);
+        }
+    }
+
+private:
+    ByteWriter w_;
+};
+
+// Walks the tree as JsonEmitter emits it: aliases and merge keys expanded
+// through the emitter, with the same alias budget, depth, output size and
+// deadline checks
+template<class Encoder>
+class TreeEncoder {
+public:
+    TreeEncoder(const ryml::Tree& tree, ScalarTyping typing, const ConversionLimits& limits, std::string& out)
+        : tree_(tree), typing_(typing), limits_(limits), aliases_(tree, limits), out_(out), enc_(out) {}
+
+    void encode() {
+        ryml::id_type root = tree_.root_id();
+        if (tree_.is_stream(root)) {
+            for (ryml::id_type doc = tree_.first_child(root); doc != ryml::NONE;
+                 doc = tree_.next_sibling(doc)) {
+                encode_value(doc, 0);
+            }
+        } else {
+            encode_value(root, 0);
+        }
+        check_output_size();
+    }
+
+private:
+    void encode_value(ryml::id_type node, size_t depth) {
+        ryml::id_type target = aliases_.resolve_value(node);
+        check_budget();
+        if (target == node && tree_.is_val_ref(node)) {
+            // An alias of an anchored key stands for the key's text
+            enc_.string(aliases_.value_text(node));
+        } else if (tree_.is_map(target)) {
+            encode_map(target, depth + 1);
+        } else if (tree_.is_seq(target)) {
+            encode_seq(target, depth + 1);
+        } else if (tree_.has_val(target)) {
+            encode_scalar(target);
+        } else {
+            enc_.null();
+        }
+    }
+
+    void encode_map(ryml::id_type node, size_t depth) {
+        check_depth(depth);
+        // One entry list per nesting level, reused across the maps there;
+        // indexed on every use since deeper levels may grow the outer vector
+        if (entries_.size() < depth) {
+            entries_.resize(depth);
+        }
+        entries_[depth - 1].clear();
+        aliases_.map_entries(node, entries_[depth - 1]);
+        size_t count = entries_[depth - 1].size();
+        enc_.begin_map(count);
+        for (size_t i = 0; i < count; ++i) {
+            ryml::id_type child = entries_[depth - 1][i];
+            enc_.string(aliases_.entry_key(child));
+            encode_value(child, depth);
+        }
+        enc_.end_container();
+    }
+
+    void encode_seq(ryml::id_type node, size_t depth) {
+        check_depth(depth);
+        enc_.begin_seq(tree_.num_children(node));
+        for (ryml::id_type child = tree_.first_child(node); child != ryml::NONE;
+             child = tree_.next_sibling(child)) {
+            encode_value(child, depth);
+        }
+        enc_.end_container();
+    }
+
+    void encode_scalar(ryml::id_type node) {
+        ScalarValue value = ScalarClassifier::decode_node(tree_, node, typing_);
+        switch (value.type) {
+            case ScalarType::Null:
+                enc_.null();
+                break;
+            case ScalarType::Bool:
+                enc_.boolean(value.boolean);
+                break;
+            case ScalarType::Int:
+                enc_.integer(value.negative, value.magnitude);
+                break;
+            case ScalarType::Float:
+                enc_.real(value.number);
+                break;
+            case ScalarType::String:
+                enc_.string(tree_.val(node));
+                break;
+        }
+    }
+
+    void check_depth(size_t depth) const {
+        if (limits_.max_depth > 0 && depth > limits_.max_depth) {
+            throw LimitExceededError("Nesting depth limit exceeded: more than " +
+                                     std::to_string(limits_.max_depth) + " levels");
+        }
+    }
+
+    void check_budget() {
+        if (++encoded_nodes_ > aliases_.node_budget()) {
+            throw LimitExceededError("Alias expansion limit exceeded: more than " +
+                                     std::to_string(aliases_.node_budget()) + " values emitted from " +
+                                     std::to_string(tree_.size()) + " parsed nodes");
+        }
+        check_output_size();
+        if ((encoded_nodes_ & (kDeadlineCheckInterval - 1)) == 0 && limits_.has_deadline() &&
+            ConversionLimits::Clock::now() > limits_.deadline) {
+            throw LimitExceededError("Deadline exceeded while emitting");
+        }
+    }
+
+    void check_output_size() const {
+        if (limits_.max_output_bytes > 0 && out_.size() > limits_.max_output_bytes) {
+            throw LimitExceededError("Output size limit exceeded: more than " +
+                                     std::to_string(limits_.max_output_bytes) + " bytes");
+        }
+    }
+
+    const ryml::Tree& tree_;
+    ScalarTyping typing_;
+    const ConversionLimits& limits_;
+    JsonEmitter aliases_;
+    std::string& out_;
+    Encoder enc_;
+    std::vector<std::vector<ryml::id_type>> entries_;
+    size_t encoded_nodes_ = 0;
+};
+
+template<class Encoder>
+std::string encode(const ryml::Tree& tree, ScalarTyping typing, const ConversionLimits& limits) {
+    std::string out;
+    if (tree.size() == 0) {
+        return out;
+    }
+    out.reserve(static_cast<size_t>(tree.size()) * 8);
+    TreeEncoder<Encoder>(tree, typing, limits, out).encode();
+    return out;
+}
+
+} // namespace
+
+std::string BinaryEmitter::to_cbor(const ryml::Tree& tree, ScalarTyping typing, const ConversionLimits& limits) {
+    return encode<CborEncoder>(tree, typing, limits);
+}
+
+std::string BinaryEmitter::to_msgpack(const ryml::Tree& tree, ScalarTyping typing,
+                                      const ConversionLimits& limits) {
+    return encode<MsgPackEncoder>(tree, typing, limits);
+}
+
+} // namespace yaml2json
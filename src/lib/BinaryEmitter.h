@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <ryml.hpp>
+#include "ConversionOptions.h"
+
+namespace yaml2json {
+
+// Binary emitters that walk the ryml tree directly, skipping textual JSON.
+// Plain scalars are typed with ScalarClassifier (the core schema unless
+// YAML 1.1 typing is requested); keys are always strings. Aliases and merge
+// keys are expanded through JsonEmitter, so the data matches the JSON output,
+// and ConversionLimits are enforced while encoding.
+class BinaryEmitter {
+public:
+    // Encode as CBOR (RFC 8949); multiple documents form a CBOR sequence (RFC 8742)
+    static std::string to_cbor(const ryml::Tree& tree, ScalarTyping typing = ScalarTyping::Core,
+                               const ConversionLimits& limits = ConversionLimits{});
+
+    // Encode as MessagePack; multiple documents are concatenated
+    static std::string to_msgpack(const ryml::Tree& tree, ScalarTyping typing = ScalarTyping::Core,
+                                  const ConversionLimits& limits = ConversionLimits{});
+};
+
+} // namespace yaml2json
@@ -0,0 +1,431 @@
+#include "Compression.h"
+#include "ErrorHandler.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#ifdef YAML2JSON_HAVE_ZLIB
+    #include <zlib.h>
+#endif
+#ifdef YAML2JSON_HAVE_ZSTD
+    #include <zstd.h>
+#endif
+
+namespace yaml2json {
+
+namespace {
+
+// Granularity of output growth and of codec input slices (zlib counts in uInt)
+constexpr size_t kChunkSize = 256 * 1024;
+constexpr size_t kMaxSlice = 1u << 30;
+
+// Largest compression ratio for which a stored size hint is used to pre-size output
+constexpr size_t kMaxHintRatio = 64;
+
+[[noreturn]] void throw_unsupported(CompressionFormat format) {
+    throw ConversionError(std::string("Input is ") + Compression::name(format) +
+                          "-compressed but yaml2json was built without " +
+                          Compression::name(format) + " support");
+}
+
+} // namespace
+
+struct Decompressor::Impl {
+    CompressionFormat format;
+    std::string output;
+    size_t produced = 0;
+    size_t max_output = 0;
+    bool fed = false;
+
+#ifdef YAML2JSON_HAVE_ZLIB
+    z_stream zs{};
+    bool zs_ready = false;
+    bool member_done = false;
+#endif
+#ifdef YAML2JSON_HAVE_ZSTD
+    ZSTD_DStream* zds = nullptr;
+    size_t zstd_pending = 1;
+#endif
+
+    // Make sure at least min_free bytes are available past the produced data
+    void reserve_output(size_t min_free) {
+        if (output.size() - produced >= min_free) {
+            return;
+        }
+        output.resize(std::max(output.size() * 2, produced + min_free));
+    }
+
+    // Stop a decompression bomb as soon as it passes the caller's limit
+    void check_output_limit() const {
+        if (max_output > 0 && produced > max_output) {
+            throw LimitExceededError("Decompressed input exceeds the input size limit of " +
+                                     std::to_string(max_output) + " bytes");
+        }
+    }
+};
+
+Decompressor::Decompressor(CompressionFormat format, size_t size_hint)
+    : impl_(std::make_unique<Impl>()) {
+    if (!Compression::is_supported(format) || format == CompressionFormat::None) {
+        throw_unsupported(format);
+    }
+    impl_->format = format;
+    impl_->output.resize(std::max(size_hint, kChunkSize));
+
+#ifdef YAML2JSON_HAVE_ZLIB
+    if (format == CompressionFormat::Gzip) {
+        // 16 + MAX_WBITS: accept gzip framing only
+        if (inflateInit2(&impl_->zs, 16 + MAX_WBITS) != Z_OK) {
+            throw ConversionError("Failed to initialise gzip decoder");
+        }
+        impl_->zs_ready = true;
+    }
+#endif
+#ifdef YAML2JSON_HAVE_ZSTD
+    if (format == CompressionFormat::Zstd) {
+        impl_->zds = ZSTD_createDStream();
+        if (impl_->zds == nullptr) {
+            throw ConversionError("Failed to initialise zstd decoder");
+        }
+    }
+#endif
+}
+
+Decompressor::~Decompressor() {
+#ifdef YAML2JSON_HAVE_ZLIB
+    if (impl_->zs_ready) {
+        inflateEnd(&impl_->zs);
+    }
+#endif
+#ifdef YAML2JSON_HAVE_ZSTD
+    if (impl_->zds != nullptr) {
+        ZSTD_freeDStream(impl_->zds);
+    }
+#endif
+}
+
+void Decompressor::set_output_limit(size_t max_bytes) {
+    impl_->max_output = max_bytes;
+}
+
+void Decompressor::feed(const char* data, size_t size) {
+    Impl& d = *impl_;
+    if (size > 0) {
+        d.fed = true;
+    }
+
+#ifdef YAML2JSON_HAVE_ZLIB
+    if (d.format == CompressionFormat::Gzip) {
+        while (size > 0) {
+            size_t slice = std::min(size, kMaxSlice);
+            d.zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+            d.zs.avail_in = static_cast<uInt>(slice);
+
+            do {
+                if (d.member_done) {
+                    // A member ending exactly at a full output buffer: wait for more input
+                    if (d.zs.avail_in == 0) {
+                        break;
+                    }
+                    // NUL padding after a member (tape blocks, fixed-size records) is skipped, as gzip does
+                    const Bytef* rest = d.zs.next_in;
+                    if (std::all_of(rest, rest + d.zs.avail_in, [](Bytef b) { return b == 0; })) {
+                        d.zs.next_in += d.zs.avail_in;
+                        d.zs.avail_in = 0;
+                        break;
+                    }
+                    // Concatenated gzip members (pigz, cat a.gz b.gz) decode as one stream
+                    inflateReset(&d.zs);
+                    d.member_done = false;
+                }
+                d.reserve_output(kChunkSize);
+                size_t room = std::min(d.output.size() - d.produced, kMaxSlice);
+                d.zs.next_out = reinterpret_cast<Bytef*>(&d.output[d.produced]);
+                d.zs.avail_out = static_cast<uInt>(room);
+
+                int rc = inflate(&d.zs, Z_NO_FLUSH);
+                d.produced += room - d.zs.avail_out;
+                d.check_output_limit();
+
+                if (rc == Z_STREAM_END) {
+                    d.member_done = true;
+                    continue;
+                }
+                if (rc == Z_BUF_ERROR) {
+                    break;
+                }
+                if (rc != Z_OK) {
+                    throw ConversionError(std::string("gzip decompression failed: ") +
+                                          (d.zs.msg ? d.zs.msg : "corrupt stream"));
+                }
+            } while (d.zs.avail_in > 0 || d.zs.avail_out == 0);
+
+            data += slice;
+            size -= slice;
+        }
+        return;
+    }
+#endif
+
+#ifdef YAML2JSON_HAVE_ZSTD
+    if (d.format == CompressionFormat::Zstd) {
+        ZSTD_inBuffer in{data, size, 0};
+        for (;;) {
+            d.reserve_output(ZSTD_DStreamOutSize());
+            ZSTD_outBuffer out{&d.output[d.produced], d.output.size() - d.produced, 0};
+
+            size_t ret = ZSTD_decompressStream(d.zds, &out, &in);
+            if (ZSTD_isError(ret)) {
+                throw ConversionError(std::string("zstd decompression failed: ") +
+                                      ZSTD_getErrorName(ret));
+            }
+            d.produced += out.pos;
+            d.zstd_pending = ret;
+            d.check_output_limit();
+
+            // Input drained and either the frame is complete or the decoder did not
+            // fill the buffer: nothing left to flush
+            if (in.pos == in.size && (ret == 0 || out.pos < out.size)) {
+                break;
+            }
+        }
+        return;
+    }
+#endif
+
+    (void)data;
+    throw_unsupported(d.format);
+}
+
+std::string Decompressor::finish() {
+    Impl& d = *impl_;
+    bool complete = false;
+
+#ifdef YAML2JSON_HAVE_ZLIB
+    if (d.format == CompressionFormat::Gzip) {
+        complete = d.member_done;
+    }
+#endif
+#ifdef YAML2JSON_HAVE_ZSTD
+    if (d.format == CompressionFormat::Zstd) {
+        complete = d.zstd_pending == 0;
+    }
+#endif
+
+    if (!d.fed || !complete) {
+        throw ConversionError(std::string("Truncated ") + Compression::name(d.format) + " stream");
+    }
+
+    d.output.resize(d.produced);
+    return std::move(d.output);
+}
+
+CompressionFormat Compression::detect(const char* data, size_t size) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    if (size >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b) {
+        return CompressionFormat::Gzip;
+    }
+    if (size >= 4 && bytes[0] == 0x28 && bytes[1] == 0xb5 && bytes[2] == 0x2f && bytes[3] == 0xfd) {
+        return CompressionFormat::Zstd;
+    }
+    return CompressionFormat::None;
+}
+
+bool Compression::is_supported(CompressionFormat format) {
+    switch (format) {
+        case CompressionFormat::None:
+            return true;
+        case CompressionFormat::Gzip:
+#ifdef YAML2JSON_HAVE_ZLIB
+            return true;
+#else
+            return false;
+#endif
+        case CompressionFormat::Zstd:
+#ifdef YAML2JSON_HAVE_ZSTD
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+const char* Compression::name(CompressionFormat format) {
+    switch (format) {
+        case CompressionFormat::Gzip: return "gzip";
+        case CompressionFormat::Zstd: return "zstd";
+        case CompressionFormat::None: break;
+    }
+    return "none";
+}
+
+CompressionOptions Compression::parse_spec(const std::string& spec) {
+    CompressionOptions options;
+    std::string codec = spec;
+    std::string level;
+
+    size_t colon = spec.find(':');
+    if (colon != std::string::npos) {
+        codec = spec.substr(0, colon);
+        level = spec.substr(colon + 1);
+    }
+
+    int max_level = 0;
+    if (codec == "gzip" || codec == "gz") {
+        options.format = CompressionFormat::Gzip;
+        max_level = 9;
+    } else if (codec == "zstd" || codec == "zst") {
+        options.format = CompressionFormat::Zstd;
+        max_level = 22;
+    } else {
+        throw ConversionError("Unknown compression format '" + codec + "' (expected gzip or zstd)");
+    }
+
+    if (colon != std::string::npos) {
+        char* end = nullptr;
+        long value = std::strtol(level.c_str(), &end, 10);
+        if (level.empty() || *end != '\0' || value < 1 || value > max_level) {
+            throw ConversionError("Invalid " + codec + " compression level '" + level +
+                                  "' (expected 1-" + std::to_string(max_level) + ")");
+        }
+        options.level = static_cast<int>(value);
+    }
+
+    if (!is_supported(options.format)) {
+        throw ConversionError(std::string("yaml2json was built without ") +
+                              name(options.format) + " support");
+    }
+    return options;
+}
+
+std::string Compression::decompress(const char* data, size_t size, CompressionFormat format,
+                                    size_t max_output) {
+    size_t hint = 0;
+#ifdef YAML2JSON_HAVE_ZSTD
+    if (format == CompressionFormat::Zstd) {
+        unsigned long long content_size = ZSTD_getFrameContentSize(data, size);
+        if (content_size != ZSTD_CONTENTSIZE_UNKNOWN && content_size != ZSTD_CONTENTSIZE_ERROR &&
+            content_size / kMaxHintRatio <= size) {
+            hint = static_cast<size_t>(content_size);
+        }
+    }
+#endif
+    if (format == CompressionFormat::Gzip && size >= 18) {
+        // ISIZE trailer: uncompressed size of the last member modulo 2^32
+        const auto* tail = reinterpret_cast<const unsigned char*>(data + size - 4);
+        size_t isize = static_cast<size_t>(tail[0]) | (static_cast<size_t>(tail[1]) << 8) |
+                       (static_cast<size_t>(tail[2]) << 16) | (static_cast<size_t>(tail[3]) << 24);
+        // The trailer is only a hint (wraps at 4GB, garbage when truncated): trust plausible ratios
+        if (isize >= size && isize / kMaxHintRatio <= size) {
+            hint = isize;
+        }
+    }
+
+    if (max_output > 0) {
+        hint = std::min(hint, max_output);
+    }
+
+    Decompressor decoder(format, hint + 1);
+    decoder.set_output_limit(max_output);
+    for (size_t offset = 0; offset < size; offset += kChunkSize) {
+        decoder.feed(data + offset, std::min(kChunkSize, size - offset));
+    }
+    return decoder.finish();
+}
+
+std::string Compression::compress(const char* data, size_t size, const CompressionOptions& options) {
+    if (options.format == CompressionFormat::None) {
+        return std::string(data, size);
+    }
+    if (!is_supported(options.format)) {
+        throw_unsupported(options.format);
+    }
+
+    std::string output;
+
+#ifdef YAML2JSON_HAVE_ZLIB
+    if (options.format == CompressionFormat::Gzip) {
+        z_stream zs{};
+        int level = options.level < 0 ? Z_DEFAULT_COMPRESSION : options.level;
+        if (deflateInit2(&zs, level, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw ConversionError("Failed to initialise gzip encoder");
+        }
+        output.resize(deflateBound(&zs, static_cast<uLong>(size)) + 64);
+
+        size_t consumed = 0;
+        size_t produced = 0;
+        int rc = Z_OK;
+        while (rc != Z_STREAM_END) {
+            size_t in_slice = std::min(size - consumed, kMaxSlice);
+            size_t out_slice = std::min(output.size() - produced, kMaxSlice);
+            zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data + consumed));
+            zs.avail_in = static_cast<uInt>(in_slice);
+            zs.next_out = reinterpret_cast<Bytef*>(&output[produced]);
+            zs.avail_out = static_cast<uInt>(out_slice);
+
+            bool last = consumed + in_slice == size;
+            rc = deflate(&zs, last ? Z_FINISH : Z_NO_FLUSH);
+            consumed += in_slice - zs.avail_in;
+            produced += out_slice - zs.avail_out;
+
+            if (rc == Z_STREAM_ERROR) {
+                deflateEnd(&zs);
+                throw ConversionError("gzip compression failed");
+            }
+            if (produced == output.size()) {
+                output.resize(output.size() + kChunkSize);
+            }
+        }
+        deflateEnd(&zs);
+        output.resize(produced);
+        return output;
+    }
+#endif
+
+#ifdef YAML2JSON_HAVE_ZSTD
+    if (options.format == CompressionFormat::Zstd) {
+        ZSTD_CCtx* cctx = ZSTD_createCCtx();
+        if (cctx == nullptr) {
+            throw ConversionError("Failed to initialise zstd encoder");
+        }
+        int threads = options.threads > 0
+            ? options.threads
+            : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+        ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel,
+                               options.level < 0 ? ZSTD_CLEVEL_DEFAULT : options.level);
+        // Fails harmlessly (single-threaded) when libzstd lacks ZSTD_MULTITHREAD
+        ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, threads > 1 ? threads : 0);
+        ZSTD_CCtx_setPledgedSrcSize(cctx, size);
+
+        output.resize(ZSTD_compressBound(size));
+        ZSTD_inBuffer in{data, size, 0};
+        ZSTD_outBuffer out{&output[0], output.size(), 0};
+        size_t remaining = 0;
+        do {
+            remaining = ZSTD_compressStream2(cctx, &out, &in, ZSTD_e_end);
+            if (ZSTD_isError(remaining)) {
+                std::string reason = ZSTD_getErrorName(remaining);
+                ZSTD_freeCCtx(cctx);
+                throw ConversionError("zstd compression failed: " + reason);
+            }
+            if (remaining != 0 && out.pos == out.size) {
+                output.resize(output.size() + std::max(remaining, kChunkSize));
+                out.dst = &output[0];
+                out.size = output.size();
+            }
+        } while (remaining != 0);
+
+        ZSTD_freeCCtx(cctx);
+        output.resize(out.pos);
+        return output;
+    }
+#endif
+
+    throw_unsupported(options.format);
+}
+
+} // namespace yaml2json
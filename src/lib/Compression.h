@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <cstddef>
+
+namespace yaml2json {
+
+// Compression container formats recognised on input and produced on output
+enum class CompressionFormat {
+    None,
+    Gzip,
+    Zstd
+};
+
+// Output compression options
+struct CompressionOptions {
+    CompressionFormat format = CompressionFormat::None;
+    int level = -1;   // -1 selects the codec default
+    int threads = 0;  // zstd worker threads (0 = one per hardware thread)
+};
+
+// Incremental decoder: feed compressed chunks, collect the decompressed bytes
+class Decompressor {
+public:
+    explicit Decompressor(CompressionFormat format, size_t size_hint = 0);
+    Decompressor(const Decompressor&) = delete;
+    Decompressor& operator=(const Decompressor&) = delete;
+    ~Decompressor();
+
+    // Fail with LimitExceededError once the output exceeds max_bytes (0 = unlimited)
+    void set_output_limit(size_t max_bytes);
+
+    // Decompress the next chunk of input
+    void feed(const char* data, size_t size);
+
+    // Verify the stream is complete and take the decompressed output
+    std::string finish();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// gzip/zstd codecs (available when built with zlib/libzstd)
+class Compression {
+public:
+    // Detect compression format from the leading magic bytes
+    static CompressionFormat detect(const char* data, size_t size);
+
+    // Check whether support for a format was compiled in
+    static bool is_supported(CompressionFormat format);
+
+    // Short format name ("none", "gzip", "zstd")
+    static const char* name(CompressionFormat format);
+
+    // Parse a "gzip|zstd[:level]" specification
+    static CompressionOptions parse_spec(const std::string& spec);
+
+    // Decompress a complete buffer in streaming fashion, producing at most max_output bytes
+    static std::string decompress(const char* data, size_t size, CompressionFormat format,
+                                  size_t max_output = 0);
+
+    // Compress a complete buffer
+    static std::string compress(const char* data, size_t size, const CompressionOptions& options);
+};
+
+} // namespace yaml2json
@@ -0,0 +1,146 @@
+#include "ContentHash.h"
+#include <cstring>
+
+namespace yaml2json {
+
+namespace {
+
+constexpr uint64_t kPrime1 = 11400714785074694791ULL;
+constexpr uint64_t kPrime2 = 14029467366897019727ULL;
+constexpr uint64_t kPrime3 = 1609587929392839161ULL;
+constexpr uint64_t kPrime4 = 9650029242287828579ULL;
+constexpr uint64_t kPrime5 = 2870177450012600261ULL;
+
+inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// XXH64 is defined on little-endian words; assemble them bytewise so the
+// digest is the same on every platform (compilers fold this into one load)
+inline uint64_t read64(const unsigned char* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+inline uint32_t read32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+           static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+inline uint64_t mix_round(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t merge_round(uint64_t h, uint64_t acc) {
+    h ^= mix_round(0, acc);
+    return h * kPrime1 + kPrime4;
+}
+
+// Consume whole 32-byte stripes; returns the bytes consumed
+inline size_t consume_stripes(uint64_t acc[4], const unsigned char* p, size_t size) {
+    size_t done = 0;
+    for (; done + 32 <= size; done += 32) {
+        acc[0] = mix_round(acc[0], read64(p + done));
+        acc[1] = mix_round(acc[1], read64(p + done + 8));
+        acc[2] = mix_round(acc[2], read64(p + done + 16));
+        acc[3] = mix_round(acc[3], read64(p + done + 24));
+    }
+    return done;
+}
+
+} // namespace
+
+ContentHash::ContentHash(uint64_t seed) : seed_(seed) {
+    acc_[0] = seed + kPrime1 + kPrime2;
+    acc_[1] = seed + kPrime2;
+    acc_[2] = seed;
+    acc_[3] = seed - kPrime1;
+}
+
+void ContentHash::write(const char* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    auto p = reinterpret_cast<const unsigned char*>(data);
+    total_ += size;
+
+    if (pending_size_ > 0) {
+        size_t take = sizeof(pending_) - pending_size_;
+        if (size < take) {
+            std::memcpy(pending_ + pending_size_, p, size);
+            pending_size_ += size;
+            return;
+        }
+        std::memcpy(pending_ + pending_size_, p, take);
+        consume_stripes(acc_, pending_, sizeof(pending_));
+        pending_size_ = 0;
+        p += take;
+        size -= take;
+    }
+
+    size_t done = consume_stripes(acc_, p, size);
+    pending_size_ = size - done;
+    if (pending_size_ > 0) {
+        std::memcpy(pending_, p + done, pending_size_);
+    }
+}
+
+uint64_t ContentHash::digest() const {
+    uint64_t h;
+    if (total_ >= 32) {
+        h = rotl(acc_[0], 1) + rotl(acc_[1], 7) + rotl(acc_[2], 12) + rotl(acc_[3], 18);
+        for (uint64_t acc : acc_) {
+            h = merge_round(h, acc);
+        }
+    } else {
+        h = seed_ + kPrime5;
+    }
+    h += total_;
+
+    const unsigned char* p = pending_;
+    const unsigned char* end = pending_ + pending_size_;
+    for (; p + 8 <= end; p += 8) {
+        h ^= mix_round(0, read64(p));
+        h = rotl(h, 27) * kPrime1 + kPrime4;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * kPrime1;
+        h = rotl(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= *p * kPrime5;
+        h = rotl(h, 11) * kPrime1;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+std::string ContentHash::hex() const {
+    static const char digits[] = "0123456789abcdef";
+    uint64_t h = digest();
+    std::string out(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        out[i] = digits[h & 0xf];
+        h >>= 4;
+    }
+    return out;
+}
+
+uint64_t ContentHash::of(const char* data, size_t size, uint64_t seed) {
+    ContentHash hash(seed);
+    hash.write(data, size);
+    return hash.digest();
+}
+
+} // namespace yaml2json
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "OutputSink.h"
+
+namespace yaml2json {
+
+// Streaming 64-bit XXH64 hash of everything written to it. Not cryptographic:
+// meant for spotting changed output (config drift, cache keys) cheaply.
+class ContentHash : public OutputSink {
+public:
+    explicit ContentHash(uint64_t seed = 0);
+
+    void write(const char* data, size_t size) override;
+
+    // Hash of the bytes written so far; more may be written afterwards
+    uint64_t digest() const;
+
+    // digest() as 16 lowercase hex digits
+    std::string hex() const;
+
+    // Hash a buffer in one call
+    static uint64_t of(const char* data, size_t size, uint64_t seed = 0);
+
+private:
+    uint64_t acc_[4];
+    uint64_t seed_;
+    uint64_t total_ = 0;
+    unsigned char pending_[32];
+    size_t pending_size_ = 0;
+};
+
+} // namespace yaml2json
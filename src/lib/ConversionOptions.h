@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+namespace yaml2json {
+
+class JsonSchema;
+
+// Serialization formats produced from the parsed tree
+enum class OutputFormat {
+    Json,
+    Cbor,
+    MsgPack
+};
+
+// How plain scalars are typed in JSON output
+enum class ScalarTyping {
+    Json,   // scalars that already are JSON literals pass through, everything else is a string
+    Core,   // YAML 1.2 core schema, normalized to JSON: 0x1F -> 31, .5 -> 0.5, TRUE -> true
+    Yaml11  // YAML 1.1 as well: yes/no/on/off, 0b1010, 017 (octal), 1_000
+};
+
+// What to do with a key that occurs more than once in the same mapping
+enum class DuplicateKeys {
+    Keep,       // emit every occurrence; JSON parsers then disagree on which one counts
+    Error,      // fail, pointing at the second occurrence
+    LastWins,   // drop all but the last occurrence
+    FirstWins   // drop all but the first occurrence
+};
+
+// Bounds on the cost of a single conversion (0 = unlimited);
+// violations raise LimitExceededError
+struct ConversionLimits {
+    using Clock = std::chrono::steady_clock;
+
+    // Maximum input size in bytes, after decompression
+    size_t max_input_bytes = 0;
+
+    // Maximum number of nodes in the parsed tree
+    size_t max_nodes = 0;
+
+    // Maximum bytes the parser may keep in the tree arena
+    size_t max_arena_bytes = 0;
+
+    // Wall-clock deadline for parsing and emitting (default: none)
+    Clock::time_point deadline{};
+
+    // Emitted nodes per parsed node once aliases are expanded (billion-laughs guard)
+    double max_alias_expansion = 100.0;
+
+    // Maximum size of the emitted output in bytes
+    size_t max_output_bytes = 0;
+
+    // Maximum container nesting depth, counted through expanded aliases
+    size_t max_depth = 0;
+
+    bool has_deadline() const { return deadline != Clock::time_point{}; }
+};
+
+// Settings for a single conversion
+struct ConversionOptions {
+    OutputFormat format = OutputFormat::Json;
+    ScalarTyping scalars = ScalarTyping::Json;
+    ConversionLimits limits;
+
+    // JSON only: sort map keys bytewise and drop all whitespace. Scalars are
+    // not normalized (1.0 and 1.00 stay distinct)
+    bool canonical = false;
+
+    // Handling of repeated mapping keys, applied to the tree before emitting
+    DuplicateKeys duplicate_keys = DuplicateKeys::Keep;
+
+    // Validate each document against this schema before emitting (null = none).
+    // Compiled once, it can be shared by any number of conversions
+    std::shared_ptr<const JsonSchema> schema;
+
+    // Threads for parsing one large document in chunks (1 = serial, 0 = all cores)
+    size_t threads = 1;
+
+    // JSON only: cache the escaped form of short strings that need escaping
+    // (StringInterner), for inputs that repeat the same few keys and values
+    // millions of times
+    bool intern_strings = false;
+};
+
+} // namespace yaml2json
@@ -0,0 +1,404 @@
+#include "Document.h"
+#include "ErrorHandler.h"
+#include "FileReader.h"
+#include "JsonEmitter.h"
+#include "ScalarClassifier.h"
+#include "YamlToJsonConverter.h"
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+namespace yaml2json {
+
+namespace detail {
+
+// Everything a Document owns, kept at a fixed address so NodeRefs survive
+// moves of the Document
+struct DocumentState {
+    // Members of an object in output order, merge keys expanded, with a hash
+    // index by key (the last occurrence of a repeated key wins)
+    struct MapIndex {
+        std::vector<ryml::id_type> entries;
+        std::unordered_map<std::string_view, ryml::id_type> by_key;
+    };
+
+    struct Scalar {
+        JsonType type;
+        ScalarValue value;
+    };
+
+    std::string buffer;  // parse(): the copy parsed in place
+    FileContent file;    // load(): the mapped or decompressed file
+    ryml::Tree tree;
+    ConversionOptions options;
+
+    // Resolves aliases and merge keys and emits subtrees. Aliases are resolved
+    // up front, after which lookups only read it; emitting is serialized
+    std::unique_ptr<JsonEmitter> emitter;
+    bool aliases = false;
+
+    mutable std::mutex mutex;
+    mutable std::unordered_map<ryml::id_type, std::unique_ptr<MapIndex>> indexes;
+
+    void init(const char* data, size_t size, const std::string& filename) {
+        emitter = std::make_unique<JsonEmitter>(tree, options);
+        emitter->set_source(data, size, filename);
+        emitter->resolve_aliases();
+        aliases = emitter->has_aliases();
+    }
+
+    ryml::id_type resolve(ryml::id_type entry) const {
+        return aliases ? emitter->resolve_value(entry) : entry;
+    }
+
+    std::string_view key_of(ryml::id_type entry) const {
+        if (!tree.has_key(entry)) {
+            return {};
+        }
+        ryml::csubstr key = aliases ? emitter->entry_key(entry) : tree.key(entry);
+        return std::string_view(key.str, key.len);
+    }
+
+    const MapIndex& index(ryml::id_type map) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unique_ptr<MapIndex>& slot = indexes[map];
+        if (slot == nullptr) {
+            auto built = std::make_unique<MapIndex>();
+            emitter->map_entries(map, built->entries);
+            built->by_key.reserve(built->entries.size());
+            for (ryml::id_type entry : built->entries) {
+                built->by_key[key_of(entry)] = entry;
+            }
+            slot = std::move(built);
+        }
+        return *slot;
+    }
+
+    // Scalars are typed as JsonEmitter::emit_scalar types them
+    Scalar classify(ryml::id_type node) const {
+        ryml::csubstr val = tree.val(node);
+        bool is_string = tree.is_val_quoted(node) || (tree.has_val_tag(node) && tree.val_tag(node) == "!!str");
+        if (!is_string && (val.str == nullptr || tree.val_is_null(node))) {
+            return Scalar{JsonType::Null, ScalarValue{}};
+        }
+        if (is_string) {
+            return Scalar{JsonType::String, ScalarValue{}};
+        }
+        if (options.scalars != ScalarTyping::Json) {
+            ScalarValue value = ScalarClassifier::decode(val, options.scalars);
+            switch (value.type) {
+                case ScalarType::Null: return Scalar{JsonType::Null, value};
+                case ScalarType::Bool: return Scalar{JsonType::Bool, value};
+                case ScalarType::Int: return Scalar{JsonType::Number, value};
+                case ScalarType::Float:
+                    // JSON has no infinity or NaN: the emitter keeps them as strings
+                    return Scalar{std::isfinite(value.number) ? JsonType::Number : JsonType::String, value};
+                case ScalarType::String: break;
+            }
+            return Scalar{JsonType::String, value};
+        }
+        if (val == "true" || val == "false") {
+            ScalarValue value;
+            value.type = ScalarType::Bool;
+            value.boolean = val == "true";
+            return Scalar{JsonType::Bool, value};
+        }
+        if (ScalarClassifier::is_json_number(val)) {
+            return Scalar{JsonType::Number, ScalarClassifier::decode(val, ScalarTyping::Core)};
+        }
+        return Scalar{JsonType::String, ScalarValue{}};
+    }
+};
+
+} // namespace detail
+
+namespace {
+
+const char* type_name(JsonType type) {
+    switch (type) {
+        case JsonType::Null: return "null";
+        case JsonType::Bool: return "a boolean";
+        case JsonType::Number: return "a number";
+        case JsonType::String: return "a string";
+        case JsonType::Object: return "an object";
+        case JsonType::Array: return "an array";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+NodeRef::NodeRef(const detail::DocumentState* state, ryml::id_type entry)
+    : state_(state), entry_(entry), node_(state->resolve(entry)) {}
+
+JsonType NodeRef::type() const {
+    if (state_ == nullptr) {
+        throw ConversionError("Empty node: the member or item it was looked up by does not exist");
+    }
+    const ryml::Tree& tree = state_->tree;
+    if (tree.is_map(node_)) {
+        return JsonType::Object;
+    }
+    if (tree.is_seq(node_)) {
+        return JsonType::Array;
+    }
+    if (tree.is_val_ref(node_)) {
+        return JsonType::String;  // an alias of a key is emitted as that key
+    }
+    if (!tree.has_val(node_)) {
+        return JsonType::Null;
+    }
+    return state_->classify(node_).type;
+}
+
+void NodeRef::require(JsonType expected) const {
+    JsonType actual = type();
+    if (actual != expected) {
+        std::string_view name = key();
+        throw ConversionError((name.empty() ? std::string("Value") : "Member '" + std::string(name) + "'") + " is " +
+                              type_name(actual) + ", not " + type_name(expected));
+    }
+}
+
+std::string_view NodeRef::as_string() const {
+    require(JsonType::String);
+    return text();
+}
+
+bool NodeRef::as_bool() const {
+    require(JsonType::Bool);
+    return state_->classify(node_).value.boolean;
+}
+
+double NodeRef::as_double() const {
+    require(JsonType::Number);
+    ScalarValue value = state_->classify(node_).value;
+    if (value.type == ScalarType::Int) {
+        double magnitude = static_cast<double>(value.magnitude);
+        return value.negative ? -magnitude : magnitude;
+    }
+    return value.number;
+}
+
+int64_t NodeRef::as_int() const {
+    require(JsonType::Number);
+    ScalarValue value = state_->classify(node_).value;
+    constexpr auto max = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+    if (value.type != ScalarType::Int || value.magnitude > max + (value.negative ? 1 : 0)) {
+        throw ConversionError("Number '" + std::string(text()) + "' is not a 64-bit integer");
+    }
+    if (value.negative) {
+        // -2^63 has no positive counterpart: negate in unsigned arithmetic
+        return static_cast<int64_t>(0 - value.magnitude);
+    }
+    return static_cast<int64_t>(value.magnitude);
+}
+
+std::string_view NodeRef::text() const {
+    JsonType actual = type();
+    if (actual == JsonType::Object || actual == JsonType::Array) {
+        throw ConversionError(std::string("Value is ") + type_name(actual) + ", not a scalar");
+    }
+    if (!state_->tree.has_val(node_)) {
+        return {};
+    }
+    ryml::csubstr val = state_->aliases ? state_->emitter->value_text(node_) : state_->tree.val(node_);
+    return std::string_view(val.str, val.len);
+}
+
+std::string_view NodeRef::key() const {
+    return state_ != nullptr ? state_->key_of(entry_) : std::string_view();
+}
+
+const std::vector<ryml::id_type>* NodeRef::indexed_entries() const {
+    // Merge keys change which members an object has: those objects are always indexed
+    if (state_ != nullptr && state_->aliases && state_->tree.is_map(node_)) {
+        return &state_->index(node_).entries;
+    }
+    return nullptr;
+}
+
+NodeRef NodeRef::operator[](std::string_view name) const {
+    if (state_ == nullptr || !state_->tree.is_map(node_)) {
+        return NodeRef();
+    }
+    const ryml::Tree& tree = state_->tree;
+    if (!state_->aliases) {
+        // Short objects: a scan beats hashing
+        ryml::id_type found = ryml::NONE;
+        size_t members = 0;
+        for (ryml::id_type child = tree.first_child(node_); child != ryml::NONE && members <= kIndexedMembers;
+             child = tree.next_sibling(child), ++members) {
+            ryml::csubstr key = tree.key(child);
+            if (std::string_view(key.str, key.len) == name) {
+                found = child;
+            }
+        }
+        if (members <= kIndexedMembers) {
+            return found == ryml::NONE ? NodeRef() : NodeRef(state_, found);
+        }
+    }
+    const detail::DocumentState::MapIndex& index = state_->index(node_);
+    auto it = index.by_key.find(name);
+    return it == index.by_key.end() ? NodeRef() : NodeRef(state_, it->second);
+}
+
+NodeRef NodeRef::operator[](size_t position) const {
+    if (state_ == nullptr || !state_->tree.is_seq(node_)) {
+        return NodeRef();
+    }
+    const ryml::Tree& tree = state_->tree;
+    for (ryml::id_type child = tree.first_child(node_); child != ryml::NONE; child = tree.next_sibling(child)) {
+        if (position-- == 0) {
+            return NodeRef(state_, child);
+        }
+    }
+    return NodeRef();
+}
+
+NodeRef NodeRef::at(std::string_view name) const {
+    NodeRef member = (*this)[name];
+    if (!member) {
+        throw ConversionError("No member '" + std::string(name) + "'" +
+                              (state_ != nullptr && !state_->tree.is_map(node_) ? " (not an object)" : ""));
+    }
+    return member;
+}
+
+size_t NodeRef::size() const {
+    if (state_ == nullptr || !state_->tree.is_container(node_)) {
+        return 0;
+    }
+    if (const std::vector<ryml::id_type>* entries = indexed_entries()) {
+        return entries->size();
+    }
+    size_t count = 0;
+    for (ryml::id_type child = state_->tree.first_child(node_); child != ryml::NONE;
+         child = state_->tree.next_sibling(child)) {
+        ++count;
+    }
+    return count;
+}
+
+NodeRef::iterator NodeRef::begin() const {
+    iterator it;
+    it.state_ = state_;
+    if (state_ == nullptr || !state_->tree.is_container(node_)) {
+        return it;
+    }
+    it.entries_ = indexed_entries();
+    if (it.entries_ == nullptr) {
+        it.child_ = state_->tree.first_child(node_);
+    }
+    return it;
+}
+
+NodeRef::iterator NodeRef::end() const {
+    iterator it;
+    it.state_ = state_;
+    if (state_ != nullptr && state_->tree.is_container(node_)) {
+        it.entries_ = indexed_entries();
+        if (it.entries_ != nullptr) {
+            it.pos_ = it.entries_->size();
+        }
+    }
+    return it;
+}
+
+NodeRef::iterator& NodeRef::iterator::operator++() {
+    if (entries_ != nullptr) {
+        ++pos_;
+    } else {
+        child_ = state_->tree.next_sibling(child_);
+    }
+    return *this;
+}
+
+std::string NodeRef::json() const {
+    std::string out;
+    json(out);
+    return out;
+}
+
+void NodeRef::json(std::string& out) const {
+    type();  // throws on an empty handle
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->emitter->reset_budget();
+    state_->emitter->emit_node(entry_, out);
+}
+
+Document::Document(std::unique_ptr<detail::DocumentState> state) : state_(std::move(state)) {}
+
+Document::Document(Document&&) noexcept = default;
+Document& Document::operator=(Document&&) noexcept = default;
+Document::~Document() = default;
+
+Document Document::parse(std::string_view yaml, const ConversionOptions& options, const std::string& filename) {
+    auto state = std::make_unique<detail::DocumentState>();
+    state->options = options;
+    state->buffer.assign(yaml.data(), yaml.size());
+    state->tree = YamlToJsonConverter::parse_tree(state->buffer.data(), state->buffer.size(), filename, options);
+    state->init(state->buffer.data(), state->buffer.size(), filename);
+    return Document(std::move(state));
+}
+
+Document Document::load(const std::string& path, const ConversionOptions& options) {
+    auto state = std::make_unique<detail::DocumentState>();
+    state->options = options;
+    state->file = FileReader::read_file(path, options.limits.max_input_bytes);
+    state->tree = YamlToJsonConverter::parse_tree(state->file.data(), state->file.size(), path, options);
+    state->init(state->file.data(), state->file.size(), path);
+    return Document(std::move(state));
+}
+
+NodeRef Document::root() const {
+    return document(0);
+}
+
+size_t Document::document_count() const {
+    const ryml::Tree& tree = state_->tree;
+    if (tree.size() == 0) {
+        return 0;
+    }
+    ryml::id_type root = tree.root_id();
+    if (!tree.is_stream(root)) {
+        return 1;
+    }
+    size_t count = 0;
+    for (ryml::id_type doc = tree.first_child(root); doc != ryml::NONE; doc = tree.next_sibling(doc)) {
+        ++count;
+    }
+    return count;
+}
+
+NodeRef Document::document(size_t index) const {
+    const ryml::Tree& tree = state_->tree;
+    if (tree.size() == 0) {
+        return NodeRef();
+    }
+    ryml::id_type root = tree.root_id();
+    if (!tree.is_stream(root)) {
+        return index == 0 ? NodeRef(state_.get(), root) : NodeRef();
+    }
+    for (ryml::id_type doc = tree.first_child(root); doc != ryml::NONE; doc = tree.next_sibling(doc)) {
+        if (index-- == 0) {
+            return NodeRef(state_.get(), doc);
+        }
+    }
+    return NodeRef();
+}
+
+std::string Document::json() const {
+    std::string out;
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->emitter->reset_budget();
+    state_->emitter->emit(out);
+    return out;
+}
+
+const ryml::Tree& Document::tree() const {
+    return state_->tree;
+}
+
+} // namespace yaml2json
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ryml.hpp>
+#include "ConversionOptions.h"
+
+namespace yaml2json {
+
+// JSON type of a node, as the converter would emit it under the document's options
+enum class JsonType {
+    Null,
+    Bool,
+    Number,
+    String,
+    Object,
+    Array
+};
+
+namespace detail {
+struct DocumentState;
+}
+
+// Handle to a node of a Document: a pointer and two ids, cheap to copy, valid
+// as long as the document. Aliases are looked through and merge keys expanded
+// exactly as in the JSON output. Looking up a missing member or index gives an
+// empty handle (false in a condition) and lookups on an empty handle stay
+// empty, so paths chain: doc.root()["spec"]["template"]["replicas"].
+class NodeRef {
+public:
+    class iterator;
+
+    NodeRef() = default;
+
+    explicit operator bool() const { return state_ != nullptr; }
+
+    // Type of the value; ConversionError on an empty handle
+    JsonType type() const;
+
+    // Type tests; false on an empty handle
+    bool is_null() const { return is(JsonType::Null); }
+    bool is_bool() const { return is(JsonType::Bool); }
+    bool is_number() const { return is(JsonType::Number); }
+    bool is_string() const { return is(JsonType::String); }
+    bool is_object() const { return is(JsonType::Object); }
+    bool is_array() const { return is(JsonType::Array); }
+
+    // Scalar values; ConversionError if the node has another type. Strings
+    // are returned as parsed (YAML escapes resolved, not JSON-escaped) and
+    // point into the document
+    std::string_view as_string() const;
+    bool as_bool() const;
+    double as_double() const;
+
+    // Numbers that are integers within the int64_t range
+    int64_t as_int() const;
+
+    // Text of any scalar as parsed, e.g. "0x1F" for a number typed as 31
+    std::string_view text() const;
+
+    // Key of this node in its object; empty for array items and documents
+    std::string_view key() const;
+
+    // Object member by key (the last one if the key repeats, as JSON parsers
+    // read it). Objects of more than kIndexedMembers members, and objects
+    // with merge keys, get a hash index on their first lookup
+    NodeRef operator[](std::string_view key) const;
+    NodeRef operator[](const char* key) const { return (*this)[std::string_view(key)]; }
+
+    // Array item by position, walking the items before it
+    NodeRef operator[](size_t index) const;
+
+    // Member by key; ConversionError naming the key if it is missing
+    NodeRef at(std::string_view key) const;
+
+    // Members of an object or items of an array; 0 for scalars and empty handles
+    size_t size() const;
+
+    // Members or items in order, O(1) per step; empty for scalars
+    iterator begin() const;
+    iterator end() const;
+
+    // Compact JSON of the subtree (canonical, typed, ... per the document's options)
+    std::string json() const;
+    void json(std::string& out) const;
+
+    // Objects with more members are indexed for key lookups
+    static constexpr size_t kIndexedMembers = 16;
+
+private:
+    friend class Document;
+    friend class iterator;
+
+    NodeRef(const detail::DocumentState* state, ryml::id_type entry);
+
+    bool is(JsonType type) const { return state_ != nullptr && this->type() == type; }
+    const std::vector<ryml::id_type>* indexed_entries() const;
+    void require(JsonType type) const;
+
+    const detail::DocumentState* state_ = nullptr;
+    ryml::id_type entry_ = 0;  // node as it appears in its parent (holds the key)
+    ryml::id_type node_ = 0;   // node the value comes from, aliases resolved
+};
+
+// Forward iterator over the members of an object or the items of an array
+class NodeRef::iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = NodeRef;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const NodeRef*;
+    using reference = NodeRef;
+
+    iterator() = default;
+
+    NodeRef operator*() const { return NodeRef(state_, entries_ != nullptr ? (*entries_)[pos_] : child_); }
+    iterator& operator++();
+    iterator operator++(int) {
+        iterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    bool operator==(const iterator& other) const {
+        return entries_ != nullptr ? pos_ == other.pos_ : child_ == other.child_;
+    }
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+private:
+    friend class NodeRef;
+
+    const detail::DocumentState* state_ = nullptr;
+    ryml::id_type child_ = ryml::NONE;                      // sibling walk
+    const std::vector<ryml::id_type>* entries_ = nullptr;   // or the entries of an indexed object
+    size_t pos_ = 0;
+};
+
+// A parsed YAML document for reading a few fields without producing JSON:
+// typed access through NodeRef, JSON of any subtree on demand. The input is
+// parsed in place from a buffer the document owns; limits, duplicate keys and
+// the schema of the options are applied as by YamlToJsonConverter. Const
+// member functions (and NodeRefs) may be used from several threads at once.
+class Document {
+public:
+    // Parse a copy of the YAML; throws ConversionError (LimitExceededError)
+    static Document parse(std::string_view yaml, const ConversionOptions& options = ConversionOptions{},
+                          const std::string& filename = "");
+
+    // Parse a file (mapped, gzip/zstd decompressed); throws ConversionError
+    static Document load(const std::string& path, const ConversionOptions& options = ConversionOptions{});
+
+    Document(Document&&) noexcept;
+    Document& operator=(Document&&) noexcept;
+    ~Document();
+
+    // The first document of the stream; empty for an empty input
+    NodeRef root() const;
+
+    // Documents of a multi-document stream (1 for a single document)
+    size_t document_count() const;
+    NodeRef document(size_t index) const;
+
+    // Compact JSON of the whole stream, as YamlToJsonConverter::convert writes it
+    std::string json() const;
+
+    // The parsed tree, for code that works on ryml directly
+    const ryml::Tree& tree() const;
+
+private:
+    explicit Document(std::unique_ptr<detail::DocumentState> state);
+
+    std::unique_ptr<detail::DocumentState> state_;
+};
+
+} // namespace yaml2json
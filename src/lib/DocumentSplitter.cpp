@@ -0,0 +1,336 @@
+#include "DocumentSplitter.h"
+#include "ErrorHandler.h"
+#include "GatherWriter.h"
+#include "JsonEmitter.h"
+#include "JsonFormatter.h"
+#include "OutputFile.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include "YamlToJsonConverter.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace yaml2json {
+
+namespace {
+
+bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// "---" or "..." at the start of a line, followed by whitespace or the line end
+bool is_marker(const char* p, const char* end, const char* marker) {
+    return end - p >= 3 && std::memcmp(p, marker, 3) == 0 && (p + 3 == end || is_blank(p[3]));
+}
+
+// Anything but whitespace and a comment between p and end
+bool has_text(const char* p, const char* end) {
+    while (p < end && is_blank(*p)) {
+        ++p;
+    }
+    return p < end && *p != '#';
+}
+
+// Reduce a looked-up value to characters that are safe in any file name
+std::string sanitize(ryml::csubstr value) {
+    std::string out(value.str, value.len);
+    for (char& c : out) {
+        bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                    c == '.' || c == '_' || c == '-';
+        if (!safe) {
+            c = '_';
+        }
+    }
+    return out;
+}
+
+// Errors of a document parsed on its own count lines from its first line
+[[noreturn]] void rethrow_at_line(const ConversionError& e, size_t first_line) {
+    ErrorLocation loc = e.location();
+    if (loc.line == 0 || first_line <= 1) {
+        throw e;
+    }
+    loc.line += first_line - 1;
+    // Parser errors keep the parser's prefix; tree checks put the detail first
+    static const std::string kParserPrefix = "YAML parsing error";
+    std::string message = e.what();
+    if (message.compare(0, kParserPrefix.size(), kParserPrefix) == 0) {
+        message = format_error_with_location(kParserPrefix, loc.file, loc.line, loc.column) + ": " + e.detail();
+    } else {
+        message = format_error_with_location(e.detail(), loc.file, loc.line, loc.column);
+    }
+    throw ConversionError(message, std::move(loc), e.detail());
+}
+
+// The output directory. Each file is written to a temporary beside it and
+// renamed into place (OutputFile), and the files written so far are removed
+// again if the split fails
+class OutputDirectory {
+public:
+    explicit OutputDirectory(const std::string& path) : path_(path) {
+        std::error_code ec;
+        std::filesystem::create_directories(path, ec);
+        if (ec) {
+            throw ConversionError("Failed to create output directory '" + path + "': " + ec.message());
+        }
+    }
+
+    OutputDirectory(const OutputDirectory&) = delete;
+    OutputDirectory& operator=(const OutputDirectory&) = delete;
+
+    // Write one file with a single writev and move it into place
+    void write(const std::string& name, std::string&& content) {
+        TraceSpan span("write", name);
+        OutputFile file(path_ + "/" + name);
+        GatherWriter writer;
+        writer.buffer() = std::move(content);
+        writer.write_to(file.fd());
+        file.commit();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        written_.push_back(file.path());
+    }
+
+    // Remove every file write() completed
+    void remove_written() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const std::string& path : written_) {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+        written_.clear();
+    }
+
+private:
+    std::string path_;
+    std::mutex mutex_;
+    std::vector<std::string> written_;
+};
+
+} // namespace
+
+NameTemplate::NameTemplate(const std::string& pattern) {
+    if (pattern.find('/') != std::string::npos || pattern.find('\\') != std::string::npos) {
+        throw ConversionError("Name template '" + pattern + "' must not contain a path separator");
+    }
+    size_t pos = 0;
+    while (pos < pattern.size()) {
+        size_t open = pattern.find('{', pos);
+        if (open == std::string::npos) {
+            parts_.push_back(Part{pattern.substr(pos), {}, false});
+            break;
+        }
+        if (open > pos) {
+            parts_.push_back(Part{pattern.substr(pos, open - pos), {}, false});
+        }
+        size_t close = pattern.find('}', open);
+        if (close == std::string::npos || close == open + 1) {
+            throw ConversionError("Name template '" + pattern + "' has an unclosed or empty placeholder");
+        }
+
+        Part part;
+        part.is_placeholder = true;
+        std::string field = pattern.substr(open + 1, close - open - 1);
+        if (field != "index") {
+            size_t start = 0;
+            for (size_t dot = field.find('.'); ; dot = field.find('.', start)) {
+                std::string segment = field.substr(start, dot == std::string::npos ? std::string::npos : dot - start);
+                if (segment.empty()) {
+                    throw ConversionError("Name template '" + pattern + "' has an empty path segment in {" +
+                                          field + "}");
+                }
+                part.path.push_back(std::move(segment));
+                if (dot == std::string::npos) {
+                    break;
+                }
+                start = dot + 1;
+            }
+        }
+        parts_.push_back(std::move(part));
+        pos = close + 1;
+    }
+}
+
+std::string NameTemplate::render(size_t index, size_t index_width, const ryml::Tree& tree, ryml::id_type doc) const {
+    std::string name;
+    for (const Part& part : parts_) {
+        if (!part.is_placeholder) {
+            name += part.literal;
+            continue;
+        }
+        if (part.path.empty()) {
+            std::string digits = std::to_string(index);
+            if (digits.size() < index_width) {
+                name.append(index_width - digits.size(), '0');
+            }
+            name += digits;
+            continue;
+        }
+
+        // Only plain lookups: a path through an alias or to a container renders empty
+        ryml::id_type node = doc;
+        for (const std::string& segment : part.path) {
+            if (node == ryml::NONE || !tree.is_map(node)) {
+                node = ryml::NONE;
+                break;
+            }
+            node = tree.find_child(node, ryml::csubstr(segment.data(), segment.size()));
+        }
+        if (node != ryml::NONE && tree.has_val(node) && !tree.is_val_ref(node) && !tree.val_is_null(node)) {
+            name += sanitize(tree.val(node));
+        }
+    }
+    return name;
+}
+
+std::vector<DocumentSplitter::Document> DocumentSplitter::find_documents(const char* yaml_data, size_t yaml_size) {
+    std::vector<Document> documents;
+    Document current;
+    bool has_content = false;  // a line that is not a marker, directive, comment or blank
+    bool has_marker = false;   // the current document opened with "---"
+
+    auto close = [&](size_t end) {
+        if (has_content) {
+            current.end = end;
+            documents.push_back(current);
+        }
+    };
+
+    size_t line = 1;
+    size_t pos = 0;
+    // A byte order mark would hide a marker on the first line
+    if (yaml_size >= 3 && std::memcmp(yaml_data, "\xEF\xBB\xBF", 3) == 0) {
+        pos = 3;
+    }
+    for (; pos < yaml_size; ++line) {
+        const char* p = yaml_data + pos;
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', yaml_size - pos));
+        const char* line_end = nl != nullptr ? nl : yaml_data + yaml_size;
+        size_t next = nl != nullptr ? static_cast<size_t>(nl - yaml_data) + 1 : yaml_size;
+
+        if (is_marker(p, line_end, "---")) {
+            // Directives and comments since the last "..." stay with this document
+            if (has_content || has_marker) {
+                close(pos);
+                current = Document{pos, pos, line};
+                has_content = false;
+            }
+            has_marker = true;
+            has_content = has_text(p + 3, line_end);  // "--- value" or "--- |"
+        } else if (is_marker(p, line_end, "...")) {
+            close(next);
+            current = Document{next, next, line + 1};
+            has_content = false;
+            has_marker = false;
+        } else if (!has_content && has_text(p, line_end) && (*p != '%' || has_marker)) {
+            has_content = true;
+        }
+        pos = next;
+    }
+    close(yaml_size);
+    return documents;
+}
+
+size_t DocumentSplitter::split(char* yaml_data, size_t yaml_size, const std::string& filename,
+                               const ConversionOptions& options, const SplitOptions& split) {
+    setup_error_handlers();
+
+    NameTemplate names(split.name_template);
+    std::vector<Document> documents = find_documents(yaml_data, yaml_size);
+    OutputDirectory directory(split.directory);
+    size_t index_width = std::to_string(documents.empty() ? 0 : documents.size() - 1).size();
+
+    // Each document is small: it is converted serially, the documents in parallel
+    ConversionOptions document_options = options;
+    document_options.threads = 1;
+
+    std::mutex names_mutex;
+    std::unordered_map<std::string, size_t> taken;
+    std::vector<std::exception_ptr> errors(documents.size());
+    std::atomic<bool> failed{false};
+
+    auto convert_one = [&](size_t i) {
+        if (failed.load(std::memory_order_relaxed)) {
+            return;
+        }
+        const Document& document = documents[i];
+        TraceSpan span("document", filename, document.line);
+        try {
+            ryml::Tree tree;
+            try {
+                tree = YamlToJsonConverter::parse_tree(yaml_data + document.begin, document.end - document.begin,
+                                                       filename, document_options);
+            } catch (const LimitExceededError&) {
+                throw;
+            } catch (const ConversionError& e) {
+                rethrow_at_line(e, document.line);
+            }
+
+            ryml::id_type root = tree.root_id();
+            if (tree.is_stream(root)) {
+                root = tree.first_child(root);
+            }
+            std::string name = names.render(i, index_width, tree, root);
+            if (name.empty() || name == "." || name == "..") {
+                throw ConversionError("Document at line " + std::to_string(document.line) +
+                                      " has no usable file name ('" + name + "')");
+            }
+            {
+                std::lock_guard<std::mutex> lock(names_mutex);
+                auto inserted = taken.emplace(name, i);
+                if (!inserted.second) {
+                    size_t other = inserted.first->second;
+                    throw ConversionError("Documents at lines " +
+                                          std::to_string(documents[std::min(i, other)].line) + " and " +
+                                          std::to_string(documents[std::max(i, other)].line) +
+                                          " would both be written to '" + name + "'");
+                }
+            }
+
+            std::string output;
+            if (options.format == OutputFormat::Json && tree.is_stream(tree.root_id())) {
+                // ryml's JSON emitter has no documents; ours writes the single one as is
+                JsonEmitter emitter(tree, document_options);
+                emitter.emit(output);
+            } else {
+                output = YamlToJsonConverter::emit(tree, document_options);
+            }
+            if (split.pretty && options.format == OutputFormat::Json) {
+                output = JsonFormatter::pretty_print(output);
+            }
+            directory.write(name, std::move(output));
+        } catch (...) {
+            errors[i] = std::current_exception();
+            failed.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    // The calling thread converts documents too
+    size_t threads = options.threads == 0 ? ThreadPool::default_threads() : options.threads;
+    size_t workers = std::min(threads, documents.size());
+    if (workers <= 1) {
+        for (size_t i = 0; i < documents.size(); ++i) {
+            convert_one(i);
+        }
+    } else {
+        ThreadPool pool(workers - 1);
+        pool.parallel_for(documents.size(), convert_one);
+    }
+
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            directory.remove_written();
+            std::rethrow_exception(error);
+        }
+    }
+    return documents.size();
+}
+
+} // namespace yaml2json
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <ryml.hpp>
+#include "ConversionOptions.h"
+
+namespace yaml2json {
+
+// File name pattern for split documents: literal text with {index} (the
+// document's position among the written documents, zero-padded so names sort
+// in stream order) and {dotted.path} placeholders that look up scalars in the
+// document's root mapping. Looked-up values are reduced to [A-Za-z0-9._-];
+// a missing value renders as nothing.
+class NameTemplate {
+public:
+    static constexpr const char* kDefault = "{index}-{kind}-{metadata.name}.json";
+
+    // Throws ConversionError on an unclosed or empty placeholder or a '/'
+    explicit NameTemplate(const std::string& pattern = kDefault);
+
+    // Name of document `doc` of `tree`; index_width is the zero-padded width of {index}
+    std::string render(size_t index, size_t index_width, const ryml::Tree& tree, ryml::id_type doc) const;
+
+private:
+    struct Part {
+        std::string literal;
+        std::vector<std::string> path;  // empty for {index}
+        bool is_placeholder = false;
+    };
+
+    std::vector<Part> parts_;
+};
+
+// Settings for writing one file per document
+struct SplitOptions {
+    std::string directory;  // created if it does not exist
+    std::string name_template = NameTemplate::kDefault;
+    bool pretty = false;    // indent JSON output
+};
+
+// Splits a YAML stream at its document markers and converts the documents
+// concurrently, each into its own file. Document boundaries are found with a
+// line scan (a "---" or "..." at column 0 can only be a marker), so every
+// document is parsed in place on its own; nothing parses the whole stream.
+class DocumentSplitter {
+public:
+    // One document of the stream
+    struct Document {
+        size_t begin = 0;  // byte range in the source, including its "---" line
+        size_t end = 0;
+        size_t line = 1;   // 1-based source line of `begin`
+    };
+
+    // Documents with content, in stream order; empty documents (only markers,
+    // directives, comments or blank lines) are left out
+    static std::vector<Document> find_documents(const char* yaml_data, size_t yaml_size);
+
+    // Convert every document of the stream (parsed in place, so the buffer is
+    // modified) into split.directory on options.threads threads (0 = all cores)
+    // and return the number of files written. Errors report source lines; the
+    // first failing document in stream order is rethrown once all work stopped,
+    // after the files already written have been removed
+    static size_t split(char* yaml_data, size_t yaml_size, const std::string& filename,
+                        const ConversionOptions& options, const SplitOptions& split);
+};
+
+} // namespace yaml2json
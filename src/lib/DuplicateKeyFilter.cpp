@@ -0,0 +1,183 @@
+#include "DuplicateKeyFilter.h"
+#include "ErrorHandler.h"
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace yaml2json {
+
+namespace {
+
+std::string_view view(ryml::csubstr s) {
+    return std::string_view(s.str, s.len);
+}
+
+// One pass over the tree; the scratch vectors are reused across maps
+class Filter {
+public:
+    Filter(ryml::Tree& tree, DuplicateKeys policy, const char* source, size_t source_size,
+           const std::string& filename)
+        : tree_(tree), policy_(policy), source_(source), source_size_(source_size), filename_(filename) {}
+
+    size_t run() {
+        // Explicit stack: documents can nest deeper than is safe to recurse
+        std::vector<ryml::id_type> pending{tree_.root_id()};
+        while (!pending.empty()) {
+            ryml::id_type node = pending.back();
+            pending.pop_back();
+            if (tree_.is_map(node)) {
+                filter_map(node);
+            }
+            for (ryml::id_type child = tree_.first_child(node); child != ryml::NONE;
+                 child = tree_.next_sibling(child)) {
+                if (tree_.is_container(child)) {
+                    pending.push_back(child);
+                }
+            }
+        }
+        return removed_;
+    }
+
+private:
+    struct Entry {
+        std::string_view key;
+        ryml::id_type node;
+    };
+
+    // Alias keys are only known once resolved and merge keys may legitimately
+    // repeat, so neither takes part
+    bool is_candidate(ryml::id_type child) const {
+        if (!tree_.has_key(child) || tree_.is_key_ref(child)) {
+            return false;
+        }
+        return tree_.is_key_quoted(child) || tree_.key(child) != "<<";
+    }
+
+    void filter_map(ryml::id_type map) {
+        doomed_.clear();
+        if (tree_.num_children(map) <= DuplicateKeyFilter::kLinearScanKeys) {
+            small_.clear();
+            for (ryml::id_type child = tree_.first_child(map); child != ryml::NONE;
+                 child = tree_.next_sibling(child)) {
+                if (!is_candidate(child)) {
+                    continue;
+                }
+                std::string_view key = view(tree_.key(child));
+                auto it = std::find_if(small_.begin(), small_.end(),
+                                       [key](const Entry& e) { return e.key == key; });
+                if (it == small_.end()) {
+                    small_.push_back(Entry{key, child});
+                } else {
+                    it->node = resolve(it->node, child);
+                }
+            }
+        } else {
+            // A fresh table sized for this map: clearing a reused one would cost
+            // its largest bucket count for every map
+            std::unordered_map<std::string_view, ryml::id_type> index;
+            index.reserve(tree_.num_children(map));
+            for (ryml::id_type child = tree_.first_child(map); child != ryml::NONE;
+                 child = tree_.next_sibling(child)) {
+                if (!is_candidate(child)) {
+                    continue;
+                }
+                auto inserted = index.emplace(view(tree_.key(child)), child);
+                if (!inserted.second) {
+                    inserted.first->second = resolve(inserted.first->second, child);
+                }
+            }
+        }
+
+        for (ryml::id_type node : doomed_) {
+            check_no_anchor(node);
+            tree_.remove(node);
+        }
+        removed_ += doomed_.size();
+    }
+
+    // Decide between two entries with the same key; returns the one that stays
+    ryml::id_type resolve(ryml::id_type first, ryml::id_type second) {
+        switch (policy_) {
+            case DuplicateKeys::FirstWins:
+                doomed_.push_back(second);
+                return first;
+            case DuplicateKeys::LastWins:
+                doomed_.push_back(first);
+                return second;
+            case DuplicateKeys::Error:
+            case DuplicateKeys::Keep:
+                break;
+        }
+        throw_duplicate(first, second);
+    }
+
+    [[noreturn]] void throw_duplicate(ryml::id_type first, ryml::id_type second) const {
+        ryml::csubstr key = tree_.key(second);
+        ErrorLocation previous = locate(key_start(first));
+        std::string detail = "Duplicate key '" + std::string(key.str, key.len) + "'";
+        if (previous.line > 0) {
+            detail += " (first defined on line " + std::to_string(previous.line) + ")";
+        }
+        ErrorLocation loc = locate(key_start(second));
+        throw ConversionError(format_error_with_location(detail, loc.file, loc.line, loc.column),
+                              std::move(loc), detail);
+    }
+
+    // A dropped entry must not take an anchor with it: later aliases would dangle
+    void check_no_anchor(ryml::id_type node) const {
+        std::vector<ryml::id_type> pending{node};
+        while (!pending.empty()) {
+            ryml::id_type id = pending.back();
+            pending.pop_back();
+            if (tree_.has_key_anchor(id) || tree_.has_val_anchor(id)) {
+                ryml::csubstr key = tree_.key(node);
+                std::string detail = "Duplicate key '" + std::string(key.str, key.len) +
+                                     "' cannot be dropped: it defines an anchor";
+                ErrorLocation loc = locate(key_start(node));
+                throw ConversionError(format_error_with_location(detail, loc.file, loc.line, loc.column),
+                                      std::move(loc), detail);
+            }
+            for (ryml::id_type child = tree_.first_child(id); child != ryml::NONE;
+                 child = tree_.next_sibling(child)) {
+                pending.push_back(child);
+            }
+        }
+    }
+
+    // Point at the opening quote of quoted keys
+    const char* key_start(ryml::id_type node) const {
+        const char* where = tree_.key(node).str;
+        if (source_ != nullptr && where > source_ && where <= source_ + source_size_ &&
+            tree_.is_key_quoted(node) && (where[-1] == '"' || where[-1] == '\'')) {
+            --where;
+        }
+        return where;
+    }
+
+    ErrorLocation locate(const char* where) const {
+        return locate_in_source(source_, source_size_, where, filename_);
+    }
+
+    ryml::Tree& tree_;
+    DuplicateKeys policy_;
+    const char* source_;
+    size_t source_size_;
+    const std::string& filename_;
+
+    std::vector<Entry> small_;
+    std::vector<ryml::id_type> doomed_;
+    size_t removed_ = 0;
+};
+
+} // namespace
+
+size_t DuplicateKeyFilter::apply(ryml::Tree& tree, DuplicateKeys policy, const char* source,
+                                 size_t source_size, const std::string& filename) {
+    if (policy == DuplicateKeys::Keep || tree.size() == 0) {
+        return 0;
+    }
+    return Filter(tree, policy, source, source_size, filename).run();
+}
+
+} // namespace yaml2json
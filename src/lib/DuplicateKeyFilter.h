@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <ryml.hpp>
+#include "ConversionOptions.h"
+
+namespace yaml2json {
+
+// Tree pass finding keys that occur more than once in one mapping. Each map
+// is checked in O(n): small maps by linear scan, larger ones with a hash set.
+class DuplicateKeyFilter {
+public:
+    // Maps with at most this many keys are scanned linearly instead of hashed
+    static constexpr size_t kLinearScanKeys = 8;
+
+    // Apply the policy to every mapping of the tree: throw ConversionError on
+    // the first duplicate (Error) or remove the losing entries from the tree
+    // (LastWins, FirstWins). `source` is the buffer the tree was parsed in place
+    // from, used to locate errors (may be null). Returns the entries removed.
+    static size_t apply(ryml::Tree& tree, DuplicateKeys policy,
+                        const char* source = nullptr, size_t source_size = 0,
+                        const std::string& filename = "");
+};
+
+} // namespace yaml2json
@@ -1,10 +1,15 @@
 #include "ErrorHandler.h"
+#include "SimdKernels.h"
+#include <mutex>
 #include <sstream>
 
 namespace yaml2json {
 
 void ryml_error_handler(const char* msg, size_t msg_len, ryml::Location loc, void* /*user_data*/) {
-    std::string error_msg = "YAML parsing error";
+    // Sized once instead of regrown by the appends below
+    std::string error_msg;
+    error_msg.reserve(64 + loc.name.len + msg_len);
+    error_msg += "YAML parsing error";
     if (loc.name.not_empty()) {
         error_msg += " in file '";
         error_msg.append(loc.name.str, loc.name.len);
@@ -16,12 +21,21 @@ void ryml_error_handler(const char* msg, size_t msg_len, ryml::Location loc, voi
     error_msg += std::to_string(loc.col);
     error_msg += ": ";
     error_msg.append(msg, msg_len);
+
+    ErrorLocation location;
+    location.file.assign(loc.name.str, loc.name.len);
+    location.line = loc.line;
+    location.column = loc.col;
     
-    throw ConversionError(error_msg);
+    throw ConversionError(error_msg, std::move(location), std::string(msg, msg_len));
 }
 
 void setup_error_handlers() {
-    ryml::set_callbacks(ryml::Callbacks(nullptr, nullptr, nullptr, ryml_error_handler));
+    // ryml's callbacks are global: install them once so concurrent conversions don't race
+    static std::once_flag installed;
+    std::call_once(installed, [] {
+        ryml::set_callbacks(ryml::Callbacks(nullptr, nullptr, nullptr, ryml_error_handler));
+    });
 }
 
 std::string format_error_with_location(const std::string& base_message, 
@@ -42,4 +56,32 @@ std::string format_error_with_location(const std::string& base_message,
     return oss.str();
 }
 
-} // namespace yaml2json
\ No newline at end of file
+std::string format_machine_error(const ConversionError& error, const std::string& filename) {
+    const ErrorLocation& loc = error.location();
+    std::string out = loc.file.empty() ? filename : loc.file;
+    out += ':';
+    out += std::to_string(loc.line);
+    out += ':';
+    out += std::to_string(loc.column);
+    out += ": ";
+    out += error.detail();
+    return out;
+}
+
+ErrorLocation locate_in_source(const char* source, size_t source_size, const char* where,
+                               const std::string& filename) {
+    ErrorLocation loc;
+    loc.file = filename;
+    if (source == nullptr || where < source || where > source + source_size) {
+        return loc;
+    }
+    loc.line = 1 + SimdKernels::count_newlines(source, static_cast<size_t>(where - source));
+    const char* line_start = where;
+    while (line_start > source && line_start[-1] != '\n') {
+        --line_start;
+    }
+    loc.column = static_cast<size_t>(where - line_start) + 1;
+    return loc;
+}
+
+} // namespace yaml2json
@@ -2,21 +2,47 @@
 
 #include <string>
 #include <stdexcept>
+#include <utility>
 #include <ryml.hpp>
 
 namespace yaml2json {
 
+// Position of an error in its source (line and column are 1-based, 0 = unknown)
+struct ErrorLocation {
+    std::string file;
+    size_t line = 0;
+    size_t column = 0;
+};
+
 // Custom exception for YAML to JSON conversion errors
 class ConversionError : public std::runtime_error {
 public:
     explicit ConversionError(const std::string& message) 
-        : std::runtime_error(message) {}
+        : std::runtime_error(message), detail_(message) {}
+
+    // what() carries the full message; detail is the message without the location
+    ConversionError(const std::string& message, ErrorLocation location, std::string detail)
+        : std::runtime_error(message), location_(std::move(location)), detail_(std::move(detail)) {}
+
+    const ErrorLocation& location() const { return location_; }
+    const std::string& detail() const { return detail_; }
+
+private:
+    ErrorLocation location_;
+    std::string detail_;
+};
+
+// Raised when a conversion exceeds one of its ConversionLimits
+class LimitExceededError : public ConversionError {
+public:
+    explicit LimitExceededError(const std::string& message)
+        : ConversionError(message) {}
 };
 
 // Error handler for rapidyaml callbacks
 void ryml_error_handler(const char* msg, size_t msg_len, ryml::Location loc, void* user_data);
 
-// Set up error handlers for rapidyaml
+// Set up error handlers for rapidyaml (thread-safe, installs them once)
 void setup_error_handlers();
 
 // Format error message with location information
@@ -25,4 +51,12 @@ std::string format_error_with_location(const std::string& base_message,
                                        size_t line, 
                                        size_t column);
 
+// Format an error as "file:line:col: message" for tools and editors; the error's
+// own location wins over the fallback filename, unknown positions print as 0
+std::string format_machine_error(const ConversionError& error, const std::string& filename);
+
+// Locate a pointer into a source buffer (1-based line and column)
+ErrorLocation locate_in_source(const char* source, size_t source_size, const char* where,
+                               const std::string& filename);
+
 } // namespace yaml2json
\ No newline at end of file
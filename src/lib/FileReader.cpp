@@ -1,9 +1,13 @@
 #include "FileReader.h"
+#include "Compression.h"
 #include "ErrorHandler.h"
+#include "Trace.h"
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <cerrno>
 #include <cstring>
+#include <utility>
 
 #ifdef _WIN32
     // Windows doesn't support mmap easily, so we'll use regular file I/O
@@ -16,7 +20,47 @@
 
 namespace yaml2json {
 
+namespace {
+
+// Read granularity for streamed (non-mappable) input
+constexpr size_t kStreamChunkSize = 256 * 1024;
+
+[[noreturn]] void throw_input_too_large(const std::string& source_name, size_t max_bytes) {
+    throw LimitExceededError("Input '" + source_name + "' exceeds the input size limit of " +
+                             std::to_string(max_bytes) + " bytes");
+}
+
+} // namespace
+
+FileContent::FileContent(FileContent&& other) noexcept {
+    *this = std::move(other);
+}
+
+FileContent& FileContent::operator=(FileContent&& other) noexcept {
+    if (this != &other) {
+        release();
+        bool owned = other.data_ptr_ != nullptr && other.data_ptr_ == other.owned_data_.data();
+        owned_data_ = std::move(other.owned_data_);
+        data_ptr_ = owned ? owned_data_.data() : other.data_ptr_;
+        size_ = other.size_;
+        is_mmap_ = other.is_mmap_;
+        was_decompressed_ = other.was_decompressed_;
+        fd_ = other.fd_;
+
+        other.data_ptr_ = nullptr;
+        other.size_ = 0;
+        other.is_mmap_ = false;
+        other.was_decompressed_ = false;
+        other.fd_ = -1;
+    }
+    return *this;
+}
+
 FileContent::~FileContent() {
+    release();
+}
+
+void FileContent::release() {
 #ifndef _WIN32
     if (is_mmap_ && data_ptr_) {
         ::munmap(data_ptr_, size_);
@@ -25,6 +69,18 @@ FileContent::~FileContent() {
         ::close(fd_);
     }
 #endif
+    data_ptr_ = nullptr;
+    size_ = 0;
+    is_mmap_ = false;
+    fd_ = -1;
+    owned_data_.clear();
+}
+
+void FileContent::adopt(std::string&& buffer) {
+    release();
+    owned_data_ = std::move(buffer);
+    data_ptr_ = owned_data_.data();
+    size_ = owned_data_.size();
 }
 
 void FileReader::validate_file(const std::string& filepath) {
@@ -37,7 +93,106 @@ void FileReader::validate_file(const std::string& filepath) {
     }
 }
 
-FileContent FileReader::read_file(const std::string& filepath) {
+void FileReader::decompress_content(FileContent& content, const std::string& source_name, size_t max_bytes) {
+    CompressionFormat format = Compression::detect(content.data(), content.size());
+    if (format == CompressionFormat::None) {
+        return;
+    }
+    if (!Compression::is_supported(format)) {
+        throw ConversionError("Input '" + source_name + "' is " + Compression::name(format) +
+                              "-compressed but yaml2json was built without " +
+                              Compression::name(format) + " support");
+    }
+    TraceSpan span("decompress", source_name);
+
+#ifndef _WIN32
+    if (content.is_mmap_) {
+        ::madvise(content.data_ptr_, content.size_, MADV_SEQUENTIAL);
+    }
+#endif
+
+    std::string decoded;
+    try {
+        decoded = Compression::decompress(content.data(), content.size(), format, max_bytes);
+    } catch (const LimitExceededError&) {
+        throw_input_too_large(source_name, max_bytes);
+    } catch (const ConversionError& e) {
+        throw ConversionError("Failed to decompress input '" + source_name + "': " + e.what());
+    }
+    if (decoded.empty()) {
+        throw ConversionError("Input '" + source_name + "' is empty after decompression");
+    }
+
+    content.adopt(std::move(decoded));
+    content.was_decompressed_ = true;
+}
+
+FileContent FileReader::read_stream(std::FILE* stream, const std::string& source_name, size_t max_bytes) {
+    TraceSpan span("read", source_name);
+    FileContent content;
+    std::string buffer;
+    std::unique_ptr<Decompressor> decoder;
+    size_t used = 0;
+    bool first_chunk = true;
+
+    for (;;) {
+        if (buffer.size() - used < kStreamChunkSize) {
+            buffer.resize(std::max(buffer.size() * 2, used + kStreamChunkSize));
+        }
+        size_t n = std::fread(&buffer[used], 1, kStreamChunkSize, stream);
+        if (n == 0) {
+            break;
+        }
+
+        if (first_chunk) {
+            first_chunk = false;
+            CompressionFormat format = Compression::detect(&buffer[used], n);
+            if (format != CompressionFormat::None) {
+                decoder = std::make_unique<Decompressor>(format);
+                decoder->set_output_limit(max_bytes);
+            }
+        }
+
+        if (decoder) {
+            // Decode chunk by chunk; the compressed stream is never held in full
+            try {
+                decoder->feed(&buffer[used], n);
+            } catch (const LimitExceededError&) {
+                throw_input_too_large(source_name, max_bytes);
+            }
+        } else {
+            used += n;
+            if (max_bytes > 0 && used > max_bytes) {
+                throw_input_too_large(source_name, max_bytes);
+            }
+        }
+    }
+
+    if (std::ferror(stream)) {
+        throw ConversionError("Failed to read " + source_name + ": " + std::strerror(errno));
+    }
+
+    if (decoder) {
+        try {
+            buffer = decoder->finish();
+        } catch (const ConversionError& e) {
+            throw ConversionError("Failed to decompress input '" + source_name + "': " + e.what());
+        }
+    } else {
+        buffer.resize(used);
+    }
+
+    if (buffer.empty()) {
+        throw ConversionError("No input provided via " + source_name);
+    }
+
+    content.adopt(std::move(buffer));
+    content.was_decompressed_ = decoder != nullptr;
+    return content;
+}
+
+FileContent FileReader::read_file(const std::string& filepath, size_t max_bytes) {
+    TraceSpan span("read", filepath);
     validate_file(filepath);
     
     FileContent content;
@@ -50,18 +205,22 @@ FileContent FileReader::read_file(const std::string& filepath) {
     }
     
     file.seekg(0, std::ios::end);
-    content.size_ = static_cast<size_t>(file.tellg());
+    size_t file_size = static_cast<size_t>(file.tellg());
     file.seekg(0, std::ios::beg);
     
-    if (content.size_ == 0) {
+    if (file_size == 0) {
         throw ConversionError("Input file '" + filepath + "' is empty");
     }
+    if (max_bytes > 0 && file_size > max_bytes) {
+        throw_input_too_large(filepath, max_bytes);
+    }
     
-    content.owned_data_ = std::make_unique<char[]>(content.size_);
-    if (!file.read(content.owned_data_.get(), content.size_)) {
+    content.owned_data_.resize(file_size);
+    if (!file.read(&content.owned_data_[0], file_size)) {
         throw ConversionError("Failed to read input file '" + filepath + "': " + std::strerror(errno));
     }
-    content.data_ptr_ = content.owned_data_.get();
+    content.data_ptr_ = content.owned_data_.data();
+    content.size_ = file_size;
 #else
     // Unix: try mmap first, fallback to regular I/O
     content.fd_ = ::open(filepath.c_str(), O_RDONLY);
@@ -82,6 +241,13 @@ FileContent FileReader::read_file(const std::string& filepath) {
         throw ConversionError("Input file '" + filepath + "' is empty");
     }
     
+    // Checked before mapping so oversized input never touches memory
+    if (max_bytes > 0 && static_cast<size_t>(st.st_size) > max_bytes) {
+        ::close(content.fd_);
+        content.fd_ = -1;
+        throw_input_too_large(filepath, max_bytes);
+    }
+    
     content.size_ = static_cast<size_t>(st.st_size);
     void *addr = ::mmap(nullptr, content.size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, content.fd_, 0);
     if (addr != MAP_FAILED) {
@@ -96,17 +262,19 @@ FileContent FileReader::read_file(const std::string& filepath) {
             throw ConversionError("Failed to open input file '" + filepath + "': " + std::strerror(errno));
         }
         
-        content.owned_data_ = std::make_unique<char[]>(content.size_);
-        if (!file.read(content.owned_data_.get(), content.size_)) {
+        content.owned_data_.resize(content.size_);
+        if (!file.read(&content.owned_data_[0], content.size_)) {
             ::close(content.fd_);
             content.fd_ = -1;
             throw ConversionError("Failed to read input file '" + filepath + "': " + std::strerror(errno));
         }
-        content.data_ptr_ = content.owned_data_.get();
+        content.data_ptr_ = content.owned_data_.data();
     }
 #endif
+
+    decompress_content(content, filepath, max_bytes);
     
     return content;
 }
 
-} // namespace yaml2json
\ No newline at end of file
+} // namespace yaml2json
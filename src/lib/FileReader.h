@@ -3,6 +3,7 @@
 #include <string>
 #include <memory>
 #include <cstddef>
+#include <cstdio>
 
 namespace yaml2json {
 
@@ -12,8 +13,8 @@ public:
     FileContent() = default;
     FileContent(const FileContent&) = delete;
     FileContent& operator=(const FileContent&) = delete;
-    FileContent(FileContent&&) = default;
-    FileContent& operator=(FileContent&&) = default;
+    FileContent(FileContent&& other) noexcept;
+    FileContent& operator=(FileContent&& other) noexcept;
     ~FileContent();
 
     // Get pointer to data
@@ -26,24 +27,41 @@ public:
     // Check if content is valid
     bool is_valid() const { return data_ptr_ != nullptr && size_ > 0; }
 
+    // Check if the content was decompressed from a gzip/zstd source
+    bool was_decompressed() const { return was_decompressed_; }
+
 private:
     friend class FileReader;
+
+    void release();
+    void adopt(std::string&& buffer);
     
     char* data_ptr_ = nullptr;
     size_t size_ = 0;
     bool is_mmap_ = false;
+    bool was_decompressed_ = false;
     int fd_ = -1;
-    std::unique_ptr<char[]> owned_data_;
+    std::string owned_data_;
 };
 
 // File reader with memory mapping support
 class FileReader {
 public:
-    // Read file content (uses mmap on Unix, regular I/O on Windows)
-    static FileContent read_file(const std::string& filepath);
+    // Read file content (uses mmap on Unix, regular I/O on Windows);
+    // gzip/zstd input is detected by magic bytes and decompressed transparently.
+    // Input larger than max_bytes (0 = unlimited), before or after decompression,
+    // raises LimitExceededError without being mapped or inflated in full
+    static FileContent read_file(const std::string& filepath, size_t max_bytes = 0);
+
+    // Read a whole stream (e.g. stdin), decompressing it on the fly if needed
+    static FileContent read_stream(std::FILE* stream, const std::string& source_name, size_t max_bytes = 0);
     
     // Check if file exists and is readable
     static void validate_file(const std::string& filepath);
+
+private:
+    // Replace compressed content with its decompressed form
+    static void decompress_content(FileContent& content, const std::string& source_name, size_t max_bytes);
 };
 
-} // namespace yaml2json
\ No newline at end of file
+} // namespace yaml2json
@@ -0,0 +1,116 @@
+#include "GatherWriter.h"
+#include "ErrorHandler.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
+
+namespace yaml2json {
+
+namespace {
+
+// Entries per writev call (IOV_MAX is 1024 on Linux and macOS)
+constexpr size_t kMaxIov = 1024;
+
+[[noreturn]] void throw_write_error() {
+    throw ConversionError(std::string("Failed to write output: ") + std::strerror(errno));
+}
+
+#ifndef _WIN32
+// Write every entry of iov, resuming after partial writes
+void write_all(int fd, std::vector<iovec>& iov) {
+    size_t first = 0;
+    while (first < iov.size()) {
+        int count = static_cast<int>(std::min(iov.size() - first, kMaxIov));
+        ssize_t written = ::writev(fd, iov.data() + first, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_write_error();
+        }
+        auto left = static_cast<size_t>(written);
+        while (first < iov.size() && left >= iov[first].iov_len) {
+            left -= iov[first].iov_len;
+            ++first;
+        }
+        if (left > 0) {
+            iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+            iov[first].iov_len -= left;
+        }
+    }
+    iov.clear();
+}
+#endif
+
+} // namespace
+
+void GatherWriter::reference(const char* data, size_t size) {
+    if (size < kMinReferenceBytes) {
+        buffer_.append(data, size);
+        return;
+    }
+    references_.push_back(Reference{buffer_.size(), data, size});
+    referenced_bytes_ += size;
+}
+
+template <class Fn>
+void GatherWriter::for_each_segment(Fn&& fn) const {
+    size_t pos = 0;
+    for (const Reference& ref : references_) {
+        if (ref.buffer_pos > pos) {
+            fn(buffer_.data() + pos, ref.buffer_pos - pos);
+            pos = ref.buffer_pos;
+        }
+        fn(ref.data, ref.size);
+    }
+    if (buffer_.size() > pos) {
+        fn(buffer_.data() + pos, buffer_.size() - pos);
+    }
+}
+
+void GatherWriter::write_to(int fd) const {
+#ifdef _WIN32
+    for_each_segment([fd](const char* data, size_t size) {
+        while (size > 0) {
+            int written = ::_write(fd, data, static_cast<unsigned>(std::min<size_t>(size, 1u << 30)));
+            if (written < 0) {
+                throw_write_error();
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    });
+#else
+    std::vector<iovec> iov;
+    iov.reserve(std::min(kMaxIov, 2 * references_.size() + 1));
+    for_each_segment([&](const char* data, size_t size) {
+        iov.push_back(iovec{const_cast<char*>(data), size});
+        if (iov.size() == kMaxIov) {
+            write_all(fd, iov);
+        }
+    });
+    write_all(fd, iov);
+#endif
+}
+
+std::string GatherWriter::str() const {
+    std::string out;
+    out.reserve(size());
+    for_each_segment([&out](const char* data, size_t size) { out.append(data, size); });
+    return out;
+}
+
+void GatherWriter::clear() {
+    buffer_.clear();
+    references_.clear();
+    referenced_bytes_ = 0;
+}
+
+} // namespace yaml2json
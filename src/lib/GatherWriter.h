@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace yaml2json {
+
+// Output assembled from bytes written into a small buffer (structure, escaped
+// strings) and references to bytes that already exist elsewhere, such as
+// scalars in the parsed input. write_to() hands both to writev, so referenced
+// bytes are never copied in user space. Referenced memory must stay valid
+// until the output has been written.
+class GatherWriter {
+public:
+    // Shorter references are copied: an iovec entry costs about as much
+    static constexpr size_t kMinReferenceBytes = 64;
+
+    // Buffer for bytes written directly; references are placed at its current end
+    std::string& buffer() { return buffer_; }
+
+    // Output `size` bytes at `data` at this point without copying them
+    void reference(const char* data, size_t size);
+
+    // Total output size so far
+    size_t size() const { return buffer_.size() + referenced_bytes_; }
+
+    // Bytes copied into the buffer vs bytes left in place
+    size_t copied_bytes() const { return buffer_.size(); }
+    size_t referenced_bytes() const { return referenced_bytes_; }
+
+    // Write the output to a file descriptor (writev in IOV_MAX batches,
+    // retrying partial writes); throws ConversionError on I/O errors
+    void write_to(int fd) const;
+
+    // Flatten the output into one string
+    std::string str() const;
+
+    void clear();
+
+private:
+    struct Reference {
+        size_t buffer_pos;  // buffer bytes before this reference
+        const char* data;
+        size_t size;
+    };
+
+    // Visit the output as (data, size) segments in order
+    template <class Fn>
+    void for_each_segment(Fn&& fn) const;
+
+    std::string buffer_;
+    std::vector<Reference> references_;
+    size_t referenced_bytes_ = 0;
+};
+
+} // namespace yaml2json
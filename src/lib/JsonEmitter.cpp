@@ -0,0 +1,649 @@
+#include "JsonEmitter.h"
+#include "ErrorHandler.h"
+#include "GatherWriter.h"
+#include "OutputSink.h"
+#include "ScalarClassifier.h"
+#include "SimdKernels.h"
+#include "StringInterner.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <unordered_set>
+
+namespace yaml2json {
+
+namespace {
+
+// Expansion budget floor, so small files with a few legitimate aliases never trip the ratio
+constexpr size_t kMinNodeBudget = 100000;
+
+// The clock is read once per this many emitted values (power of two)
+constexpr size_t kDeadlineCheckInterval = 4096;
+
+std::string_view view(ryml::csubstr s) {
+    return std::string_view(s.str, s.len);
+}
+
+// Anchor and alias names are stored without their '&'/'*' sigil; strip it defensively
+ryml::csubstr strip_sigil(ryml::csubstr name, char sigil) {
+    return name.begins_with(sigil) ? name.sub(1) : name;
+}
+
+bool needs_escape(ryml::csubstr s) {
+    return SimdKernels::find_escape(s.str, s.len) != s.len;
+}
+
+// First eight bytes as a big-endian integer, zero padded: comparing two
+// prefixes orders keys like memcmp over those bytes
+uint64_t key_prefix(ryml::csubstr key) {
+    uint64_t prefix = 0;
+    size_t n = std::min<size_t>(key.len, 8);
+    for (size_t i = 0; i < n; ++i) {
+        prefix |= static_cast<uint64_t>(static_cast<unsigned char>(key.str[i])) << (56 - 8 * i);
+    }
+    return prefix;
+}
+
+const char* escape_for(unsigned char c) {
+    switch (c) {
+        case '"': return "\\\"";
+        case '\\': return "\\\\";
+        case '\n': return "\\n";
+        case '\t': return "\\t";
+        case '\r': return "\\r";
+        case '\b': return "\\b";
+        case '\f': return "\\f";
+        default: return nullptr;
+    }
+}
+
+} // namespace
+
+JsonEmitter::JsonEmitter(const ryml::Tree& tree, const ConversionLimits& limits)
+    : tree_(tree), limits_(limits) {
+    node_budget_ = std::numeric_limits<size_t>::max();
+    if (limits_.max_alias_expansion > 0) {
+        double budget = limits_.max_alias_expansion * static_cast<double>(std::max<size_t>(tree_.size(), 1));
+        if (budget < static_cast<double>(std::numeric_limits<size_t>::max())) {
+            node_budget_ = std::max(kMinNodeBudget, static_cast<size_t>(budget));
+        }
+    }
+
+    scan_tree();
+}
+
+JsonEmitter::JsonEmitter(const ryml::Tree& tree, const ConversionOptions& options)
+    : JsonEmitter(tree, options.limits) {
+    typing_ = options.scalars;
+    canonical_ = options.canonical;
+    set_interning(options.intern_strings);
+}
+
+JsonEmitter::~JsonEmitter() = default;
+
+void JsonEmitter::set_interning(bool interning) {
+    if (!interning) {
+        interner_.reset();
+    } else if (interner_ == nullptr) {
+        interner_ = std::make_unique<StringInterner>();
+    }
+}
+
+void JsonEmitter::set_source(const char* data, size_t size, const std::string& filename) {
+    source_ = data;
+    source_size_ = size;
+    filename_ = filename;
+}
+
+void JsonEmitter::resolve_aliases() {
+    if (resolved_) {
+        return;
+    }
+    resolved_ = true;
+    if (has_aliases_ && tree_.size() > 0) {
+        AnchorMap anchors;
+        index_aliases(tree_.root_id(), anchors);
+    }
+}
+
+void JsonEmitter::scan_tree() {
+    // Linear pass over the node array: much cheaper than a tree walk
+    for (ryml::id_type id = 0; id < tree_.capacity(); ++id) {
+        if (tree_.is_key_ref(id) || tree_.is_val_ref(id) ||
+            tree_.has_key_anchor(id) || tree_.has_val_anchor(id)) {
+            has_aliases_ = true;
+        }
+        if (tree_.has_key(id) && !tree_.is_key_quoted(id) && tree_.key(id) == "<<") {
+            has_aliases_ = true;
+            has_merges_ = true;
+        }
+    }
+}
+
+void JsonEmitter::index_aliases(ryml::id_type node, AnchorMap& anchors) {
+    // Aliases may only refer to anchors that precede them in document order,
+    // so a value's anchor is registered once its whole subtree has been visited
+    if (tree_.has_key_anchor(node)) {
+        anchors[view(strip_sigil(tree_.key_anchor(node), '&'))] = AliasTarget{node, true};
+    }
+    if (tree_.is_key_ref(node)) {
+        key_refs_[node] = lookup_anchor(anchors, strip_sigil(tree_.key_ref(node), '*'));
+    }
+    if (tree_.is_val_ref(node)) {
+        val_refs_[node] = lookup_anchor(anchors, strip_sigil(tree_.val_ref(node), '*'));
+    }
+
+    for (ryml::id_type child = tree_.first_child(node); child != ryml::NONE;
+         child = tree_.next_sibling(child)) {
+        index_aliases(child, anchors);
+    }
+
+    if (tree_.has_val_anchor(node)) {
+        anchors[view(strip_sigil(tree_.val_anchor(node), '&'))] = AliasTarget{node, false};
+    }
+}
+
+JsonEmitter::AliasTarget JsonEmitter::lookup_anchor(const AnchorMap& anchors, ryml::csubstr name) const {
+    auto it = anchors.find(view(name));
+    if (it == anchors.end()) {
+        std::string detail = "Undefined alias '*" + std::string(name.str, name.len) + "'";
+        const char* where = name.str;
+        if (source_ != nullptr && where > source_ && where[-1] == '*') {
+            --where;
+        }
+        ErrorLocation loc = locate_in_source(source_, source_size_, where, filename_);
+        throw ConversionError(format_error_with_location(detail, loc.file, loc.line, loc.column),
+                              std::move(loc), detail);
+    }
+    return it->second;
+}
+
+void JsonEmitter::emit(std::string& out) {
+    // Sized up front so a large output is not regrown and copied as it is
+    // written; only escapes and expanded aliases can outgrow the estimate
+    out.reserve(out.size() + estimated_size());
+    out_ = &out;
+    gather_ = nullptr;
+    sink_ = nullptr;
+    flushed_bytes_ = 0;
+    emit_root();
+}
+
+void JsonEmitter::emit(GatherWriter& out) {
+    out_ = &out.buffer();
+    gather_ = &out;
+    sink_ = nullptr;
+    flushed_bytes_ = 0;
+    emit_root();
+}
+
+void JsonEmitter::emit(OutputSink& sink) {
+    std::string block;
+    block.reserve(kSinkBlockBytes + kSinkBlockBytes / 4);
+    out_ = &block;
+    gather_ = nullptr;
+    sink_ = &sink;
+    flushed_bytes_ = 0;
+    if (sink.wants_size_estimate()) {
+        sink.reserve(estimated_size());
+    }
+    emit_root();
+    flush_to_sink();
+    sink_ = nullptr;
+    out_ = nullptr;
+}
+
+size_t JsonEmitter::estimated_size() const {
+    size_t size = 0;
+    for (ryml::id_type id = 0; id < tree_.capacity(); ++id) {
+        if (tree_.has_key(id)) {
+            size += tree_.key(id).len + 4;  // "key": 
+        }
+        if (tree_.has_val(id)) {
+            size += tree_.val(id).len + 3;  // "value",
+        } else if (tree_.is_container(id)) {
+            size += 3;  // {},
+        }
+    }
+    return size;
+}
+
+void JsonEmitter::flush_to_sink() {
+    if (!out_->empty()) {
+        sink_->write(out_->data(), out_->size());
+        flushed_bytes_ += out_->size();
+        out_->clear();
+    }
+}
+
+void JsonEmitter::emit_root() {
+    resolve_aliases();
+    std::string& out = *out_;
+    if (tree_.size() == 0) {
+        return;
+    }
+
+    ryml::id_type root = tree_.root_id();
+    if (tree_.is_stream(root)) {
+        bool first = true;
+        for (ryml::id_type doc = tree_.first_child(root); doc != ryml::NONE;
+             doc = tree_.next_sibling(doc)) {
+            if (!first) {
+                out += '\n';
+            }
+            first = false;
+            emit_value(doc, 0);
+        }
+    } else {
+        emit_value(root, 0);
+    }
+}
+
+void JsonEmitter::emit_node(ryml::id_type node, std::string& out, size_t depth) {
+    resolve_aliases();
+    out_ = &out;
+    gather_ = nullptr;
+    sink_ = nullptr;
+    flushed_bytes_ = 0;
+    emit_value(node, depth);
+}
+
+ryml::id_type JsonEmitter::resolve_value(ryml::id_type node) {
+    resolve_aliases();
+    if (has_aliases_ && tree_.is_val_ref(node)) {
+        const AliasTarget& target = val_refs_.at(node);
+        if (!target.is_key) {
+            return target.node;
+        }
+    }
+    return node;
+}
+
+ryml::csubstr JsonEmitter::value_text(ryml::id_type node) {
+    resolve_aliases();
+    if (has_aliases_ && tree_.is_val_ref(node)) {
+        const AliasTarget& target = val_refs_.at(node);
+        return target.is_key ? tree_.key(target.node) : tree_.val(target.node);
+    }
+    return tree_.val(node);
+}
+
+void JsonEmitter::map_entries(ryml::id_type map, std::vector<ryml::id_type>& entries) {
+    resolve_aliases();
+    if (has_merges_ && has_merge_key(map)) {
+        collect_entries(map, entries, 1);
+        return;
+    }
+    for (ryml::id_type child = tree_.first_child(map); child != ryml::NONE;
+         child = tree_.next_sibling(child)) {
+        entries.push_back(child);
+    }
+}
+
+void JsonEmitter::check_depth(size_t depth) const {
+    if (limits_.max_depth > 0 && depth > limits_.max_depth) {
+        throw LimitExceededError("Nesting depth limit exceeded: more than " +
+                                 std::to_string(limits_.max_depth) + " levels");
+    }
+}
+
+void JsonEmitter::check_budget() {
+    if (++emitted_nodes_ > node_budget_) {
+        throw LimitExceededError("Alias expansion limit exceeded: more than " +
+                                 std::to_string(node_budget_) + " values emitted from " +
+                                 std::to_string(tree_.size()) + " parsed nodes");
+    }
+    if (sink_ != nullptr && out_->size() >= kSinkBlockBytes) {
+        flush_to_sink();
+    }
+    size_t output_size = flushed_bytes_;
+    if (gather_ != nullptr) {
+        output_size += gather_->size();
+    } else if (out_ != nullptr) {
+        output_size += out_->size();
+    }
+    if (limits_.max_output_bytes > 0 && output_size > limits_.max_output_bytes) {
+        throw LimitExceededError("Output size limit exceeded: more than " +
+                                 std::to_string(limits_.max_output_bytes) + " bytes");
+    }
+    if ((emitted_nodes_ & (kDeadlineCheckInterval - 1)) == 0 && limits_.has_deadline() &&
+        ConversionLimits::Clock::now() > limits_.deadline) {
+        throw LimitExceededError("Deadline exceeded while emitting");
+    }
+}
+
+void JsonEmitter::emit_value(ryml::id_type node, size_t depth) {
+    // An alias is emitted as a re-walk of its anchored node (never itself an alias)
+    if (has_aliases_ && tree_.is_val_ref(node)) {
+        const AliasTarget& target = val_refs_.at(node);
+        if (target.is_key) {
+            check_budget();
+            write_string(tree_.key(target.node));
+            return;
+        }
+        node = target.node;
+    }
+
+    check_budget();
+
+    if (tree_.is_map(node)) {
+        emit_map(node, depth + 1);
+    } else if (tree_.is_seq(node)) {
+        emit_seq(node, depth + 1);
+    } else if (tree_.has_val(node)) {
+        emit_scalar(node);
+    } else {
+        out_->append("null");
+    }
+}
+
+void JsonEmitter::emit_map(ryml::id_type node, size_t depth) {
+    check_depth(depth);
+    if (canonical_) {
+        emit_sorted_map(node, depth);
+        return;
+    }
+    std::string& out = *out_;
+    out += '{';
+
+    if (has_merges_ && has_merge_key(node)) {
+        std::vector<ryml::id_type> entries;
+        collect_entries(node, entries, depth);
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (i > 0) {
+                out += ',';
+            }
+            write_string(key_text(entries[i]));
+            out.append(": ");
+            emit_value(entries[i], depth);
+        }
+    } else {
+        bool first = true;
+        for (ryml::id_type child = tree_.first_child(node); child != ryml::NONE;
+             child = tree_.next_sibling(child)) {
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            write_string(key_text(child));
+            out.append(": ");
+            emit_value(child, depth);
+        }
+    }
+
+    out += '}';
+}
+
+void JsonEmitter::emit_sorted_map(ryml::id_type node, size_t depth) {
+    // Child ids are sorted, the tree itself is left alone. The buffer is moved
+    // out while in use: nested maps may grow sort_scratch_
+    if (sort_scratch_.size() <= depth) {
+        sort_scratch_.resize(depth + 1);
+    }
+    std::vector<SortedKey> keys = std::move(sort_scratch_[depth]);
+    keys.clear();
+
+    auto add = [&](ryml::id_type child) {
+        ryml::csubstr key = key_text(child);
+        keys.push_back(SortedKey{key_prefix(key), key, child, keys.size()});
+    };
+    if (has_merges_ && has_merge_key(node)) {
+        std::vector<ryml::id_type> entries;
+        collect_entries(node, entries, depth);
+        for (ryml::id_type entry : entries) {
+            add(entry);
+        }
+    } else {
+        for (ryml::id_type child = tree_.first_child(node); child != ryml::NONE;
+             child = tree_.next_sibling(child)) {
+            add(child);
+        }
+    }
+
+    // Most keys differ within eight bytes, so a comparison is usually one
+    // integer compare without touching the key bytes
+    auto less = [](const SortedKey& a, const SortedKey& b) {
+        if (a.prefix != b.prefix) {
+            return a.prefix < b.prefix;
+        }
+        size_t common = std::min(a.key.len, b.key.len);
+        if (common > 8) {
+            int cmp = std::memcmp(a.key.str + 8, b.key.str + 8, common - 8);
+            if (cmp != 0) {
+                return cmp < 0;
+            }
+        }
+        if (a.key.len != b.key.len) {
+            return a.key.len < b.key.len;
+        }
+        return a.pos < b.pos;
+    };
+    if (keys.size() <= kSmallMapKeys) {
+        for (size_t i = 1; i < keys.size(); ++i) {
+            SortedKey entry = keys[i];
+            size_t j = i;
+            for (; j > 0 && less(entry, keys[j - 1]); --j) {
+                keys[j] = keys[j - 1];
+            }
+            keys[j] = entry;
+        }
+    } else {
+        std::sort(keys.begin(), keys.end(), less);
+    }
+
+    std::string& out = *out_;
+    out += '{';
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (i > 0) {
+            out += ',';
+        }
+        write_string(keys[i].key);
+        out += ':';
+        emit_value(keys[i].node, depth);
+    }
+    out += '}';
+
+    sort_scratch_[depth] = std::move(keys);
+}
+
+void JsonEmitter::emit_seq(ryml::id_type node, size_t depth) {
+    check_depth(depth);
+    std::string& out = *out_;
+    out += '[';
+    bool first = true;
+    for (ryml::id_type child = tree_.first_child(node); child != ryml::NONE;
+         child = tree_.next_sibling(child)) {
+        if (!first) {
+            out += ',';
+        }
+        first = false;
+        emit_value(child, depth);
+    }
+    out += ']';
+}
+
+void JsonEmitter::emit_scalar(ryml::id_type node) {
+    ryml::csubstr val = tree_.val(node);
+    bool is_string = tree_.is_val_quoted(node) ||
+                     (tree_.has_val_tag(node) && tree_.val_tag(node) == "!!str");
+
+    if (!is_string && (val.str == nullptr || tree_.val_is_null(node))) {
+        out_->append("null");
+    } else if (is_string) {
+        write_string(val);
+    } else if (typing_ != ScalarTyping::Json) {
+        emit_typed_scalar(val);
+    } else if (val == "true" || val == "false" || ScalarClassifier::is_json_number(val)) {
+        out_->append(val.str, val.len);
+    } else {
+        write_string(val);
+    }
+}
+
+void JsonEmitter::emit_typed_scalar(ryml::csubstr val) {
+    ScalarValue value = ScalarClassifier::decode(val, typing_);
+    switch (value.type) {
+        case ScalarType::Null:
+            out_->append("null");
+            return;
+        case ScalarType::Bool:
+            out_->append(value.boolean ? "true" : "false");
+            return;
+        case ScalarType::Int:
+        case ScalarType::Float: {
+            // Most numbers are already in JSON form; only the rest is reprinted
+            if (ScalarClassifier::is_json_number(val)) {
+                out_->append(val.str, val.len);
+                return;
+            }
+            char buf[32];
+            size_t len = ScalarClassifier::format_number(value, buf, sizeof(buf));
+            if (len > 0) {
+                out_->append(buf, len);
+                return;
+            }
+            // JSON has no infinity or NaN: keep the YAML text as a string
+            break;
+        }
+        case ScalarType::String:
+            break;
+    }
+    write_string(val);
+}
+
+void JsonEmitter::write_string(ryml::csubstr s) {
+    // Short strings that need escaping are escaped once and then copied from
+    // the table; clean ones are copied directly, the scan is cheaper than a lookup
+    if (interner_ != nullptr && s.len <= StringInterner::kMaxStringBytes && needs_escape(s) &&
+        interner_->append_json(*out_, s)) {
+        return;
+    }
+    // Strings parsed in place are slices of the input: write them from there
+    if (gather_ != nullptr && s.len >= GatherWriter::kMinReferenceBytes && !needs_escape(s)) {
+        *out_ += '"';
+        gather_->reference(s.str, s.len);
+        *out_ += '"';
+        return;
+    }
+    append_string(*out_, s);
+}
+
+void JsonEmitter::append_string(std::string& out, ryml::csubstr s) {
+    out += '"';
+    // Copy the runs between escapes whole; the vector kernel finds each escape
+    size_t pos = 0;
+    while (pos < s.len) {
+        size_t run = SimdKernels::find_escape(s.str + pos, s.len - pos);
+        out.append(s.str + pos, run);
+        pos += run;
+        if (pos == s.len) {
+            break;
+        }
+        auto c = static_cast<unsigned char>(s.str[pos++]);
+        if (const char* esc = escape_for(c)) {
+            out.append(esc);
+        } else {
+            static const char hex[] = "0123456789abcdef";
+            char u[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+            out.append(u, 6);
+        }
+    }
+    out += '"';
+}
+
+ryml::csubstr JsonEmitter::key_text(ryml::id_type child) const {
+    if (has_aliases_ && tree_.is_key_ref(child)) {
+        const AliasTarget& target = key_refs_.at(child);
+        if (target.is_key) {
+            return tree_.key(target.node);
+        }
+        if (tree_.is_container(target.node)) {
+            throw ConversionError("Alias '*" + std::string(tree_.key_ref(child).str, tree_.key_ref(child).len) +
+                                  "' refers to a collection and cannot be used as a JSON object key");
+        }
+        return tree_.val(target.node);
+    }
+    return tree_.key(child);
+}
+
+bool JsonEmitter::is_merge_key(ryml::id_type child) const {
+    return tree_.has_key(child) && !tree_.is_key_quoted(child) && tree_.key(child) == "<<" &&
+           (tree_.is_val_ref(child) || tree_.is_container(child));
+}
+
+bool JsonEmitter::has_merge_key(ryml::id_type map) const {
+    for (ryml::id_type child = tree_.first_child(map); child != ryml::NONE;
+         child = tree_.next_sibling(child)) {
+        if (is_merge_key(child)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void JsonEmitter::append_merge_source(ryml::id_type source, std::vector<ryml::id_type>& sources) const {
+    if (tree_.is_val_ref(source)) {
+        const AliasTarget& target = val_refs_.at(source);
+        source = target.node;
+        if (target.is_key) {
+            source = ryml::NONE;
+        }
+    }
+    if (source == ryml::NONE || !tree_.is_map(source)) {
+        throw ConversionError("Merge key '<<' must refer to a mapping or a sequence of mappings");
+    }
+    sources.push_back(source);
+}
+
+void JsonEmitter::collect_entries(ryml::id_type map, std::vector<ryml::id_type>& entries, size_t depth) {
+    check_depth(depth);
+
+    // Explicit keys always win over merged ones; among merge sources the first wins
+    std::unordered_set<std::string_view> seen;
+    for (ryml::id_type child = tree_.first_child(map); child != ryml::NONE;
+         child = tree_.next_sibling(child)) {
+        if (!is_merge_key(child)) {
+            seen.insert(view(key_text(child)));
+        }
+    }
+
+    std::vector<ryml::id_type> sources;
+    std::vector<ryml::id_type> merged;
+    for (ryml::id_type child = tree_.first_child(map); child != ryml::NONE;
+         child = tree_.next_sibling(child)) {
+        if (!is_merge_key(child)) {
+            entries.push_back(child);
+            continue;
+        }
+
+        sources.clear();
+        if (tree_.is_seq(child)) {
+            for (ryml::id_type item = tree_.first_child(child); item != ryml::NONE;
+                 item = tree_.next_sibling(item)) {
+                append_merge_source(item, sources);
+            }
+        } else {
+            append_merge_source(child, sources);
+        }
+
+        for (ryml::id_type source : sources) {
+            merged.clear();
+            if (has_merge_key(source)) {
+                collect_entries(source, merged, depth + 1);
+            } else {
+                for (ryml::id_type entry = tree_.first_child(source); entry != ryml::NONE;
+                     entry = tree_.next_sibling(entry)) {
+                    merged.push_back(entry);
+                }
+            }
+            for (ryml::id_type entry : merged) {
+                check_budget();
+                if (seen.insert(view(key_text(entry))).second) {
+                    entries.push_back(entry);
+                }
+            }
+        }
+    }
+}
+
+} // namespace yaml2json
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <ryml.hpp>
+#include "ConversionOptions.h"
+
+namespace yaml2json {
+
+class GatherWriter;
+class OutputSink;
+class StringInterner;
+
+// JSON emitter walking the ryml tree itself. Aliases and merge keys are
+// expanded by re-walking the anchored node (the tree is never duplicated)
+// and ConversionLimits are enforced while emitting.
+class JsonEmitter {
+public:
+    JsonEmitter(const ryml::Tree& tree, const ConversionLimits& limits);
+
+    // Limits, scalar typing, key order and interning taken from the conversion options
+    JsonEmitter(const ryml::Tree& tree, const ConversionOptions& options);
+
+    ~JsonEmitter();
+
+    // Source buffer the tree was parsed in place from, used to locate errors
+    void set_source(const char* data, size_t size, const std::string& filename);
+
+    // How plain scalars are typed (default ScalarTyping::Json)
+    void set_scalar_typing(ScalarTyping typing) { typing_ = typing; }
+
+    // Emit map keys sorted by their UTF-8 bytes, without whitespace (default off)
+    void set_canonical(bool canonical) { canonical_ = canonical; }
+
+    // Write short strings that need escaping from a StringInterner (default off)
+    void set_interning(bool interning);
+
+    // The interner in use, for its statistics; null when interning is off
+    const StringInterner* interner() const { return interner_.get(); }
+
+    // Map every alias to its anchor; throws ConversionError on undefined aliases.
+    // Called by emit() when needed, so only useful for validating without emitting
+    void resolve_aliases();
+
+    // Emit the whole tree; documents of a stream are separated by newlines
+    void emit(std::string& out);
+
+    // Emit the whole tree, referencing long strings that need no escaping
+    // in place; the tree and its source buffer must outlive the output
+    void emit(GatherWriter& out);
+
+    // Emit the whole tree into a sink in blocks of about kSinkBlockBytes;
+    // sinks that ask for it are first given estimated_size()
+    void emit(OutputSink& sink);
+
+    // Approximate size of the compact JSON output, from one pass over the
+    // node array: scalar lengths plus quotes and separators. Escapes and
+    // expanded aliases are not counted
+    size_t estimated_size() const;
+
+    // Emit a single node and its subtree as a JSON value, appending to out;
+    // depth is the nesting level of the node in the whole output
+    void emit_node(ryml::id_type node, std::string& out, size_t depth = 0);
+
+    // Node an alias value stands for (the node itself if it is no alias, or an
+    // alias of a key); lets other passes look through aliases like the emitter
+    ryml::id_type resolve_value(ryml::id_type node);
+
+    // Entries of a map as emitted, merge keys expanded (in place of `<<`)
+    void map_entries(ryml::id_type map, std::vector<ryml::id_type>& entries);
+
+    // Key of a map entry as emitted, aliases resolved
+    ryml::csubstr entry_key(ryml::id_type child) { resolve_aliases(); return key_text(child); }
+
+    // Scalar text a value stands for, looking through aliases (also aliases of keys)
+    ryml::csubstr value_text(ryml::id_type node);
+
+    // Count emitted values from zero again, so independent emit_node calls on
+    // one emitter each get the whole alias expansion budget
+    void reset_budget() { emitted_nodes_ = 0; }
+
+    // Check whether the tree uses anchors, aliases or merge keys
+    bool has_aliases() const { return has_aliases_; }
+
+    // Number of values emitted so far (expanded aliases count every time)
+    size_t emitted_nodes() const { return emitted_nodes_; }
+
+    // Values that may be emitted before the alias expansion limit is hit,
+    // for walkers that expand aliases through this emitter
+    size_t node_budget() const { return node_budget_; }
+
+    // Append s as a quoted, escaped JSON string
+    static void append_string(std::string& out, ryml::csubstr s);
+
+    // Output is handed to a sink once this much has accumulated
+    static constexpr size_t kSinkBlockBytes = 64 * 1024;
+
+    // Maps with at most this many keys are sorted by insertion sort
+    static constexpr size_t kSmallMapKeys = 16;
+
+private:
+    struct AliasTarget {
+        ryml::id_type node;
+        bool is_key;  // alias of an anchored key rather than of a value
+    };
+    using AnchorMap = std::unordered_map<std::string_view, AliasTarget>;
+
+    // Map entry in canonical order: compared on the first eight key bytes as
+    // one integer, then on the rest, then on document order
+    struct SortedKey {
+        uint64_t prefix;
+        ryml::csubstr key;
+        ryml::id_type node;
+        size_t pos;
+    };
+
+    void scan_tree();
+    void index_aliases(ryml::id_type node, AnchorMap& anchors);
+    void emit_root();
+    AliasTarget lookup_anchor(const AnchorMap& anchors, ryml::csubstr name) const;
+
+    void emit_value(ryml::id_type node, size_t depth);
+    void emit_map(ryml::id_type node, size_t depth);
+    void emit_sorted_map(ryml::id_type node, size_t depth);
+    void emit_seq(ryml::id_type node, size_t depth);
+    void emit_scalar(ryml::id_type node);
+    void emit_typed_scalar(ryml::csubstr val);
+    void write_string(ryml::csubstr s);
+
+    bool has_merge_key(ryml::id_type map) const;
+    bool is_merge_key(ryml::id_type child) const;
+    void collect_entries(ryml::id_type map, std::vector<ryml::id_type>& entries, size_t depth);
+    void append_merge_source(ryml::id_type source, std::vector<ryml::id_type>& sources) const;
+    ryml::csubstr key_text(ryml::id_type child) const;
+
+    void check_depth(size_t depth) const;
+    void check_budget();
+    void flush_to_sink();
+
+    const ryml::Tree& tree_;
+    ConversionLimits limits_;
+    ScalarTyping typing_ = ScalarTyping::Json;
+    bool canonical_ = false;
+    std::unique_ptr<StringInterner> interner_;
+    std::string* out_ = nullptr;
+    GatherWriter* gather_ = nullptr;
+    OutputSink* sink_ = nullptr;
+    size_t flushed_bytes_ = 0;
+
+    // One buffer per nesting level, reused across the maps sorted there
+    std::vector<std::vector<SortedKey>> sort_scratch_;
+
+    bool has_aliases_ = false;
+    bool has_merges_ = false;
+    bool resolved_ = false;
+    size_t node_budget_ = 0;
+    size_t emitted_nodes_ = 0;
+
+    std::unordered_map<ryml::id_type, AliasTarget> key_refs_;
+    std::unordered_map<ryml::id_type, AliasTarget> val_refs_;
+
+    const char* source_ = nullptr;
+    size_t source_size_ = 0;
+    std::string filename_;
+};
+
+} // namespace yaml2json
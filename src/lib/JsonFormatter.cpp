@@ -1,4 +1,5 @@
 #include "JsonFormatter.h"
+#include "Trace.h"
 
 namespace yaml2json {
 
@@ -6,6 +7,7 @@ std::string JsonFormatter::format(const std::string& json, const JsonFormatOptio
     if (!options.pretty_print) {
         return compact(json);
     }
+    TraceSpan span("format");
     
     std::string result;
     result.reserve(json.size() * 2);
@@ -0,0 +1,956 @@
+#include "JsonSchema.h"
+#include "ErrorHandler.h"
+#include "FileReader.h"
+#include "JsonEmitter.h"
+#include "ScalarClassifier.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <regex>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace yaml2json {
+
+namespace {
+
+constexpr size_t kNone = static_cast<size_t>(-1);
+
+// The clock is read once per this many checked values (power of two)
+constexpr size_t kDeadlineCheckInterval = 4096;
+
+// std::regex matches recursively, about one stack frame per input character,
+// so longer strings are never handed to it
+constexpr size_t kMaxPatternSubject = 4096;
+
+// Subschemas applied within one another, so "$ref": "#" on the same value
+// ends with an error instead of a stack overflow
+constexpr size_t kMaxCheckNesting = 1000;
+
+// JSON types as a bit set; an integer is also a number
+enum TypeBits : unsigned {
+    kNull = 1u << 0,
+    kBoolean = 1u << 1,
+    kObject = 1u << 2,
+    kArray = 1u << 3,
+    kNumber = 1u << 4,
+    kInteger = 1u << 5,
+    kString = 1u << 6
+};
+
+const char* const kTypeNames[] = {"null", "boolean", "object", "array", "number", "integer", "string"};
+
+std::string_view view(ryml::csubstr s) {
+    return std::string_view(s.str, s.len);
+}
+
+std::string type_list(unsigned types) {
+    std::string names;
+    for (unsigned bit = 0; bit < 7; ++bit) {
+        if (types & (1u << bit)) {
+            if (!names.empty()) {
+                names += " or ";
+            }
+            names += kTypeNames[bit];
+        }
+    }
+    return names;
+}
+
+// Characters, not bytes: continuation bytes of UTF-8 sequences are skipped
+size_t code_points(ryml::csubstr s) {
+    size_t count = 0;
+    for (size_t i = 0; i < s.len; ++i) {
+        if ((static_cast<unsigned char>(s.str[i]) & 0xC0) != 0x80) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// A value listed by enum or const: compared as canonical JSON, numbers by value
+struct Literal {
+    std::string canonical;
+    bool is_number = false;
+    double number = 0.0;
+};
+
+} // namespace
+
+struct JsonSchema::Impl {
+    struct Node {
+        bool reject_all = false;  // the `false` schema
+        unsigned types = 0;       // 0 = any type
+        size_t ref = kNone;
+
+        bool has_enum = false;
+        std::vector<Literal> enum_values;
+
+        // Objects; properties are sorted by name for binary search
+        std::vector<std::pair<std::string, size_t>> properties;
+        std::vector<std::pair<std::regex, size_t>> pattern_properties;
+        size_t additional_properties = kNone;
+        std::vector<std::string> required;
+        size_t min_properties = 0;
+        size_t max_properties = kNone;
+
+        // Arrays
+        std::vector<size_t> prefix_items;
+        size_t items = kNone;
+        size_t min_items = 0;
+        size_t max_items = kNone;
+        bool unique_items = false;
+
+        // Strings
+        size_t min_length = 0;
+        size_t max_length = kNone;
+        bool has_pattern = false;
+        std::regex pattern;
+        std::string pattern_source;
+
+        // Numbers
+        bool has_minimum = false, has_maximum = false;
+        bool has_exclusive_minimum = false, has_exclusive_maximum = false;
+        double minimum = 0, maximum = 0, exclusive_minimum = 0, exclusive_maximum = 0;
+        double multiple_of = 0;  // 0 = none
+
+        // Combinators
+        std::vector<size_t> all_of;
+        std::vector<size_t> any_of;
+        std::vector<size_t> one_of;
+        size_t not_schema = kNone;
+        size_t if_schema = kNone;
+        size_t then_schema = kNone;
+        size_t else_schema = kNone;
+    };
+
+    std::vector<Node> nodes;  // nodes[0] is the root schema
+};
+
+namespace {
+
+using Node = JsonSchema::Impl::Node;
+
+// Schema literals are small and come from the schema author, so they are
+// emitted without limits; instances are emitted under the caller's limits
+ConversionOptions canonical_options(ScalarTyping typing, const ConversionLimits& limits) {
+    ConversionOptions options;
+    options.scalars = typing;
+    options.canonical = true;
+    options.limits = limits;
+    return options;
+}
+
+ConversionOptions canonical_options(ScalarTyping typing) {
+    ConversionLimits limits;
+    limits.max_alias_expansion = 0;
+    return canonical_options(typing, limits);
+}
+
+// Builds the node array from the parsed schema document. Subschemas are
+// compiled once per schema tree node, which also ends $ref cycles
+class SchemaCompiler {
+public:
+    SchemaCompiler(const ryml::Tree& tree, JsonSchema::Impl& impl, const std::string& filename)
+        : tree_(tree), impl_(impl), filename_(filename), literals_(tree, canonical_options(ScalarTyping::Json)) {}
+
+    size_t compile(ryml::id_type node) {
+        auto known = compiled_.find(node);
+        if (known != compiled_.end()) {
+            return known->second;
+        }
+        size_t index = impl_.nodes.size();
+        impl_.nodes.emplace_back();
+        compiled_[node] = index;
+
+        if (!tree_.is_map(node)) {
+            if (tree_.has_val(node) && !tree_.is_val_quoted(node) && tree_.val(node) == "false") {
+                impl_.nodes[index].reject_all = true;
+            } else if (!(tree_.has_val(node) && !tree_.is_val_quoted(node) && tree_.val(node) == "true")) {
+                fail("a schema must be an object or a boolean");
+            }
+            return index;
+        }
+
+        bool tuple_items = false;
+        size_t additional_items = kNone;
+        bool exclusive_minimum_flag = false, exclusive_maximum_flag = false;
+        for (ryml::id_type child = tree_.first_child(node); child != ryml::NONE;
+             child = tree_.next_sibling(child)) {
+            ryml::csubstr key = tree_.key(child);
+            // Compile subschemas before taking a reference: compiling grows the array
+            if (key == "type") {
+                unsigned types = 0;
+                if (tree_.is_seq(child)) {
+                    for (ryml::id_type item = tree_.first_child(child); item != ryml::NONE;
+                         item = tree_.next_sibling(item)) {
+                        types |= type_bit(item);
+                    }
+                } else {
+                    types = type_bit(child);
+                }
+                impl_.nodes[index].types = types;
+            } else if (key == "enum") {
+                require_seq(child, "enum");
+                std::vector<Literal> values;
+                for (ryml::id_type item = tree_.first_child(child); item != ryml::NONE;
+                     item = tree_.next_sibling(item)) {
+                    values.push_back(literal(item));
+                }
+                impl_.nodes[index].has_enum = true;
+                impl_.nodes[index].enum_values = std::move(values);
+            } else if (key == "const") {
+                impl_.nodes[index].has_enum = true;
+                impl_.nodes[index].enum_values = {literal(child)};
+            } else if (key == "properties" || key == "patternProperties") {
+                require_map(child, key);
+                for (ryml::id_type entry = tree_.first_child(child); entry != ryml::NONE;
+                     entry = tree_.next_sibling(entry)) {
+                    size_t sub = compile(entry);
+                    std::string name(tree_.key(entry).str, tree_.key(entry).len);
+                    Node& target = impl_.nodes[index];
+                    if (key == "properties") {
+                        target.properties.emplace_back(std::move(name), sub);
+                    } else {
+                        target.pattern_properties.emplace_back(make_regex(name), sub);
+                    }
+                }
+            } else if (key == "additionalProperties") {
+                size_t sub = compile(child);
+                impl_.nodes[index].additional_properties = sub;
+            } else if (key == "required") {
+                require_seq(child, "required");
+                std::vector<std::string> names;
+                for (ryml::id_type item = tree_.first_child(child); item != ryml::NONE;
+                     item = tree_.next_sibling(item)) {
+                    names.emplace_back(tree_.val(item).str, tree_.val(item).len);
+                }
+                impl_.nodes[index].required = std::move(names);
+            } else if (key == "minProperties") {
+                impl_.nodes[index].min_properties = count(child, key);
+            } else if (key == "maxProperties") {
+                impl_.nodes[index].max_properties = count(child, key);
+            } else if (key == "items" || key == "prefixItems") {
+                if (tree_.is_seq(child)) {
+                    // Array form of items is draft 7 for prefixItems
+                    std::vector<size_t> subs;
+                    for (ryml::id_type item = tree_.first_child(child); item != ryml::NONE;
+                         item = tree_.next_sibling(item)) {
+                        subs.push_back(compile(item));
+                    }
+                    impl_.nodes[index].prefix_items = std::move(subs);
+                    tuple_items = tuple_items || key == "items";
+                } else if (key == "items") {
+                    size_t sub = compile(child);
+                    impl_.nodes[index].items = sub;
+                } else {
+                    fail("prefixItems must be an array");
+                }
+            } else if (key == "additionalItems") {
+                additional_items = compile(child);
+            } else if (key == "minItems") {
+                impl_.nodes[index].min_items = count(child, key);
+            } else if (key == "maxItems") {
+                impl_.nodes[index].max_items = count(child, key);
+            } else if (key == "uniqueItems") {
+                impl_.nodes[index].unique_items = boolean(child, key);
+            } else if (key == "minLength") {
+                impl_.nodes[index].min_length = count(child, key);
+            } else if (key == "maxLength") {
+                impl_.nodes[index].max_length = count(child, key);
+            } else if (key == "pattern") {
+                Node& target = impl_.nodes[index];
+                target.pattern_source.assign(tree_.val(child).str, tree_.val(child).len);
+                target.pattern = make_regex(target.pattern_source);
+                target.has_pattern = true;
+            } else if (key == "minimum") {
+                impl_.nodes[index].minimum = number(child, key);
+                impl_.nodes[index].has_minimum = true;
+            } else if (key == "maximum") {
+                impl_.nodes[index].maximum = number(child, key);
+                impl_.nodes[index].has_maximum = true;
+            } else if (key == "exclusiveMinimum") {
+                if (is_boolean(child)) {
+                    exclusive_minimum_flag = boolean(child, key);  // draft 4 form
+                } else {
+                    impl_.nodes[index].exclusive_minimum = number(child, key);
+                    impl_.nodes[index].has_exclusive_minimum = true;
+                }
+            } else if (key == "exclusiveMaximum") {
+                if (is_boolean(child)) {
+                    exclusive_maximum_flag = boolean(child, key);
+                } else {
+                    impl_.nodes[index].exclusive_maximum = number(child, key);
+                    impl_.nodes[index].has_exclusive_maximum = true;
+                }
+            } else if (key == "multipleOf") {
+                double divisor = number(child, key);
+                if (!(divisor > 0)) {
+                    fail("multipleOf must be greater than 0");
+                }
+                impl_.nodes[index].multiple_of = divisor;
+            } else if (key == "allOf" || key == "anyOf" || key == "oneOf") {
+                require_seq(child, key);
+                std::vector<size_t> subs;
+                for (ryml::id_type item = tree_.first_child(child); item != ryml::NONE;
+                     item = tree_.next_sibling(item)) {
+                    subs.push_back(compile(item));
+                }
+                Node& target = impl_.nodes[index];
+                (key == "allOf" ? target.all_of : key == "anyOf" ? target.any_of : target.one_of) = std::move(subs);
+            } else if (key == "not") {
+                size_t sub = compile(child);
+                impl_.nodes[index].not_schema = sub;
+            } else if (key == "if") {
+                size_t sub = compile(child);
+                impl_.nodes[index].if_schema = sub;
+            } else if (key == "then") {
+                size_t sub = compile(child);
+                impl_.nodes[index].then_schema = sub;
+            } else if (key == "else") {
+                size_t sub = compile(child);
+                impl_.nodes[index].else_schema = sub;
+            } else if (key == "$ref") {
+                size_t sub = compile(resolve_ref(tree_.val(child)));
+                impl_.nodes[index].ref = sub;
+            }
+        }
+
+        Node& target = impl_.nodes[index];
+        if (tuple_items && additional_items != kNone) {
+            target.items = additional_items;
+        }
+        if (exclusive_minimum_flag && target.has_minimum) {
+            target.has_exclusive_minimum = true;
+            target.exclusive_minimum = target.minimum;
+        }
+        if (exclusive_maximum_flag && target.has_maximum) {
+            target.has_exclusive_maximum = true;
+            target.exclusive_maximum = target.maximum;
+        }
+        std::sort(target.properties.begin(), target.properties.end());
+        return index;
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& what) const {
+        throw ConversionError("Invalid JSON Schema" + (filename_.empty() ? "" : " '" + filename_ + "'") +
+                              ": " + what);
+    }
+
+    void require_seq(ryml::id_type node, ryml::csubstr keyword) const {
+        if (!tree_.is_seq(node)) {
+            fail(std::string(keyword.str, keyword.len) + " must be an array");
+        }
+    }
+
+    void require_map(ryml::id_type node, ryml::csubstr keyword) const {
+        if (!tree_.is_map(node)) {
+            fail(std::string(keyword.str, keyword.len) + " must be an object");
+        }
+    }
+
+    unsigned type_bit(ryml::id_type node) const {
+        ryml::csubstr name = tree_.has_val(node) ? tree_.val(node) : ryml::csubstr{};
+        for (unsigned bit = 0; bit < 7; ++bit) {
+            if (name == ryml::to_csubstr(kTypeNames[bit])) {
+                return 1u << bit;
+            }
+        }
+        fail("unknown type '" + std::string(name.str, name.len) + "'");
+    }
+
+    bool is_boolean(ryml::id_type node) const {
+        return tree_.has_val(node) && !tree_.is_val_quoted(node) &&
+               (tree_.val(node) == "true" || tree_.val(node) == "false");
+    }
+
+    bool boolean(ryml::id_type node, ryml::csubstr keyword) const {
+        if (!is_boolean(node)) {
+            fail(std::string(keyword.str, keyword.len) + " must be a boolean");
+        }
+        return tree_.val(node) == "true";
+    }
+
+    double number(ryml::id_type node, ryml::csubstr keyword) const {
+        if (tree_.has_val(node) && !tree_.is_val_quoted(node)) {
+            ScalarValue value = ScalarClassifier::decode(tree_.val(node), ScalarTyping::Json);
+            if (value.type == ScalarType::Int) {
+                double magnitude = static_cast<double>(value.magnitude);
+                return value.negative ? -magnitude : magnitude;
+            }
+            if (value.type == ScalarType::Float) {
+                return value.number;
+            }
+        }
+        fail(std::string(keyword.str, keyword.len) + " must be a number");
+    }
+
+    size_t count(ryml::id_type node, ryml::csubstr keyword) const {
+        double value = number(node, keyword);
+        if (value < 0 || value != std::floor(value)) {
+            fail(std::string(keyword.str, keyword.len) + " must be a non-negative integer");
+        }
+        return value >= static_cast<double>(kNone) ? kNone : static_cast<size_t>(value);
+    }
+
+    Literal literal(ryml::id_type node) {
+        Literal lit;
+        literals_.emit_node(node, lit.canonical);
+        if (tree_.has_val(node) && !tree_.is_container(node) && !tree_.is_val_quoted(node) &&
+            ScalarClassifier::is_json_number(tree_.val(node))) {
+            lit.is_number = true;
+            lit.number = number(node, "enum");
+        }
+        return lit;
+    }
+
+    std::regex make_regex(const std::string& source) const {
+        try {
+            return std::regex(source, std::regex::ECMAScript | std::regex::optimize);
+        } catch (const std::regex_error& e) {
+            fail("invalid pattern '" + source + "': " + e.what());
+        }
+    }
+
+    // Local references only: "#" or a JSON pointer such as "#/$defs/port"
+    ryml::id_type resolve_ref(ryml::csubstr ref) const {
+        if (!ref.begins_with('#')) {
+            fail("only references within the schema are supported, not '" + std::string(ref.str, ref.len) + "'");
+        }
+        ryml::id_type node = tree_.root_id();
+        if (tree_.is_stream(node)) {
+            node = tree_.first_child(node);
+        }
+        size_t pos = 1;
+        while (pos < ref.len) {
+            if (ref.str[pos] != '/') {
+                fail("unsupported reference '" + std::string(ref.str, ref.len) + "'");
+            }
+            size_t end = pos + 1;
+            while (end < ref.len && ref.str[end] != '/') {
+                ++end;
+            }
+            std::string token;
+            for (size_t i = pos + 1; i < end; ++i) {
+                if (ref.str[i] == '~' && i + 1 < end && (ref.str[i + 1] == '0' || ref.str[i + 1] == '1')) {
+                    token += ref.str[i + 1] == '0' ? '~' : '/';
+                    ++i;
+                } else {
+                    token += ref.str[i];
+                }
+            }
+            ryml::id_type next = ryml::NONE;
+            if (tree_.is_map(node)) {
+                next = tree_.find_child(node, ryml::csubstr(token.data(), token.size()));
+            } else if (tree_.is_seq(node) && !token.empty() &&
+                       std::all_of(token.begin(), token.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+                size_t item = std::stoul(token);
+                if (item < tree_.num_children(node)) {
+                    next = tree_.child(node, item);
+                }
+            }
+            if (next == ryml::NONE) {
+                fail("reference '" + std::string(ref.str, ref.len) + "' does not resolve");
+            }
+            node = next;
+            pos = end;
+        }
+        return node;
+    }
+
+    const ryml::Tree& tree_;
+    JsonSchema::Impl& impl_;
+    const std::string& filename_;
+    JsonEmitter literals_;
+    std::unordered_map<ryml::id_type, size_t> compiled_;
+};
+
+// What a tree node is as JSON under the conversion's scalar typing
+struct Instance {
+    ryml::id_type node;  // aliases resolved
+    unsigned type;       // one bit; kNumber | kInteger for integral numbers
+    ryml::csubstr text;  // string value
+    double number = 0.0;
+};
+
+struct Failure {
+    ryml::id_type node = ryml::NONE;
+    std::string pointer;
+    std::string message;
+};
+
+class SchemaValidator {
+public:
+    SchemaValidator(const JsonSchema::Impl& impl, const ryml::Tree& tree, const ConversionOptions& options)
+        : impl_(impl), tree_(tree), typing_(options.scalars), limits_(options.limits),
+          emitter_(tree, canonical_options(options.scalars, options.limits)) {}
+
+    // Validate one document against the root schema
+    bool validate(ryml::id_type document, Failure& failure) {
+        path_.clear();
+        return check(0, document, &failure);
+    }
+
+    // Point at the entry in the YAML source: the key of containers, the value of scalars
+    const char* where(ryml::id_type node) const {
+        while (node != ryml::NONE) {
+            if (!tree_.is_container(node) && tree_.has_val(node) && tree_.val(node).str != nullptr) {
+                return tree_.val(node).str;
+            }
+            if (tree_.has_key(node) && tree_.key(node).str != nullptr) {
+                return tree_.key(node).str;
+            }
+            node = tree_.first_child(node);
+        }
+        return nullptr;
+    }
+
+private:
+    Instance inspect(ryml::id_type node) {
+        node = emitter_.resolve_value(node);
+        Instance inst{node, kNull, {}, 0.0};
+        if (tree_.is_map(node)) {
+            inst.type = kObject;
+            return inst;
+        }
+        if (tree_.is_seq(node)) {
+            inst.type = kArray;
+            return inst;
+        }
+        if (!tree_.has_val(node)) {
+            return inst;
+        }
+
+        // Mirrors JsonEmitter::emit_scalar
+        ryml::csubstr val = tree_.val(node);
+        inst.text = val;
+        bool is_string = tree_.is_val_quoted(node) || (tree_.has_val_tag(node) && tree_.val_tag(node) == "!!str");
+        if (is_string) {
+            inst.type = kString;
+            return inst;
+        }
+        if (val.str == nullptr || tree_.val_is_null(node)) {
+            return inst;
+        }
+        if (typing_ == ScalarTyping::Json &&
+            !(val == "true" || val == "false" || ScalarClassifier::is_json_number(val))) {
+            inst.type = kString;
+            return inst;
+        }
+
+        ScalarValue value = ScalarClassifier::decode(val, typing_ == ScalarTyping::Json ? ScalarTyping::Core : typing_);
+        switch (value.type) {
+            case ScalarType::Null:
+                inst.type = kNull;
+                break;
+            case ScalarType::Bool:
+                inst.type = kBoolean;
+                break;
+            case ScalarType::Int: {
+                double magnitude = static_cast<double>(value.magnitude);
+                inst.number = value.negative ? -magnitude : magnitude;
+                inst.type = kNumber | kInteger;
+                break;
+            }
+            case ScalarType::Float:
+                inst.number = value.number;
+                if (!std::isfinite(value.number)) {
+                    inst.type = kString;  // emitted as the YAML text
+                } else {
+                    inst.type = value.number == std::floor(value.number) ? (kNumber | kInteger) : kNumber;
+                }
+                break;
+            case ScalarType::String:
+                inst.type = kString;
+                break;
+        }
+        return inst;
+    }
+
+    bool fail(Failure* failure, ryml::id_type node, std::string message) const {
+        if (failure != nullptr && failure->message.empty()) {
+            failure->node = node;
+            failure->message = std::move(message);
+            failure->pointer = "#";
+            for (const std::string& segment : path_) {
+                failure->pointer += '/';
+                for (char c : segment) {
+                    if (c == '~') {
+                        failure->pointer += "~0";
+                    } else if (c == '/') {
+                        failure->pointer += "~1";
+                    } else {
+                        failure->pointer += c;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    std::string canonical(ryml::id_type node) {
+        std::string json;
+        emitter_.emit_node(node, json);
+        return json;
+    }
+
+    // Aliases are looked through like the emitter does, so the values checked
+    // count against the same expansion budget, and containers against max_depth
+    void check_limits(const Instance& inst) {
+        if (++checked_nodes_ > emitter_.node_budget()) {
+            throw LimitExceededError("Alias expansion limit exceeded: more than " +
+                                     std::to_string(emitter_.node_budget()) + " values checked from " +
+                                     std::to_string(tree_.size()) + " parsed nodes");
+        }
+        if ((checked_nodes_ & (kDeadlineCheckInterval - 1)) == 0 && limits_.has_deadline() &&
+            ConversionLimits::Clock::now() > limits_.deadline) {
+            throw LimitExceededError("Deadline exceeded while validating");
+        }
+        if ((inst.type == kObject || inst.type == kArray) && limits_.max_depth > 0 &&
+            path_.size() + 1 > limits_.max_depth) {
+            throw LimitExceededError("Nesting depth limit exceeded: more than " +
+                                     std::to_string(limits_.max_depth) + " levels");
+        }
+    }
+
+    bool check(size_t index, ryml::id_type node, Failure* failure) {
+        if (++nesting_ > kMaxCheckNesting) {
+            throw LimitExceededError("Schema validation nested more than " + std::to_string(kMaxCheckNesting) +
+                                     " subschemas deep");
+        }
+        bool ok = check_node(index, node, failure);
+        --nesting_;
+        return ok;
+    }
+
+    bool check_node(size_t index, ryml::id_type node, Failure* failure) {
+        const Node& schema = impl_.nodes[index];
+        if (schema.reject_all) {
+            return fail(failure, node, "no value is allowed here");
+        }
+
+        Instance inst = inspect(node);
+        check_limits(inst);
+        if (schema.types != 0 && (schema.types & inst.type) == 0) {
+            unsigned shown = inst.type & kInteger ? kInteger : inst.type;
+            return fail(failure, node, "expected " + type_list(schema.types) + ", got " + type_list(shown));
+        }
+        if (schema.ref != kNone && !check(schema.ref, node, failure)) {
+            return false;
+        }
+        if (schema.has_enum && !in_enum(schema, inst)) {
+            return fail(failure, node, schema.enum_values.size() == 1
+                ? "value must be " + schema.enum_values[0].canonical
+                : "value is not one of the allowed values");
+        }
+
+        bool ok = true;
+        if (inst.type & kNumber) {
+            ok = check_number(schema, inst, failure);
+        } else if (inst.type == kString) {
+            ok = check_string(schema, inst, failure);
+        } else if (inst.type == kObject) {
+            ok = check_object(schema, inst, failure);
+        } else if (inst.type == kArray) {
+            ok = check_array(schema, inst, failure);
+        }
+        return ok && check_combinators(schema, node, failure);
+    }
+
+    bool in_enum(const Node& schema, const Instance& inst) {
+        std::string json;
+        for (const Literal& lit : schema.enum_values) {
+            if (inst.type & kNumber) {
+                if (lit.is_number && lit.number == inst.number) {
+                    return true;
+                }
+                continue;
+            }
+            if (json.empty()) {
+                json = canonical(inst.node);
+            }
+            if (json == lit.canonical) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool check_number(const Node& schema, const Instance& inst, Failure* failure) const {
+        double x = inst.number;
+        if (schema.has_minimum && x < schema.minimum) {
+            return fail(failure, inst.node, "must be at least " + format(schema.minimum));
+        }
+        if (schema.has_maximum && x > schema.maximum) {
+            return fail(failure, inst.node, "must be at most " + format(schema.maximum));
+        }
+        if (schema.has_exclusive_minimum && x <= schema.exclusive_minimum) {
+            return fail(failure, inst.node, "must be greater than " + format(schema.exclusive_minimum));
+        }
+        if (schema.has_exclusive_maximum && x >= schema.exclusive_maximum) {
+            return fail(failure, inst.node, "must be less than " + format(schema.exclusive_maximum));
+        }
+        if (schema.multiple_of > 0) {
+            double quotient = x / schema.multiple_of;
+            if (std::fabs(quotient - std::round(quotient)) > 1e-9 * std::max(1.0, std::fabs(quotient))) {
+                return fail(failure, inst.node, "must be a multiple of " + format(schema.multiple_of));
+            }
+        }
+        return true;
+    }
+
+    bool check_string(const Node& schema, const Instance& inst, Failure* failure) const {
+        if (schema.min_length > 0 || schema.max_length != kNone) {
+            size_t length = code_points(inst.text);
+            if (length < schema.min_length) {
+                return fail(failure, inst.node, "must be at least " + std::to_string(schema.min_length) + " characters long");
+            }
+            if (length > schema.max_length) {
+                return fail(failure, inst.node, "must be at most " + std::to_string(schema.max_length) + " characters long");
+            }
+        }
+        if (schema.has_pattern) {
+            if (inst.text.len > kMaxPatternSubject) {
+                return fail(failure, inst.node, "is longer than " + std::to_string(kMaxPatternSubject) +
+                                                " bytes, too long to match pattern '" + schema.pattern_source + "'");
+            }
+            if (!std::regex_search(inst.text.str, inst.text.str + inst.text.len, schema.pattern)) {
+                return fail(failure, inst.node, "does not match pattern '" + schema.pattern_source + "'");
+            }
+        }
+        return true;
+    }
+
+    bool check_object(const Node& schema, const Instance& inst, Failure* failure) {
+        std::vector<ryml::id_type> entries;
+        emitter_.map_entries(inst.node, entries);
+        if (entries.size() < schema.min_properties) {
+            return fail(failure, inst.node, "must have at least " + std::to_string(schema.min_properties) + " properties");
+        }
+        if (entries.size() > schema.max_properties) {
+            return fail(failure, inst.node, "must have at most " + std::to_string(schema.max_properties) + " properties");
+        }
+
+        if (!schema.required.empty()) {
+            std::unordered_set<std::string_view> present;
+            present.reserve(entries.size());
+            for (ryml::id_type child : entries) {
+                present.insert(view(emitter_.entry_key(child)));
+            }
+            for (const std::string& name : schema.required) {
+                if (present.count(name) == 0) {
+                    return fail(failure, inst.node, "missing required property '" + name + "'");
+                }
+            }
+        }
+
+        bool open = schema.properties.empty() && schema.pattern_properties.empty() &&
+                    schema.additional_properties == kNone;
+        if (open) {
+            return true;
+        }
+        for (ryml::id_type child : entries) {
+            ryml::csubstr key = emitter_.entry_key(child);
+            path_.emplace_back(key.str, key.len);
+            bool matched = false;
+            auto prop = std::lower_bound(schema.properties.begin(), schema.properties.end(), view(key),
+                                         [](const std::pair<std::string, size_t>& p, std::string_view k) {
+                                             return std::string_view(p.first) < k;
+                                         });
+            if (prop != schema.properties.end() && prop->first == view(key)) {
+                matched = true;
+                if (!check(prop->second, child, failure)) {
+                    return false;
+                }
+            }
+            if (!schema.pattern_properties.empty() && key.len > kMaxPatternSubject) {
+                return fail(failure, child, "property name is longer than " + std::to_string(kMaxPatternSubject) +
+                                            " bytes, too long to match patternProperties");
+            }
+            for (const auto& pattern : schema.pattern_properties) {
+                if (std::regex_search(key.str, key.str + key.len, pattern.first)) {
+                    matched = true;
+                    if (!check(pattern.second, child, failure)) {
+                        return false;
+                    }
+                }
+            }
+            if (!matched && schema.additional_properties != kNone &&
+                !check(schema.additional_properties, child, failure)) {
+                return false;
+            }
+            path_.pop_back();
+        }
+        return true;
+    }
+
+    bool check_array(const Node& schema, const Instance& inst, Failure* failure) {
+        size_t size = tree_.num_children(inst.node);
+        if (size < schema.min_items) {
+            return fail(failure, inst.node, "must have at least " + std::to_string(schema.min_items) + " items");
+        }
+        if (size > schema.max_items) {
+            return fail(failure, inst.node, "must have at most " + std::to_string(schema.max_items) + " items");
+        }
+
+        std::unordered_set<std::string> seen;
+        size_t position = 0;
+        for (ryml::id_type item = tree_.first_child(inst.node); item != ryml::NONE;
+             item = tree_.next_sibling(item), ++position) {
+            size_t sub = position < schema.prefix_items.size() ? schema.prefix_items[position] : schema.items;
+            if (sub == kNone && !schema.unique_items) {
+                continue;
+            }
+            path_.push_back(std::to_string(position));
+            if (sub != kNone && !check(sub, item, failure)) {
+                return false;
+            }
+            if (schema.unique_items && !seen.insert(canonical(item)).second) {
+                return fail(failure, item, "duplicate item in an array of unique items");
+            }
+            path_.pop_back();
+        }
+        return true;
+    }
+
+    bool check_combinators(const Node& schema, ryml::id_type node, Failure* failure) {
+        for (size_t sub : schema.all_of) {
+            if (!check(sub, node, failure)) {
+                return false;
+            }
+        }
+        if (!schema.any_of.empty()) {
+            size_t depth = path_.size();
+            bool any = false;
+            for (size_t sub : schema.any_of) {
+                path_.resize(depth);
+                if (check(sub, node, nullptr)) {
+                    any = true;
+                    break;
+                }
+            }
+            path_.resize(depth);
+            if (!any) {
+                return fail(failure, node, "does not match any schema in anyOf");
+            }
+        }
+        if (!schema.one_of.empty()) {
+            size_t depth = path_.size();
+            size_t matches = 0;
+            for (size_t sub : schema.one_of) {
+                path_.resize(depth);
+                matches += check(sub, node, nullptr) ? 1 : 0;
+            }
+            path_.resize(depth);
+            if (matches != 1) {
+                return fail(failure, node, "matches " + std::to_string(matches) +
+                                           " schemas in oneOf, expected exactly one");
+            }
+        }
+        if (schema.not_schema != kNone) {
+            size_t depth = path_.size();
+            bool matched = check(schema.not_schema, node, nullptr);
+            path_.resize(depth);
+            if (matched) {
+                return fail(failure, node, "must not match the schema in not");
+            }
+        }
+        if (schema.if_schema != kNone) {
+            size_t depth = path_.size();
+            bool condition = check(schema.if_schema, node, nullptr);
+            path_.resize(depth);
+            size_t branch = condition ? schema.then_schema : schema.else_schema;
+            if (branch != kNone && !check(branch, node, failure)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static std::string format(double value) {
+        ScalarValue number;
+        number.type = ScalarType::Float;
+        number.number = value;
+        char buf[32];
+        size_t len = ScalarClassifier::format_number(number, buf, sizeof(buf));
+        return std::string(buf, len);
+    }
+
+    const JsonSchema::Impl& impl_;
+    const ryml::Tree& tree_;
+    ScalarTyping typing_;
+    const ConversionLimits& limits_;
+    JsonEmitter emitter_;
+    std::vector<std::string> path_;
+    size_t checked_nodes_ = 0;
+    size_t nesting_ = 0;
+};
+
+} // namespace
+
+JsonSchema::JsonSchema() : impl_(std::make_unique<Impl>()) {}
+
+JsonSchema::~JsonSchema() = default;
+
+std::shared_ptr<const JsonSchema> JsonSchema::compile(const std::string& json, const std::string& filename) {
+    setup_error_handlers();
+
+    ryml::Tree tree;
+    try {
+        ryml::parse_json_in_arena(ryml::csubstr(filename.data(), filename.size()),
+                                  ryml::csubstr(json.data(), json.size()), &tree);
+    } catch (const std::exception& e) {
+        throw ConversionError("Invalid JSON Schema" + (filename.empty() ? "" : " '" + filename + "'") +
+                              ": " + e.what());
+    }
+
+    std::shared_ptr<JsonSchema> schema(new JsonSchema());
+    ryml::id_type root = tree.root_id();
+    if (tree.is_stream(root)) {
+        root = tree.first_child(root);
+    }
+    if (tree.size() == 0 || root == ryml::NONE) {
+        throw ConversionError("Invalid JSON Schema" + (filename.empty() ? "" : " '" + filename + "'") +
+                              ": the document is empty");
+    }
+    SchemaCompiler(tree, *schema->impl_, filename).compile(root);
+    return schema;
+}
+
+std::shared_ptr<const JsonSchema> JsonSchema::load(const std::string& path) {
+    FileContent content = FileReader::read_file(path);
+    return compile(std::string(content.data(), content.size()), path);
+}
+
+void JsonSchema::validate(const ryml::Tree& tree, const ConversionOptions& options, const char* source,
+                          size_t source_size, const std::string& filename) const {
+    if (tree.size() == 0) {
+        return;
+    }
+
+    SchemaValidator validator(*impl_, tree, options);
+    ryml::id_type root = tree.root_id();
+    std::vector<ryml::id_type> documents;
+    if (tree.is_stream(root)) {
+        for (ryml::id_type doc = tree.first_child(root); doc != ryml::NONE; doc = tree.next_sibling(doc)) {
+            documents.push_back(doc);
+        }
+    } else {
+        documents.push_back(root);
+    }
+
+    for (ryml::id_type document : documents) {
+        Failure failure;
+        if (!validator.validate(document, failure)) {
+            std::string detail = "Schema violation at " + failure.pointer + ": " + failure.message;
+            ErrorLocation loc = locate_in_source(source, source_size, validator.where(failure.node), filename);
+            throw ConversionError(format_error_with_location(detail, loc.file, loc.line, loc.column),
+                                  std::move(loc), detail);
+        }
+    }
+}
+
+} // namespace yaml2json
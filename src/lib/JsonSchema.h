@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <ryml.hpp>
+#include "ConversionOptions.h"
+
+namespace yaml2json {
+
+// JSON Schema compiled once into a flat array of nodes and checked directly
+// against parsed YAML trees, so no JSON is produced or parsed again to validate.
+// Supported keywords (draft 7 and 2020-12): type, enum, const, properties,
+// patternProperties, additionalProperties, required, minProperties,
+// maxProperties, items, prefixItems, additionalItems, minItems, maxItems,
+// uniqueItems, minLength, maxLength, pattern, minimum, maximum,
+// exclusiveMinimum, exclusiveMaximum, multipleOf, allOf, anyOf, oneOf, not,
+// if/then/else and $ref within the schema document. Annotations and other
+// keywords (format, title, default, ...) are ignored.
+// Strings longer than 4096 bytes fail pattern and patternProperties rather
+// than being matched, and subschemas nested more than 1000 deep (a $ref that
+// loops back on the same value) raise LimitExceededError.
+// A compiled schema is immutable and may validate trees on several threads.
+class JsonSchema {
+public:
+    ~JsonSchema();
+
+    // Compile a schema from JSON text; throws ConversionError if it is not
+    // valid JSON, is malformed or refers outside of itself
+    static std::shared_ptr<const JsonSchema> compile(const std::string& json, const std::string& filename = "");
+
+    // Read (gzip/zstd transparently) and compile a schema file
+    static std::shared_ptr<const JsonSchema> load(const std::string& path);
+
+    // Check every document of the tree as it would be emitted under the
+    // options' scalar typing. Throws ConversionError at the first violation,
+    // with its JSON pointer and, when the tree was parsed in place from
+    // `source`, its YAML line and column
+    void validate(const ryml::Tree& tree, const ConversionOptions& options, const char* source = nullptr,
+                  size_t source_size = 0, const std::string& filename = "") const;
+
+    // Compiled form, defined in JsonSchema.cpp
+    struct Impl;
+
+private:
+    JsonSchema();
+
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace yaml2json
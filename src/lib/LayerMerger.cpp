@@ -0,0 +1,283 @@
+#include "LayerMerger.h"
+#include "ErrorHandler.h"
+#include "JsonEmitter.h"
+#include "JsonSchema.h"
+#include "ThreadPool.h"
+#include "YamlToJsonConverter.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
+namespace yaml2json {
+
+namespace {
+
+std::string_view view(ryml::csubstr s) {
+    return std::string_view(s.str, s.len);
+}
+
+// A value as defined by one layer; containers are already looked up through aliases
+struct LayerValue {
+    size_t layer;
+    ryml::id_type node;
+};
+
+enum class Kind {
+    Scalar,
+    Map,
+    Seq
+};
+
+class MergeEmitter {
+public:
+    MergeEmitter(const std::vector<const ryml::Tree*>& trees, const std::vector<std::string>& names,
+                 const ConversionOptions& options, SequenceMerge sequences)
+        : trees_(trees), names_(names), options_(options), sequences_(sequences) {
+        // One emitter per layer: it resolves that layer's aliases and writes
+        // the subtrees only that layer defines
+        for (const ryml::Tree* tree : trees_) {
+            emitters_.push_back(std::make_unique<JsonEmitter>(*tree, options_));
+        }
+    }
+
+    std::string run() {
+        std::vector<LayerValue> roots;
+        for (size_t i = 0; i < trees_.size(); ++i) {
+            ryml::id_type root = document_root(i);
+            if (root != ryml::NONE) {
+                roots.push_back(LayerValue{i, resolve(i, root)});
+            }
+        }
+        if (roots.empty()) {
+            return "null";
+        }
+
+        std::vector<LayerValue> effective;
+        fold(roots, effective);
+        emit(effective, 0);
+        return std::move(out_);
+    }
+
+private:
+    // The single document of a layer, or NONE if the layer is empty
+    ryml::id_type document_root(size_t layer) const {
+        const ryml::Tree& tree = *trees_[layer];
+        if (tree.size() == 0) {
+            return ryml::NONE;
+        }
+        ryml::id_type root = tree.root_id();
+        if (tree.is_stream(root)) {
+            if (tree.num_children(root) > 1) {
+                std::string name = layer < names_.size() && !names_[layer].empty()
+                    ? "'" + names_[layer] + "'" : "layer " + std::to_string(layer + 1);
+                throw ConversionError("Merge input " + name + " contains more than one document");
+            }
+            root = tree.first_child(root);
+            if (root == ryml::NONE) {
+                return ryml::NONE;
+            }
+        }
+        if (!tree.is_container(root) && !tree.has_val(root)) {
+            return ryml::NONE;
+        }
+        return root;
+    }
+
+    LayerValue resolve_entry(size_t layer, ryml::id_type child) {
+        return LayerValue{layer, resolve(layer, child)};
+    }
+
+    // Containers are followed through aliases; scalars stay as they are so the
+    // emitter handles aliases of keys and quoting itself
+    ryml::id_type resolve(size_t layer, ryml::id_type node) {
+        ryml::id_type target = emitters_[layer]->resolve_value(node);
+        return trees_[layer]->is_container(target) ? target : node;
+    }
+
+    Kind kind(const LayerValue& value) const {
+        const ryml::Tree& tree = *trees_[value.layer];
+        if (tree.is_map(value.node)) {
+            return Kind::Map;
+        }
+        return tree.is_seq(value.node) ? Kind::Seq : Kind::Scalar;
+    }
+
+    // Reduce the definitions of one value, in layer order, to those that
+    // contribute: a value that does not combine with the previous one replaces it
+    void fold(const std::vector<LayerValue>& values, std::vector<LayerValue>& effective) const {
+        effective.clear();
+        for (const LayerValue& value : values) {
+            Kind k = kind(value);
+            bool combines = !effective.empty() && kind(effective.back()) == k &&
+                            (k == Kind::Map || (k == Kind::Seq && sequences_ == SequenceMerge::Append));
+            if (!combines) {
+                effective.clear();
+            }
+            effective.push_back(value);
+        }
+    }
+
+    void emit(const std::vector<LayerValue>& values, size_t depth) {
+        if (values.size() == 1) {
+            emitters_[values[0].layer]->emit_node(values[0].node, out_, depth);
+            return;
+        }
+        check_depth(depth + 1);
+        if (kind(values[0]) == Kind::Map) {
+            emit_map(values, depth + 1);
+        } else {
+            emit_seq(values, depth + 1);
+        }
+    }
+
+    void emit_map(const std::vector<LayerValue>& values, size_t depth) {
+        struct Slot {
+            ryml::csubstr key;
+            std::vector<LayerValue> values;
+        };
+
+        // Keys in order of first definition; later layers only append new ones
+        std::vector<Slot> slots;
+        std::unordered_map<std::string_view, size_t> index;
+        std::vector<ryml::id_type> entries;
+        for (const LayerValue& value : values) {
+            JsonEmitter& emitter = *emitters_[value.layer];
+            entries.clear();
+            emitter.map_entries(value.node, entries);
+            for (ryml::id_type child : entries) {
+                ryml::csubstr key = emitter.entry_key(child);
+                auto slot = index.emplace(view(key), slots.size());
+                if (slot.second) {
+                    slots.push_back(Slot{key, {}});
+                }
+                slots[slot.first->second].values.push_back(resolve_entry(value.layer, child));
+            }
+        }
+
+        if (options_.canonical) {
+            std::sort(slots.begin(), slots.end(), [](const Slot& a, const Slot& b) {
+                int cmp = std::memcmp(a.key.str, b.key.str, std::min(a.key.len, b.key.len));
+                return cmp != 0 ? cmp < 0 : a.key.len < b.key.len;
+            });
+        }
+
+        std::vector<LayerValue> effective;
+        out_ += '{';
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (i > 0) {
+                out_ += ',';
+            }
+            JsonEmitter::append_string(out_, slots[i].key);
+            out_.append(options_.canonical ? ":" : ": ");
+            fold(slots[i].values, effective);
+            emit(effective, depth);
+        }
+        out_ += '}';
+    }
+
+    void emit_seq(const std::vector<LayerValue>& values, size_t depth) {
+        out_ += '[';
+        bool first = true;
+        for (const LayerValue& value : values) {
+            const ryml::Tree& tree = *trees_[value.layer];
+            for (ryml::id_type item = tree.first_child(value.node); item != ryml::NONE;
+                 item = tree.next_sibling(item)) {
+                if (!first) {
+                    out_ += ',';
+                }
+                first = false;
+                emitters_[value.layer]->emit_node(item, out_, depth);
+            }
+        }
+        out_ += ']';
+    }
+
+    void check_depth(size_t depth) const {
+        size_t max_depth = options_.limits.max_depth;
+        if (max_depth > 0 && depth > max_depth) {
+            throw LimitExceededError("Nesting depth limit exceeded: more than " +
+                                     std::to_string(max_depth) + " levels");
+        }
+    }
+
+    const std::vector<const ryml::Tree*>& trees_;
+    const std::vector<std::string>& names_;
+    const ConversionOptions& options_;
+    SequenceMerge sequences_;
+    std::vector<std::unique_ptr<JsonEmitter>> emitters_;
+    std::string out_;
+};
+
+} // namespace
+
+std::string LayerMerger::merge(const std::vector<MergeInput>& layers, const ConversionOptions& options,
+                               SequenceMerge sequences) {
+    // A schema describes the merged document, not each layer
+    ConversionOptions layer_options = options;
+    layer_options.schema = nullptr;
+    // Keys are matched across layers, so a key repeated within one layer cannot
+    // be kept twice: the default takes its last value, as a JSON parser would
+    if (layer_options.duplicate_keys == DuplicateKeys::Keep) {
+        layer_options.duplicate_keys = DuplicateKeys::LastWins;
+    }
+
+    std::vector<ryml::Tree> trees(layers.size());
+    std::vector<std::exception_ptr> errors(layers.size());
+    auto parse_one = [&](size_t i) {
+        try {
+            trees[i] = YamlToJsonConverter::parse_tree(layers[i].data, layers[i].size, layers[i].filename,
+                                                       layer_options);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    // Layers parse independently; the calling thread takes part
+    size_t threads = options.threads == 0 ? ThreadPool::default_threads() : options.threads;
+    size_t workers = std::min(threads, layers.size());
+    if (workers <= 1) {
+        for (size_t i = 0; i < layers.size(); ++i) {
+            parse_one(i);
+        }
+    } else {
+        ThreadPool pool(workers - 1);
+        pool.parallel_for(layers.size(), parse_one);
+    }
+
+    // Report the first failing layer in command-line order
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::vector<const ryml::Tree*> pointers;
+    std::vector<std::string> names;
+    for (size_t i = 0; i < layers.size(); ++i) {
+        pointers.push_back(&trees[i]);
+        names.push_back(layers[i].filename);
+    }
+    std::string json = MergeEmitter(pointers, names, options, sequences).run();
+
+    // The merged document only exists as JSON, so it is parsed once more to be
+    // validated; errors carry its JSON pointer but no line in any layer
+    if (options.schema) {
+        ryml::Tree merged;
+        ryml::parse_json_in_arena(ryml::csubstr(json.data(), json.size()), &merged);
+        ConversionOptions merged_options;
+        merged_options.scalars = ScalarTyping::Json;
+        options.schema->validate(merged, merged_options);
+    }
+    return json;
+}
+
+std::string LayerMerger::merge_trees(const std::vector<const ryml::Tree*>& trees, const ConversionOptions& options,
+                                     SequenceMerge sequences) {
+    std::vector<std::string> names;
+    return MergeEmitter(trees, names, options, sequences).run();
+}
+
+} // namespace yaml2json
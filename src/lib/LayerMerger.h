@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <ryml.hpp>
+#include "ConversionOptions.h"
+
+namespace yaml2json {
+
+// How a sequence in a later layer combines with one in an earlier layer
+enum class SequenceMerge {
+    Replace,  // the later sequence replaces the earlier one
+    Append    // items of the later sequence follow those of the earlier one
+};
+
+// One YAML input of a merge; parsed in place, so the buffer is modified
+struct MergeInput {
+    char* data;
+    size_t size;
+    std::string filename;
+};
+
+// Deep merge of YAML layers into one JSON document: maps merge key by key,
+// scalars and mismatched types are overridden by later layers. The merge is
+// done while emitting, so subtrees only one layer defines are written straight
+// from that layer's tree and nothing is copied into a combined tree.
+class LayerMerger {
+public:
+    // Parse every layer (on options.threads threads, 0 = all cores) and merge
+    // them, lowest precedence first. Empty layers are skipped; each other layer
+    // must hold a single document. options.duplicate_keys applies to each layer
+    // before merging, the default (Keep) as LastWins. Output is JSON whatever
+    // options.format says
+    static std::string merge(const std::vector<MergeInput>& layers, const ConversionOptions& options,
+                             SequenceMerge sequences = SequenceMerge::Replace);
+
+    // Merge already parsed trees, lowest precedence first; keys repeated within
+    // one tree are merged into each other
+    static std::string merge_trees(const std::vector<const ryml::Tree*>& trees, const ConversionOptions& options,
+                                   SequenceMerge sequences = SequenceMerge::Replace);
+};
+
+} // namespace yaml2json
@@ -0,0 +1,147 @@
+#include "MappedFileWriter.h"
+#include "ErrorHandler.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace yaml2json {
+
+namespace {
+
+[[noreturn]] void throw_file_error(const char* what, const std::string& path) {
+    throw ConversionError(std::string(what) + " output file '" + path + "': " + std::strerror(errno));
+}
+
+#ifndef _WIN32
+size_t round_to_pages(size_t bytes) {
+    static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return (bytes + page - 1) / page * page;
+}
+#endif
+
+} // namespace
+
+#ifdef _WIN32
+
+MappedFileWriter::MappedFileWriter(const std::string& path) : path_(path), file_(path) {
+    throw ConversionError("Mapped output is not supported on Windows");
+}
+
+MappedFileWriter::~MappedFileWriter() = default;
+
+bool MappedFileWriter::can_map(const std::string&) {
+    return false;
+}
+
+void MappedFileWriter::reserve(size_t) {}
+void MappedFileWriter::write(const char*, size_t) {}
+void MappedFileWriter::finish() {}
+void MappedFileWriter::grow(size_t, bool) {}
+void MappedFileWriter::unmap() {}
+
+#else
+
+// The temporary is open for reading too, which a shared writable mapping needs
+MappedFileWriter::MappedFileWriter(const std::string& path) : path_(path), file_(path) {}
+
+MappedFileWriter::~MappedFileWriter() {
+    // file_ then removes the unfinished temporary
+    unmap();
+}
+
+bool MappedFileWriter::can_map(const std::string& path) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        return errno == ENOENT;
+    }
+    return S_ISREG(st.st_mode);
+}
+
+void MappedFileWriter::reserve(size_t bytes) {
+    if (bytes > capacity_ - size_) {
+        grow(size_ + bytes, false);
+    }
+}
+
+void MappedFileWriter::write(const char* data, size_t size) {
+    // Nothing may be mapped yet: memcpy to a null map_ is undefined even for 0 bytes
+    if (size == 0) {
+        return;
+    }
+    if (size > capacity_ - size_) {
+        // Past the estimate: grow geometrically so a bad guess costs few remaps
+        grow(std::max({size_ + size, capacity_ + capacity_ / 2, capacity_ + kMinGrowBytes}), true);
+    }
+    std::memcpy(map_ + size_, data, size);
+    size_ += size;
+}
+
+void MappedFileWriter::grow(size_t min_capacity, bool counted) {
+    size_t capacity = round_to_pages(min_capacity);
+#ifdef __linux__
+    // Allocate the blocks now where the filesystem can (ext4, xfs, tmpfs); a
+    // sparse file would only run out of space on a store into the mapping
+    if (::fallocate(file_.fd(), 0, static_cast<off_t>(capacity_), static_cast<off_t>(capacity - capacity_)) != 0 &&
+        (errno == ENOSPC || errno == EFBIG)) {
+        throw_file_error("Failed to extend", path_);
+    }
+#endif
+    if (::ftruncate(file_.fd(), static_cast<off_t>(capacity)) != 0) {
+        throw_file_error("Failed to extend", path_);
+    }
+
+    void* map;
+    if (map_ == nullptr) {
+        map = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, file_.fd(), 0);
+    } else {
+#ifdef __linux__
+        map = ::mremap(map_, capacity_, capacity, MREMAP_MAYMOVE);
+#else
+        ::munmap(map_, capacity_);
+        map_ = nullptr;
+        map = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, file_.fd(), 0);
+#endif
+    }
+    if (map == MAP_FAILED) {
+        throw_file_error("Failed to map", path_);
+    }
+    map_ = static_cast<char*>(map);
+#ifdef MADV_POPULATE_WRITE
+    // Fault the new pages in with one call rather than one fault per page on
+    // first store; older kernels reject the advice and fault lazily
+    (void)::madvise(map_ + capacity_, capacity - capacity_, MADV_POPULATE_WRITE);
+#endif
+    capacity_ = capacity;
+    if (counted) {
+        ++remaps_;
+    }
+}
+
+void MappedFileWriter::finish() {
+    if (file_.fd() < 0) {
+        return;
+    }
+    unmap();
+    if (::ftruncate(file_.fd(), static_cast<off_t>(size_)) != 0) {
+        throw_file_error("Failed to truncate", path_);
+    }
+    file_.commit();
+}
+
+void MappedFileWriter::unmap() {
+    if (map_ != nullptr) {
+        ::munmap(map_, capacity_);
+        map_ = nullptr;
+    }
+}
+
+#endif
+
+} // namespace yaml2json
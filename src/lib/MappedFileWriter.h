@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "OutputFile.h"
+#include "OutputSink.h"
+
+namespace yaml2json {
+
+// Writes an output file through a shared memory mapping instead of write(2):
+// the file is sized up front (reserve(), e.g. from an estimate of the output),
+// output is copied straight into the page cache, the mapping grows by
+// remapping when the estimate falls short, and finish() truncates the file to
+// the bytes actually written. Space is allocated when the file grows where the
+// filesystem supports it, so a full disk fails with ConversionError instead
+// of SIGBUS on a later store. The mapping is of a temporary file (see
+// OutputFile) that finish() renames over the path, so the output is replaced
+// only once it is complete.
+class MappedFileWriter : public OutputSink {
+public:
+    // Create the temporary beside path; throws ConversionError if it cannot be
+    // created. path must be one can_map() accepts
+    explicit MappedFileWriter(const std::string& path);
+    ~MappedFileWriter() override;
+
+    MappedFileWriter(const MappedFileWriter&) = delete;
+    MappedFileWriter& operator=(const MappedFileWriter&) = delete;
+
+    // True where the output can be mapped: a regular file or a path that does
+    // not exist yet (not stdout, pipes, devices; never on Windows)
+    static bool can_map(const std::string& path);
+
+    // Grow the mapping to hold at least `bytes` more output
+    void reserve(size_t bytes) override;
+    bool wants_size_estimate() const override { return true; }
+
+    void write(const char* data, size_t size) override;
+
+    // Unmap, truncate the file to size() and rename it over the path; throws
+    // ConversionError. Without finish() the destructor discards the temporary
+    // and the path is left as it was
+    void finish();
+
+    // Bytes written so far
+    size_t size() const { return size_; }
+
+    // Size of the file (and mapping) while writing
+    size_t capacity() const { return capacity_; }
+
+    // Times the mapping had to grow past the reserved size
+    size_t remaps() const { return remaps_; }
+
+    // Smallest growth step once the reservation is used up
+    static constexpr size_t kMinGrowBytes = 1 << 20;
+
+private:
+    void grow(size_t min_capacity, bool counted);
+    void unmap();
+
+    std::string path_;
+    OutputFile file_;
+    char* map_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    size_t remaps_ = 0;
+};
+
+} // namespace yaml2json
@@ -0,0 +1,217 @@
+#include "OutputFile.h"
+#include "ErrorHandler.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <filesystem>
+    #include <io.h>
+    #include <sys/stat.h>
+    #include <system_error>
+#else
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace yaml2json {
+
+namespace {
+
+[[noreturn]] void throw_file_error(const char* what, const std::string& path) {
+    throw ConversionError(std::string(what) + " output file '" + path + "': " + std::strerror(errno));
+}
+
+#ifndef _WIN32
+// umask() can only be read by setting it, so do that once
+mode_t current_umask() {
+    static const mode_t mask = [] {
+        mode_t previous = ::umask(0);
+        ::umask(previous);
+        return previous;
+    }();
+    return mask;
+}
+
+// Truncate and write the path itself. A regular file is opened for reading
+// too where permitted, so it can still be mapped
+int open_in_place(const std::string& path, bool regular) {
+    int fd = -1;
+    if (regular) {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    }
+    if (fd < 0 && (!regular || errno == EACCES)) {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    }
+    if (fd < 0) {
+        throw_file_error("Failed to create", path);
+    }
+    return fd;
+}
+#endif
+
+} // namespace
+
+#ifdef _WIN32
+
+OutputFile::OutputFile(const std::string& path) : path_(path), target_(path) {
+    std::error_code ec;
+    std::filesystem::file_status status = std::filesystem::status(path, ec);
+    if (std::filesystem::exists(status) && !std::filesystem::is_regular_file(status)) {
+        fd_ = ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+        if (fd_ < 0) {
+            throw_file_error("Failed to create", path);
+        }
+        return;
+    }
+
+    std::string temp = path + ".XXXXXX";
+    if (::_mktemp_s(&temp[0], temp.size() + 1) != 0) {
+        throw_file_error("Failed to create", path);
+    }
+    fd_ = ::_open(temp.c_str(), _O_RDWR | _O_CREAT | _O_EXCL | _O_BINARY, _S_IREAD | _S_IWRITE);
+    if (fd_ < 0) {
+        throw_file_error("Failed to create", path);
+    }
+    temp_path_ = temp;
+}
+
+void OutputFile::commit() {
+    if (fd_ < 0) {
+        return;
+    }
+    int fd = fd_;
+    fd_ = -1;
+    if (::_close(fd) != 0) {
+        int error = errno;
+        discard();
+        errno = error;
+        throw_file_error("Failed to write", path_);
+    }
+    if (replaces()) {
+        std::error_code ec;
+        std::filesystem::rename(temp_path_, target_, ec);
+        if (ec) {
+            discard();
+            throw ConversionError("Failed to replace output file '" + path_ + "': " + ec.message());
+        }
+        temp_path_.clear();
+    }
+}
+
+void OutputFile::discard() {
+    if (fd_ >= 0) {
+        ::_close(fd_);
+        fd_ = -1;
+    }
+    if (!temp_path_.empty()) {
+        ::_unlink(temp_path_.c_str());
+        temp_path_.clear();
+    }
+}
+
+#else
+
+OutputFile::OutputFile(const std::string& path) : path_(path), target_(path) {
+    struct stat st;
+    bool exists = ::stat(path.c_str(), &st) == 0;
+    if (!exists && errno != ENOENT) {
+        throw_file_error("Failed to create", path);
+    }
+    struct stat link;
+    bool dangling = !exists && ::lstat(path.c_str(), &link) == 0 && S_ISLNK(link.st_mode);
+    // Renaming over a special file, a dangling symlink, a file with other hard
+    // links or one owned by someone else would change what the path is
+    if (dangling || (exists && (!S_ISREG(st.st_mode) || st.st_nlink > 1 || st.st_uid != ::geteuid()))) {
+        fd_ = open_in_place(path, dangling || S_ISREG(st.st_mode));
+        return;
+    }
+
+    if (exists) {
+        // Replace what a symlink points to, not the link
+        if (char* resolved = ::realpath(path.c_str(), nullptr)) {
+            target_ = resolved;
+            std::free(resolved);
+        }
+    }
+    std::string temp = target_ + ".XXXXXX";
+    fd_ = ::mkstemp(&temp[0]);
+    if (fd_ < 0) {
+        if (exists && (errno == EACCES || errno == EPERM || errno == EROFS)) {
+            // The directory is not writable, but the file may be
+            fd_ = open_in_place(path, true);
+            return;
+        }
+        throw_file_error("Failed to create", path);
+    }
+    temp_path_ = temp;
+    (void)::fcntl(fd_, F_SETFD, FD_CLOEXEC);
+
+    // Keep the group of the file replaced; where it cannot be kept, write in place
+    if (exists && ::fchown(fd_, static_cast<uid_t>(-1), st.st_gid) != 0) {
+        discard();
+        fd_ = open_in_place(path, true);
+        return;
+    }
+
+    // mkstemp creates the file 0600; give it the mode the output would have had
+    mode_t mode = exists ? (st.st_mode & 07777) : (0666 & ~current_umask());
+    if (::fchmod(fd_, mode) != 0) {
+        int error = errno;
+        discard();
+        errno = error;
+        throw_file_error("Failed to create", path);
+    }
+}
+
+void OutputFile::commit() {
+    if (fd_ < 0) {
+        return;
+    }
+    int fd = fd_;
+    fd_ = -1;
+    // Data first, so a crash after the rename cannot leave an empty output
+    if (replaces() && ::fsync(fd) != 0) {
+        int error = errno;
+        ::close(fd);
+        discard();
+        errno = error;
+        throw_file_error("Failed to write", path_);
+    }
+    if (::close(fd) != 0) {
+        int error = errno;
+        discard();
+        errno = error;
+        throw_file_error("Failed to write", path_);
+    }
+    if (replaces()) {
+        if (::rename(temp_path_.c_str(), target_.c_str()) != 0) {
+            int error = errno;
+            discard();
+            errno = error;
+            throw_file_error("Failed to replace", path_);
+        }
+        temp_path_.clear();
+    }
+}
+
+void OutputFile::discard() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    if (!temp_path_.empty()) {
+        ::unlink(temp_path_.c_str());
+        temp_path_.clear();
+    }
+}
+
+#endif
+
+OutputFile::~OutputFile() {
+    discard();
+}
+
+} // namespace yaml2json
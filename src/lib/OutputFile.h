@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+
+namespace yaml2json {
+
+// An output file that is only replaced once conversion has succeeded. A
+// regular file, or a path that does not exist yet, is written to a temporary
+// file in the same directory and renamed over the target by commit(), so a
+// failed conversion leaves an existing output untouched and the output may
+// name the input it is converted from (which stays mapped while it is read).
+// The temporary takes the mode and group of the file it replaces, or 0666
+// less the umask for a new one; a symlink is followed and its target
+// replaced, and the data is synced before the rename.
+// Where a rename would change what the path is, the path is truncated and
+// written in place instead, with no protection for a failed conversion or for
+// output naming the input: devices, pipes and other special files
+// (/dev/stdout, /dev/null), dangling symlinks, files with other hard links,
+// files owned by another user or whose group cannot be kept, and writable
+// files in a directory where no temporary can be created.
+class OutputFile {
+public:
+    // Create the temporary (or open the special file); throws ConversionError
+    explicit OutputFile(const std::string& path);
+
+    // Removes the temporary unless commit() succeeded
+    ~OutputFile();
+
+    OutputFile(const OutputFile&) = delete;
+    OutputFile& operator=(const OutputFile&) = delete;
+
+    // Descriptor to write the output to; open for reading too when replacing,
+    // so the temporary can be mapped
+    int fd() const { return fd_; }
+
+    // True when writing to a temporary that commit() renames into place,
+    // false when writing the path in place
+    bool replaces() const { return !temp_path_.empty(); }
+
+    // Close the file and rename the temporary over the target; throws
+    // ConversionError, after which the target is unchanged
+    void commit();
+
+    // The path as given, for messages
+    const std::string& path() const { return path_; }
+
+private:
+    void discard();
+
+    std::string path_;
+    std::string target_;
+    std::string temp_path_;
+    int fd_ = -1;
+};
+
+} // namespace yaml2json
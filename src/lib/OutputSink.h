@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+namespace yaml2json {
+
+// Receiver for output produced in pieces, so it never has to exist in memory
+// as a whole (see YamlToJsonConverter::convert_to)
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    // Consume the next `size` bytes of output; `data` is only valid during the call
+    virtual void write(const char* data, size_t size) = 0;
+
+    // Sinks that allocate their storage up front return true to be told the
+    // expected output size, through reserve(), before the first write
+    virtual bool wants_size_estimate() const { return false; }
+
+    // About `bytes` more output will follow; a hint, more or less may come
+    virtual void reserve(size_t bytes) { (void)bytes; }
+};
+
+} // namespace yaml2json
@@ -0,0 +1,542 @@
+#include "ParallelConverter.h"
+#include "ErrorHandler.h"
+#include "JsonEmitter.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include "YamlToJsonConverter.h"
+#include <ryml_std.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+
+namespace yaml2json {
+
+namespace {
+
+// Below this size thread start-up outweighs the parse time saved
+constexpr size_t kMinParallelBytes = 4 * 1024 * 1024;
+constexpr size_t kMinChunkBytes = 256 * 1024;
+constexpr size_t kChunksPerThread = 4;
+
+// How many levels of large mapping entries the planner looks into
+constexpr size_t kMaxDescent = 4;
+
+constexpr size_t kNone = static_cast<size_t>(-1);
+
+// Start of an entry of the container being split
+struct Item {
+    size_t offset;
+    size_t line;
+    bool dash;      // "- " sequence entry
+    bool bare_key;  // "key:" with the value on the following lines
+};
+
+// Lexical state carried from one line to the next
+struct LexState {
+    size_t block_indent = kNone;  // inside a block scalar whose header line had this indentation
+    char quote = 0;               // inside a multi-line quoted scalar
+    int flow = 0;                 // open flow collections
+
+    bool clean() const { return quote == 0 && flow == 0; }
+};
+
+struct LineFlags {
+    bool dash = false;
+    bool colon = false;  // mapping indicator at flow level 0
+    bool value = false;  // something other than a comment follows the colon
+};
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// True when p is the end of the line or whitespace (i.e. the previous char ended a token)
+bool at_break(const char* p, const char* end) {
+    return p == end || is_space(*p);
+}
+
+bool is_document_marker(const char* p, const char* end) {
+    return end - p >= 3 && (std::memcmp(p, "---", 3) == 0 || std::memcmp(p, "...", 3) == 0) &&
+           at_break(p + 3, end);
+}
+
+// Lex one line from its first non-space character. Returns false on constructs
+// that make splitting unsafe (anchors, aliases, merge and complex keys)
+bool lex_line(const char* p, const char* end, size_t indent, LexState& st, LineFlags& flags) {
+    const char* first = p;
+    bool token_start = st.quote == 0;
+
+    for (; p < end; ++p) {
+        char c = *p;
+        if (st.quote == '"') {
+            if (c == '\\') {
+                ++p;
+            } else if (c == '"') {
+                st.quote = 0;
+                token_start = false;
+            }
+            continue;
+        }
+        if (st.quote == '\'') {
+            if (c == '\'') {
+                if (p + 1 < end && p[1] == '\'') {
+                    ++p;
+                } else {
+                    st.quote = 0;
+                    token_start = false;
+                }
+            }
+            continue;
+        }
+        if (is_space(c)) {
+            continue;
+        }
+        if (c == '#' && (p == first || is_space(p[-1]))) {
+            break;
+        }
+        if (flags.colon && st.flow == 0) {
+            flags.value = true;
+        }
+
+        if (token_start) {
+            switch (c) {
+                case '"':
+                case '\'':
+                    st.quote = c;
+                    continue;
+                case '&':
+                case '*':
+                    return false;
+                case '?':
+                    if (at_break(p + 1, end)) {
+                        return false;
+                    }
+                    break;
+                case '<':
+                    if (end - p >= 3 && p[1] == '<' && p[2] == ':') {
+                        return false;
+                    }
+                    break;
+                case '!':
+                    // Tag: the node itself follows
+                    while (p + 1 < end && !is_space(p[1])) {
+                        ++p;
+                    }
+                    continue;
+                case '|':
+                case '>':
+                    if (st.flow == 0) {
+                        // Block scalar: every following line indented deeper belongs to it
+                        st.block_indent = indent;
+                        return true;
+                    }
+                    break;
+                case '-':
+                    if (at_break(p + 1, end)) {
+                        flags.dash = flags.dash || p == first;
+                        continue;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if ((c == '[' || c == '{') && (token_start || st.flow > 0)) {
+            ++st.flow;
+            token_start = true;
+        } else if (st.flow > 0 && (c == ']' || c == '}')) {
+            --st.flow;
+            token_start = false;
+        } else if (st.flow > 0 && c == ',') {
+            token_start = true;
+        } else if (c == ':' && (at_break(p + 1, end) ||
+                                (st.flow > 0 && (p[1] == ',' || p[1] == ']' || p[1] == '}')))) {
+            flags.colon = flags.colon || st.flow == 0;
+            token_start = true;
+        } else {
+            token_start = false;
+        }
+    }
+    return true;
+}
+
+// Collect the entries starting at exactly `indent` within [begin, end).
+// False when a line could confuse the split (see lex_line) or the region
+// contains lines outside the container.
+bool scan_items(const char* data, size_t begin, size_t end, size_t first_line, size_t indent,
+                std::vector<Item>& items) {
+    LexState st;
+    size_t line = first_line;
+    for (size_t pos = begin; pos < end; ++line) {
+        const char* start = data + pos;
+        const char* nl = static_cast<const char*>(std::memchr(start, '\n', end - pos));
+        const char* line_end = nl != nullptr ? nl : data + end;
+        size_t next = nl != nullptr ? static_cast<size_t>(nl - data) + 1 : end;
+
+        const char* p = start;
+        while (p < line_end && *p == ' ') {
+            ++p;
+        }
+        size_t ind = static_cast<size_t>(p - start);
+        bool blank = p == line_end || (*p == '\r' && p + 1 == line_end);
+
+        if (st.block_indent != kNone) {
+            if (blank || ind > st.block_indent) {
+                pos = next;
+                continue;
+            }
+            st.block_indent = kNone;
+        }
+
+        bool clean = st.clean();
+        if (clean) {
+            if (blank || *p == '#') {
+                pos = next;
+                continue;
+            }
+            if (*p == '\t' || ind < indent ||
+                (ind == 0 && (*p == '%' || is_document_marker(p, line_end)))) {
+                return false;
+            }
+        }
+
+        LineFlags flags;
+        if (!lex_line(p, line_end, ind, st, flags)) {
+            return false;
+        }
+        if (clean && ind == indent) {
+            items.push_back(Item{pos, line, flags.dash, !flags.dash && flags.colon && !flags.value});
+        }
+        pos = next;
+    }
+    return st.clean();
+}
+
+// Find the first content line in [pos, end); false if there is none
+bool first_content_line(const char* data, size_t& pos, size_t end, size_t& line, size_t& indent) {
+    while (pos < end) {
+        const char* start = data + pos;
+        const char* nl = static_cast<const char*>(std::memchr(start, '\n', end - pos));
+        const char* line_end = nl != nullptr ? nl : data + end;
+        const char* p = start;
+        while (p < line_end && *p == ' ') {
+            ++p;
+        }
+        if (p < line_end && *p != '#' && *p != '\r') {
+            indent = static_cast<size_t>(p - start);
+            return true;
+        }
+        pos = nl != nullptr ? static_cast<size_t>(nl - data) + 1 : end;
+        ++line;
+    }
+    return false;
+}
+
+class Planner {
+public:
+    Planner(const char* data, size_t target)
+        : data_(data), target_(target) {}
+
+    bool plan_container(size_t begin, size_t end, size_t first_line, size_t indent, bool is_seq,
+                        size_t depth, std::vector<ParallelConverter::Piece>& pieces) {
+        std::vector<Item> items;
+        if (!scan_items(data_, begin, end, first_line, indent, items) || items.empty()) {
+            return false;
+        }
+        if (is_seq) {
+            if (std::any_of(items.begin(), items.end(), [](const Item& item) { return !item.dash; })) {
+                return false;
+            }
+        } else {
+            // "- " lines at a key's own indentation are its compact sequence value
+            if (items.front().dash) {
+                return false;
+            }
+            items.erase(std::remove_if(items.begin(), items.end(), [](const Item& item) { return item.dash; }),
+                        items.end());
+        }
+
+        pieces.push_back(glue(is_seq ? "[" : "{"));
+        bool first = true;
+        size_t chunk_begin = kNone;
+        size_t chunk_line = 0;
+
+        auto separate = [&] {
+            if (!first) {
+                pieces.push_back(glue(","));
+            }
+            first = false;
+        };
+        auto flush = [&](size_t chunk_end) {
+            if (chunk_begin == kNone) {
+                return;
+            }
+            separate();
+            ParallelConverter::Piece piece;
+            piece.begin = chunk_begin;
+            piece.end = chunk_end;
+            piece.line = chunk_line;
+            piece.depth = depth;
+            piece.is_chunk = true;
+            pieces.push_back(piece);
+            chunk_begin = kNone;
+        };
+
+        for (size_t k = 0; k < items.size(); ++k) {
+            size_t item_begin = items[k].offset;
+            size_t item_end = k + 1 < items.size() ? items[k + 1].offset : end;
+
+            if (!is_seq && items[k].bare_key && item_end - item_begin > target_ && depth < kMaxDescent) {
+                std::vector<ParallelConverter::Piece> nested;
+                if (descend(items[k], item_end, depth, nested)) {
+                    flush(item_begin);
+                    separate();
+                    pieces.insert(pieces.end(), nested.begin(), nested.end());
+                    continue;
+                }
+            }
+
+            if (chunk_begin == kNone) {
+                chunk_begin = item_begin;
+                chunk_line = items[k].line;
+            }
+            if (item_end - chunk_begin >= target_) {
+                flush(item_end);
+            }
+        }
+        flush(end);
+
+        pieces.push_back(glue(is_seq ? "]" : "}"));
+        return true;
+    }
+
+private:
+    static ParallelConverter::Piece glue(std::string text) {
+        ParallelConverter::Piece piece;
+        piece.glue = std::move(text);
+        return piece;
+    }
+
+    // Split the block collection under a large "key:" entry
+    bool descend(const Item& item, size_t end, size_t depth, std::vector<ParallelConverter::Piece>& nested) {
+        const char* key_start = data_ + item.offset;
+        const char* nl = static_cast<const char*>(std::memchr(key_start, '\n', end - item.offset));
+        if (nl == nullptr) {
+            return false;
+        }
+        size_t body = static_cast<size_t>(nl - data_) + 1;
+        size_t body_line = item.line + 1;
+        size_t body_indent = 0;
+        size_t content = body;
+        if (!first_content_line(data_, content, end, body_line, body_indent)) {
+            return false;
+        }
+
+        size_t key_indent = 0;
+        while (key_start[key_indent] == ' ') {
+            ++key_indent;
+        }
+        bool body_is_seq = data_[content + body_indent] == '-' &&
+                           at_break(data_ + content + body_indent + 1, data_ + end);
+        if (body_indent < key_indent || (body_indent == key_indent && !body_is_seq)) {
+            return false;
+        }
+
+        std::string key_json;
+        if (!key_to_json(ryml::csubstr(key_start, static_cast<size_t>(nl - key_start)), key_json)) {
+            return false;
+        }
+        nested.push_back(glue(key_json + ": "));
+        return plan_container(content, end, body_line, body_indent, body_is_seq, depth + 1, nested);
+    }
+
+    // JSON string for the key of a "key:" line, exactly as the emitters write it
+    static bool key_to_json(ryml::csubstr line, std::string& json) {
+        try {
+            ryml::Tree tree = ryml::parse_in_arena(line);
+            ryml::id_type root = tree.root_id();
+            if (!tree.is_map(root) || tree.num_children(root) != 1) {
+                return false;
+            }
+            JsonEmitter::append_string(json, tree.key(tree.first_child(root)));
+            return true;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    const char* data_;
+    size_t target_;
+};
+
+[[noreturn]] void rethrow_at_chunk(const ConversionError& e, size_t chunk_line) {
+    ErrorLocation loc = e.location();
+    loc.line += chunk_line - 1;
+    std::string message = format_error_with_location("YAML parsing error", loc.file, loc.line, loc.column) +
+                          ": " + e.detail();
+    throw ConversionError(message, std::move(loc), e.detail());
+}
+
+} // namespace
+
+bool ParallelConverter::plan(const char* yaml_data, size_t yaml_size, size_t threads, std::vector<Piece>& pieces) {
+    if (threads < 2 || yaml_size < kMinParallelBytes) {
+        return false;
+    }
+
+    // Root: the first content line, after an optional bare "---"
+    size_t begin = 0;
+    size_t line = 1;
+    size_t indent = 0;
+    if (!first_content_line(yaml_data, begin, yaml_size, line, indent)) {
+        return false;
+    }
+    const char* root = yaml_data + begin + indent;
+    const char* end = yaml_data + yaml_size;
+    if (indent == 0 && end - root >= 3 && std::memcmp(root, "---", 3) == 0) {
+        const char* p = root + 3;
+        while (p < end && (*p == ' ' || *p == '\r')) {
+            ++p;
+        }
+        if (p < end && *p != '\n' && *p != '#') {
+            return false;  // content on the document start line
+        }
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (nl == nullptr) {
+            return false;
+        }
+        begin = static_cast<size_t>(nl - yaml_data) + 1;
+        ++line;
+        if (!first_content_line(yaml_data, begin, yaml_size, line, indent)) {
+            return false;
+        }
+        root = yaml_data + begin + indent;
+    }
+    if (*root == '[' || *root == '{') {
+        return false;
+    }
+    bool is_seq = *root == '-' && at_break(root + 1, end);
+
+    size_t target = std::max(kMinChunkBytes, yaml_size / (threads * kChunksPerThread));
+    Planner planner(yaml_data, target);
+    pieces.clear();
+    if (!planner.plan_container(begin, yaml_size, line, indent, is_seq, 0, pieces)) {
+        return false;
+    }
+    return std::count_if(pieces.begin(), pieces.end(), [](const Piece& piece) { return piece.is_chunk; }) >= 2;
+}
+
+bool ParallelConverter::try_convert(char* yaml_data, size_t yaml_size, const std::string& filename,
+                                    const ConversionOptions& options, std::string& json) {
+    size_t threads = options.threads == 0 ? ThreadPool::default_threads() : options.threads;
+    std::vector<Piece> pieces;
+    // Sorting keys, finding duplicates and schema checks need every entry of
+    // a map at once, chunks only see some of them
+    if (options.format != OutputFormat::Json || options.canonical ||
+        options.duplicate_keys != DuplicateKeys::Keep || options.schema || !plan(yaml_data, yaml_size, threads, pieces)) {
+        return false;
+    }
+
+    std::vector<size_t> chunks;
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        if (pieces[i].is_chunk) {
+            chunks.push_back(i);
+        }
+    }
+
+    // Chunks are disjoint, so each is parsed in place like a whole document would be
+    const ConversionLimits& limits = options.limits;
+    std::vector<std::string> results(pieces.size());
+    std::vector<std::exception_ptr> errors(chunks.size());
+    std::atomic<size_t> total_nodes{0};
+    std::atomic<size_t> total_arena{0};
+
+    auto convert_chunk = [&](size_t c) {
+        const Piece& piece = pieces[chunks[c]];
+        TraceSpan span("chunk", filename, piece.line);
+        try {
+            ConversionOptions chunk_options = options;
+            if (limits.max_depth > 0) {
+                if (limits.max_depth <= piece.depth) {
+                    throw LimitExceededError("Nesting depth limit exceeded: more than " +
+                                             std::to_string(limits.max_depth) + " levels");
+                }
+                chunk_options.limits.max_depth -= piece.depth;
+            }
+
+            ryml::Tree tree;
+            try {
+                tree = YamlToJsonConverter::parse_yaml(yaml_data + piece.begin, piece.end - piece.begin, filename);
+            } catch (const LimitExceededError&) {
+                throw;
+            } catch (const ConversionError& e) {
+                if (e.location().line == 0) {
+                    throw;
+                }
+                rethrow_at_chunk(e, piece.line);
+            }
+
+            size_t nodes = total_nodes += static_cast<size_t>(tree.size());
+            size_t arena = total_arena += tree.arena_size();
+            if (limits.max_nodes > 0 && nodes > limits.max_nodes) {
+                throw LimitExceededError("Node limit exceeded: more than " +
+                                         std::to_string(limits.max_nodes) + " nodes parsed");
+            }
+            if (limits.max_arena_bytes > 0 && arena > limits.max_arena_bytes) {
+                throw LimitExceededError("Arena limit exceeded: more than " +
+                                         std::to_string(limits.max_arena_bytes) + " bytes used");
+            }
+
+            std::string chunk_json = YamlToJsonConverter::emit(tree, chunk_options);
+            char open = chunk_json.empty() ? 0 : chunk_json.front();
+            char close = chunk_json.empty() ? 0 : chunk_json.back();
+            if (!((open == '[' && close == ']') || (open == '{' && close == '}')) || chunk_json.size() < 3) {
+                throw ConversionError("Internal error: chunk at line " + std::to_string(piece.line) +
+                                      " did not convert to a collection");
+            }
+            results[chunks[c]] = std::move(chunk_json);
+        } catch (...) {
+            errors[c] = std::current_exception();
+        }
+    };
+
+    if (chunks.size() > 1 && threads > 1) {
+        ThreadPool pool(std::min(threads, chunks.size()) - 1);
+        pool.parallel_for(chunks.size(), convert_chunk);
+    } else {
+        for (size_t c = 0; c < chunks.size(); ++c) {
+            convert_chunk(c);
+        }
+    }
+
+    // Report the error a serial parse would have hit first
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        total += pieces[i].is_chunk ? results[i].size() - 2 : pieces[i].glue.size();
+    }
+    if (limits.max_output_bytes > 0 && total > limits.max_output_bytes) {
+        throw LimitExceededError("Output size limit exceeded: more than " +
+                                 std::to_string(limits.max_output_bytes) + " bytes");
+    }
+
+    json.clear();
+    json.reserve(total);
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        if (pieces[i].is_chunk) {
+            json.append(results[i], 1, results[i].size() - 2);
+        } else {
+            json.append(pieces[i].glue);
+        }
+    }
+    return true;
+}
+
+} // namespace yaml2json
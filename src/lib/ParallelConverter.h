@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "ConversionOptions.h"
+
+namespace yaml2json {
+
+// Speculative parallel conversion of one large YAML document. The document is
+// split at lines that start an entry of a block sequence or mapping (at the
+// root, or inside large entries of a root mapping), the chunks are parsed and
+// emitted concurrently as independent documents, and their JSON is stitched
+// back together in order. Splitting is only attempted when a conservative scan
+// proves it safe: no anchors/aliases/merge keys, no directives or document
+// markers, and no split inside a quoted scalar, block scalar or flow collection.
+class ParallelConverter {
+public:
+    // A chunk's JSON with the container brackets removed, or a literal glue string
+    struct Piece {
+        std::string glue;
+        size_t begin = 0;       // chunk byte range in the source
+        size_t end = 0;
+        size_t line = 0;        // 1-based source line of the chunk start
+        size_t depth = 0;       // containers enclosing the chunk's container
+        bool is_chunk = false;
+    };
+
+    // Split the document into pieces; false when a split is unsafe or not worthwhile
+    static bool plan(const char* yaml_data, size_t yaml_size, size_t threads, std::vector<Piece>& pieces);
+
+    // Convert to JSON on `threads` threads (0 = all cores); returns false, with
+    // the input untouched, when the document has to be converted serially
+    static bool try_convert(char* yaml_data, size_t yaml_size, const std::string& filename,
+                            const ConversionOptions& options, std::string& json);
+};
+
+} // namespace yaml2json
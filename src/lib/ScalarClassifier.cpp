@@ -0,0 +1,483 @@
+#include "ScalarClassifier.h"
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace yaml2json {
+
+namespace {
+
+bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+bool equals_any(ryml::csubstr s, const char* a, const char* b, const char* c) {
+    return s == ryml::to_csubstr(a) || s == ryml::to_csubstr(b) || s == ryml::to_csubstr(c);
+}
+
+// What the first byte of a plain scalar allows it to be. Most strings are
+// rejected by this single lookup before any comparison is made
+enum FirstByte : uint8_t {
+    kString = 0,
+    kNumber,     // digit, sign or '.'
+    kNull,       // '~', 'n', 'N' (also YAML 1.1 "n"/"no")
+    kBool,       // 't', 'T', 'f', 'F'
+    kYaml11Bool  // 'y', 'Y', 'o', 'O'
+};
+
+constexpr std::array<uint8_t, 256> make_first_byte_table() {
+    std::array<uint8_t, 256> table{};
+    for (char c = '0'; c <= '9'; ++c) {
+        table[static_cast<unsigned char>(c)] = kNumber;
+    }
+    table['-'] = table['+'] = table['.'] = kNumber;
+    table['~'] = table['n'] = table['N'] = kNull;
+    table['t'] = table['T'] = table['f'] = table['F'] = kBool;
+    table['y'] = table['Y'] = table['o'] = table['O'] = kYaml11Bool;
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> kFirstByte = make_first_byte_table();
+
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_WIN32)
+#define YAML2JSON_SWAR_DIGITS 1
+#endif
+
+// Eight ASCII digits checked and converted per step (SWAR: plain 64-bit
+// arithmetic, no SIMD instructions needed)
+bool is_eight_digits(uint64_t chunk) {
+    return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+            (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+}
+
+#ifdef YAML2JSON_SWAR_DIGITS
+uint32_t eight_digits_value(uint64_t chunk) {
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 100 + (1000000ULL << 32);
+    const uint64_t mul2 = 1 + (10000ULL << 32);
+    chunk -= 0x3030303030303030ULL;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+    return static_cast<uint32_t>(chunk);
+}
+#endif
+
+bool all_digits(ryml::csubstr s) {
+    if (s.empty()) {
+        return false;
+    }
+    size_t i = 0;
+    for (; i + 8 <= s.len; i += 8) {
+        uint64_t chunk;
+        std::memcpy(&chunk, s.str + i, 8);
+        if (!is_eight_digits(chunk)) {
+            return false;
+        }
+    }
+    for (; i < s.len; ++i) {
+        if (!is_digit(s.str[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Accumulate digits in the given base; false on an invalid digit or 64-bit overflow
+bool parse_magnitude(ryml::csubstr digits, unsigned base, uint64_t& out) {
+    if (digits.empty()) {
+        return false;
+    }
+    uint64_t value = 0;
+    for (char c : digits) {
+        unsigned d;
+        if (is_digit(c)) {
+            d = static_cast<unsigned>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            d = static_cast<unsigned>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            d = static_cast<unsigned>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        if (d >= base) {
+            return false;
+        }
+        if (value > (std::numeric_limits<uint64_t>::max() - d) / base) {
+            return false;
+        }
+        value = value * base + d;
+    }
+    out = value;
+    return true;
+}
+
+// Decimal digits only (checked by the caller); false on 64-bit overflow
+bool parse_decimal(ryml::csubstr digits, uint64_t& out) {
+    // Up to 19 digits always fit; longer runs take the checked path
+    if (digits.len > 19) {
+        return parse_magnitude(digits, 10, out);
+    }
+    uint64_t value = 0;
+    size_t i = 0;
+#ifdef YAML2JSON_SWAR_DIGITS
+    for (; i + 8 <= digits.len; i += 8) {
+        uint64_t chunk;
+        std::memcpy(&chunk, digits.str + i, 8);
+        value = value * 100000000 + eight_digits_value(chunk);
+    }
+#endif
+    for (; i < digits.len; ++i) {
+        value = value * 10 + static_cast<uint64_t>(digits.str[i] - '0');
+    }
+    out = value;
+    return true;
+}
+
+// [-+]? ( \. [0-9]+ | [0-9]+ ( \. [0-9]* )? ) ( [eE] [-+]? [0-9]+ )?
+bool is_core_float(ryml::csubstr s) {
+    size_t i = 0;
+    if (i < s.len && (s.str[i] == '-' || s.str[i] == '+')) {
+        ++i;
+    }
+    size_t int_digits = 0;
+    while (i < s.len && is_digit(s.str[i])) {
+        ++i;
+        ++int_digits;
+    }
+    size_t frac_digits = 0;
+    if (i < s.len && s.str[i] == '.') {
+        ++i;
+        while (i < s.len && is_digit(s.str[i])) {
+            ++i;
+            ++frac_digits;
+        }
+    }
+    if (int_digits == 0 && frac_digits == 0) {
+        return false;
+    }
+    if (i < s.len && (s.str[i] == 'e' || s.str[i] == 'E')) {
+        ++i;
+        if (i < s.len && (s.str[i] == '-' || s.str[i] == '+')) {
+            ++i;
+        }
+        size_t exp_digits = 0;
+        while (i < s.len && is_digit(s.str[i])) {
+            ++i;
+            ++exp_digits;
+        }
+        if (exp_digits == 0) {
+            return false;
+        }
+    }
+    return i == s.len;
+}
+
+double parse_double(ryml::csubstr s) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    // from_chars rejects a leading '+'; it never allocates or consults the locale
+    ryml::csubstr text = s.begins_with('+') ? s.sub(1) : s;
+    double value = 0.0;
+    auto result = std::from_chars(text.str, text.str + text.len, value);
+    if (result.ec == std::errc() && result.ptr == text.str + text.len) {
+        return value;
+    }
+    // Out of range: strtod saturates to infinity or rounds to zero
+#endif
+    char buf[64];
+    if (s.len < sizeof(buf)) {
+        std::memcpy(buf, s.str, s.len);
+        buf[s.len] = '\0';
+        return std::strtod(buf, nullptr);
+    }
+    std::string copy(s.str, s.len);
+    return std::strtod(copy.c_str(), nullptr);
+}
+
+ScalarValue null_value() {
+    ScalarValue v;
+    v.type = ScalarType::Null;
+    return v;
+}
+
+ScalarValue bool_value(bool b) {
+    ScalarValue v;
+    v.type = ScalarType::Bool;
+    v.boolean = b;
+    return v;
+}
+
+// Special floats: [-+]?.inf and .nan (sign not allowed on nan)
+bool decode_special_float(ryml::csubstr s, ScalarValue& v) {
+    char first = s.str[0];
+    ryml::csubstr unsigned_part = (first == '-' || first == '+') ? s.sub(1) : s;
+    if (equals_any(unsigned_part, ".inf", ".Inf", ".INF")) {
+        v.type = ScalarType::Float;
+        v.number = first == '-' ? -std::numeric_limits<double>::infinity()
+                                : std::numeric_limits<double>::infinity();
+        return true;
+    }
+    if (unsigned_part.str == s.str && equals_any(s, ".nan", ".NaN", ".NAN")) {
+        v.type = ScalarType::Float;
+        v.number = std::numeric_limits<double>::quiet_NaN();
+        return true;
+    }
+    return false;
+}
+
+ScalarValue decode_core_number(ryml::csubstr s) {
+    ScalarValue v;
+    char first = s.str[0];
+    if (decode_special_float(s, v)) {
+        return v;
+    }
+
+    // Hexadecimal and octal integers (unsigned in the core schema)
+    if (s.len > 2 && first == '0' && (s.str[1] == 'x' || s.str[1] == 'o')) {
+        if (parse_magnitude(s.sub(2), s.str[1] == 'x' ? 16 : 8, v.magnitude)) {
+            v.type = ScalarType::Int;
+        }
+        return v;
+    }
+
+    // Decimal integers
+    bool negative = first == '-';
+    ryml::csubstr digits = (first == '-' || first == '+') ? s.sub(1) : s;
+    if (all_digits(digits)) {
+        if (parse_decimal(digits, v.magnitude)) {
+            v.type = ScalarType::Int;
+            v.negative = negative && v.magnitude != 0;
+        } else {
+            v.type = ScalarType::Float;
+            v.number = parse_double(s);
+        }
+        return v;
+    }
+
+    if (is_core_float(s)) {
+        v.type = ScalarType::Float;
+        v.number = parse_double(s);
+    }
+    return v;
+}
+
+// YAML 1.1 (tag:yaml.org,2002:int/float): signed 0b/0x/0 octal integers and
+// '_' digit separators; floats need a '.'. Sexagesimal (1:30) stays a string
+ScalarValue decode_yaml11_number(ryml::csubstr s) {
+    ScalarValue v;
+    if (decode_special_float(s, v)) {
+        return v;
+    }
+
+    char first = s.str[0];
+    bool negative = first == '-';
+    ryml::csubstr body = (first == '-' || first == '+') ? s.sub(1) : s;
+    if (body.empty() || body.begins_with('_')) {
+        return v;
+    }
+
+    // Drop separators into a small buffer; very long numbers are not worth it
+    char buf[80];
+    if (body.find('_') != ryml::csubstr::npos) {
+        if (body.len >= sizeof(buf) - 1) {
+            return v;
+        }
+        size_t n = 0;
+        if (negative) {
+            buf[n++] = '-';
+        }
+        for (char c : body) {
+            if (c != '_') {
+                buf[n++] = c;
+            }
+        }
+        ryml::csubstr cleaned(buf + (negative ? 1 : 0), n - (negative ? 1 : 0));
+        if (cleaned.empty()) {
+            return v;
+        }
+        body = cleaned;
+        s = ryml::csubstr(buf, n);
+    }
+
+    unsigned base = 0;
+    ryml::csubstr digits;
+    if (body.len > 2 && body.str[0] == '0' && (body.str[1] == 'b' || body.str[1] == 'x')) {
+        base = body.str[1] == 'b' ? 2 : 16;
+        digits = body.sub(2);
+    } else if (body.len > 1 && body.str[0] == '0' && all_digits(body)) {
+        base = 8;
+        digits = body.sub(1);
+    }
+    if (base != 0) {
+        if (parse_magnitude(digits, base, v.magnitude)) {
+            v.type = ScalarType::Int;
+            v.negative = negative && v.magnitude != 0;
+        }
+        return v;
+    }
+
+    if (all_digits(body)) {
+        if (parse_decimal(body, v.magnitude)) {
+            v.type = ScalarType::Int;
+            v.negative = negative && v.magnitude != 0;
+        } else {
+            v.type = ScalarType::Float;
+            v.number = parse_double(s);
+        }
+        return v;
+    }
+
+    if (body.find('.') != ryml::csubstr::npos && is_core_float(s)) {
+        v.type = ScalarType::Float;
+        v.number = parse_double(s);
+    }
+    return v;
+}
+
+bool is_yaml11_bool(ryml::csubstr s, bool& value) {
+    switch (s.len) {
+        case 1:
+            if (s == "y" || s == "Y") { value = true; return true; }
+            if (s == "n" || s == "N") { value = false; return true; }
+            return false;
+        case 2:
+            if (equals_any(s, "on", "On", "ON")) { value = true; return true; }
+            if (equals_any(s, "no", "No", "NO")) { value = false; return true; }
+            return false;
+        case 3:
+            if (equals_any(s, "yes", "Yes", "YES")) { value = true; return true; }
+            if (equals_any(s, "off", "Off", "OFF")) { value = false; return true; }
+            return false;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+ScalarType ScalarClassifier::classify(ryml::csubstr scalar) {
+    return decode(scalar).type;
+}
+
+ScalarValue ScalarClassifier::decode(ryml::csubstr s) {
+    return decode(s, ScalarTyping::Core);
+}
+
+ScalarValue ScalarClassifier::decode(ryml::csubstr s, ScalarTyping typing) {
+    if (s.len == 0) {
+        return null_value();
+    }
+
+    bool yaml11 = typing == ScalarTyping::Yaml11;
+    switch (kFirstByte[static_cast<unsigned char>(s.str[0])]) {
+        case kNumber:
+            return yaml11 ? decode_yaml11_number(s) : decode_core_number(s);
+        case kNull:
+            if (s == "~" || equals_any(s, "null", "Null", "NULL")) {
+                return null_value();
+            }
+            break;
+        case kBool:
+            if (equals_any(s, "true", "True", "TRUE")) {
+                return bool_value(true);
+            }
+            if (equals_any(s, "false", "False", "FALSE")) {
+                return bool_value(false);
+            }
+            return ScalarValue{};
+        case kYaml11Bool:
+            break;
+        default:
+            return ScalarValue{};
+    }
+
+    bool value = false;
+    if (yaml11 && is_yaml11_bool(s, value)) {
+        return bool_value(value);
+    }
+    return ScalarValue{};
+}
+
+bool ScalarClassifier::is_json_number(ryml::csubstr s) {
+    // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    size_t i = 0;
+    if (i < s.len && s.str[i] == '-') {
+        ++i;
+    }
+    if (i >= s.len || !is_digit(s.str[i])) {
+        return false;
+    }
+    if (s.str[i] == '0') {
+        ++i;
+    } else {
+        while (i < s.len && is_digit(s.str[i])) {
+            ++i;
+        }
+    }
+    if (i < s.len && s.str[i] == '.') {
+        size_t start = ++i;
+        while (i < s.len && is_digit(s.str[i])) {
+            ++i;
+        }
+        if (i == start) {
+            return false;
+        }
+    }
+    if (i < s.len && (s.str[i] == 'e' || s.str[i] == 'E')) {
+        ++i;
+        if (i < s.len && (s.str[i] == '+' || s.str[i] == '-')) {
+            ++i;
+        }
+        size_t start = i;
+        while (i < s.len && is_digit(s.str[i])) {
+            ++i;
+        }
+        if (i == start) {
+            return false;
+        }
+    }
+    return i == s.len;
+}
+
+size_t ScalarClassifier::format_number(const ScalarValue& value, char* buf, size_t size) {
+    if (value.type == ScalarType::Int) {
+        char* p = buf;
+        if (value.negative) {
+            *p++ = '-';
+        }
+        auto result = std::to_chars(p, buf + size, value.magnitude);
+        return result.ec == std::errc() ? static_cast<size_t>(result.ptr - buf) : 0;
+    }
+    if (value.type != ScalarType::Float || !std::isfinite(value.number)) {
+        return 0;
+    }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    // Shortest text that parses back to the same double
+    auto result = std::to_chars(buf, buf + size, value.number);
+    return result.ec == std::errc() ? static_cast<size_t>(result.ptr - buf) : 0;
+#else
+    int n = std::snprintf(buf, size, "%.17g", value.number);
+    return n > 0 && static_cast<size_t>(n) < size ? static_cast<size_t>(n) : 0;
+#endif
+}
+
+ScalarValue ScalarClassifier::decode_node(const ryml::Tree& tree, ryml::id_type node) {
+    return decode_node(tree, node, ScalarTyping::Core);
+}
+
+ScalarValue ScalarClassifier::decode_node(const ryml::Tree& tree, ryml::id_type node, ScalarTyping typing) {
+    if (!tree.has_val(node) || tree.val_is_null(node)) {
+        ScalarValue v;
+        v.type = tree.is_val_quoted(node) ? ScalarType::String : ScalarType::Null;
+        return v;
+    }
+    if (tree.is_val_quoted(node) ||
+        (tree.has_val_tag(node) && tree.val_tag(node) == "!!str")) {
+        return ScalarValue{};
+    }
+    return decode(tree.val(node), typing);
+}
+
+} // namespace yaml2json
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <ryml.hpp>
+#include "ConversionOptions.h"
+
+namespace yaml2json {
+
+// Type of a plain YAML scalar under the YAML 1.2 core schema
+enum class ScalarType {
+    String,
+    Null,
+    Bool,
+    Int,
+    Float
+};
+
+// Classification result with the decoded value for non-string types
+struct ScalarValue {
+    ScalarType type = ScalarType::String;
+    bool boolean = false;    // Bool
+    bool negative = false;   // Int: value is -magnitude
+    uint64_t magnitude = 0;  // Int: absolute value
+    double number = 0.0;     // Float
+};
+
+// Plain scalar classifier shared by the typed emitters
+class ScalarClassifier {
+public:
+    // Classify a plain scalar (integers that overflow 64 bits classify as Float)
+    static ScalarType classify(ryml::csubstr scalar);
+
+    // Classify a plain scalar and decode its value
+    static ScalarValue decode(ryml::csubstr scalar);
+
+    // Classify and decode under the given typing (Json decodes like Core).
+    // The first byte rules out most strings with one table lookup, and
+    // decimal digits are checked and converted eight at a time
+    static ScalarValue decode(ryml::csubstr scalar, ScalarTyping typing);
+
+    // Check whether a scalar is already a valid JSON number literal
+    static bool is_json_number(ryml::csubstr scalar);
+
+    // Write an Int or finite Float as a JSON number (shortest round-trip form
+    // for floats); returns the length, or 0 if the value has no JSON number form
+    static size_t format_number(const ScalarValue& value, char* buf, size_t size);
+
+    // Decode a node's value; quoted, block and !!str-tagged scalars are strings
+    static ScalarValue decode_node(const ryml::Tree& tree, ryml::id_type node);
+    static ScalarValue decode_node(const ryml::Tree& tree, ryml::id_type node, ScalarTyping typing);
+};
+
+} // namespace yaml2json
@@ -0,0 +1,351 @@
+#include "SimdKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+// x86-64 always has SSE2; the wider variants are compiled with per-function
+// target attributes (GCC and Clang) so the rest of the build stays generic
+#if defined(__x86_64__) || defined(_M_X64)
+    #define YAML2JSON_KERNELS_SSE2 1
+    #include <emmintrin.h>
+    #if defined(__GNUC__)
+        #define YAML2JSON_KERNELS_AVX 1
+        #include <immintrin.h>
+    #endif
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+    #define YAML2JSON_KERNELS_NEON 1
+    #include <arm_neon.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+namespace yaml2json {
+
+namespace {
+
+// Below one vector the plain loop wins over an indirect call
+constexpr size_t kMinVectorBytes = 16;
+
+inline bool is_escaped(unsigned char c) {
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+size_t find_escape_scalar(const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        if (is_escaped(static_cast<unsigned char>(data[i]))) {
+            return i;
+        }
+    }
+    return size;
+}
+
+size_t count_newlines_scalar(const char* data, size_t size) {
+    return static_cast<size_t>(std::count(data, data + size, '\n'));
+}
+
+#if defined(YAML2JSON_KERNELS_SSE2) || defined(YAML2JSON_KERNELS_AVX)
+inline unsigned lowest_bit(uint32_t mask) {
+    #if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+    #else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+    #endif
+}
+#endif
+
+#ifdef YAML2JSON_KERNELS_SSE2
+// Bytes to escape: v <= 0x1f (unsigned, via min), '"' or '\\'
+inline uint32_t escape_mask_sse2(__m128i v) {
+    __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1f)), v);
+    __m128i quote = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+    __m128i backslash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(control, _mm_or_si128(quote, backslash))));
+}
+
+size_t find_escape_sse2(const char* data, size_t size) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        uint32_t mask = escape_mask_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+        if (mask != 0) {
+            return i + lowest_bit(mask);
+        }
+    }
+    return i + find_escape_scalar(data + i, size - i);
+}
+
+// Byte counters step by one per match (a match is -1); they are summed with
+// SAD before any of them can wrap
+size_t count_newlines_sse2(const char* data, size_t size) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    size_t total = 0;
+    size_t i = 0;
+    while (i + 16 <= size) {
+        __m128i counters = _mm_setzero_si128();
+        for (size_t block = 0; block < 255 && i + 16 <= size; ++block, i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(v, newline));
+        }
+        __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+        total += static_cast<size_t>(_mm_cvtsi128_si32(sums)) +
+                 static_cast<size_t>(_mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+    }
+    return total + count_newlines_scalar(data + i, size - i);
+}
+#endif
+
+#ifdef YAML2JSON_KERNELS_AVX
+__attribute__((target("avx2"))) size_t find_escape_avx2(const char* data, size_t size) {
+    const __m256i control_max = _mm256_set1_epi8(0x1f);
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(v, control_max), v),
+                                       _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+        if (mask != 0) {
+            return i + lowest_bit(mask);
+        }
+    }
+    return i + find_escape_sse2(data + i, size - i);
+}
+
+__attribute__((target("avx2"))) size_t count_newlines_avx2(const char* data, size_t size) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    size_t total = 0;
+    size_t i = 0;
+    while (i + 32 <= size) {
+        __m256i counters = _mm256_setzero_si256();
+        for (size_t block = 0; block < 255 && i + 32 <= size; ++block, i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            counters = _mm256_sub_epi8(counters, _mm256_cmpeq_epi8(v, newline));
+        }
+        __m256i sums = _mm256_sad_epu8(counters, _mm256_setzero_si256());
+        total += static_cast<size_t>(_mm256_extract_epi64(sums, 0)) + static_cast<size_t>(_mm256_extract_epi64(sums, 1)) +
+                 static_cast<size_t>(_mm256_extract_epi64(sums, 2)) + static_cast<size_t>(_mm256_extract_epi64(sums, 3));
+    }
+    return total + count_newlines_sse2(data + i, size - i);
+}
+
+// Masked loads cover the tail: bytes past the end are neither read nor matched
+__attribute__((target("avx512f,avx512bw"))) size_t find_escape_avx512(const char* data, size_t size) {
+    const __m512i control_end = _mm512_set1_epi8(0x20);
+    const __m512i quote = _mm512_set1_epi8('"');
+    const __m512i backslash = _mm512_set1_epi8('\\');
+    for (size_t i = 0; i < size; i += 64) {
+        size_t left = size - i;
+        __mmask64 valid = left >= 64 ? ~__mmask64{0} : (__mmask64{1} << left) - 1;
+        __m512i v = _mm512_maskz_loadu_epi8(valid, data + i);
+        __mmask64 hits = (_mm512_cmplt_epu8_mask(v, control_end) | _mm512_cmpeq_epi8_mask(v, quote) |
+                          _mm512_cmpeq_epi8_mask(v, backslash)) & valid;
+        if (hits != 0) {
+            return i + static_cast<size_t>(__builtin_ctzll(hits));
+        }
+    }
+    return size;
+}
+
+__attribute__((target("avx512f,avx512bw,popcnt"))) size_t count_newlines_avx512(const char* data, size_t size) {
+    const __m512i newline = _mm512_set1_epi8('\n');
+    size_t total = 0;
+    for (size_t i = 0; i < size; i += 64) {
+        size_t left = size - i;
+        __mmask64 valid = left >= 64 ? ~__mmask64{0} : (__mmask64{1} << left) - 1;
+        __m512i v = _mm512_maskz_loadu_epi8(valid, data + i);
+        total += static_cast<size_t>(__builtin_popcountll(_mm512_mask_cmpeq_epi8_mask(valid, v, newline)));
+    }
+    return total;
+}
+#endif
+
+#ifdef YAML2JSON_KERNELS_NEON
+// NEON has no movemask: find the block with a hit, then the byte in it
+size_t find_escape_neon(const char* data, size_t size) {
+    const uint8x16_t control_end = vdupq_n_u8(0x20);
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+        uint8x16_t hits = vorrq_u8(vcltq_u8(v, control_end), vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, backslash)));
+        if (vmaxvq_u8(hits) != 0) {
+            return i + find_escape_scalar(data + i, 16);
+        }
+    }
+    return i + find_escape_scalar(data + i, size - i);
+}
+
+size_t count_newlines_neon(const char* data, size_t size) {
+    const uint8x16_t newline = vdupq_n_u8('\n');
+    size_t total = 0;
+    size_t i = 0;
+    while (i + 16 <= size) {
+        uint8x16_t counters = vdupq_n_u8(0);
+        for (size_t block = 0; block < 255 && i + 16 <= size; ++block, i += 16) {
+            uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+            counters = vsubq_u8(counters, vceqq_u8(v, newline));
+        }
+        total += vaddlvq_u8(counters);
+    }
+    return total + count_newlines_scalar(data + i, size - i);
+}
+#endif
+
+struct KernelTable {
+    KernelVariant variant;
+    size_t (*find_escape)(const char*, size_t);
+    size_t (*count_newlines)(const char*, size_t);
+};
+
+constexpr KernelTable kScalar{KernelVariant::Scalar, find_escape_scalar, count_newlines_scalar};
+#ifdef YAML2JSON_KERNELS_SSE2
+constexpr KernelTable kSse2{KernelVariant::Sse2, find_escape_sse2, count_newlines_sse2};
+#endif
+#ifdef YAML2JSON_KERNELS_AVX
+constexpr KernelTable kAvx2{KernelVariant::Avx2, find_escape_avx2, count_newlines_avx2};
+constexpr KernelTable kAvx512{KernelVariant::Avx512, find_escape_avx512, count_newlines_avx512};
+#endif
+#ifdef YAML2JSON_KERNELS_NEON
+constexpr KernelTable kNeon{KernelVariant::Neon, find_escape_neon, count_newlines_neon};
+#endif
+
+// Kernels of a variant, or null if it is not built in or the CPU lacks it
+const KernelTable* table_for(KernelVariant variant) {
+    switch (variant) {
+        case KernelVariant::Scalar:
+            return &kScalar;
+        case KernelVariant::Sse2:
+#ifdef YAML2JSON_KERNELS_SSE2
+            return &kSse2;
+#else
+            return nullptr;
+#endif
+        case KernelVariant::Avx2:
+#ifdef YAML2JSON_KERNELS_AVX
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? &kAvx2 : nullptr;
+#else
+            return nullptr;
+#endif
+        case KernelVariant::Avx512:
+#ifdef YAML2JSON_KERNELS_AVX
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                           __builtin_cpu_supports("popcnt")
+                       ? &kAvx512
+                       : nullptr;
+#else
+            return nullptr;
+#endif
+        case KernelVariant::Neon:
+#ifdef YAML2JSON_KERNELS_NEON
+            return &kNeon;
+#else
+            return nullptr;
+#endif
+    }
+    return nullptr;
+}
+
+constexpr KernelVariant kAllVariants[] = {KernelVariant::Scalar, KernelVariant::Sse2, KernelVariant::Neon,
+                                          KernelVariant::Avx2, KernelVariant::Avx512};
+
+// YAML2JSON_KERNELS if set and runnable, else the fastest variant
+const KernelTable* startup_table() {
+    const char* forced = std::getenv("YAML2JSON_KERNELS");
+    KernelVariant variant;
+    if (forced != nullptr && SimdKernels::parse(forced, variant)) {
+        if (const KernelTable* table = table_for(variant)) {
+            return table;
+        }
+    }
+    const KernelTable* best = &kScalar;
+    for (KernelVariant candidate : kAllVariants) {
+        if (const KernelTable* table = table_for(candidate)) {
+            best = table;
+        }
+    }
+    return best;
+}
+
+std::atomic<const KernelTable*> g_active{nullptr};
+
+const KernelTable& kernels() {
+    const KernelTable* table = g_active.load(std::memory_order_acquire);
+    if (table == nullptr) {
+        // A concurrent select() wins over start-up detection
+        const KernelTable* detected = startup_table();
+        if (g_active.compare_exchange_strong(table, detected, std::memory_order_acq_rel)) {
+            table = detected;
+        }
+    }
+    return *table;
+}
+
+} // namespace
+
+size_t SimdKernels::find_escape(const char* data, size_t size) {
+    if (size < kMinVectorBytes) {
+        return find_escape_scalar(data, size);
+    }
+    return kernels().find_escape(data, size);
+}
+
+size_t SimdKernels::count_newlines(const char* data, size_t size) {
+    if (size < kMinVectorBytes) {
+        return count_newlines_scalar(data, size);
+    }
+    return kernels().count_newlines(data, size);
+}
+
+KernelVariant SimdKernels::active() {
+    return kernels().variant;
+}
+
+std::vector<KernelVariant> SimdKernels::supported() {
+    std::vector<KernelVariant> variants;
+    for (KernelVariant variant : kAllVariants) {
+        if (table_for(variant) != nullptr) {
+            variants.push_back(variant);
+        }
+    }
+    return variants;
+}
+
+bool SimdKernels::select(KernelVariant variant) {
+    const KernelTable* table = table_for(variant);
+    if (table == nullptr) {
+        return false;
+    }
+    g_active.store(table, std::memory_order_release);
+    return true;
+}
+
+const char* SimdKernels::name(KernelVariant variant) {
+    switch (variant) {
+        case KernelVariant::Scalar: return "scalar";
+        case KernelVariant::Sse2: return "sse2";
+        case KernelVariant::Avx2: return "avx2";
+        case KernelVariant::Avx512: return "avx512";
+        case KernelVariant::Neon: return "neon";
+    }
+    return "unknown";
+}
+
+bool SimdKernels::parse(const std::string& name, KernelVariant& variant) {
+    for (KernelVariant candidate : kAllVariants) {
+        if (name == SimdKernels::name(candidate)) {
+            variant = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace yaml2json
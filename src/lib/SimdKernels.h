@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace yaml2json {
+
+// Instruction set a kernel variant is written for
+enum class KernelVariant {
+    Scalar,  // portable C++, any CPU
+    Sse2,    // x86-64 baseline
+    Avx2,
+    Avx512,  // AVX-512 BW
+    Neon     // aarch64
+};
+
+// Byte-scanning kernels on the conversion hot path, each built for several
+// instruction sets in a portable binary. The best variant the CPU supports is
+// picked on first use; the YAML2JSON_KERNELS environment variable ("scalar",
+// "sse2", "avx2", "avx512", "neon") overrides that when the CPU supports it.
+class SimdKernels {
+public:
+    // Offset of the first byte a JSON string must escape (a control
+    // character, '"' or '\\'), or size if there is none
+    static size_t find_escape(const char* data, size_t size);
+
+    // Number of '\n' bytes in the buffer
+    static size_t count_newlines(const char* data, size_t size);
+
+    // Variant in use
+    static KernelVariant active();
+
+    // Variants this CPU can run, from the most portable to the fastest
+    static std::vector<KernelVariant> supported();
+
+    // Switch every kernel to a variant; false (and no change) if the CPU cannot run it
+    static bool select(KernelVariant variant);
+
+    // Lowercase name as accepted by YAML2JSON_KERNELS
+    static const char* name(KernelVariant variant);
+
+    // Inverse of name(); false on an unknown name
+    static bool parse(const std::string& name, KernelVariant& variant);
+};
+
+} // namespace yaml2json
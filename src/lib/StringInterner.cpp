@@ -0,0 +1,91 @@
+#include "StringInterner.h"
+#include "JsonEmitter.h"
+#include <cstring>
+
+namespace yaml2json {
+
+namespace {
+
+constexpr size_t kInitialSlots = 1024;
+
+} // namespace
+
+StringInterner::StringInterner() : slots_(kInitialSlots) {}
+
+uint64_t StringInterner::hash(const char* data, size_t size) {
+    // Eight bytes per multiply: keys are short, so this beats byte-wise hashing
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = (h ^ word) * 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 31;
+    }
+    if (i < size) {
+        uint64_t word = 0;
+        std::memcpy(&word, data + i, size - i);
+        h = (h ^ word) * 0x94d049bb133111ebULL;
+        h ^= h >> 29;
+    }
+    return h ^ (h >> 32);
+}
+
+StringInterner::Slot& StringInterner::find_slot(uint64_t h, ryml::csubstr s) {
+    size_t mask = slots_.size() - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+        Slot& slot = slots_[i];
+        if (slot.length == 0 ||
+            (slot.hash == h && slot.length == s.len && std::memcmp(pool_.data() + slot.offset, s.str, s.len) == 0)) {
+            return slot;
+        }
+    }
+}
+
+bool StringInterner::append_json(std::string& out, ryml::csubstr s) {
+    if (s.len == 0 || s.len > kMaxStringBytes) {
+        return false;
+    }
+    uint64_t h = hash(s.str, s.len);
+    Slot* slot = &find_slot(h, s);
+    if (slot->length != 0) {
+        ++hits_;
+        out.append(pool_.data() + slot->offset + slot->length, slot->json_length);
+        return true;
+    }
+    if (size_ >= kMaxEntries) {
+        return false;
+    }
+
+    // At most half full, so probe sequences stay short
+    if ((size_ + 1) * 2 > slots_.size()) {
+        grow();
+        slot = &find_slot(h, s);
+    }
+    size_t offset = pool_.size();
+    pool_.append(s.str, s.len);
+    JsonEmitter::append_string(pool_, s);
+    *slot = Slot{h, static_cast<uint32_t>(offset), static_cast<uint32_t>(s.len),
+                 static_cast<uint32_t>(pool_.size() - offset - s.len)};
+    ++size_;
+    out.append(pool_.data() + offset + s.len, slot->json_length);
+    return true;
+}
+
+void StringInterner::grow() {
+    std::vector<Slot> old(slots_.size() * 2);
+    old.swap(slots_);
+    size_t mask = slots_.size() - 1;
+    for (const Slot& slot : old) {
+        if (slot.length == 0) {
+            continue;
+        }
+        size_t i = slot.hash & mask;
+        while (slots_[i].length != 0) {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = slot;
+    }
+}
+
+} // namespace yaml2json
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ryml.hpp>
+
+namespace yaml2json {
+
+// Table of the short strings of one document (keys and short scalars), each
+// stored once with its quoted, escaped JSON form. Large documents repeat a few
+// hundred keys millions of times; with the table each is escaped once and
+// afterwards copied from the cache. New strings are only added while the
+// table has room, so documents of unique values cost one failed lookup per
+// string once it is full. A lookup costs more than the vector scan of a
+// string that needs no escaping, so JsonEmitter only asks for strings that do.
+class StringInterner {
+public:
+    // Longer strings are never interned: they rarely repeat, and escaping
+    // costs little next to copying them
+    static constexpr size_t kMaxStringBytes = 48;
+
+    // Distinct strings kept at most
+    static constexpr size_t kMaxEntries = 1 << 16;
+
+    StringInterner();
+
+    // Append the JSON form of s ("s", escaped) to out. Returns false, leaving
+    // out alone, when s is too long or new and the table is full
+    bool append_json(std::string& out, ryml::csubstr s);
+
+    // Distinct strings stored
+    size_t size() const { return size_; }
+
+    // Bytes held for strings and their JSON forms
+    size_t pool_bytes() const { return pool_.size(); }
+
+    // Strings answered from the table rather than escaped
+    size_t hits() const { return hits_; }
+
+private:
+    struct Slot {
+        uint64_t hash = 0;
+        uint32_t offset = 0;     // string bytes in pool_, followed by its JSON form
+        uint32_t length = 0;     // 0 = empty slot (the empty string is never interned)
+        uint32_t json_length = 0;
+    };
+
+    static uint64_t hash(const char* data, size_t size);
+    Slot& find_slot(uint64_t hash, ryml::csubstr s);
+    void grow();
+
+    std::vector<Slot> slots_;
+    std::string pool_;
+    size_t size_ = 0;
+    size_t hits_ = 0;
+};
+
+} // namespace yaml2json
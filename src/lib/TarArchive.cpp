@@ -0,0 +1,295 @@
+#include "TarArchive.h"
+#include "ErrorHandler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace yaml2json {
+
+namespace {
+
+// Header field offsets and widths (POSIX ustar)
+constexpr size_t kNameOffset = 0;
+constexpr size_t kNameSize = 100;
+constexpr size_t kModeOffset = 100;
+constexpr size_t kUidOffset = 108;
+constexpr size_t kGidOffset = 116;
+constexpr size_t kSizeOffset = 124;
+constexpr size_t kSizeSize = 12;
+constexpr size_t kMtimeOffset = 136;
+constexpr size_t kChecksumOffset = 148;
+constexpr size_t kChecksumSize = 8;
+constexpr size_t kTypeOffset = 156;
+constexpr size_t kMagicOffset = 257;
+constexpr size_t kVersionOffset = 263;
+constexpr size_t kPrefixOffset = 345;
+constexpr size_t kPrefixSize = 155;
+
+// Largest size an 11-digit octal field holds
+constexpr size_t kMaxOctalSize = (static_cast<size_t>(1) << 33) - 1;
+
+size_t padded(size_t size) {
+    return (size + TarArchive::kBlockSize - 1) / TarArchive::kBlockSize * TarArchive::kBlockSize;
+}
+
+bool is_zero_block(const char* block) {
+    return std::all_of(block, block + TarArchive::kBlockSize, [](char c) { return c == 0; });
+}
+
+// The checksum field counts as spaces; old writers summed signed bytes
+bool checksum_ok(const char* header) {
+    unsigned long stored = 0;
+    bool digits = false;
+    for (size_t i = kChecksumOffset; i < kChecksumOffset + kChecksumSize; ++i) {
+        char c = header[i];
+        if (c >= '0' && c <= '7') {
+            stored = stored * 8 + static_cast<unsigned long>(c - '0');
+            digits = true;
+        } else if (digits || (c != ' ' && c != 0)) {
+            break;
+        }
+    }
+    if (!digits) {
+        return false;
+    }
+
+    unsigned long unsigned_sum = 0;
+    long signed_sum = 0;
+    for (size_t i = 0; i < TarArchive::kBlockSize; ++i) {
+        bool in_field = i >= kChecksumOffset && i < kChecksumOffset + kChecksumSize;
+        char c = in_field ? ' ' : header[i];
+        unsigned_sum += static_cast<unsigned char>(c);
+        signed_sum += static_cast<signed char>(c);
+    }
+    return stored == unsigned_sum || static_cast<long>(stored) == signed_sum;
+}
+
+// Octal number, or GNU base-256 when the high bit of the first byte is set
+bool parse_number(const char* field, size_t width, size_t& value) {
+    value = 0;
+    if (static_cast<unsigned char>(field[0]) & 0x80) {
+        for (size_t i = 0; i < width; ++i) {
+            unsigned char byte = static_cast<unsigned char>(field[i]);
+            if (i == 0) {
+                byte &= 0x7f;
+            }
+            if (value > (static_cast<size_t>(-1) >> 8)) {
+                return false;
+            }
+            value = (value << 8) | byte;
+        }
+        return true;
+    }
+    size_t i = 0;
+    while (i < width && field[i] == ' ') {
+        ++i;
+    }
+    for (; i < width && field[i] >= '0' && field[i] <= '7'; ++i) {
+        value = value * 8 + static_cast<size_t>(field[i] - '0');
+    }
+    return i == width || field[i] == ' ' || field[i] == 0;
+}
+
+std::string field_string(const char* field, size_t width) {
+    const char* end = static_cast<const char*>(std::memchr(field, 0, width));
+    return std::string(field, end != nullptr ? static_cast<size_t>(end - field) : width);
+}
+
+// Path from the name field, with the ustar prefix in front when there is one
+// (GNU archives use that area for other fields)
+std::string header_path(const char* header) {
+    std::string name = field_string(header + kNameOffset, kNameSize);
+    if (std::memcmp(header + kMagicOffset, "ustar\0", 6) == 0) {
+        std::string prefix = field_string(header + kPrefixOffset, kPrefixSize);
+        if (!prefix.empty()) {
+            return prefix + "/" + name;
+        }
+    }
+    return name;
+}
+
+// Overrides for the next entry, from a pax extended header or a GNU long name
+struct Overrides {
+    std::string path;
+    size_t size = 0;
+    bool has_path = false;
+    bool has_size = false;
+};
+
+// Records read "<length> <key>=<value>\n", the length counting the whole record
+void parse_pax(const char* data, size_t size, size_t offset, Overrides& overrides) {
+    size_t pos = 0;
+    while (pos < size) {
+        size_t length = 0;
+        size_t p = pos;
+        while (p < size && data[p] >= '0' && data[p] <= '9') {
+            length = length * 10 + static_cast<size_t>(data[p] - '0');
+            ++p;
+        }
+        if (p == pos || p >= size || data[p] != ' ' || length <= p - pos + 1 || length > size - pos ||
+            data[pos + length - 1] != '\n') {
+            if (std::all_of(data + pos, data + size, [](char c) { return c == 0; })) {
+                return;
+            }
+            throw ConversionError("Invalid pax header in tar archive at offset " + std::to_string(offset));
+        }
+        const char* record = data + p + 1;
+        const char* record_end = data + pos + length - 1;
+        const char* eq = static_cast<const char*>(std::memchr(record, '=', static_cast<size_t>(record_end - record)));
+        if (eq != nullptr) {
+            std::string key(record, eq);
+            std::string value(eq + 1, record_end);
+            if (key == "path") {
+                overrides.path = std::move(value);
+                overrides.has_path = true;
+            } else if (key == "size") {
+                size_t parsed = 0;
+                for (char c : value) {
+                    if (c < '0' || c > '9') {
+                        throw ConversionError("Invalid pax size in tar archive at offset " + std::to_string(offset));
+                    }
+                    parsed = parsed * 10 + static_cast<size_t>(c - '0');
+                }
+                overrides.size = parsed;
+                overrides.has_size = true;
+            }
+        }
+        pos += length;
+    }
+}
+
+// "<length> key=value\n" where the length includes its own digits
+std::string pax_record(const std::string& key, const std::string& value) {
+    std::string body = " " + key + "=" + value + "\n";
+    size_t length = body.size() + 1;
+    while (std::to_string(length).size() + body.size() != length) {
+        length = std::to_string(length).size() + body.size();
+    }
+    return std::to_string(length) + body;
+}
+
+void write_octal(char* field, size_t width, size_t value) {
+    std::snprintf(field, width, "%0*llo", static_cast<int>(width - 1), static_cast<unsigned long long>(value));
+}
+
+void append_header(std::string& archive, const std::string& name, const std::string& prefix, size_t size, char type) {
+    char header[TarArchive::kBlockSize] = {};
+    std::memcpy(header + kNameOffset, name.data(), std::min(name.size(), kNameSize));
+    write_octal(header + kModeOffset, 8, 0644);
+    write_octal(header + kUidOffset, 8, 0);
+    write_octal(header + kGidOffset, 8, 0);
+    write_octal(header + kSizeOffset, kSizeSize, std::min(size, kMaxOctalSize));
+    write_octal(header + kMtimeOffset, 12, 0);
+    header[kTypeOffset] = type;
+    std::memcpy(header + kMagicOffset, "ustar\0", 6);
+    std::memcpy(header + kVersionOffset, "00", 2);
+    std::memcpy(header + kPrefixOffset, prefix.data(), std::min(prefix.size(), kPrefixSize));
+
+    std::memset(header + kChecksumOffset, ' ', kChecksumSize);
+    unsigned long sum = 0;
+    for (char c : header) {
+        sum += static_cast<unsigned char>(c);
+    }
+    std::snprintf(header + kChecksumOffset, 7, "%06lo", sum);
+    header[kChecksumOffset + 7] = ' ';
+    archive.append(header, sizeof(header));
+}
+
+void append_data(std::string& archive, const char* data, size_t size) {
+    archive.append(data, size);
+    archive.append(padded(size) - size, '\0');
+}
+
+} // namespace
+
+std::vector<TarMember> TarArchive::members(const char* data, size_t size) {
+    std::vector<TarMember> members;
+    Overrides overrides;
+    size_t pos = 0;
+    while (size - pos >= kBlockSize) {
+        const char* header = data + pos;
+        if (is_zero_block(header)) {
+            break;
+        }
+        if (!checksum_ok(header)) {
+            throw ConversionError("Invalid tar header at offset " + std::to_string(pos));
+        }
+
+        size_t entry_size = 0;
+        if (!parse_number(header + kSizeOffset, kSizeSize, entry_size)) {
+            throw ConversionError("Invalid size in tar header at offset " + std::to_string(pos));
+        }
+        char type = header[kTypeOffset];
+        bool is_extension = type == 'L' || type == 'x' || type == 'g';
+        if (overrides.has_size && !is_extension) {
+            entry_size = overrides.size;
+        }
+        size_t data_pos = pos + kBlockSize;
+        if (entry_size > size - data_pos) {
+            throw ConversionError("Tar entry '" + header_path(header) + "' is truncated");
+        }
+
+        switch (type) {
+            case 'L':
+                overrides.path = field_string(data + data_pos, entry_size);
+                overrides.has_path = true;
+                break;
+            case 'x':
+                parse_pax(data + data_pos, entry_size, pos, overrides);
+                break;
+            case 'g':
+                break;
+            case '0':
+            case '\0':
+            case '7':
+                members.push_back(TarMember{overrides.has_path ? overrides.path : header_path(header),
+                                            data_pos, entry_size});
+                overrides = Overrides{};
+                break;
+            default:
+                overrides = Overrides{};
+                break;
+        }
+        pos = data_pos + std::min(padded(entry_size), size - data_pos);
+    }
+    return members;
+}
+
+bool TarArchive::looks_like_tar(const char* data, size_t size) {
+    return size >= kBlockSize && (is_zero_block(data) || checksum_ok(data));
+}
+
+void TarArchive::append_file(std::string& archive, const std::string& path, const char* data, size_t size) {
+    std::string name = path;
+    std::string prefix;
+    if (path.size() > kNameSize) {
+        // ustar fits paths of up to 256 bytes split at a '/'
+        size_t slash = path.find('/', path.size() - kNameSize - 1);
+        if (slash != std::string::npos && slash > 0 && slash <= kPrefixSize && slash + 1 < path.size()) {
+            prefix = path.substr(0, slash);
+            name = path.substr(slash + 1);
+        }
+    }
+
+    std::string pax;
+    if (prefix.empty() && path.size() > kNameSize) {
+        pax += pax_record("path", path);
+        name = path.substr(0, kNameSize);
+    }
+    if (size > kMaxOctalSize) {
+        pax += pax_record("size", std::to_string(size));
+    }
+    if (!pax.empty()) {
+        append_header(archive, "PaxHeader", "", pax.size(), 'x');
+        append_data(archive, pax.data(), pax.size());
+    }
+
+    append_header(archive, name, prefix, size, '0');
+    append_data(archive, data, size);
+}
+
+void TarArchive::finish(std::string& archive) {
+    archive.append(2 * kBlockSize, '\0');
+}
+
+} // namespace yaml2json
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace yaml2json {
+
+// A regular file inside a tar archive held in memory
+struct TarMember {
+    std::string path;
+    size_t offset = 0;  // start of the member's data in the archive
+    size_t size = 0;
+};
+
+// Reading and writing of tar archives in memory: POSIX ustar with the GNU
+// long-name and pax extensions on input, ustar plus pax for long paths on output
+class TarArchive {
+public:
+    static constexpr size_t kBlockSize = 512;
+
+    // Regular files of the archive in archive order; directories, links and
+    // other entries are skipped. Throws ConversionError on a damaged header or
+    // a member that runs past the end of the data
+    static std::vector<TarMember> members(const char* data, size_t size);
+
+    // True if the data starts with a valid tar header (or the end-of-archive marker)
+    static bool looks_like_tar(const char* data, size_t size);
+
+    // Append one regular file to an archive being built. Entries are written
+    // with mode 0644, owner 0 and mtime 0, so equal input gives equal archives
+    static void append_file(std::string& archive, const std::string& path, const char* data, size_t size);
+
+    // Append the end-of-archive marker (two zero blocks)
+    static void finish(std::string& archive);
+};
+
+} // namespace yaml2json
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace yaml2json {
+
+// Fixed-size worker pool for batch work (many files, independent chunks).
+// The first exception thrown by a task is rethrown from wait().
+class ThreadPool {
+public:
+    // threads = 0 selects one worker per hardware thread
+    explicit ThreadPool(size_t threads = 0);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    // Queue a task for execution on a worker
+    void submit(std::function<void()> task);
+
+    // Block until every queued task has finished (not callable from a task)
+    void wait();
+
+    // Run fn(i) for every i in [0, count); the calling thread helps, and
+    // indices are handed out dynamically so uneven work stays balanced.
+    // Like wait(), this must not be called from inside a task
+    void parallel_for(size_t count, const std::function<void(size_t)>& fn);
+
+    // Number of worker threads
+    size_t size() const { return workers_.size(); }
+
+    // One thread per hardware thread (at least one)
+    static size_t default_threads();
+
+private:
+    void worker_loop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable task_ready_;
+    std::condition_variable all_done_;
+    size_t active_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+};
+
+} // namespace yaml2json
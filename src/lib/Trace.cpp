@@ -0,0 +1,184 @@
+#include "Trace.h"
+#include "ErrorHandler.h"
+#include "JsonEmitter.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace yaml2json {
+
+namespace detail {
+
+struct TraceEvent {
+    const char* name;
+    std::string detail;
+    int64_t start_ns;
+    int64_t duration_ns;  // -1 while the span is open
+};
+
+// Spans of one thread. Only the owning thread appends; to_json() reads once
+// the thread is done
+struct TraceBuffer {
+    uint32_t tid = 0;
+    std::string thread_name;
+    std::vector<TraceEvent> events;
+};
+
+} // namespace detail
+
+namespace {
+
+using detail::TraceBuffer;
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Buffers outlive their threads: pool workers exit before the trace is written
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    int64_t epoch_ns = 0;
+    std::atomic<uint64_t> generation{1};  // bumped by reset(), invalidating cached buffers
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+struct ThreadSlot {
+    TraceBuffer* buffer = nullptr;
+    uint64_t generation = 0;
+};
+
+thread_local ThreadSlot this_thread;
+
+TraceBuffer* thread_buffer() {
+    Registry& reg = registry();
+    uint64_t generation = reg.generation.load(std::memory_order_acquire);
+    if (this_thread.buffer != nullptr && this_thread.generation == generation) {
+        return this_thread.buffer;
+    }
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto buffer = std::make_unique<TraceBuffer>();
+    buffer->tid = static_cast<uint32_t>(reg.buffers.size() + 1);
+    buffer->events.reserve(1024);
+    this_thread.buffer = buffer.get();
+    this_thread.generation = generation;
+    reg.buffers.push_back(std::move(buffer));
+    return this_thread.buffer;
+}
+
+// Microseconds with nanosecond precision, as the format expects
+void append_micros(std::string& out, int64_t ns) {
+    char buf[32];
+    int len = std::snprintf(buf, sizeof(buf), "%lld.%03lld", static_cast<long long>(ns / 1000),
+                            static_cast<long long>(ns % 1000));
+    out.append(buf, static_cast<size_t>(len));
+}
+
+void append_string(std::string& out, const std::string& s) {
+    JsonEmitter::append_string(out, ryml::csubstr(s.data(), s.size()));
+}
+
+} // namespace
+
+std::atomic<bool> Trace::enabled_{false};
+
+void Trace::enable() {
+    Registry& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.epoch_ns = now_ns();
+    }
+    enabled_.store(true, std::memory_order_release);
+}
+
+void Trace::set_thread_name(const std::string& name) {
+    if (enabled()) {
+        thread_buffer()->thread_name = name;
+    }
+}
+
+void Trace::reset() {
+    enabled_.store(false, std::memory_order_release);
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.buffers.clear();
+    reg.generation.fetch_add(1, std::memory_order_release);
+}
+
+std::string Trace::to_json() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+    auto separate = [&] {
+        if (!first) {
+            out += ",\n";
+        }
+        first = false;
+    };
+    for (const std::unique_ptr<TraceBuffer>& buffer : reg.buffers) {
+        std::string tid = std::to_string(buffer->tid);
+        if (!buffer->thread_name.empty()) {
+            separate();
+            out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":";
+            append_string(out, buffer->thread_name);
+            out += "}}";
+        }
+        for (const detail::TraceEvent& event : buffer->events) {
+            if (event.duration_ns < 0) {
+                continue;  // still open: the thread was not done
+            }
+            separate();
+            out += "{\"name\":\"";
+            out += event.name;
+            out += "\",\"cat\":\"yaml2json\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+            append_micros(out, event.start_ns - reg.epoch_ns);
+            out += ",\"dur\":";
+            append_micros(out, event.duration_ns);
+            if (!event.detail.empty()) {
+                out += ",\"args\":{\"detail\":";
+                append_string(out, event.detail);
+                out += '}';
+            }
+            out += '}';
+        }
+    }
+    out += "],\"displayTimeUnit\":\"ms\"}\n";
+    return out;
+}
+
+void Trace::write(const std::string& path) {
+    std::string json = to_json();
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        throw ConversionError("Failed to create trace file '" + path + "': " + std::strerror(errno));
+    }
+    bool written = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    if (std::fclose(file) != 0 || !written) {
+        throw ConversionError("Failed to write trace file '" + path + "': " + std::strerror(errno));
+    }
+}
+
+void TraceSpan::begin(const char* name, const std::string* detail) {
+    buffer_ = thread_buffer();
+    index_ = buffer_->events.size();
+    buffer_->events.push_back(detail::TraceEvent{name, detail != nullptr ? *detail : std::string(), now_ns(), -1});
+}
+
+void TraceSpan::end() {
+    detail::TraceEvent& event = buffer_->events[index_];
+    event.duration_ns = now_ns() - event.start_ns;
+}
+
+} // namespace yaml2json
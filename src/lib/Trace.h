@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace yaml2json {
+
+namespace detail {
+struct TraceBuffer;
+}
+
+// Timeline of the conversion pipeline (read, parse, emit, format, write) for
+// every thread, written in Chrome trace event format for chrome://tracing or
+// ui.perfetto.dev. Recording is off until enable(); a span then costs one
+// relaxed atomic load. Each thread appends to its own buffer, so recording
+// takes no lock after the first span of a thread.
+class Trace {
+public:
+    // Start recording; timestamps count from this call
+    static void enable();
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Name of the calling thread's track in the viewer (no-op while disabled)
+    static void set_thread_name(const std::string& name);
+
+    // Trace event JSON of every finished span. Threads that record must be
+    // done (joined, or idle in a pool) before this is called
+    static std::string to_json();
+
+    // Write to_json() to a file; throws ConversionError
+    static void write(const std::string& path);
+
+    // Stop recording and drop every span (for tests; no span may be open)
+    static void reset();
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+// Records the lifetime of the object as one span on the calling thread's
+// track; detail (a file or document name) shows up in the span's arguments
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name) {
+        if (Trace::enabled()) {
+            begin(name, nullptr);
+        }
+    }
+    TraceSpan(const char* name, const std::string& detail) {
+        if (Trace::enabled()) {
+            begin(name, &detail);
+        }
+    }
+    // Detail "file:line", only put together while recording
+    TraceSpan(const char* name, const std::string& file, size_t line) {
+        if (Trace::enabled()) {
+            std::string detail = file + ":" + std::to_string(line);
+            begin(name, &detail);
+        }
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+    ~TraceSpan() {
+        if (buffer_ != nullptr) {
+            end();
+        }
+    }
+
+private:
+    void begin(const char* name, const std::string* detail);
+    void end();
+
+    detail::TraceBuffer* buffer_ = nullptr;
+    size_t index_ = 0;
+};
+
+} // namespace yaml2json
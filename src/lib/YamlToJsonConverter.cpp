@@ -1,20 +1,96 @@
 #include "YamlToJsonConverter.h"
 #include "ErrorHandler.h"
+#include "BinaryEmitter.h"
+#include "DuplicateKeyFilter.h"
+#include "GatherWriter.h"
+#include "JsonEmitter.h"
+#include "JsonSchema.h"
+#include "OutputSink.h"
+#include "ParallelConverter.h"
+#include "Trace.h"
 #include <ryml_std.hpp>
 #include <algorithm>
 
 namespace yaml2json {
 
+namespace {
+
+void check_deadline(const ConversionLimits& limits, const char* phase) {
+    if (limits.has_deadline() && ConversionLimits::Clock::now() > limits.deadline) {
+        throw LimitExceededError(std::string("Deadline exceeded ") + phase);
+    }
+}
+
+void check_input_size(const ConversionLimits& limits, size_t yaml_size, const std::string& filename) {
+    if (limits.max_input_bytes > 0 && yaml_size > limits.max_input_bytes) {
+        throw LimitExceededError("Input" + (filename.empty() ? "" : " '" + filename + "'") +
+                                 " exceeds the input size limit of " +
+                                 std::to_string(limits.max_input_bytes) + " bytes");
+    }
+}
+
+// Node and arena usage are O(1) to read off the tree; parse memory itself is
+// bounded linearly by the input size limit
+void check_tree_limits(const ryml::Tree& tree, const ConversionLimits& limits) {
+    if (limits.max_nodes > 0 && static_cast<size_t>(tree.size()) > limits.max_nodes) {
+        throw LimitExceededError("Node limit exceeded: " + std::to_string(tree.size()) +
+                                 " nodes parsed, limit is " + std::to_string(limits.max_nodes));
+    }
+    if (limits.max_arena_bytes > 0 && tree.arena_size() > limits.max_arena_bytes) {
+        throw LimitExceededError("Arena limit exceeded: " + std::to_string(tree.arena_size()) +
+                                 " bytes used, limit is " + std::to_string(limits.max_arena_bytes));
+    }
+    check_deadline(limits, "while parsing");
+}
+
+// Everything that runs between parsing and emitting
+void prepare_tree(ryml::Tree& tree, const ConversionOptions& options, const char* yaml_data, size_t yaml_size,
+                  const std::string& filename) {
+    TraceSpan span("check", filename);
+    check_tree_limits(tree, options.limits);
+    DuplicateKeyFilter::apply(tree, options.duplicate_keys, yaml_data, yaml_size, filename);
+    if (options.schema) {
+        options.schema->validate(tree, options, yaml_data, yaml_size, filename);
+    }
+}
+
+} // namespace
+
 std::string YamlToJsonConverter::convert(const char* yaml_data, size_t yaml_size) {
     return convert(yaml_data, yaml_size, "");
 }
 
 std::string YamlToJsonConverter::convert(const char* yaml_data, size_t yaml_size, const std::string& filename) {
+    return convert(yaml_data, yaml_size, filename, OutputFormat::Json);
+}
+
+std::string YamlToJsonConverter::convert(const char* yaml_data, size_t yaml_size, const std::string& filename,
+                                         OutputFormat format) {
+    ConversionOptions options;
+    options.format = format;
+    return convert(yaml_data, yaml_size, filename, options);
+}
+
+std::string YamlToJsonConverter::convert(const char* yaml_data, size_t yaml_size, const std::string& filename,
+                                         const ConversionOptions& options) {
     setup_error_handlers();
+
+    const ConversionLimits& limits = options.limits;
+    check_input_size(limits, yaml_size, filename);
+    check_deadline(limits, "before parsing");
     
     try {
+        if (options.threads != 1) {
+            std::string json;
+            if (ParallelConverter::try_convert(const_cast<char*>(yaml_data), yaml_size, filename, options, json)) {
+                check_deadline(limits, "while emitting");
+                return json;
+            }
+        }
+
         ryml::Tree tree = parse_yaml(yaml_data, yaml_size, filename);
-        return tree_to_json(tree);
+        prepare_tree(tree, options, yaml_data, yaml_size, filename);
+        return emit(tree, options);
     } catch (const ConversionError&) {
         throw;
     } catch (const std::exception& e) {
@@ -24,7 +100,133 @@ std::string YamlToJsonConverter::convert(const char* yaml_data, size_t yaml_size
     }
 }
 
+void YamlToJsonConverter::write_json(const char* yaml_data, size_t yaml_size, const std::string& filename,
+                                     const ConversionOptions& options, GatherWriter& out, int fd) {
+    // Chunked and binary output is assembled in memory anyway
+    if (options.threads != 1 || options.format != OutputFormat::Json) {
+        out.buffer() = convert(yaml_data, yaml_size, filename, options);
+        out.write_to(fd);
+        return;
+    }
+
+    setup_error_handlers();
+
+    const ConversionLimits& limits = options.limits;
+    check_input_size(limits, yaml_size, filename);
+    check_deadline(limits, "before parsing");
+
+    try {
+        ryml::Tree tree = parse_yaml(yaml_data, yaml_size, filename);
+        prepare_tree(tree, options, yaml_data, yaml_size, filename);
+
+        // The tree (and the input it was parsed from) must outlive the write
+        JsonEmitter emitter(tree, options);
+        {
+            TraceSpan span("emit", filename);
+            emitter.emit(out);
+        }
+        check_deadline(limits, "while emitting");
+        TraceSpan span("write", filename);
+        out.write_to(fd);
+    } catch (const ConversionError&) {
+        throw;
+    } catch (const std::exception& e) {
+        throw ConversionError("YAML parsing error" +
+                             (filename.empty() ? "" : " in file '" + filename + "'") +
+                             ": " + e.what());
+    }
+}
+
+void YamlToJsonConverter::convert_to(const char* yaml_data, size_t yaml_size, const std::string& filename,
+                                     const ConversionOptions& options, OutputSink& out) {
+    if (options.threads != 1 || options.format != OutputFormat::Json) {
+        std::string converted = convert(yaml_data, yaml_size, filename, options);
+        if (out.wants_size_estimate()) {
+            out.reserve(converted.size());
+        }
+        out.write(converted.data(), converted.size());
+        return;
+    }
+
+    setup_error_handlers();
+
+    const ConversionLimits& limits = options.limits;
+    check_input_size(limits, yaml_size, filename);
+    check_deadline(limits, "before parsing");
+
+    try {
+        ryml::Tree tree = parse_yaml(yaml_data, yaml_size, filename);
+        prepare_tree(tree, options, yaml_data, yaml_size, filename);
+
+        TraceSpan span("emit", filename);
+        JsonEmitter emitter(tree, options);
+        emitter.emit(out);
+        check_deadline(limits, "while emitting");
+    } catch (const ConversionError&) {
+        throw;
+    } catch (const std::exception& e) {
+        throw ConversionError("YAML parsing error" +
+                             (filename.empty() ? "" : " in file '" + filename + "'") +
+                             ": " + e.what());
+    }
+}
+
+void YamlToJsonConverter::check(char* yaml_data, size_t yaml_size, const std::string& filename,
+                                const ConversionLimits& limits, DuplicateKeys duplicate_keys) {
+    ConversionOptions options;
+    options.limits = limits;
+    options.duplicate_keys = duplicate_keys;
+    check(yaml_data, yaml_size, filename, options);
+}
+
+void YamlToJsonConverter::check(char* yaml_data, size_t yaml_size, const std::string& filename,
+                                const ConversionOptions& options) {
+    setup_error_handlers();
+
+    const ConversionLimits& limits = options.limits;
+    check_input_size(limits, yaml_size, filename);
+    check_deadline(limits, "before parsing");
+
+    try {
+        ryml::Tree tree = parse_yaml(yaml_data, yaml_size, filename);
+        prepare_tree(tree, options, yaml_data, yaml_size, filename);
+
+        // Resolving aliases catches undefined references without emitting anything
+        JsonEmitter emitter(tree, limits);
+        emitter.set_source(yaml_data, yaml_size, filename);
+        emitter.resolve_aliases();
+    } catch (const ConversionError&) {
+        throw;
+    } catch (const std::exception& e) {
+        throw ConversionError("YAML parsing error" +
+                             (filename.empty() ? "" : " in file '" + filename + "'") +
+                             ": " + e.what());
+    }
+}
+
+ryml::Tree YamlToJsonConverter::parse_tree(const char* yaml_data, size_t yaml_size, const std::string& filename,
+                                           const ConversionOptions& options) {
+    setup_error_handlers();
+
+    check_input_size(options.limits, yaml_size, filename);
+    check_deadline(options.limits, "before parsing");
+
+    try {
+        ryml::Tree tree = parse_yaml(yaml_data, yaml_size, filename);
+        prepare_tree(tree, options, yaml_data, yaml_size, filename);
+        return tree;
+    } catch (const ConversionError&) {
+        throw;
+    } catch (const std::exception& e) {
+        throw ConversionError("YAML parsing error" +
+                             (filename.empty() ? "" : " in file '" + filename + "'") +
+                             ": " + e.what());
+    }
+}
+
 ryml::Tree YamlToJsonConverter::parse_yaml(const char* yaml_data, size_t yaml_size, const std::string& filename) {
+    TraceSpan span("parse", filename);
+
     // Zero-copy parse with pre-reserved capacity
     size_t est_nodes = std::max<size_t>(1024, yaml_size / 90);
     size_t est_arena = yaml_size * 11 / 10; // 1.1× YAML size
@@ -46,7 +248,52 @@ ryml::Tree YamlToJsonConverter::parse_yaml(const char* yaml_data, size_t yaml_si
 }
 
 std::string YamlToJsonConverter::tree_to_json(const ryml::Tree& tree) {
-    return ryml::emitrs_json<std::string>(tree);
+    return tree_to_json(tree, ConversionLimits{});
+}
+
+std::string YamlToJsonConverter::tree_to_json(const ryml::Tree& tree, const ConversionLimits& limits) {
+    // Always JsonEmitter, as the writev and mapped paths use, so a document
+    // converts to the same bytes whichever way it is written
+    JsonEmitter emitter(tree, limits);
+    std::string json;
+    emitter.emit(json);
+    return json;
+}
+
+std::string YamlToJsonConverter::tree_to_cbor(const ryml::Tree& tree) {
+    return BinaryEmitter::to_cbor(tree);
+}
+
+std::string YamlToJsonConverter::tree_to_msgpack(const ryml::Tree& tree) {
+    return BinaryEmitter::to_msgpack(tree);
+}
+
+std::string YamlToJsonConverter::emit(const ryml::Tree& tree, OutputFormat format) {
+    switch (format) {
+        case OutputFormat::Cbor:
+            return tree_to_cbor(tree);
+        case OutputFormat::MsgPack:
+            return tree_to_msgpack(tree);
+        case OutputFormat::Json:
+            break;
+    }
+    return tree_to_json(tree);
+}
+
+std::string YamlToJsonConverter::emit(const ryml::Tree& tree, const ConversionOptions& options) {
+    TraceSpan span("emit");
+    if (options.format == OutputFormat::Json) {
+        JsonEmitter emitter(tree, options);
+        std::string json;
+        emitter.emit(json);
+        return json;
+    }
+
+    // Binary emitters expand aliases and check the limits as they encode.
+    // They always type scalars: Json typing means the core schema there
+    ScalarTyping typing = options.scalars == ScalarTyping::Yaml11 ? ScalarTyping::Yaml11 : ScalarTyping::Core;
+    return options.format == OutputFormat::Cbor ? BinaryEmitter::to_cbor(tree, typing, options.limits)
+                                                : BinaryEmitter::to_msgpack(tree, typing, options.limits);
 }
 
 } // namespace yaml2json
\ No newline at end of file
@@ -2,9 +2,13 @@
 
 #include <string>
 #include <ryml.hpp>
+#include "ConversionOptions.h"
 
 namespace yaml2json {
 
+class GatherWriter;
+class OutputSink;
+
 // Core YAML to JSON converter
 class YamlToJsonConverter {
 public:
@@ -13,12 +17,65 @@ public:
     
     // Convert YAML string to JSON string with filename for error reporting
     static std::string convert(const char* yaml_data, size_t yaml_size, const std::string& filename);
+
+    // Convert YAML string to the requested output format
+    static std::string convert(const char* yaml_data, size_t yaml_size, const std::string& filename,
+                               OutputFormat format);
+
+    // Convert YAML string with explicit options (format, cost limits)
+    static std::string convert(const char* yaml_data, size_t yaml_size, const std::string& filename,
+                               const ConversionOptions& options);
+    
+    // Convert to JSON and write it to a file descriptor. Strings are written
+    // straight from the input buffer (parsed in place, so it is modified)
+    // where no escaping is needed, instead of being copied into the output.
+    // Afterwards only the size counters of `out` are meaningful
+    static void write_json(const char* yaml_data, size_t yaml_size, const std::string& filename,
+                           const ConversionOptions& options, GatherWriter& out, int fd);
+    
+    // Convert and hand the output to a sink in blocks instead of returning it,
+    // e.g. to hash it without holding it in memory (JSON with threads == 1 only;
+    // anything else is converted in memory and passed on in one piece)
+    static void convert_to(const char* yaml_data, size_t yaml_size, const std::string& filename,
+                           const ConversionOptions& options, OutputSink& out);
+    
+    // Validate YAML without emitting: parse, apply the tree limits, look for
+    // duplicate keys (DuplicateKeys::Error fails on them) and resolve aliases;
+    // throws ConversionError (with its location when known) on failure.
+    // The buffer is parsed in place and is modified.
+    static void check(char* yaml_data, size_t yaml_size, const std::string& filename,
+                      const ConversionLimits& limits = ConversionLimits{},
+                      DuplicateKeys duplicate_keys = DuplicateKeys::Keep);
+
+    // Validate with the tree checks of the options: limits, duplicate keys, schema
+    static void check(char* yaml_data, size_t yaml_size, const std::string& filename,
+                      const ConversionOptions& options);
+    
+    // Parse YAML in place and apply the tree limits and duplicate key policy of
+    // the options, as convert() does before emitting; throws ConversionError
+    static ryml::Tree parse_tree(const char* yaml_data, size_t yaml_size, const std::string& filename,
+                                 const ConversionOptions& options);
     
     // Parse YAML and return tree (for testing)
     static ryml::Tree parse_yaml(const char* yaml_data, size_t yaml_size, const std::string& filename = "");
     
     // Convert tree to JSON string
     static std::string tree_to_json(const ryml::Tree& tree);
+
+    // Convert tree to JSON string, expanding aliases within the given limits
+    static std::string tree_to_json(const ryml::Tree& tree, const ConversionLimits& limits);
+
+    // Convert tree to CBOR bytes
+    static std::string tree_to_cbor(const ryml::Tree& tree);
+
+    // Convert tree to MessagePack bytes
+    static std::string tree_to_msgpack(const ryml::Tree& tree);
+
+    // Serialize tree in the requested output format
+    static std::string emit(const ryml::Tree& tree, OutputFormat format);
+
+    // Serialize tree according to the conversion options
+    static std::string emit(const ryml::Tree& tree, const ConversionOptions& options);
 };
 
-} // namespace yaml2json
\ No newline at end of file
+} // namespace yaml2json
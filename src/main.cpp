@@ -1,17 +1,178 @@
 #include <CLI/CLI.hpp>
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <cstdlib>
+#include <cstdio>
 #include <cerrno>
 #include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 #include "FileReader.h"
+#include "GatherWriter.h"
+#include "MappedFileWriter.h"
+#include "OutputFile.h"
+#include "ContentHash.h"
+#include "Compression.h"
 #include "YamlToJsonConverter.h"
 #include "JsonFormatter.h"
 #include "ErrorHandler.h"
+#include "ThreadPool.h"
+#include "LayerMerger.h"
+#include "JsonSchema.h"
+#include "DocumentSplitter.h"
+#include "ArchiveConverter.h"
+#include "SimdKernels.h"
+#include "Trace.h"
 
-int main(int argc, char **argv) {
+// Validate inputs without emitting anything, in parallel across files.
+// Errors print in input order as "file:line:col: message"; returns the exit code.
+static int run_check(const std::vector<std::string>& files, const yaml2json::ConversionOptions& conversion,
+                     size_t jobs) {
+    const yaml2json::ConversionLimits& limits = conversion.limits;
+    std::vector<std::string> errors(files.size());
+
+    auto check_one = [&](size_t i) {
+        const std::string& file = files[i];
+        yaml2json::TraceSpan span("file", file.empty() ? "<stdin>" : file);
+        try {
+            yaml2json::FileContent input = file.empty()
+                ? yaml2json::FileReader::read_stream(stdin, "stdin", limits.max_input_bytes)
+                : yaml2json::FileReader::read_file(file, limits.max_input_bytes);
+            yaml2json::YamlToJsonConverter::check(input.mutable_data(), input.size(), file, conversion);
+        } catch (const yaml2json::ConversionError& e) {
+            errors[i] = yaml2json::format_machine_error(e, file.empty() ? "<stdin>" : file);
+        } catch (const std::exception& e) {
+            errors[i] = (file.empty() ? "<stdin>" : file) + ":0:0: " + e.what();
+        }
+    };
+
+    // The calling thread checks files too, so the pool needs one worker less
+    size_t workers = std::min(jobs == 0 ? yaml2json::ThreadPool::default_threads() : jobs, files.size());
+    if (workers <= 1) {
+        for (size_t i = 0; i < files.size(); ++i) {
+            check_one(i);
+        }
+    } else {
+        yaml2json::ThreadPool pool(workers - 1);
+        pool.parallel_for(files.size(), check_one);
+    }
+
+    int status = 0;
+    for (const std::string& error : errors) {
+        if (!error.empty()) {
+            std::cerr << error << '\n';
+            status = 1;
+        }
+    }
+    std::cerr.flush();
+    return status;
+}
+
+// Convert straight to stdout or a file with writev, without assembling the
+// output in memory first; returns the exit code
+static int write_gathered(yaml2json::FileContent& input, const std::string& source_name,
+                          const yaml2json::ConversionOptions& conversion, const std::string& output_file) {
+    yaml2json::GatherWriter writer;
+    if (output_file.empty()) {
+        yaml2json::YamlToJsonConverter::write_json(input.mutable_data(), input.size(), source_name,
+                                                   conversion, writer, fileno(stdout));
+        return 0;
+    }
+
+    // Written beside the output and renamed over it once complete: a failed
+    // conversion keeps an existing output, and the output may be the input
+    // the writes still reference
+    yaml2json::OutputFile output(output_file);
+    yaml2json::YamlToJsonConverter::write_json(input.mutable_data(), input.size(), source_name,
+                                               conversion, writer, output.fd());
+    output.commit();
+    return 0;
+}
+
+// Convert straight into a shared mapping of the output file, sized from the
+// parse tree (JSON) or the converted bytes (binary formats, chunked parsing)
+static int write_mapped(yaml2json::FileContent& input, const std::string& source_name,
+                        const yaml2json::ConversionOptions& conversion, const std::string& output_file) {
+    // The writer maps a temporary beside the output and renames it into
+    // place on finish(); a failure leaves the output as it was
+    yaml2json::MappedFileWriter writer(output_file);
+    yaml2json::YamlToJsonConverter::convert_to(input.mutable_data(), input.size(), source_name, conversion, writer);
+    writer.finish();
+    return 0;
+}
+
+// Read every layer and deep-merge them into one JSON document. Inputs are
+// mapped and parsed in place, so they stay open until the merge is done
+static std::string merge_layers(const std::vector<std::string>& files, const yaml2json::ConversionOptions& conversion,
+                                yaml2json::SequenceMerge sequences) {
+    std::vector<yaml2json::FileContent> contents;
+    std::vector<yaml2json::MergeInput> layers;
+    contents.reserve(files.size());
+    for (const std::string& file : files) {
+        contents.push_back(yaml2json::FileReader::read_file(file, conversion.limits.max_input_bytes));
+        layers.push_back(yaml2json::MergeInput{contents.back().mutable_data(), contents.back().size(), file});
+    }
+    return yaml2json::LayerMerger::merge(layers, conversion, sequences);
+}
+
+// True for the plain `yaml2json [input [output]]` forms: no options, so the
+// full command-line parser does not need to be built
+static bool is_plain_invocation(int argc, char** argv) {
+    if (argc > 3) {
+        return false;
+    }
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '-' || argv[i][0] == '\0') {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void print_error(const std::string& message) {
+    std::fputs(message.c_str(), stderr);
+    std::fputc('\n', stderr);
+}
+
+// The plain forms with default options, as the full path would run them:
+// mapped input, output written with writev through the same temporary-and-
+// rename path (so `yaml2json bad.yaml out.json` keeps out.json), stdio only
+// for errors
+static int run_plain(const char* input_file, const char* output_file) {
+    try {
+        yaml2json::FileContent input;
+        std::string source_name;
+        if (input_file == nullptr) {
+            input = yaml2json::FileReader::read_stream(stdin, "stdin");
+            source_name = "<stdin>";
+        } else {
+            std::FILE* probe = std::fopen(input_file, "rb");
+            if (probe == nullptr) {
+                print_error(std::string("Error: Cannot open input file '") + input_file + "': " +
+                            std::strerror(errno));
+                return 1;
+            }
+            std::fclose(probe);
+            input = yaml2json::FileReader::read_file(input_file);
+            source_name = input_file;
+        }
+        return write_gathered(input, source_name, yaml2json::ConversionOptions{},
+                              output_file != nullptr ? output_file : "");
+    } catch (const yaml2json::ConversionError& e) {
+        print_error(std::string("Error: ") + e.what());
+        return 1;
+    } catch (const std::exception& e) {
+        print_error(std::string("Error: Unexpected error: ") + e.what());
+        return 1;
+    }
+}
+
+// Every other invocation: the full option parser. trace_file is set when
+// --trace asks for the spans of the run to be written on exit
+static int run_cli(int argc, char **argv, std::string& trace_file) {
     // Disable synchronization with C I/O to speed up reading/writing
     std::ios::sync_with_stdio(false);
 
@@ -22,6 +183,23 @@ int main(int argc, char **argv) {
     std::string input_file;
     std::string output_file;
     bool pretty_print = false;
+    std::string compress_spec;
+    std::string format_name = "json";
+    std::string scalars_name = "json";
+    std::string duplicate_keys_name;
+    std::string schema_file;
+    yaml2json::ConversionOptions conversion;
+    long long timeout_ms = 0;
+    bool check_only = false;
+    bool buffered_output = false;
+    bool mmap_output = false;
+    bool hash_only = false;
+    bool merge = false;
+    std::string merge_sequences_name = "replace";
+    yaml2json::SplitOptions split;
+    bool tar_input = false;
+    std::string tar_output_name = "tar";
+    size_t jobs = 0;
     std::vector<std::string> positional_args;
     
     // Optional flags for explicit file specification
@@ -32,11 +210,94 @@ int main(int argc, char **argv) {
     
     app.add_flag("-p,--pretty", pretty_print, "Pretty-print JSON output with indentation");
     
+    app.add_option("--compress", compress_spec, "Compress output: gzip|zstd[:level]");
+    
+    app.add_option("-f,--format", format_name, "Output format: json|cbor|msgpack")
+        ->check(CLI::IsMember({"json", "cbor", "msgpack"}));
+    
+    app.add_option("--scalars", scalars_name,
+                   "Typing of plain scalars: json (pass JSON literals through), core (YAML 1.2), yaml11")
+        ->check(CLI::IsMember({"json", "core", "yaml11"}));
+    
+    app.add_option("--duplicate-keys", duplicate_keys_name,
+                   "Repeated keys in a mapping: error, last-wins or first-wins (default: emit all)")
+        ->check(CLI::IsMember({"error", "last-wins", "first-wins"}));
+    
+    app.add_option("--schema", schema_file,
+                   "Validate the output against a JSON Schema while converting (no JSON is re-parsed)")
+        ->check(CLI::ExistingFile);
+    
+    app.add_flag("--canonical", conversion.canonical,
+                 "Canonical JSON: map keys sorted bytewise, no whitespace");
+    
+    app.add_flag("--intern-strings", conversion.intern_strings,
+                 "Escape repeated short strings once and reuse them (large documents with repetitive keys)");
+    
+    app.add_flag("--hash", hash_only,
+                 "Print an XXH64 hash of the output instead of the output itself");
+    
+    app.add_flag("--buffered-output", buffered_output,
+                 "Assemble the whole output in memory before writing (no scatter-gather writes)");
+    
+    app.add_flag("--mmap-output", mmap_output,
+                 "Write a regular output file through a memory mapping sized from the parse tree");
+    
+    // Cost limits for untrusted input (0 = unlimited)
+    app.add_option("--max-input-bytes", conversion.limits.max_input_bytes,
+                   "Max input size in bytes, checked before mapping and while decompressing");
+    
+    app.add_option("--max-nodes", conversion.limits.max_nodes, "Max number of parsed YAML nodes");
+    
+    app.add_option("--max-arena-bytes", conversion.limits.max_arena_bytes, "Max parser arena size in bytes");
+    
+    app.add_option("--timeout", timeout_ms, "Wall-clock budget for the conversion in milliseconds")
+        ->check(CLI::NonNegativeNumber);
+    
+    app.add_option("--max-alias-expansion", conversion.limits.max_alias_expansion,
+                   "Max emitted nodes per parsed node when expanding aliases (default 100)")
+        ->check(CLI::NonNegativeNumber);
+    
+    app.add_option("--max-output-bytes", conversion.limits.max_output_bytes, "Max output size in bytes");
+    
+    app.add_option("--max-depth", conversion.limits.max_depth, "Max nesting depth, counted through aliases");
+    
+    app.add_flag("--merge", merge,
+                 "Deep-merge all input files into one JSON document, later files overriding earlier ones");
+    
+    app.add_option("--merge-sequences", merge_sequences_name,
+                   "How --merge combines sequences: replace (default) or append")
+        ->check(CLI::IsMember({"replace", "append"}));
+    
+    app.add_option("--split-dir", split.directory,
+                   "Write each document of the input stream to its own file in this directory");
+    
+    app.add_option("--name-template", split.name_template,
+                   "File names for --split-dir: {index} and {dotted.path} lookups "
+                   "(default: {index}-{kind}-{metadata.name}.json)");
+    
+    app.add_flag("--tar", tar_input,
+                 "Input is a tar archive (.tar, .tgz, .tar.zst): convert every .yaml/.yml member in memory");
+    
+    app.add_option("--tar-output", tar_output_name,
+                   "Output of --tar: a tar of converted members (default) or ndjson records tagged with member paths")
+        ->check(CLI::IsMember({"tar", "ndjson"}));
+    
+    app.add_option("--trace", trace_file,
+                   "Write a Chrome trace (chrome://tracing, Perfetto) of read/parse/emit/format/write per thread");
+    
+    app.add_flag("--check", check_only,
+                 "Only validate the input files (no output); errors print as file:line:col: message");
+    
+    auto* jobs_option = app.add_option("-j,--jobs", jobs,
+                   "Parallel jobs: files for --check (default: one per hardware thread), "
+                   "chunks of one large document otherwise (default: 1, 0 = all cores)");
+    
     // Positional arguments for backwards compatibility
     app.add_option("files", positional_args, "Input file [output file] (use stdin/stdout if omitted)");
     
     // Version option
-    app.set_version_flag("-v,--version", std::string("yaml2json built on ") + BUILD_DATE);
+    app.set_version_flag("-v,--version", std::string("yaml2json built on ") + BUILD_DATE + " (kernels: " +
+                                             yaml2json::SimdKernels::name(yaml2json::SimdKernels::active()) + ")");
     
     // Parse command line
     try {
@@ -45,6 +306,81 @@ int main(int argc, char **argv) {
         return app.exit(e);
     }
     
+    if (!trace_file.empty()) {
+        yaml2json::Trace::enable();
+        yaml2json::Trace::set_thread_name("main");
+    }
+    
+    // The deadline covers reading, parsing and emitting
+    if (timeout_ms > 0) {
+        conversion.limits.deadline = yaml2json::ConversionLimits::Clock::now() +
+                                     std::chrono::milliseconds(timeout_ms);
+    }
+    
+    if (scalars_name == "core") {
+        conversion.scalars = yaml2json::ScalarTyping::Core;
+    } else if (scalars_name == "yaml11") {
+        conversion.scalars = yaml2json::ScalarTyping::Yaml11;
+    }
+    
+    if (duplicate_keys_name == "error") {
+        conversion.duplicate_keys = yaml2json::DuplicateKeys::Error;
+    } else if (duplicate_keys_name == "last-wins") {
+        conversion.duplicate_keys = yaml2json::DuplicateKeys::LastWins;
+    } else if (duplicate_keys_name == "first-wins") {
+        conversion.duplicate_keys = yaml2json::DuplicateKeys::FirstWins;
+    }
+    
+    // The schema is compiled once and shared by every file (and --check thread)
+    if (!schema_file.empty()) {
+        try {
+            conversion.schema = yaml2json::JsonSchema::load(schema_file);
+        } catch (const yaml2json::ConversionError& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    
+    // Validation mode: every positional argument is an input, nothing is written
+    if (check_only) {
+        if (!output_file.empty()) {
+            std::cerr << "Error: --check does not write output" << std::endl;
+            return 1;
+        }
+        if (tar_input) {
+            std::cerr << "Error: --check does not read tar archives" << std::endl;
+            return 1;
+        }
+        std::vector<std::string> files;
+        if (!input_file.empty()) {
+            files.push_back(input_file);
+        }
+        files.insert(files.end(), positional_args.begin(), positional_args.end());
+        if (files.empty()) {
+            files.emplace_back();  // stdin
+        }
+        yaml2json::setup_error_handlers();
+        return run_check(files, conversion, jobs);
+    }
+    
+    // Merge mode: every positional argument is a layer, lowest precedence first;
+    // output goes to --output or stdout
+    std::vector<std::string> merge_files;
+    yaml2json::SequenceMerge sequences = merge_sequences_name == "append"
+        ? yaml2json::SequenceMerge::Append : yaml2json::SequenceMerge::Replace;
+    if (merge) {
+        if (!input_file.empty()) {
+            merge_files.push_back(input_file);
+        }
+        merge_files.insert(merge_files.end(), positional_args.begin(), positional_args.end());
+        if (merge_files.empty()) {
+            std::cerr << "Error: --merge needs at least one input file" << std::endl;
+            return 1;
+        }
+        input_file = merge_files.front();
+        positional_args.clear();
+    }
+    
     // Determine input and output sources with backwards compatibility
     bool use_stdin = false;
     bool use_stdout = false;
@@ -78,6 +414,55 @@ int main(int argc, char **argv) {
         use_stdout = true;
     }
     
+    // Binary formats are emitted straight from the tree; there is nothing to indent
+    if (format_name == "cbor") {
+        conversion.format = yaml2json::OutputFormat::Cbor;
+    } else if (format_name == "msgpack") {
+        conversion.format = yaml2json::OutputFormat::MsgPack;
+    }
+    if (pretty_print && conversion.format != yaml2json::OutputFormat::Json) {
+        std::cerr << "Error: --pretty only applies to JSON output" << std::endl;
+        return 1;
+    }
+    if (conversion.canonical && (pretty_print || conversion.format != yaml2json::OutputFormat::Json)) {
+        std::cerr << "Error: --canonical only applies to compact JSON output" << std::endl;
+        return 1;
+    }
+    if (merge && conversion.format != yaml2json::OutputFormat::Json) {
+        std::cerr << "Error: --merge only produces JSON output" << std::endl;
+        return 1;
+    }
+    if (mmap_output && buffered_output) {
+        std::cerr << "Error: --mmap-output and --buffered-output are exclusive" << std::endl;
+        return 1;
+    }
+    if (hash_only && (pretty_print || !compress_spec.empty())) {
+        std::cerr << "Error: --hash cannot be combined with --pretty or --compress" << std::endl;
+        return 1;
+    }
+    bool splitting = !split.directory.empty();
+    if (splitting && (merge || hash_only || !compress_spec.empty() || !output_file.empty())) {
+        std::cerr << "Error: --split-dir takes one input and cannot be combined with an output file, "
+                  << "--merge, --hash or --compress" << std::endl;
+        return 1;
+    }
+    yaml2json::ArchiveOptions archive;
+    archive.output = tar_output_name == "ndjson" ? yaml2json::ArchiveOutput::Ndjson : yaml2json::ArchiveOutput::Tar;
+    archive.pretty = pretty_print;
+    if (tar_input && (merge || splitting || hash_only)) {
+        std::cerr << "Error: --tar cannot be combined with --merge, --split-dir or --hash" << std::endl;
+        return 1;
+    }
+    if (tar_input && archive.output == yaml2json::ArchiveOutput::Ndjson &&
+        (pretty_print || conversion.format != yaml2json::OutputFormat::Json)) {
+        std::cerr << "Error: --tar-output ndjson writes compact JSON records only" << std::endl;
+        return 1;
+    }
+    
+    // Chunked parsing stays opt-in: it only pays off for very large documents.
+    // Merge layers, split documents and archive members use all cores unless -j says otherwise
+    conversion.threads = jobs_option->count() > 0 ? jobs : (merge || splitting || tar_input ? 0 : 1);
+    
     // Validate input file exists (if not using stdin)
     if (!use_stdin) {
         std::ifstream test_input(input_file);
@@ -88,42 +473,109 @@ int main(int argc, char **argv) {
         }
     }
     
+    int exit_status = 0;
     try {
-        // Read input (file or stdin)
-        std::string yaml_content;
-        std::string source_name;
+        // Parse compression spec up front so bad values fail before any work
+        yaml2json::CompressionOptions compression;
+        if (!compress_spec.empty()) {
+            compression = yaml2json::Compression::parse_spec(compress_spec);
+        }
         
-        if (use_stdin) {
-            // Read from stdin
-            std::ostringstream buffer;
-            buffer << std::cin.rdbuf();
-            yaml_content = buffer.str();
-            source_name = "<stdin>";
-            
-            if (yaml_content.empty()) {
-                std::cerr << "Error: No input provided via stdin" << std::endl;
-                return 1;
+        // Split mode: the input is mapped once and its documents are converted
+        // in place, each into its own file
+        if (splitting) {
+            yaml2json::FileContent input = use_stdin
+                ? yaml2json::FileReader::read_stream(stdin, "stdin", conversion.limits.max_input_bytes)
+                : yaml2json::FileReader::read_file(input_file, conversion.limits.max_input_bytes);
+            split.pretty = pretty_print;
+            yaml2json::DocumentSplitter::split(input.mutable_data(), input.size(),
+                                               use_stdin ? "<stdin>" : input_file, conversion, split);
+            return 0;
+        }
+        
+        std::string json_output;
+        if (tar_input) {
+            // Members are converted inside the (decompressed) archive buffer;
+            // failed members are reported and left out, the rest is still written
+            yaml2json::FileContent input = use_stdin
+                ? yaml2json::FileReader::read_stream(stdin, "stdin", conversion.limits.max_input_bytes)
+                : yaml2json::FileReader::read_file(input_file, conversion.limits.max_input_bytes);
+            std::vector<std::string> errors;
+            json_output = yaml2json::ArchiveConverter::convert(input.mutable_data(), input.size(),
+                                                               use_stdin ? "<stdin>" : input_file,
+                                                               conversion, archive, errors);
+            for (const std::string& error : errors) {
+                std::cerr << error << '\n';
+            }
+            exit_status = errors.empty() ? 0 : 1;
+        } else if (!merge_files.empty()) {
+            json_output = merge_layers(merge_files, conversion, sequences);
+            if (hash_only) {
+                // The merged document has no file name of its own
+                yaml2json::ContentHash hash;
+                hash.write(json_output.data(), json_output.size());
+                json_output = hash.hex() + "  -\n";
             }
         } else {
-            // Read from file using FileReader
-            auto file_content = yaml2json::FileReader::read_file(input_file);
-            yaml_content.assign(file_content.data(), file_content.size());
-            source_name = input_file;
-        }
+            // Read input (file or stdin); gzip/zstd input is decompressed transparently
+            yaml2json::FileContent input;
+            std::string source_name;
+        
+            if (use_stdin) {
+                input = yaml2json::FileReader::read_stream(stdin, "stdin", conversion.limits.max_input_bytes);
+                source_name = "<stdin>";
+            } else {
+                input = yaml2json::FileReader::read_file(input_file, conversion.limits.max_input_bytes);
+                source_name = input_file;
+            }
         
-        // Convert YAML to JSON
-        std::string json_output = yaml2json::YamlToJsonConverter::convert(
-            const_cast<char*>(yaml_content.data()), 
-            yaml_content.size(), 
-            source_name
-        );
+            // Mapped output: emitted into the page cache of the output file
+            // without write calls (other outputs fall back to the paths below)
+            bool mappable = mmap_output && !use_stdout && yaml2json::MappedFileWriter::can_map(output_file);
+            if (mappable && !pretty_print && !hash_only &&
+                compression.format == yaml2json::CompressionFormat::None) {
+                return write_mapped(input, source_name, conversion, output_file);
+            }
         
-        // Format JSON if requested
-        if (pretty_print) {
+            // Plain JSON is written from the parsed input with writev: long strings
+            // are never copied into an output buffer
+            if (conversion.format == yaml2json::OutputFormat::Json && !pretty_print && !hash_only &&
+                compression.format == yaml2json::CompressionFormat::None && !buffered_output) {
+                return write_gathered(input, source_name, conversion, use_stdout ? "" : output_file);
+            }
+        
+            if (hash_only) {
+                // The output is hashed block by block as it is emitted, never held whole;
+                // the line reads like sha256sum's so digests of many files can be diffed
+                yaml2json::ContentHash hash;
+                yaml2json::YamlToJsonConverter::convert_to(
+                    input.mutable_data(), input.size(), source_name, conversion, hash);
+                json_output = hash.hex() + "  " + source_name + "\n";
+            } else {
+                // Convert YAML to JSON (parses in place: no copy of the input buffer)
+                json_output = yaml2json::YamlToJsonConverter::convert(
+                    input.mutable_data(), 
+                    input.size(), 
+                    source_name,
+                    conversion
+                );
+            }
+        }
+        
+        // Format JSON if requested (archive members are indented one by one)
+        if (pretty_print && !tar_input) {
             json_output = yaml2json::JsonFormatter::pretty_print(json_output);
         }
         
+        // Compress output if requested
+        if (compression.format != yaml2json::CompressionFormat::None) {
+            yaml2json::TraceSpan span("compress");
+            json_output = yaml2json::Compression::compress(
+                json_output.data(), json_output.size(), compression);
+        }
+        
         // Write output (file or stdout)
+        yaml2json::TraceSpan write_span("write", use_stdout ? "<stdout>" : output_file);
         if (use_stdout) {
             // Write to stdout
             std::cout.write(json_output.data(), json_output.size());
@@ -133,6 +585,12 @@ int main(int argc, char **argv) {
                 std::cerr << "Error: Failed to write to stdout" << std::endl;
                 return 1;
             }
+        } else if (mmap_output && yaml2json::MappedFileWriter::can_map(output_file)) {
+            // The size is known: one mapping, one copy, no remaps
+            yaml2json::MappedFileWriter output(output_file);
+            output.reserve(json_output.size());
+            output.write(json_output.data(), json_output.size());
+            output.finish();
         } else {
             // Write to file
             std::ofstream output(output_file, std::ios::binary);
@@ -159,5 +617,26 @@ int main(int argc, char **argv) {
         return 1;
     }
     
-    return 0;
-} 
\ No newline at end of file
+    return exit_status;
+}
+
+int main(int argc, char **argv) {
+    // Tiny inputs convert in well under a millisecond, so start-up dominates:
+    // the common forms skip constructing the CLI parser altogether
+    if (is_plain_invocation(argc, argv)) {
+        return run_plain(argc > 1 ? argv[1] : nullptr, argc > 2 ? argv[2] : nullptr);
+    }
+    std::string trace_file;
+    int status = run_cli(argc, argv, trace_file);
+    
+    // Written whatever the outcome: a trace of a failed run shows where it stopped
+    if (!trace_file.empty()) {
+        try {
+            yaml2json::Trace::write(trace_file);
+        } catch (const yaml2json::ConversionError& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            status = 1;
+        }
+    }
+    return status;
+}
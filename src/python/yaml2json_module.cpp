@@ -0,0 +1,324 @@
+// CPython extension module `yaml2json`: in-process conversion for Python,
+// written against the plain C API so it builds without pybind11 or nanobind
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "ErrorHandler.h"
+#include "FileReader.h"
+#include "JsonFormatter.h"
+#include "OutputSink.h"
+#include "YamlToJsonConverter.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <string>
+
+using namespace yaml2json;
+
+namespace {
+
+PyObject* g_conversion_error = nullptr;
+PyObject* g_limit_error = nullptr;
+
+// Inputs that may not be modified are parsed from a per-thread copy, kept
+// between calls unless it grew large
+constexpr size_t kMaxRetainedInput = 1 << 20;
+
+// A conversion failure captured while the GIL was released
+struct Failure {
+    enum Kind { None, Conversion, Limit, Memory, Other } kind = None;
+    std::string message;
+    size_t line = 0;
+    size_t column = 0;
+};
+
+// Fills a caller's writable buffer and keeps counting once it is full
+class BufferSink : public OutputSink {
+public:
+    BufferSink(char* out, size_t capacity) : out_(out), capacity_(capacity) {}
+
+    void write(const char* data, size_t size) override {
+        if (size_ < capacity_) {
+            std::memcpy(out_ + size_, data, std::min(size, capacity_ - size_));
+        }
+        size_ += size;
+    }
+
+    size_t size() const { return size_; }
+
+private:
+    char* out_;
+    size_t capacity_;
+    size_t size_ = 0;
+};
+
+// Releases a Py_buffer on every path out of a call
+class BufferView {
+public:
+    BufferView() { std::memset(&view_, 0, sizeof(view_)); }
+    BufferView(const BufferView&) = delete;
+    BufferView& operator=(const BufferView&) = delete;
+    ~BufferView() {
+        if (view_.obj != nullptr) {
+            PyBuffer_Release(&view_);
+        }
+    }
+
+    bool acquire(PyObject* object, int flags) { return PyObject_GetBuffer(object, &view_, flags) == 0; }
+
+    char* data() const { return static_cast<char*>(view_.buf); }
+    size_t size() const { return static_cast<size_t>(view_.len); }
+
+private:
+    Py_buffer view_;
+};
+
+// Where the YAML comes from: a buffer (copied, or parsed in place when
+// allowed) or a file (mapped, parsed in place)
+struct Source {
+    BufferView buffer;
+    bool is_path = false;
+    bool in_place = false;
+    std::string path;
+};
+
+// Run fn without the GIL, capturing any exception for raise_failure()
+template <typename Fn>
+Failure without_gil(Fn&& fn) {
+    Failure failure;
+    Py_BEGIN_ALLOW_THREADS
+    try {
+        fn();
+    } catch (const LimitExceededError& e) {
+        failure = Failure{Failure::Limit, e.detail(), e.location().line, e.location().column};
+    } catch (const ConversionError& e) {
+        failure = Failure{Failure::Conversion, e.detail(), e.location().line, e.location().column};
+    } catch (const std::bad_alloc&) {
+        failure.kind = Failure::Memory;
+    } catch (const std::exception& e) {
+        failure = Failure{Failure::Other, e.what(), 0, 0};
+    } catch (...) {
+        // Nothing may unwind past Py_END_ALLOW_THREADS with the GIL released
+        failure = Failure{Failure::Other, "Unknown error", 0, 0};
+    }
+    Py_END_ALLOW_THREADS
+    return failure;
+}
+
+// Set the Python exception for a failure; always returns null
+PyObject* raise_failure(const Failure& failure) {
+    if (failure.kind == Failure::Memory) {
+        return PyErr_NoMemory();
+    }
+    // Messages quote the input, which need not be valid UTF-8
+    PyObject* message = PyUnicode_DecodeUTF8(failure.message.data(),
+                                             static_cast<Py_ssize_t>(failure.message.size()), "replace");
+    if (message == nullptr) {
+        return nullptr;
+    }
+    if (failure.kind == Failure::Other) {
+        PyErr_SetObject(PyExc_RuntimeError, message);
+        Py_DECREF(message);
+        return nullptr;
+    }
+    PyObject* type = failure.kind == Failure::Limit ? g_limit_error : g_conversion_error;
+    PyObject* error = PyObject_CallFunctionObjArgs(type, message, nullptr);
+    Py_DECREF(message);
+    if (error == nullptr) {
+        return nullptr;
+    }
+    PyObject* line = PyLong_FromSize_t(failure.line);
+    PyObject* column = PyLong_FromSize_t(failure.column);
+    if (line != nullptr && column != nullptr) {
+        PyObject_SetAttrString(error, "line", line);
+        PyObject_SetAttrString(error, "column", column);
+    }
+    Py_XDECREF(line);
+    Py_XDECREF(column);
+    // Raised even if its position could not be attached, so the caller never
+    // returns null without an exception set
+    PyErr_Clear();
+    PyErr_SetObject(type, error);
+    Py_DECREF(error);
+    return nullptr;
+}
+
+bool parse_scalars(const char* name, ScalarTyping& scalars) {
+    if (std::strcmp(name, "json") == 0) {
+        scalars = ScalarTyping::Json;
+    } else if (std::strcmp(name, "core") == 0) {
+        scalars = ScalarTyping::Core;
+    } else if (std::strcmp(name, "yaml11") == 0) {
+        scalars = ScalarTyping::Yaml11;
+    } else {
+        PyErr_Format(PyExc_ValueError, "scalars must be 'json', 'core' or 'yaml11', not '%s'", name);
+        return false;
+    }
+    return true;
+}
+
+// Accept a str or os.PathLike as a path, anything else through the buffer protocol
+bool open_source(PyObject* object, bool in_place, Source& source) {
+    if (PyUnicode_Check(object) || PyObject_HasAttrString(object, "__fspath__")) {
+        PyObject* encoded = nullptr;
+        if (!PyUnicode_FSConverter(object, &encoded)) {
+            return false;
+        }
+        source.is_path = true;
+        source.path.assign(PyBytes_AS_STRING(encoded), static_cast<size_t>(PyBytes_GET_SIZE(encoded)));
+        Py_DECREF(encoded);
+        return true;
+    }
+    source.in_place = in_place;
+    if (!source.buffer.acquire(object, in_place ? PyBUF_WRITABLE : PyBUF_SIMPLE)) {
+        if (in_place) {
+            PyErr_SetString(PyExc_TypeError, "in_place=True needs a writable buffer such as a bytearray");
+        }
+        return false;
+    }
+    return true;
+}
+
+// Convert the source; the output goes to `sink` when given, else to `json`
+void convert_source(Source& source, const ConversionOptions& options, bool pretty, OutputSink* sink,
+                    std::string& json) {
+    static char empty[1] = {0};
+    FileContent file;
+    char* data = nullptr;
+    size_t size = 0;
+
+    thread_local std::string copy;
+    if (source.is_path) {
+        file = FileReader::read_file(source.path, options.limits.max_input_bytes);
+        data = file.size() > 0 ? file.mutable_data() : empty;
+        size = file.size();
+    } else if (source.in_place) {
+        data = source.buffer.size() > 0 ? source.buffer.data() : empty;
+        size = source.buffer.size();
+    } else {
+        copy.assign(source.buffer.data(), source.buffer.size());
+        data = &copy[0];
+        size = copy.size();
+    }
+
+    const std::string& name = source.is_path ? source.path : std::string();
+    if (sink != nullptr && !pretty) {
+        YamlToJsonConverter::convert_to(data, size, name, options, *sink);
+    } else {
+        json = YamlToJsonConverter::convert(data, size, name, options);
+        if (pretty) {
+            json = JsonFormatter::pretty_print(json);
+        }
+        if (sink != nullptr) {
+            sink->write(json.data(), json.size());
+        }
+    }
+    if (copy.capacity() > kMaxRetainedInput) {
+        std::string().swap(copy);
+    }
+}
+
+PyObject* convert(PyObject* /*module*/, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"source", "pretty", "scalars", "canonical", "out", "in_place", nullptr};
+    PyObject* source_object = nullptr;
+    int pretty = 0;
+    const char* scalars_name = "json";
+    int canonical = 0;
+    PyObject* out_object = Py_None;
+    int in_place = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$pspOp", const_cast<char**>(keywords), &source_object,
+                                     &pretty, &scalars_name, &canonical, &out_object, &in_place)) {
+        return nullptr;
+    }
+
+    ConversionOptions options;
+    if (!parse_scalars(scalars_name, options.scalars)) {
+        return nullptr;
+    }
+    options.canonical = canonical != 0;
+    if (options.canonical && pretty) {
+        PyErr_SetString(PyExc_ValueError, "canonical output cannot be pretty-printed");
+        return nullptr;
+    }
+
+    Source source;
+    if (!open_source(source_object, in_place != 0, source)) {
+        return nullptr;
+    }
+
+    std::string json;
+    if (out_object == Py_None) {
+        Failure failure = without_gil([&] { convert_source(source, options, pretty != 0, nullptr, json); });
+        if (failure.kind != Failure::None) {
+            return raise_failure(failure);
+        }
+        return PyBytes_FromStringAndSize(json.data(), static_cast<Py_ssize_t>(json.size()));
+    }
+
+    BufferView out;
+    if (!out.acquire(out_object, PyBUF_WRITABLE)) {
+        return nullptr;
+    }
+    BufferSink sink(out.data(), out.size());
+    Failure failure = without_gil([&] { convert_source(source, options, pretty != 0, &sink, json); });
+    if (failure.kind != Failure::None) {
+        return raise_failure(failure);
+    }
+    if (sink.size() > out.size()) {
+        PyErr_Format(PyExc_ValueError, "output needs %zu bytes, the buffer holds %zu", sink.size(), out.size());
+        return nullptr;
+    }
+    return PyLong_FromSize_t(sink.size());
+}
+
+PyMethodDef kMethods[] = {
+    {"convert", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(convert)), METH_VARARGS | METH_KEYWORDS,
+     "convert(source, *, pretty=False, scalars='json', canonical=False, out=None, in_place=False)\n"
+     "--\n\n"
+     "Convert YAML to JSON. source is bytes, a bytes-like object (bytearray,\n"
+     "memoryview, mmap, ...) or a path (str or os.PathLike; gzip and zstd files\n"
+     "are decompressed). Returns the JSON as bytes, or, when out is a writable\n"
+     "buffer, writes it there and returns the number of bytes written\n"
+     "(ValueError if it does not fit). A buffer source is copied once into a\n"
+     "private buffer that is parsed in place, and never into Python objects;\n"
+     "in_place=True parses inside a writable source buffer instead, overwriting\n"
+     "its contents, so it is not copied at all. The GIL is released while\n"
+     "parsing and emitting. Raises ConversionError (with line and column\n"
+     "attributes) on invalid input."},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyModuleDef kModule = {PyModuleDef_HEAD_INIT, "yaml2json", "Fast YAML to JSON conversion (rapidyaml)", -1, kMethods,
+                       nullptr, nullptr, nullptr, nullptr};
+
+} // namespace
+
+PyMODINIT_FUNC PyInit_yaml2json(void) {
+    setup_error_handlers();
+
+    PyObject* module = PyModule_Create(&kModule);
+    if (module == nullptr) {
+        return nullptr;
+    }
+    g_conversion_error = PyErr_NewExceptionWithDoc("yaml2json.ConversionError",
+                                                   "Invalid YAML or a conversion failure; line and column are "
+                                                   "1-based, 0 when unknown",
+                                                   PyExc_ValueError, nullptr);
+    g_limit_error = g_conversion_error == nullptr
+                        ? nullptr
+                        : PyErr_NewExceptionWithDoc("yaml2json.LimitExceededError",
+                                                    "The input exceeded a conversion limit", g_conversion_error,
+                                                    nullptr);
+    if (g_limit_error == nullptr) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+    Py_INCREF(g_conversion_error);
+    Py_INCREF(g_limit_error);
+    if (PyModule_AddObject(module, "ConversionError", g_conversion_error) != 0 ||
+        PyModule_AddObject(module, "LimitExceededError", g_limit_error) != 0) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
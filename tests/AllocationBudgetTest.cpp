@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "AllocationTracker.h"
+#include "FileReader.h"
+#include "YamlToJsonConverter.h"
+#include "JsonFormatter.h"
+#include "ErrorHandler.h"
+
+using namespace yaml2json;
+
+// Caps on heap use per conversion. Parsing reserves the tree and arena from
+// the input size, emitting sizes the output once, so allocation counts must
+// not grow with the document; a per-node or per-scalar allocation, or an
+// extra copy of the input or output, breaks these. When a change lowers the
+// numbers, tighten the caps.
+
+namespace {
+
+// rapidyaml's node array (reserved from the input size, doubled as it
+// fills), the arena and the output
+constexpr uint64_t kMaxCount = 48;
+constexpr uint64_t kFixedBytes = 512 * 1024;
+constexpr uint64_t kBytesPerInputByte = 48;
+
+// Between parse_tree and convert: the output string, sized once
+constexpr uint64_t kMaxEmitCount = 4;
+
+// Error message, location and detail strings
+constexpr uint64_t kMaxErrorCount = 24;
+
+std::string read_test_file(const std::string& name) {
+    FileContent content = FileReader::read_file("tests/test_data/" + name);
+    return std::string(content.data(), content.size());
+}
+
+// About 1MB of records in the shape of the benchmark corpus
+std::string large_document() {
+    std::string yaml = "items:\n";
+    for (int i = 0; yaml.size() < (1 << 20); ++i) {
+        std::string n = std::to_string(i);
+        yaml += "  - id: " + n + "\n";
+        yaml += "    name: \"item " + n + "\"\n";
+        yaml += "    enabled: true\n";
+        yaml += "    tags: [alpha, beta, gamma]\n";
+        yaml += "    owner:\n      team: platform\n      email: team" + n + "@example.com\n";
+    }
+    return yaml;
+}
+
+// Conversion of a private copy (parsing is in place), measured alone
+AllocationStats measure_convert(std::string yaml, std::string* json = nullptr) {
+    AllocationScope scope;
+    std::string out = YamlToJsonConverter::convert(&yaml[0], yaml.size(), "input.yaml");
+    AllocationStats used = scope.used();
+    if (json != nullptr) {
+        *json = std::move(out);
+    }
+    return used;
+}
+
+AllocationStats measure_parse(std::string yaml) {
+    AllocationScope scope;
+    ryml::Tree tree = YamlToJsonConverter::parse_tree(&yaml[0], yaml.size(), "input.yaml", ConversionOptions{});
+    return scope.used();
+}
+
+AllocationStats measure_error(std::string yaml) {
+    AllocationScope scope;
+    EXPECT_THROW(YamlToJsonConverter::convert(&yaml[0], yaml.size(), "input.yaml"), ConversionError);
+    return scope.used();
+}
+
+void expect_within_budget(const AllocationStats& used, size_t input_bytes) {
+    EXPECT_LE(used.count, kMaxCount);
+    EXPECT_LE(used.bytes, kFixedBytes + kBytesPerInputByte * input_bytes);
+}
+
+} // namespace
+
+class AllocationBudgetTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setup_error_handlers();
+        AllocationTracker::install();
+    }
+};
+
+TEST_F(AllocationBudgetTest, Tracker_CountsNewAndRymlAllocations) {
+    // Called directly: a new-expression and its delete may be optimized away
+    AllocationScope scope;
+    void* mem = ::operator new(1000);
+    ::operator delete(mem);
+    AllocationStats used = scope.used();
+    EXPECT_EQ(used.count, 1u);
+    EXPECT_EQ(used.bytes, 1000u);
+
+    AllocationScope parse_scope;
+    measure_parse("a: 1\n");
+    EXPECT_GE(parse_scope.used().count, 1u);  // the tree's node array goes through the ryml callbacks
+}
+
+TEST_F(AllocationBudgetTest, SmallDocuments_StayWithinBudget) {
+    for (const char* name : {"simple.yaml", "nested.yaml"}) {
+        SCOPED_TRACE(name);
+        std::string yaml = read_test_file(name);
+        expect_within_budget(measure_convert(yaml), yaml.size());
+    }
+}
+
+TEST_F(AllocationBudgetTest, LargeDocument_CountDoesNotGrowWithSize) {
+    std::string yaml = large_document();
+    AllocationStats small = measure_convert(read_test_file("simple.yaml"));
+    AllocationStats large = measure_convert(yaml);
+
+    expect_within_budget(large, yaml.size());
+    EXPECT_LE(large.count, small.count + 16) << "allocations scale with the document";
+}
+
+TEST_F(AllocationBudgetTest, Emit_AllocatesOnlyTheOutput) {
+    std::string yaml = large_document();
+    std::string json;
+    AllocationStats parsed = measure_parse(yaml);
+    AllocationStats converted = measure_convert(yaml, &json);
+
+    ASSERT_GE(converted.count, parsed.count);
+    EXPECT_LE(converted.count - parsed.count, kMaxEmitCount);
+    EXPECT_LE(converted.bytes - parsed.bytes, 2 * json.size() + 4096);
+}
+
+TEST_F(AllocationBudgetTest, AliasesAndMergeKeys_StayWithinBudget) {
+    // The expanding emitter indexes anchors and collects merged entries
+    std::string yaml = read_test_file("merge_keys.yaml");
+    AllocationStats used = measure_convert(yaml);
+    EXPECT_LE(used.count, 2 * kMaxCount);
+    EXPECT_LE(used.bytes, kFixedBytes + kBytesPerInputByte * yaml.size());
+}
+
+TEST_F(AllocationBudgetTest, PrettyPrint_GrowsTheOutputFewTimes) {
+    std::string json;
+    measure_convert(large_document(), &json);
+
+    AllocationScope scope;
+    std::string pretty = JsonFormatter::pretty_print(json);
+    AllocationStats used = scope.used();
+    EXPECT_LE(used.count, 4u);
+    EXPECT_LE(used.bytes, 4 * pretty.size());
+}
+
+TEST_F(AllocationBudgetTest, ErrorPath_StaysWithinBudget) {
+    std::string yaml = read_test_file("invalid.yaml");
+    AllocationStats used = measure_error(yaml);
+    EXPECT_LE(used.count, kMaxErrorCount);
+    EXPECT_LE(used.bytes, kFixedBytes + kBytesPerInputByte * yaml.size());
+}
+
+TEST_F(AllocationBudgetTest, ErrorPath_CountDoesNotGrowWithInput) {
+    // An unclosed flow sequence ahead of a large input: reporting the error
+    // must not allocate per line
+    std::string yaml = "key: [unclosed\n" + large_document();
+    AllocationStats used = measure_error(yaml);
+    EXPECT_LE(used.count, kMaxErrorCount);
+    EXPECT_LE(used.bytes, kFixedBytes + kBytesPerInputByte * yaml.size());
+}
@@ -0,0 +1,69 @@
+#include "AllocationTracker.h"
+#include "ErrorHandler.h"
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+namespace yaml2json {
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+std::atomic<uint64_t> allocated_bytes{0};
+
+void* counted_malloc(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* ryml_allocate(size_t len, void* /*hint*/, void* /*user_data*/) {
+    void* mem = counted_malloc(len);
+    if (mem == nullptr) {
+        throw std::bad_alloc();
+    }
+    return mem;
+}
+
+void ryml_free(void* mem, size_t /*size*/, void* /*user_data*/) {
+    std::free(mem);
+}
+
+} // namespace
+
+void AllocationTracker::install() {
+    static std::once_flag installed;
+    std::call_once(installed, [] {
+        // Install the error handler first so its one-time setup cannot replace these
+        setup_error_handlers();
+        ryml::Callbacks callbacks = ryml::get_callbacks();
+        callbacks.m_allocate = ryml_allocate;
+        callbacks.m_free = ryml_free;
+        ryml::set_callbacks(callbacks);
+    });
+}
+
+AllocationStats AllocationTracker::total() {
+    return AllocationStats{allocations.load(std::memory_order_relaxed),
+                           allocated_bytes.load(std::memory_order_relaxed)};
+}
+
+} // namespace yaml2json
+
+// The array and nothrow forms of the standard library call these two
+void* operator new(std::size_t size) {
+    void* mem = yaml2json::counted_malloc(size);
+    if (mem == nullptr) {
+        throw std::bad_alloc();
+    }
+    return mem;
+}
+
+void operator delete(void* mem) noexcept {
+    std::free(mem);
+}
+
+void operator delete(void* mem, std::size_t) noexcept {
+    std::free(mem);
+}
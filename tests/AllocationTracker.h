@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+namespace yaml2json {
+
+// Heap allocations made between two points
+struct AllocationStats {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+// Test-only allocation counting. The test binary replaces the global
+// operator new/delete with counting versions; install() also routes
+// rapidyaml's allocate/free callbacks (its tree, arena and parser use malloc,
+// not new) through the counters. Counts are process-wide: nothing else may
+// run while a block is measured.
+class AllocationTracker {
+public:
+    // Count rapidyaml's allocations too; keeps the installed error handler
+    static void install();
+
+    // Everything allocated since the process started
+    static AllocationStats total();
+};
+
+// Allocations made since construction
+class AllocationScope {
+public:
+    AllocationScope() : start_(AllocationTracker::total()) {}
+
+    AllocationStats used() const {
+        AllocationStats now = AllocationTracker::total();
+        return AllocationStats{now.count - start_.count, now.bytes - start_.bytes};
+    }
+
+private:
+    AllocationStats start_;
+};
+
+} // namespace yaml2json
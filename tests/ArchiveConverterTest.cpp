@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "ArchiveConverter.h"
+#include "TarArchive.h"
+#include "ErrorHandler.h"
+
+using namespace yaml2json;
+
+namespace {
+
+std::string make_archive(const std::vector<std::pair<std::string, std::string>>& files) {
+    std::string archive;
+    for (const auto& file : files) {
+        TarArchive::append_file(archive, file.first, file.second.data(), file.second.size());
+    }
+    TarArchive::finish(archive);
+    return archive;
+}
+
+std::string member_text(const std::string& archive, const TarMember& member) {
+    return archive.substr(member.offset, member.size);
+}
+
+} // namespace
+
+TEST(TarArchiveTest, RoundTripsMembers) {
+    std::string long_dir(120, 'd');
+    std::string long_name(150, 'n');
+    std::string archive = make_archive({{"a.yaml", "x: 1\n"},
+                                        {long_dir + "/values.yaml", std::string(1000, 'y')},
+                                        {long_name + ".yml", ""}});
+
+    ASSERT_EQ(archive.size() % TarArchive::kBlockSize, 0u);
+    auto members = TarArchive::members(archive.data(), archive.size());
+    ASSERT_EQ(members.size(), 3u);
+    EXPECT_EQ(members[0].path, "a.yaml");
+    EXPECT_EQ(member_text(archive, members[0]), "x: 1\n");
+    EXPECT_EQ(members[1].path, long_dir + "/values.yaml");  // ustar prefix
+    EXPECT_EQ(members[1].size, 1000u);
+    EXPECT_EQ(members[2].path, long_name + ".yml");         // pax path record
+    EXPECT_EQ(members[2].size, 0u);
+}
+
+TEST(TarArchiveTest, RejectsDamagedArchives) {
+    std::string archive = make_archive({{"a.yaml", "x: 1\n"}});
+
+    std::string corrupt = archive;
+    corrupt[10] ^= 1;
+    EXPECT_THROW(TarArchive::members(corrupt.data(), corrupt.size()), ConversionError);
+
+    std::string big = make_archive({{"big.yaml", std::string(1000, 'x')}});
+    EXPECT_THROW(TarArchive::members(big.data(), TarArchive::kBlockSize + 100), ConversionError);
+    EXPECT_FALSE(TarArchive::looks_like_tar("plain: yaml\n", 12));
+}
+
+class ArchiveConverterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setup_error_handlers();
+    }
+
+    std::string convert(const std::vector<std::pair<std::string, std::string>>& files, ArchiveOutput output,
+                        size_t threads = 4) {
+        buffer_ = make_archive(files);
+        ConversionOptions options;
+        options.threads = threads;
+        ArchiveOptions archive;
+        archive.output = output;
+        errors_.clear();
+        return ArchiveConverter::convert(&buffer_[0], buffer_.size(), "chart.tgz", options, archive, errors_);
+    }
+
+    std::string buffer_;
+    std::vector<std::string> errors_;
+};
+
+TEST_F(ArchiveConverterTest, TarOutputRenamesAndConvertsYamlMembers) {
+    std::string out = convert({{"chart/Chart.yaml", "name: web\nversion: 1.0.0\n"},
+                               {"chart/README.md", "# not yaml\n"},
+                               {"chart/values.yml", "replicas: 2\n"}},
+                              ArchiveOutput::Tar);
+
+    EXPECT_TRUE(errors_.empty());
+    auto members = TarArchive::members(out.data(), out.size());
+    ASSERT_EQ(members.size(), 2u);
+    EXPECT_EQ(members[0].path, "chart/Chart.json");
+    EXPECT_EQ(member_text(out, members[0]), R"({"name": "web","version": "1.0.0"})");
+    EXPECT_EQ(members[1].path, "chart/values.json");
+    EXPECT_EQ(member_text(out, members[1]), R"({"replicas": 2})");
+}
+
+TEST_F(ArchiveConverterTest, NdjsonHasOneRecordPerDocument) {
+    std::string out = convert({{"a.yaml", "kind: A\n---\nkind: B\n"}, {"dir/b.yml", "[1, 2]\n"}},
+                              ArchiveOutput::Ndjson);
+
+    EXPECT_EQ(out, "{\"path\":\"a.yaml\",\"document\":0,\"value\":{\"kind\": \"A\"}}\n"
+                   "{\"path\":\"a.yaml\",\"document\":1,\"value\":{\"kind\": \"B\"}}\n"
+                   "{\"path\":\"dir/b.yml\",\"document\":0,\"value\":[1,2]}\n");
+}
+
+TEST_F(ArchiveConverterTest, FailedMembersAreReportedAndSkipped) {
+    std::string out = convert({{"good.yaml", "a: 1\n"}, {"bad.yaml", "a: [1\n"}, {"also_good.yaml", "b: 2\n"}},
+                              ArchiveOutput::Ndjson);
+
+    ASSERT_EQ(errors_.size(), 1u);
+    EXPECT_EQ(errors_[0].rfind("chart.tgz:bad.yaml:", 0), 0u);
+    EXPECT_NE(out.find("good.yaml"), std::string::npos);
+    EXPECT_NE(out.find("also_good.yaml"), std::string::npos);
+    EXPECT_EQ(out.find("\"bad.yaml\""), std::string::npos);
+}
+
+TEST_F(ArchiveConverterTest, ParallelOutputKeepsArchiveOrder) {
+    std::vector<std::pair<std::string, std::string>> files;
+    for (int i = 0; i < 300; ++i) {
+        files.emplace_back("m" + std::to_string(i) + ".yaml", "i: " + std::to_string(i) + "\n");
+    }
+
+    std::string serial = convert(files, ArchiveOutput::Tar, 1);
+    EXPECT_EQ(convert(files, ArchiveOutput::Tar, 8), serial);
+}
+
+TEST_F(ArchiveConverterTest, RejectsInputThatIsNoTar) {
+    std::string yaml = "a: 1\n" + std::string(600, ' ');
+    std::vector<std::string> errors;
+
+    EXPECT_THROW(ArchiveConverter::convert(&yaml[0], yaml.size(), "x.yaml", ConversionOptions{}, ArchiveOptions{},
+                                           errors),
+                 ConversionError);
+}
+
+TEST(ArchiveConverterPathTest, OutputPaths) {
+    EXPECT_TRUE(ArchiveConverter::is_yaml_path("a/b.yaml"));
+    EXPECT_TRUE(ArchiveConverter::is_yaml_path("b.yml"));
+    EXPECT_FALSE(ArchiveConverter::is_yaml_path("b.yaml.bak"));
+    EXPECT_EQ(ArchiveConverter::output_path("a/b.yaml", OutputFormat::Json), "a/b.json");
+    EXPECT_EQ(ArchiveConverter::output_path("a.b/c.yml", OutputFormat::Cbor), "a.b/c.cbor");
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <initializer_list>
+#include "YamlToJsonConverter.h"
+#include "FileReader.h"
+#include "ErrorHandler.h"
+
+using namespace yaml2json;
+
+class BinaryEmitterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setup_error_handlers();
+    }
+
+    std::string bytes(std::initializer_list<int> values) {
+        std::string out;
+        for (int v : values) {
+            out += static_cast<char>(v);
+        }
+        return out;
+    }
+
+    std::string convert(const char* yaml, OutputFormat format) {
+        std::string buffer(yaml);
+        return YamlToJsonConverter::convert(buffer.data(), buffer.size(), "", format);
+    }
+
+    std::string convert(std::string yaml, OutputFormat format, const ConversionLimits& limits) {
+        ConversionOptions options;
+        options.format = format;
+        options.limits = limits;
+        return YamlToJsonConverter::convert(yaml.data(), yaml.size(), "", options);
+    }
+
+    std::string convertFile(const std::string& path, OutputFormat format,
+                            const ConversionLimits& limits = ConversionLimits{}) {
+        auto content = FileReader::read_file(path);
+        return convert(std::string(content.data(), content.size()), format, limits);
+    }
+};
+
+TEST_F(BinaryEmitterTest, Cbor_SimpleMap) {
+    EXPECT_EQ(convert("a: 1", OutputFormat::Cbor), bytes({0xa1, 0x61, 'a', 0x01}));
+}
+
+TEST_F(BinaryEmitterTest, MsgPack_SimpleMap) {
+    EXPECT_EQ(convert("a: 1", OutputFormat::MsgPack), bytes({0x81, 0xa1, 'a', 0x01}));
+}
+
+TEST_F(BinaryEmitterTest, Cbor_TypedScalars) {
+    EXPECT_EQ(convert("[true, null, -1, 1.5, x]", OutputFormat::Cbor),
+              bytes({0x85, 0xf5, 0xf6, 0x20, 0xfa, 0x3f, 0xc0, 0x00, 0x00, 0x61, 'x'}));
+}
+
+TEST_F(BinaryEmitterTest, MsgPack_TypedScalars) {
+    EXPECT_EQ(convert("[true, null, -1, 1.5, x]", OutputFormat::MsgPack),
+              bytes({0x95, 0xc3, 0xc0, 0xff, 0xca, 0x3f, 0xc0, 0x00, 0x00, 0xa1, 'x'}));
+}
+
+TEST_F(BinaryEmitterTest, QuotedScalarsStayStrings) {
+    EXPECT_EQ(convert("['1', \"true\"]", OutputFormat::Cbor),
+              bytes({0x82, 0x61, '1', 0x64, 't', 'r', 'u', 'e'}));
+}
+
+TEST_F(BinaryEmitterTest, Cbor_WideIntegers) {
+    EXPECT_EQ(convert("[255, 65536, -1000]", OutputFormat::Cbor),
+              bytes({0x83, 0x18, 0xff, 0x1a, 0x00, 0x01, 0x00, 0x00, 0x39, 0x03, 0xe7}));
+}
+
+TEST_F(BinaryEmitterTest, MsgPack_WideIntegers) {
+    EXPECT_EQ(convert("[255, 65536, -1000]", OutputFormat::MsgPack),
+              bytes({0x93, 0xcc, 0xff, 0xce, 0x00, 0x01, 0x00, 0x00, 0xd1, 0xfc, 0x18}));
+}
+
+TEST_F(BinaryEmitterTest, MultiDocumentStreamIsASequence) {
+    EXPECT_EQ(convert("--- 1\n--- 2\n", OutputFormat::Cbor), bytes({0x01, 0x02}));
+    EXPECT_EQ(convert("--- 1\n--- 2\n", OutputFormat::MsgPack), bytes({0x01, 0x02}));
+}
+
+TEST_F(BinaryEmitterTest, NestedStructure) {
+    std::string cbor = convert("db:\n  ports: [1, 2]\n", OutputFormat::Cbor);
+    EXPECT_EQ(cbor, bytes({0xa1, 0x62, 'd', 'b', 0xa1, 0x65, 'p', 'o', 'r', 't', 's', 0x82, 0x01, 0x02}));
+}
+
+TEST_F(BinaryEmitterTest, Alias_EncodesTheAnchoredValue) {
+    const char* aliased = "base: &b {x: 1, y: [a, 2]}\ncopy: *b\nname: &n joe\nwho: *n\n";
+    const char* expanded = "base: {x: 1, y: [a, 2]}\ncopy: {x: 1, y: [a, 2]}\nname: joe\nwho: joe\n";
+    for (OutputFormat format : {OutputFormat::Cbor, OutputFormat::MsgPack}) {
+        EXPECT_EQ(convert(aliased, format), convert(expanded, format));
+    }
+}
+
+TEST_F(BinaryEmitterTest, Alias_AsKey) {
+    EXPECT_EQ(convert("k: &key shared\n*key : value\n", OutputFormat::Cbor),
+              bytes({0xa2, 0x61, 'k', 0x66, 's', 'h', 'a', 'r', 'e', 'd',
+                     0x66, 's', 'h', 'a', 'r', 'e', 'd', 0x65, 'v', 'a', 'l', 'u', 'e'}));
+}
+
+TEST_F(BinaryEmitterTest, Alias_UndefinedThrows) {
+    EXPECT_THROW(convert("a: *missing\n", OutputFormat::Cbor), ConversionError);
+    EXPECT_THROW(convert("a: *missing\n", OutputFormat::MsgPack), ConversionError);
+}
+
+TEST_F(BinaryEmitterTest, MergeKey_MatchesJsonOutput) {
+    // The same entries, in the same order, as JsonEmitterTest.MergeKey_ExplicitKeysWin
+    const char* expanded =
+        "defaults: {image: ubuntu:22.04, timeout: 30, retries: 2}\n"
+        "build: {image: ubuntu:22.04, timeout: 30, retries: 2, script: make}\n"
+        "test: {image: ubuntu:22.04, timeout: 60, retries: 2, script: make test}\n";
+    for (OutputFormat format : {OutputFormat::Cbor, OutputFormat::MsgPack}) {
+        EXPECT_EQ(convertFile("tests/test_data/merge_keys.yaml", format), convert(expanded, format));
+    }
+}
+
+TEST_F(BinaryEmitterTest, BillionLaughs_FailsFast) {
+    for (OutputFormat format : {OutputFormat::Cbor, OutputFormat::MsgPack}) {
+        EXPECT_THROW(convertFile("tests/test_data/billion_laughs.yaml", format), LimitExceededError);
+
+        ConversionLimits limits;
+        limits.max_alias_expansion = 0;
+        limits.max_output_bytes = 1 << 20;
+        EXPECT_THROW(convertFile("tests/test_data/billion_laughs.yaml", format, limits), LimitExceededError);
+    }
+}
+
+TEST_F(BinaryEmitterTest, Limits_DepthCountsThroughAliases) {
+    ConversionLimits limits;
+    limits.max_depth = 3;
+
+    EXPECT_NO_THROW(convert("a: &a {b: {c: 1}}\n", OutputFormat::Cbor, limits));
+    EXPECT_THROW(convert("a: &a {b: {c: 1}}\nd: [*a]\n", OutputFormat::Cbor, limits), LimitExceededError);
+    EXPECT_THROW(convert("a: &a {b: {c: 1}}\nd: [*a]\n", OutputFormat::MsgPack, limits), LimitExceededError);
+}
+
+TEST_F(BinaryEmitterTest, Limits_OutputBytes) {
+    ConversionLimits limits;
+    limits.max_output_bytes = 8;
+
+    EXPECT_THROW(convert("items: [one, two, three, four]\n", OutputFormat::MsgPack, limits), LimitExceededError);
+    EXPECT_EQ(convert("a: 1", OutputFormat::MsgPack, limits), bytes({0x81, 0xa1, 'a', 0x01}));
+}
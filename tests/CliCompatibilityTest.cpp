@@ -380,4 +380,141 @@ TEST_F(CliCompatibilityTest, ComplexNestedStructure_AllModes) {
     
     // Clean up
     std::filesystem::remove("complex_test.yaml");
-} 
\ No newline at end of file
+} 
+
+TEST_F(CliCompatibilityTest, Check_ValidatesManyFilesWithoutOutput) {
+    createTestFile("check_invalid.yaml", "key: value\nother: [unclosed");
+    
+    std::string ok = runCommand(getExecutablePath() + " --check test_simple.yaml test_nested.yaml 2>&1");
+    EXPECT_TRUE(ok.empty());
+    EXPECT_EQ(system((getExecutablePath() + " --check test_simple.yaml test_nested.yaml").c_str()), 0);
+    
+    std::string errors = runCommand(getExecutablePath() +
+        " --check -j 2 test_simple.yaml check_invalid.yaml test_nested.yaml 2>&1");
+    EXPECT_EQ(errors.rfind("check_invalid.yaml:", 0), 0u);
+    EXPECT_EQ(errors.find("test_simple.yaml"), std::string::npos);
+    EXPECT_NE(system((getExecutablePath() + " --check test_simple.yaml check_invalid.yaml 2>" +
+                      getNullDevice()).c_str()), 0);
+    
+    std::filesystem::remove("check_invalid.yaml");
+}
+
+TEST_F(CliCompatibilityTest, GatheredOutput_MatchesBufferedOutput) {
+    std::string long_text(200, 'x');
+    createTestFile("gather_test.yaml", "short: a\nlong: \"" + long_text + "\"\nlist: [" + long_text + ", 1]\n");
+    
+    std::string gathered = runCommand(getExecutablePath() + " gather_test.yaml");
+    std::string buffered = runCommand(getExecutablePath() + " --buffered-output gather_test.yaml");
+    EXPECT_EQ(gathered, buffered);
+    
+    EXPECT_EQ(system((getExecutablePath() + " gather_test.yaml output_test.json").c_str()), 0);
+    EXPECT_EQ(readFile("output_test.json"), buffered);
+    
+    std::filesystem::remove("gather_test.yaml");
+}
+
+TEST_F(CliCompatibilityTest, FailedConversion_KeepsExistingOutput) {
+    createTestFile("keep_invalid.yaml", "key: value\nother: [unclosed");
+    createTestFile("output_test.json", "{\"previous\": true}");
+    
+    EXPECT_NE(system((getExecutablePath() + " -i keep_invalid.yaml -o output_test.json 2>" +
+                      getNullDevice()).c_str()), 0);
+    EXPECT_EQ(readFile("output_test.json"), "{\"previous\": true}");
+    
+    // Nor is the temporary it was written to left behind
+    for (const auto& entry : std::filesystem::directory_iterator(".")) {
+        EXPECT_NE(entry.path().filename().string().rfind("output_test.json.", 0), 0u) << entry.path();
+    }
+    
+    std::filesystem::remove("keep_invalid.yaml");
+}
+
+TEST_F(CliCompatibilityTest, OutputReplacingInput_ConvertsTheOriginal) {
+    // Long strings are written by reference into the mapped input
+    std::string long_text(200, 'z');
+    std::string yaml = "text: \"" + long_text + "\"\nlist: [" + long_text + ", 'quoted', 2]\n";
+    createTestFile("same_file.yaml", yaml);
+    std::string expected = runCommand(getExecutablePath() + " same_file.yaml");
+    ASSERT_FALSE(expected.empty());
+    
+    EXPECT_EQ(system((getExecutablePath() + " -i same_file.yaml -o same_file.yaml").c_str()), 0);
+    EXPECT_EQ(readFile("same_file.yaml"), expected);
+    
+    std::filesystem::remove("same_file.yaml");
+}
+
+TEST_F(CliCompatibilityTest, PlainInvocation_KeepsOutputAndMayReplaceInput) {
+    // `yaml2json in out` skips the option parser; it must be as safe as -i/-o
+    createTestFile("plain_invalid.yaml", "key: value\nother: [unclosed");
+    createTestFile("output_test.json", "{\"previous\": true}");
+    EXPECT_NE(system((getExecutablePath() + " plain_invalid.yaml output_test.json 2>" +
+                      getNullDevice()).c_str()), 0);
+    EXPECT_EQ(readFile("output_test.json"), "{\"previous\": true}");
+    
+    std::string long_text(200, 'w');
+    createTestFile("plain_same.yaml", "a: \"" + long_text + "\"\nb: [" + long_text + ", \"x\\ty\"]\n");
+    std::string expected = runCommand(getExecutablePath() + " plain_same.yaml");
+    ASSERT_FALSE(expected.empty());
+    EXPECT_EQ(system((getExecutablePath() + " plain_same.yaml plain_same.yaml").c_str()), 0);
+    EXPECT_EQ(readFile("plain_same.yaml"), expected);
+    
+    std::filesystem::remove("plain_invalid.yaml");
+    std::filesystem::remove("plain_same.yaml");
+}
+
+TEST_F(CliCompatibilityTest, MappedOutput_MatchesDefaultOutput) {
+    std::string long_text(300, 'y');
+    createTestFile("mapped_test.yaml", "a: 1\nb: [" + long_text + ", \"quoted\\n\"]\nc: {d: true}\n");
+    
+    std::string expected = runCommand(getExecutablePath() + " mapped_test.yaml");
+    EXPECT_EQ(system((getExecutablePath() + " --mmap-output mapped_test.yaml output_test.json").c_str()), 0);
+    EXPECT_EQ(readFile("output_test.json"), expected);
+    
+    // Pretty output is written through a mapping of its exact size
+    std::string pretty = runCommand(getExecutablePath() + " --pretty mapped_test.yaml");
+    EXPECT_EQ(system((getExecutablePath() + " --mmap-output --pretty mapped_test.yaml output_test.json").c_str()), 0);
+    EXPECT_EQ(readFile("output_test.json"), pretty);
+    
+    // stdout cannot be mapped and is written as before
+    EXPECT_EQ(runCommand(getExecutablePath() + " --mmap-output mapped_test.yaml"), expected);
+    
+    std::filesystem::remove("mapped_test.yaml");
+}
+
+TEST_F(CliCompatibilityTest, MappedOutput_KeepsOutputAndMayReplaceInput) {
+    createTestFile("mapped_invalid.yaml", "key: value\nother: [unclosed");
+    createTestFile("output_test.json", "{\"previous\": true}");
+    EXPECT_NE(system((getExecutablePath() + " --mmap-output mapped_invalid.yaml output_test.json 2>" +
+                      getNullDevice()).c_str()), 0);
+    EXPECT_EQ(readFile("output_test.json"), "{\"previous\": true}");
+    
+    std::string long_text(300, 'v');
+    createTestFile("mapped_same.yaml", "a: \"" + long_text + "\"\nb: [" + long_text + ", 'q']\n");
+    std::string expected = runCommand(getExecutablePath() + " mapped_same.yaml");
+    ASSERT_FALSE(expected.empty());
+    EXPECT_EQ(system((getExecutablePath() + " --mmap-output mapped_same.yaml mapped_same.yaml").c_str()), 0);
+    EXPECT_EQ(readFile("mapped_same.yaml"), expected);
+    
+    std::filesystem::remove("mapped_invalid.yaml");
+    std::filesystem::remove("mapped_same.yaml");
+}
+
+TEST_F(CliCompatibilityTest, Trace_WritesChromeTraceEvents) {
+    std::string output = runCommand(getExecutablePath() + " --trace=trace_test.json --pretty test_nested.yaml");
+    EXPECT_EQ(output, runCommand(getExecutablePath() + " --pretty test_nested.yaml"));
+    
+    std::string trace = readFile("trace_test.json");
+    EXPECT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0u);
+    for (const char* span : {"\"read\"", "\"parse\"", "\"emit\"", "\"format\"", "\"write\""}) {
+        EXPECT_NE(trace.find(span), std::string::npos) << span;
+    }
+    EXPECT_NE(trace.find("\"detail\":\"test_nested.yaml\""), std::string::npos);
+    
+    // A failed run still leaves its trace
+    std::filesystem::remove("trace_test.json");
+    EXPECT_NE(system((getExecutablePath() + " --trace trace_test.json --max-nodes 1 test_nested.yaml 2>" +
+                      getNullDevice()).c_str()), 0);
+    EXPECT_NE(readFile("trace_test.json").find("\"parse\""), std::string::npos);
+    
+    std::filesystem::remove("trace_test.json");
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "Compression.h"
+#include "FileReader.h"
+#include "ErrorHandler.h"
+#include <fstream>
+#include <filesystem>
+
+using namespace yaml2json;
+
+class CompressionTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        std::filesystem::remove("compressed_test.yaml.gz");
+        std::filesystem::remove("compressed_test.yaml.zst");
+    }
+
+    void writeFile(const std::string& path, const std::string& content) {
+        std::ofstream file(path, std::ios::binary);
+        file.write(content.data(), content.size());
+    }
+
+    std::string sampleYaml() {
+        std::string yaml = "items:\n";
+        for (int i = 0; i < 2000; ++i) {
+            yaml += "  - name: item" + std::to_string(i) + "\n";
+        }
+        return yaml;
+    }
+
+    void expectRoundTrip(CompressionFormat format) {
+        if (!Compression::is_supported(format)) {
+            GTEST_SKIP() << Compression::name(format) << " support not built";
+        }
+        CompressionOptions options;
+        options.format = format;
+
+        std::string yaml = sampleYaml();
+        std::string packed = Compression::compress(yaml.data(), yaml.size(), options);
+
+        EXPECT_LT(packed.size(), yaml.size());
+        EXPECT_EQ(Compression::detect(packed.data(), packed.size()), format);
+        EXPECT_EQ(Compression::decompress(packed.data(), packed.size(), format), yaml);
+    }
+};
+
+TEST_F(CompressionTest, Detect_MagicBytes) {
+    const char gzip[] = "\x1f\x8b\x08\x00";
+    const char zstd[] = "\x28\xb5\x2f\xfd";
+    const char plain[] = "key: value";
+
+    EXPECT_EQ(Compression::detect(gzip, 4), CompressionFormat::Gzip);
+    EXPECT_EQ(Compression::detect(zstd, 4), CompressionFormat::Zstd);
+    EXPECT_EQ(Compression::detect(plain, 10), CompressionFormat::None);
+    EXPECT_EQ(Compression::detect(gzip, 1), CompressionFormat::None);
+}
+
+TEST_F(CompressionTest, ParseSpec_Valid) {
+    if (Compression::is_supported(CompressionFormat::Zstd)) {
+        CompressionOptions options = Compression::parse_spec("zstd:19");
+        EXPECT_EQ(options.format, CompressionFormat::Zstd);
+        EXPECT_EQ(options.level, 19);
+    }
+    if (Compression::is_supported(CompressionFormat::Gzip)) {
+        CompressionOptions options = Compression::parse_spec("gzip");
+        EXPECT_EQ(options.format, CompressionFormat::Gzip);
+        EXPECT_EQ(options.level, -1);
+    }
+}
+
+TEST_F(CompressionTest, ParseSpec_Invalid) {
+    EXPECT_THROW(Compression::parse_spec("brotli"), ConversionError);
+    EXPECT_THROW(Compression::parse_spec("gzip:10"), ConversionError);
+    EXPECT_THROW(Compression::parse_spec("zstd:fast"), ConversionError);
+}
+
+TEST_F(CompressionTest, RoundTrip_Gzip) {
+    expectRoundTrip(CompressionFormat::Gzip);
+}
+
+TEST_F(CompressionTest, RoundTrip_Zstd) {
+    expectRoundTrip(CompressionFormat::Zstd);
+}
+
+TEST_F(CompressionTest, Decompress_HighRatioFillsOutputExactly) {
+    // 8 MB of zeros: well past the size-hint ratio, ends exactly on a buffer boundary
+    std::string zeros(8 << 20, '0');
+    for (CompressionFormat format : {CompressionFormat::Gzip, CompressionFormat::Zstd}) {
+        if (!Compression::is_supported(format)) {
+            continue;
+        }
+        CompressionOptions options;
+        options.format = format;
+        std::string packed = Compression::compress(zeros.data(), zeros.size(), options);
+
+        EXPECT_EQ(Compression::decompress(packed.data(), packed.size(), format), zeros);
+    }
+}
+
+TEST_F(CompressionTest, Decompress_ConcatenatedGzipMembers) {
+    if (!Compression::is_supported(CompressionFormat::Gzip)) {
+        GTEST_SKIP() << "gzip support not built";
+    }
+    CompressionOptions options;
+    options.format = CompressionFormat::Gzip;
+    std::string first = Compression::compress("a: 1\n", 5, options);
+    std::string second = Compression::compress("b: 2\n", 5, options);
+    std::string joined = first + second;
+
+    EXPECT_EQ(Compression::decompress(joined.data(), joined.size(), CompressionFormat::Gzip),
+              "a: 1\nb: 2\n");
+}
+
+TEST_F(CompressionTest, Decompress_GzipTrailingZeroPadding) {
+    if (!Compression::is_supported(CompressionFormat::Gzip)) {
+        GTEST_SKIP() << "gzip support not built";
+    }
+    CompressionOptions options;
+    options.format = CompressionFormat::Gzip;
+    std::string yaml = sampleYaml();
+    std::string packed = Compression::compress(yaml.data(), yaml.size(), options);
+    std::string padded = packed + std::string(512, '\0');
+
+    EXPECT_EQ(Compression::decompress(padded.data(), padded.size(), CompressionFormat::Gzip), yaml);
+
+    // Anything else after a member is still an error
+    std::string garbage = packed + std::string(16, '\0') + "x";
+    EXPECT_THROW(Compression::decompress(garbage.data(), garbage.size(), CompressionFormat::Gzip),
+                 ConversionError);
+}
+
+TEST_F(CompressionTest, Decompress_TruncatedStreamThrows) {
+    for (CompressionFormat format : {CompressionFormat::Gzip, CompressionFormat::Zstd}) {
+        if (!Compression::is_supported(format)) {
+            continue;
+        }
+        CompressionOptions options;
+        options.format = format;
+        std::string yaml = sampleYaml();
+        std::string packed = Compression::compress(yaml.data(), yaml.size(), options);
+        packed.resize(packed.size() / 2);
+
+        EXPECT_THROW(Compression::decompress(packed.data(), packed.size(), format), ConversionError);
+    }
+}
+
+TEST_F(CompressionTest, FileReader_DecompressesTransparently) {
+    std::string yaml = sampleYaml();
+    const std::pair<CompressionFormat, const char*> cases[] = {
+        {CompressionFormat::Gzip, "compressed_test.yaml.gz"},
+        {CompressionFormat::Zstd, "compressed_test.yaml.zst"},
+    };
+
+    for (const auto& [format, path] : cases) {
+        if (!Compression::is_supported(format)) {
+            continue;
+        }
+        CompressionOptions options;
+        options.format = format;
+        writeFile(path, Compression::compress(yaml.data(), yaml.size(), options));
+
+        FileContent content = FileReader::read_file(path);
+        ASSERT_TRUE(content.is_valid());
+        EXPECT_TRUE(content.was_decompressed());
+        EXPECT_EQ(std::string(content.data(), content.size()), yaml);
+    }
+}
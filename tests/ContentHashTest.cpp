@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include "ContentHash.h"
+#include "YamlToJsonConverter.h"
+#include "ErrorHandler.h"
+
+using namespace yaml2json;
+
+TEST(ContentHashTest, KnownVectors) {
+    // Reference values of XXH64 with seed 0
+    EXPECT_EQ(ContentHash::of("", 0), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(ContentHash::of("a", 1), 0xD24EC4F1A98C6E5BULL);
+    EXPECT_EQ(ContentHash::of("abc", 3), 0x44BC2CF5AD770999ULL);
+    EXPECT_EQ(ContentHash().hex(), "ef46db3751d8e999");
+}
+
+TEST(ContentHashTest, StreamingMatchesOneShot) {
+    std::string data;
+    for (int i = 0; i < 1000; ++i) {
+        data += static_cast<char>('a' + i % 26);
+    }
+
+    // Piece sizes straddling the 32-byte stripe boundary
+    for (size_t piece : {1u, 7u, 31u, 32u, 33u, 100u}) {
+        ContentHash hash;
+        for (size_t pos = 0; pos < data.size(); pos += piece) {
+            hash.write(data.data() + pos, std::min(piece, data.size() - pos));
+        }
+        EXPECT_EQ(hash.digest(), ContentHash::of(data.data(), data.size())) << "piece " << piece;
+    }
+}
+
+TEST(ContentHashTest, SeedChangesDigest) {
+    EXPECT_NE(ContentHash::of("abc", 3, 1), ContentHash::of("abc", 3));
+}
+
+TEST(ContentHashTest, HashOfConversionMatchesOutput) {
+    setup_error_handlers();
+    std::string yaml = "name: test\nitems: [1, 2, 3]\nnested: {b: 2, a: 1}\n";
+    ConversionOptions options;
+    options.canonical = true;
+
+    std::string copy = yaml;
+    std::string json = YamlToJsonConverter::convert(copy.data(), copy.size(), "", options);
+    ContentHash hash;
+    YamlToJsonConverter::convert_to(yaml.data(), yaml.size(), "", options, hash);
+
+    EXPECT_EQ(hash.digest(), ContentHash::of(json.data(), json.size()));
+}
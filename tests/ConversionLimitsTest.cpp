@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "YamlToJsonConverter.h"
+#include "FileReader.h"
+#include "Compression.h"
+#include "ErrorHandler.h"
+
+using namespace yaml2json;
+
+class ConversionLimitsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setup_error_handlers();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove("limits_test.yaml");
+        std::filesystem::remove("limits_test.yaml.gz");
+    }
+
+    void writeFile(const std::string& path, const std::string& content) {
+        std::ofstream file(path, std::ios::binary);
+        file.write(content.data(), content.size());
+    }
+
+    std::string convert(std::string yaml, const ConversionLimits& limits) {
+        ConversionOptions options;
+        options.limits = limits;
+        return YamlToJsonConverter::convert(yaml.data(), yaml.size(), "", options);
+    }
+
+    std::string listYaml(int items) {
+        std::string yaml = "items:\n";
+        for (int i = 0; i < items; ++i) {
+            yaml += "  - item" + std::to_string(i) + "\n";
+        }
+        return yaml;
+    }
+};
+
+TEST_F(ConversionLimitsTest, LimitExceededError_IsConversionError) {
+    LimitExceededError error("limit");
+    const ConversionError& base = error;
+
+    EXPECT_STREQ(base.what(), "limit");
+}
+
+TEST_F(ConversionLimitsTest, FileReader_RejectsOversizedFileBeforeMapping) {
+    writeFile("limits_test.yaml", listYaml(100));
+
+    EXPECT_THROW(FileReader::read_file("limits_test.yaml", 64), LimitExceededError);
+    EXPECT_NO_THROW(FileReader::read_file("limits_test.yaml", 1 << 20));
+}
+
+TEST_F(ConversionLimitsTest, FileReader_StopsDecompressionBomb) {
+    if (!Compression::is_supported(CompressionFormat::Gzip)) {
+        GTEST_SKIP() << "gzip support not built";
+    }
+    // 8 MB of zeros compresses to a few KB
+    std::string bomb(8 << 20, '0');
+    CompressionOptions options;
+    options.format = CompressionFormat::Gzip;
+    writeFile("limits_test.yaml.gz", Compression::compress(bomb.data(), bomb.size(), options));
+
+    EXPECT_THROW(FileReader::read_file("limits_test.yaml.gz", 1 << 20), LimitExceededError);
+    EXPECT_EQ(FileReader::read_file("limits_test.yaml.gz", 16 << 20).size(), bomb.size());
+}
+
+TEST_F(ConversionLimitsTest, FileReader_StreamLimit) {
+    std::string yaml = listYaml(1000);
+    std::FILE* stream = std::tmpfile();
+    ASSERT_NE(stream, nullptr);
+    std::fwrite(yaml.data(), 1, yaml.size(), stream);
+    std::rewind(stream);
+
+    EXPECT_THROW(FileReader::read_stream(stream, "stream", 1024), LimitExceededError);
+    std::fclose(stream);
+}
+
+TEST_F(ConversionLimitsTest, Convert_InputBytes) {
+    ConversionLimits limits;
+    limits.max_input_bytes = 16;
+
+    EXPECT_THROW(convert(listYaml(10), limits), LimitExceededError);
+    EXPECT_EQ(convert("a: 1", limits), R"({"a": 1})");
+}
+
+TEST_F(ConversionLimitsTest, Check_InputBytesReportedLikeConvert) {
+    ConversionLimits limits;
+    limits.max_input_bytes = 16;
+    ConversionOptions options;
+    options.limits = limits;
+
+    std::string converted;
+    std::string checked;
+    std::string yaml = listYaml(10);
+    try {
+        YamlToJsonConverter::convert(yaml.data(), yaml.size(), "big.yaml", options);
+    } catch (const LimitExceededError& e) {
+        converted = e.what();
+    }
+    yaml = listYaml(10);
+    try {
+        YamlToJsonConverter::check(&yaml[0], yaml.size(), "big.yaml", options);
+    } catch (const LimitExceededError& e) {
+        checked = e.what();
+    }
+    EXPECT_NE(checked.find("'big.yaml'"), std::string::npos);
+    EXPECT_EQ(checked, converted);
+}
+
+TEST_F(ConversionLimitsTest, Convert_NodeCount) {
+    ConversionLimits limits;
+    limits.max_nodes = 50;
+
+    EXPECT_THROW(convert(listYaml(100), limits), LimitExceededError);
+    EXPECT_NO_THROW(convert(listYaml(10), limits));
+}
+
+TEST_F(ConversionLimitsTest, Convert_ArenaBytes) {
+    // \L (U+2028) unescapes to three bytes, too long to filter in place: it lands in the arena
+    std::string yaml = "items:\n";
+    for (int i = 0; i < 200; ++i) {
+        yaml += "  - \"sep\\L" + std::to_string(i) + "\"\n";
+    }
+    ConversionLimits limits;
+    limits.max_arena_bytes = 1;
+
+    EXPECT_THROW(convert(yaml, limits), LimitExceededError);
+}
+
+TEST_F(ConversionLimitsTest, Convert_Deadline) {
+    ConversionLimits limits;
+    limits.deadline = ConversionLimits::Clock::now() - std::chrono::milliseconds(1);
+
+    EXPECT_THROW(convert("a: 1", limits), LimitExceededError);
+
+    limits.deadline = ConversionLimits::Clock::now() + std::chrono::hours(1);
+    EXPECT_EQ(convert("a: 1", limits), R"({"a": 1})");
+}
+
+TEST_F(ConversionLimitsTest, Convert_BinaryOutputBytes) {
+    ConversionOptions options;
+    options.format = OutputFormat::Cbor;
+    options.limits.max_output_bytes = 8;
+    std::string yaml = listYaml(10);
+
+    EXPECT_THROW(YamlToJsonConverter::convert(yaml.data(), yaml.size(), "", options), LimitExceededError);
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "DocumentSplitter.h"
+#include "ErrorHandler.h"
+
+using namespace yaml2json;
+
+class DocumentSplitterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setup_error_handlers();
+        std::filesystem::remove_all(kDir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(kDir);
+    }
+
+    size_t split(std::string yaml, const std::string& name_template = NameTemplate::kDefault, size_t threads = 4) {
+        buffer_ = std::move(yaml);
+        ConversionOptions options;
+        options.threads = threads;
+        SplitOptions split;
+        split.directory = kDir;
+        split.name_template = name_template;
+        return DocumentSplitter::split(&buffer_[0], buffer_.size(), "dump.yaml", options, split);
+    }
+
+    static std::string read(const std::string& name) {
+        std::ifstream in(std::string(kDir) + "/" + name, std::ios::binary);
+        std::ostringstream content;
+        content << in.rdbuf();
+        return content.str();
+    }
+
+    static size_t file_count() {
+        size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(kDir)) {
+            (void)entry;
+            ++count;
+        }
+        return count;
+    }
+
+    static constexpr const char* kDir = "split_test_out";
+    std::string buffer_;
+};
+
+TEST_F(DocumentSplitterTest, FindsDocumentBoundaries) {
+    std::string yaml = "# dump\n---\nkind: Pod\n---\n---\nkind: Service\n...\n%YAML 1.2\n---\nkind: Secret\n";
+    auto documents = DocumentSplitter::find_documents(yaml.data(), yaml.size());
+
+    ASSERT_EQ(documents.size(), 3u);
+    EXPECT_EQ(yaml.substr(documents[0].begin, documents[0].end - documents[0].begin), "# dump\n---\nkind: Pod\n");
+    EXPECT_EQ(documents[1].line, 5u);
+    EXPECT_EQ(yaml.substr(documents[2].begin, documents[2].end - documents[2].begin),
+              "%YAML 1.2\n---\nkind: Secret\n");
+    EXPECT_EQ(documents[2].line, 8u);
+}
+
+TEST_F(DocumentSplitterTest, MarkersNeedColumnZeroAndABreak) {
+    std::string yaml = "a: |\n  ---\n---word: 1\n--- b\n";
+    auto documents = DocumentSplitter::find_documents(yaml.data(), yaml.size());
+
+    ASSERT_EQ(documents.size(), 2u);
+    EXPECT_EQ(documents[1].line, 4u);
+}
+
+TEST_F(DocumentSplitterTest, WritesOneFilePerDocument) {
+    size_t written = split("kind: Pod\nmetadata: {name: web}\n---\nkind: Service\nmetadata: {name: web}\n");
+
+    EXPECT_EQ(written, 2u);
+    EXPECT_EQ(file_count(), 2u);
+    EXPECT_EQ(read("0-Pod-web.json"), R"({"kind": "Pod","metadata": {"name": "web"}})");
+    EXPECT_EQ(read("1-Service-web.json"), R"({"kind": "Service","metadata": {"name": "web"}})");
+}
+
+TEST_F(DocumentSplitterTest, IndexIsPaddedAndValuesSanitized) {
+    std::string yaml;
+    for (int i = 0; i < 12; ++i) {
+        yaml += "---\nmetadata: {name: 'a/b c', namespace: ns}\nn: " + std::to_string(i) + "\n";
+    }
+    split(yaml, "{metadata.namespace}_{index}_{metadata.name}{missing.field}.json");
+
+    EXPECT_EQ(file_count(), 12u);
+    EXPECT_EQ(read("ns_03_a_b_c.json"), R"({"metadata": {"name": "a/b c","namespace": "ns"},"n": 3})");
+}
+
+TEST_F(DocumentSplitterTest, CollidingNamesFail) {
+    try {
+        split("kind: A\n---\nkind: A\n", "{kind}.json", 1);
+        FAIL() << "expected a name collision";
+    } catch (const ConversionError& e) {
+        EXPECT_NE(std::string(e.what()).find("lines 1 and 2 would both be written to 'A.json'"), std::string::npos);
+    }
+}
+
+TEST_F(DocumentSplitterTest, ErrorsReportSourceLines) {
+    try {
+        split("a: 1\n---\nb: 2\n---\nc: [unclosed\n");
+        FAIL() << "expected a parse error";
+    } catch (const ConversionError& e) {
+        EXPECT_GE(e.location().line, 5u);
+        EXPECT_EQ(e.location().file, "dump.yaml");
+    }
+}
+
+TEST_F(DocumentSplitterTest, FailureRemovesWrittenFiles) {
+    EXPECT_THROW(split("a: 1\n---\nb: 2\n---\nc: [unclosed\n", NameTemplate::kDefault, 1), ConversionError);
+
+    // Neither the files written before the failure nor temporaries are left
+    EXPECT_EQ(file_count(), 0u);
+}
+
+TEST_F(DocumentSplitterTest, RejectsBadTemplates) {
+    EXPECT_THROW(NameTemplate("{index"), ConversionError);
+    EXPECT_THROW(NameTemplate("{}.json"), ConversionError);
+    EXPECT_THROW(NameTemplate("{a..b}.json"), ConversionError);
+    EXPECT_THROW(NameTemplate("sub/{index}.json"), ConversionError);
+}
+
+TEST_F(DocumentSplitterTest, ParallelMatchesSerial) {
+    std::string yaml;
+    for (int i = 0; i < 500; ++i) {
+        yaml += "---\nkind: ConfigMap\nmetadata:\n  name: cm-" + std::to_string(i) + "\ndata: {k: v" +
+                std::to_string(i) + "}\n";
+    }
+    split(yaml, NameTemplate::kDefault, 1);
+    std::string serial = read("137-ConfigMap-cm-137.json");
+    std::filesystem::remove_all(kDir);
+
+    EXPECT_EQ(split(yaml, NameTemplate::kDefault, 8), 500u);
+    EXPECT_EQ(file_count(), 500u);
+    EXPECT_EQ(read("137-ConfigMap-cm-137.json"), serial);
+}
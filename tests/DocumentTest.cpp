@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Document.h"
+#include "ErrorHandler.h"
+#include "YamlToJsonConverter.h"
+
+using namespace yaml2json;
+
+namespace {
+
+std::string convert(const std::string& yaml, const ConversionOptions& options = ConversionOptions{}) {
+    std::string copy = yaml;
+    return YamlToJsonConverter::convert(&copy[0], copy.size(), "", options);
+}
+
+} // namespace
+
+TEST(DocumentTest, Root_TypesFollowTheJsonOutput) {
+    Document doc = Document::parse("name: app\nreplicas: 3\nratio: 0.5\nenabled: true\n"
+                                   "empty: ~\nquoted: \"42\"\nitems: [a, b]\nnested: {k: v}\n");
+    NodeRef root = doc.root();
+
+    ASSERT_TRUE(root.is_object());
+    EXPECT_EQ(root["name"].as_string(), "app");
+    EXPECT_EQ(root["replicas"].as_int(), 3);
+    EXPECT_DOUBLE_EQ(root["ratio"].as_double(), 0.5);
+    EXPECT_TRUE(root["enabled"].as_bool());
+    EXPECT_TRUE(root["empty"].is_null());
+    EXPECT_TRUE(root["quoted"].is_string());
+    EXPECT_EQ(root["quoted"].as_string(), "42");
+    EXPECT_TRUE(root["items"].is_array());
+    EXPECT_TRUE(root["nested"].is_object());
+}
+
+TEST(DocumentTest, MissingMembers_GiveEmptyHandlesThatChain) {
+    Document doc = Document::parse("spec: {template: {replicas: 2}}\n");
+    NodeRef root = doc.root();
+
+    EXPECT_EQ(root["spec"]["template"]["replicas"].as_int(), 2);
+    EXPECT_FALSE(root["spec"]["missing"]["replicas"]);
+    EXPECT_FALSE(root["spec"][size_t(0)]);
+    EXPECT_FALSE(root["spec"]["template"].is_array());
+    EXPECT_EQ(root["missing"].size(), 0u);
+    EXPECT_THROW(root["missing"].type(), ConversionError);
+    EXPECT_THROW(root["spec"].at("missing"), ConversionError);
+}
+
+TEST(DocumentTest, WrongType_ThrowsNamingTheMember) {
+    Document doc = Document::parse("count: many\n");
+    try {
+        doc.root()["count"].as_int();
+        FAIL() << "expected ConversionError";
+    } catch (const ConversionError& e) {
+        EXPECT_NE(std::string(e.what()).find("'count' is a string"), std::string::npos);
+    }
+    EXPECT_THROW(doc.root().as_string(), ConversionError);
+}
+
+TEST(DocumentTest, Iteration_VisitsMembersInOrder) {
+    Document doc = Document::parse("b: 1\na: 2\nlist: [x, y, z]\n");
+    std::vector<std::string> keys;
+    for (NodeRef member : doc.root()) {
+        keys.emplace_back(member.key());
+    }
+    EXPECT_EQ(keys, (std::vector<std::string>{"b", "a", "list"}));
+
+    NodeRef list = doc.root()["list"];
+    EXPECT_EQ(list.size(), 3u);
+    std::string items;
+    for (NodeRef item : list) {
+        items += item.as_string();
+        EXPECT_TRUE(item.key().empty());
+    }
+    EXPECT_EQ(items, "xyz");
+    EXPECT_EQ(list[2].as_string(), "z");
+    EXPECT_FALSE(list[3]);
+}
+
+TEST(DocumentTest, WideObject_LookupsUseTheIndex) {
+    std::string yaml;
+    for (int i = 0; i < 200; ++i) {
+        yaml += "key" + std::to_string(i) + ": " + std::to_string(i) + "\n";
+    }
+    yaml += "key7: last\n";  // a repeated key: the last one wins, as in JSON parsers
+    Document doc = Document::parse(yaml);
+    NodeRef root = doc.root();
+
+    EXPECT_EQ(root.size(), 201u);
+    EXPECT_EQ(root["key0"].as_int(), 0);
+    EXPECT_EQ(root["key199"].as_int(), 199);
+    EXPECT_EQ(root["key7"].as_string(), "last");
+    EXPECT_FALSE(root["key200"]);
+}
+
+TEST(DocumentTest, Aliases_AndMergeKeysResolveAsInTheOutput) {
+    Document doc = Document::parse("base: &base {port: 80, host: a}\n"
+                                   "svc:\n  <<: *base\n  host: b\n"
+                                   "copy: *base\n"
+                                   "&k name: value\nref: *k\n");
+    NodeRef root = doc.root();
+
+    EXPECT_EQ(root["svc"]["port"].as_int(), 80);
+    EXPECT_EQ(root["svc"]["host"].as_string(), "b");
+    EXPECT_FALSE(root["svc"]["<<"]);
+    EXPECT_EQ(root["svc"].size(), 2u);
+    EXPECT_EQ(root["copy"]["host"].as_string(), "a");
+    EXPECT_EQ(root["ref"].as_string(), "name");
+
+    std::string members;
+    for (NodeRef member : root["svc"]) {
+        members += std::string(member.key()) + "=" + member.json() + ";";
+    }
+    EXPECT_EQ(members, "port=80;host=\"b\";");
+}
+
+TEST(DocumentTest, Json_OfSubtreesMatchesTheConverter) {
+    std::string yaml = "meta: {name: \"a\\tb\", tags: [x, 1, null]}\nn: 0x1F\n";
+    Document doc = Document::parse(yaml);
+
+    EXPECT_EQ(doc.json(), convert(yaml));
+    EXPECT_EQ(doc.root()["meta"].json(), convert("{name: \"a\\tb\", tags: [x, 1, null]}"));
+    EXPECT_EQ(doc.root()["meta"]["tags"].json(), "[\"x\",1,null]");
+    EXPECT_EQ(doc.root()["n"].json(), "\"0x1F\"");
+}
+
+TEST(DocumentTest, TypedScalars_FollowTheOptions) {
+    ConversionOptions options;
+    options.scalars = ScalarTyping::Core;
+    Document doc = Document::parse("hex: 0x1F\nyes: TRUE\ninf: .inf\nneg: -9223372036854775808\n", options);
+    NodeRef root = doc.root();
+
+    EXPECT_EQ(root["hex"].as_int(), 31);
+    EXPECT_EQ(root["hex"].text(), "0x1F");
+    EXPECT_EQ(root["hex"].json(), "31");
+    EXPECT_TRUE(root["yes"].as_bool());
+    EXPECT_TRUE(root["inf"].is_string());
+    EXPECT_EQ(root["neg"].as_int(), INT64_MIN);
+}
+
+TEST(DocumentTest, MultiDocumentStream) {
+    Document doc = Document::parse("---\na: 1\n---\nb: 2\n");
+    EXPECT_EQ(doc.document_count(), 2u);
+    EXPECT_EQ(doc.root()["a"].as_int(), 1);
+    EXPECT_EQ(doc.document(1)["b"].as_int(), 2);
+    EXPECT_FALSE(doc.document(2));
+}
+
+TEST(DocumentTest, EmptyInput_HasNoRoot) {
+    Document doc = Document::parse("");
+    EXPECT_FALSE(doc.root());
+    EXPECT_EQ(doc.document_count(), 0u);
+}
+
+TEST(DocumentTest, Limits_AndDuplicateKeysAreChecked) {
+    ConversionOptions options;
+    options.limits.max_nodes = 3;
+    EXPECT_THROW(Document::parse("a: {b: {c: {d: 1}}}\n", options), LimitExceededError);
+
+    options = ConversionOptions{};
+    options.duplicate_keys = DuplicateKeys::Error;
+    EXPECT_THROW(Document::parse("a: 1\na: 2\n", options), ConversionError);
+
+    // Depth is a limit on the output: it applies when JSON is emitted
+    options = ConversionOptions{};
+    options.limits.max_depth = 2;
+    Document deep = Document::parse("a: {b: {c: {d: 1}}}\n", options);
+    EXPECT_EQ(deep.root()["a"]["b"]["c"]["d"].as_int(), 1);
+    EXPECT_THROW(deep.root().json(), LimitExceededError);
+    EXPECT_EQ(deep.root()["a"]["b"].json(), R"({"c": {"d": 1}})");
+}
+
+TEST(DocumentTest, MovedDocument_KeepsHandlesValid) {
+    Document doc = Document::parse("a: {b: text}\n");
+    NodeRef b = doc.root()["a"]["b"];
+    Document moved = std::move(doc);
+    EXPECT_EQ(b.as_string(), "text");
+    EXPECT_EQ(moved.root()["a"]["b"].as_string(), "text");
+}
+
+TEST(DocumentTest, Load_ReadsFiles) {
+    std::string path = (std::filesystem::temp_directory_path() / "document_test.yaml").string();
+    {
+        std::ofstream file(path);
+        file << "key: value\n";
+    }
+    Document doc = Document::load(path);
+    std::filesystem::remove(path);
+    EXPECT_EQ(doc.root()["key"].as_string(), "value");
+}
+
+TEST(DocumentTest, ConcurrentReaders_SeeTheSameValues) {
+    std::string yaml = "anchor: &a {x: 1}\n";
+    for (int i = 0; i < 100; ++i) {
+        yaml += "k" + std::to_string(i) + ": *a\n";
+    }
+    Document doc = Document::parse(yaml);
+
+    std::vector<std::thread> threads;
+    std::vector<int> failures(4, 0);
+    for (size_t t = 0; t < failures.size(); ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 100; ++i) {
+                NodeRef member = doc.root()["k" + std::to_string(i)];
+                if (member["x"].as_int() != 1 || member.json() != "{\"x\": 1}") {
+                    ++failures[t];
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(failures, std::vector<int>(4, 0));
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "DuplicateKeyFilter.h"
+#include "YamlToJsonConverter.h"
+#include "ErrorHandler.h"
+
+using namespace yaml2json;
+
+class DuplicateKeyFilterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setup_error_handlers();
+    }
+
+    std::string convert(std::string yaml, DuplicateKeys policy) {
+        ConversionOptions options;
+        options.duplicate_keys = policy;
+        return YamlToJsonConverter::convert(yaml.data(), yaml.size(), "dup.yaml", options);
+    }
+};
+
+TEST_F(DuplicateKeyFilterTest, Keep_EmitsEveryOccurrence) {
+    EXPECT_EQ(convert("a: 1\nb: 2\na: 3\n", DuplicateKeys::Keep), R"({"a": 1,"b": 2,"a": 3})");
+}
+
+TEST_F(DuplicateKeyFilterTest, LastWins_DropsEarlierEntries) {
+    EXPECT_EQ(convert("a: 1\nb: 2\na: {x: 3}\nb: 4\n", DuplicateKeys::LastWins),
+              R"({"a": {"x": 3},"b": 4})");
+}
+
+TEST_F(DuplicateKeyFilterTest, FirstWins_DropsLaterEntries) {
+    EXPECT_EQ(convert("a: 1\nb: 2\na: {x: 3}\nb: 4\n", DuplicateKeys::FirstWins),
+              R"({"a": 1,"b": 2})");
+}
+
+TEST_F(DuplicateKeyFilterTest, Error_PointsAtSecondOccurrence) {
+    std::string yaml = "image:\n  tag: v1\n  repo: app\n  tag: v2\n";
+    ConversionOptions options;
+    options.duplicate_keys = DuplicateKeys::Error;
+    try {
+        YamlToJsonConverter::convert(yaml.data(), yaml.size(), "values.yaml", options);
+        FAIL() << "expected ConversionError";
+    } catch (const ConversionError& e) {
+        EXPECT_EQ(format_machine_error(e, "values.yaml"),
+                  "values.yaml:4:3: Duplicate key 'tag' (first defined on line 2)");
+    }
+}
+
+TEST_F(DuplicateKeyFilterTest, QuotedAndPlainKeysAreTheSameKey) {
+    EXPECT_EQ(convert("a: 1\n\"a\": 2\n", DuplicateKeys::LastWins), R"({"a": 2})");
+}
+
+TEST_F(DuplicateKeyFilterTest, SameKeyInDifferentMapsIsFine) {
+    std::string yaml = "x: {a: 1}\ny: {a: 2}\nz: [{a: 3}, {a: 4}]\n";
+
+    EXPECT_EQ(convert(yaml, DuplicateKeys::Error), R"({"x": {"a": 1},"y": {"a": 2},"z": [{"a": 3},{"a": 4}]})");
+}
+
+TEST_F(DuplicateKeyFilterTest, MergeKeysMayRepeat) {
+    std::string yaml = "a: &a {x: 1}\nb: &b {y: 2}\nc:\n  <<: *a\n  <<: *b\n";
+
+    EXPECT_NO_THROW(convert(yaml, DuplicateKeys::Error));
+}
+
+TEST_F(DuplicateKeyFilterTest, DroppingAnAnchorFails) {
+    EXPECT_THROW(convert("a: &x 1\na: 2\nb: *x\n", DuplicateKeys::LastWins), ConversionError);
+}
+
+TEST_F(DuplicateKeyFilterTest, WideMapUsesHashing) {
+    // Well past kLinearScanKeys, with every key repeated once at the end
+    std::string yaml;
+    const int keys = 20000;
+    for (int i = 0; i < keys; ++i) {
+        yaml += "k" + std::to_string(i) + ": " + std::to_string(i) + "\n";
+    }
+    for (int i = 0; i < keys; i += 1000) {
+        yaml += "k" + std::to_string(i) + ": last\n";
+    }
+
+    ryml::Tree tree = YamlToJsonConverter::parse_yaml(yaml.data(), yaml.size());
+    EXPECT_EQ(DuplicateKeyFilter::apply(tree, DuplicateKeys::FirstWins), 20u);
+    EXPECT_EQ(tree.num_children(tree.root_id()), static_cast<ryml::id_type>(keys));
+
+    std::string json = YamlToJsonConverter::tree_to_json(tree);
+    EXPECT_EQ(json.find("last"), std::string::npos);
+}
+
+TEST_F(DuplicateKeyFilterTest, Check_ReportsDuplicates) {
+    std::string yaml = "a: 1\na: 2\n";
+    std::string copy = yaml;
+
+    EXPECT_NO_THROW(YamlToJsonConverter::check(&copy[0], copy.size(), "dup.yaml"));
+    EXPECT_THROW(YamlToJsonConverter::check(&yaml[0], yaml.size(), "dup.yaml", ConversionLimits{},
+                                            DuplicateKeys::Error),
+                 ConversionError);
+}
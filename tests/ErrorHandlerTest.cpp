@@ -62,4 +62,39 @@ TEST_F(ErrorHandlerTest, RymlErrorHandler_ThrowsConversionError) {
         std::string expected = "YAML parsing error in file 'test.yaml' at line 5, column 10: Parse error";
         EXPECT_EQ(std::string(e.what()), expected);
     }
-}
\ No newline at end of file
+}
+
+TEST_F(ErrorHandlerTest, RymlErrorHandler_KeepsLocation) {
+    ryml::Location loc;
+    loc.name = ryml::csubstr("test.yaml", 9);
+    loc.line = 5;
+    loc.col = 10;
+    
+    try {
+        ryml_error_handler("Parse error", 11, loc, nullptr);
+        FAIL() << "expected ConversionError";
+    } catch (const ConversionError& e) {
+        EXPECT_EQ(e.location().file, "test.yaml");
+        EXPECT_EQ(e.location().line, 5u);
+        EXPECT_EQ(e.location().column, 10u);
+        EXPECT_EQ(e.detail(), "Parse error");
+        EXPECT_EQ(format_machine_error(e, "other.yaml"), "test.yaml:5:10: Parse error");
+    }
+}
+
+TEST_F(ErrorHandlerTest, FormatMachineError_NoLocation) {
+    ConversionError error("Input file 'x.yaml' is empty");
+    EXPECT_EQ(format_machine_error(error, "x.yaml"), "x.yaml:0:0: Input file 'x.yaml' is empty");
+}
+
+TEST_F(ErrorHandlerTest, LocateInSource_LineAndColumn) {
+    const char source[] = "a: 1\nb: *x\n";
+    ErrorLocation loc = locate_in_source(source, sizeof(source) - 1, source + 8, "f.yaml");
+    
+    EXPECT_EQ(loc.file, "f.yaml");
+    EXPECT_EQ(loc.line, 2u);
+    EXPECT_EQ(loc.column, 4u);
+    
+    ErrorLocation outside = locate_in_source(source, sizeof(source) - 1, "elsewhere", "f.yaml");
+    EXPECT_EQ(outside.line, 0u);
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "GatherWriter.h"
+#include "YamlToJsonConverter.h"
+#include "ErrorHandler.h"
+
+using namespace yaml2json;
+
+class GatherWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setup_error_handlers();
+    }
+
+    // Write through a real file descriptor and read the bytes back
+    static std::string writeAndRead(const GatherWriter& writer) {
+        std::FILE* file = std::tmpfile();
+        EXPECT_NE(file, nullptr);
+        writer.write_to(fileno(file));
+        std::rewind(file);
+        std::string content;
+        char chunk[4096];
+        size_t n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            content.append(chunk, n);
+        }
+        std::fclose(file);
+        return content;
+    }
+};
+
+TEST_F(GatherWriterTest, Reference_ShortSlicesAreCopied) {
+    GatherWriter writer;
+    writer.buffer() += '[';
+    writer.reference("abc", 3);
+    writer.buffer() += ']';
+
+    EXPECT_EQ(writer.str(), "[abc]");
+    EXPECT_EQ(writer.referenced_bytes(), 0u);
+    EXPECT_EQ(writer.copied_bytes(), 5u);
+}
+
+TEST_F(GatherWriterTest, Reference_LongSlicesStayInPlace) {
+    std::string a(100, 'a');
+    std::string b(GatherWriter::kMinReferenceBytes, 'b');
+    GatherWriter writer;
+    writer.reference(a.data(), a.size());
+    writer.reference(b.data(), b.size());
+    writer.buffer() += ',';
+
+    EXPECT_EQ(writer.str(), a + b + ",");
+    EXPECT_EQ(writer.size(), a.size() + b.size() + 1);
+    EXPECT_EQ(writer.referenced_bytes(), a.size() + b.size());
+    EXPECT_EQ(writeAndRead(writer), a + b + ",");
+}
+
+TEST_F(GatherWriterTest, WriteTo_MoreSegmentsThanOneWritev) {
+    std::string text(GatherWriter::kMinReferenceBytes, 't');
+    GatherWriter writer;
+    std::string expected;
+    for (int i = 0; i < 5000; ++i) {
+        writer.buffer() += std::to_string(i);
+        writer.reference(text.data(), text.size());
+        expected += std::to_string(i) + text;
+    }
+
+    EXPECT_EQ(writeAndRead(writer), expected);
+}
+
+TEST_F(GatherWriterTest, WriteJson_MatchesConvert) {
+    std::string long_text(300, 'y');
+    std::string yaml = "name: \"" + long_text + "\"\nescaped: \"tab\\t" + long_text + "\"\n"
+                       "items: [" + long_text + ", 2, short]\n";
+    std::string copy = yaml;
+    std::string expected = YamlToJsonConverter::convert(copy.data(), copy.size());
+
+    GatherWriter writer;
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    YamlToJsonConverter::write_json(yaml.data(), yaml.size(), "", ConversionOptions{}, writer, fileno(file));
+    std::rewind(file);
+    std::vector<char> content(expected.size() + 16);
+    size_t n = std::fread(content.data(), 1, content.size(), file);
+    std::fclose(file);
+
+    EXPECT_EQ(std::string(content.data(), n), expected);
+    // The two plain long strings are written from the input, the escaped one is copied
+    EXPECT_EQ(writer.referenced_bytes(), 2 * long_text.size());
+    EXPECT_EQ(writer.copied_bytes() + writer.referenced_bytes(), expected.size());
+}
+
+TEST_F(GatherWriterTest, WriteJson_EnforcesOutputLimit) {
+    std::string yaml = "text: \"" + std::string(500, 'z') + "\"\n";
+    ConversionOptions options;
+    options.limits.max_output_bytes = 100;
+    GatherWriter writer;
+
+    EXPECT_THROW(YamlToJsonConverter::write_json(yaml.data(), yaml.size(), "", options, writer, -1),
+                 LimitExceededError);
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "JsonSchema.h"
+#include "YamlToJsonConverter.h"
+#include "ErrorHandler.h"
+
+using namespace yaml2json;
+
+class JsonSchemaTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setup_error_handlers();
+        schema_ = JsonSchema::compile(R"({
+            "type": "object",
+            "required": ["name", "replicas"],
+            "properties": {
+                "name": {"type": "string", "pattern": "^[a-z][a-z0-9-]*$", "maxLength": 20},
+                "replicas": {"type": "integer", "minimum": 1, "maximum": 10},
+                "mode": {"enum": ["fast", "safe", null]},
+                "ports": {"type": "array", "items": {"$ref": "#/$defs/port"}, "uniqueItems": true},
+                "labels": {"type": "object", "additionalProperties": {"type": "string"}}
+            },
+            "additionalProperties": false,
+            "$defs": {"port": {"type": "integer", "exclusiveMinimum": 0, "maximum": 65535}}
+        })", "deployment.schema.json");
+    }
+
+    // Returns the error detail, or an empty string when the YAML is valid
+    std::string validate(std::string yaml, ScalarTyping typing = ScalarTyping::Json) {
+        ConversionOptions options;
+        options.schema = schema_;
+        options.scalars = typing;
+        try {
+            YamlToJsonConverter::convert(yaml.data(), yaml.size(), "app.yaml", options);
+        } catch (const ConversionError& e) {
+            return format_machine_error(e, "app.yaml");
+        }
+        return "";
+    }
+
+    std::shared_ptr<const JsonSchema> schema_;
+};
+
+TEST_F(JsonSchemaTest, ValidDocumentPasses) {
+    EXPECT_EQ(validate("name: web\nreplicas: 3\nmode: ~\nports: [80, 443]\nlabels: {tier: front}\n"), "");
+}
+
+TEST_F(JsonSchemaTest, TypeErrorHasPointerAndYamlLocation) {
+    EXPECT_EQ(validate("name: web\nreplicas: three\n"),
+              "app.yaml:2:11: Schema violation at #/replicas: expected integer, got string");
+}
+
+TEST_F(JsonSchemaTest, Keywords) {
+    EXPECT_NE(validate("name: web\n").find("missing required property 'replicas'"), std::string::npos);
+    EXPECT_NE(validate("name: Web\nreplicas: 1\n").find("does not match pattern"), std::string::npos);
+    EXPECT_NE(validate("name: web\nreplicas: 11\n").find("must be at most 10"), std::string::npos);
+    EXPECT_NE(validate("name: web\nreplicas: 1\nmode: slow\n").find("not one of the allowed values"),
+              std::string::npos);
+    EXPECT_NE(validate("name: web\nreplicas: 1\nports: [80, 80]\n").find("#/ports/1: duplicate item"),
+              std::string::npos);
+    EXPECT_NE(validate("name: web\nreplicas: 1\nports: [0]\n").find("#/ports/0: must be greater than 0"),
+              std::string::npos);
+    EXPECT_NE(validate("name: web\nreplicas: 1\nextra: 1\n").find("#/extra: no value is allowed here"),
+              std::string::npos);
+    EXPECT_NE(validate("name: web\nreplicas: 1\nlabels: {a/b: 1}\n").find("#/labels/a~1b:"), std::string::npos);
+}
+
+TEST_F(JsonSchemaTest, TypesFollowScalarTyping) {
+    // 0x2 is a string in the default typing and an integer under the core schema
+    std::string yaml = "name: web\nreplicas: 0x2\n";
+
+    EXPECT_NE(validate(yaml).find("expected integer, got string"), std::string::npos);
+    EXPECT_EQ(validate(yaml, ScalarTyping::Core), "");
+}
+
+TEST_F(JsonSchemaTest, AliasesAndMergeKeysAreValidatedExpanded) {
+    EXPECT_EQ(validate("labels: &l {tier: front}\nname: web\nreplicas: 1\n"), "");
+    EXPECT_NE(validate("base: &b {replicas: 1}\n<<: *b\nname: web\n").find("#/base"), std::string::npos);
+}
+
+TEST_F(JsonSchemaTest, Combinators) {
+    auto schema = JsonSchema::compile(R"({
+        "anyOf": [{"type": "string"}, {"type": "integer", "multipleOf": 5}],
+        "not": {"const": "forbidden"}
+    })");
+    ConversionOptions options;
+    options.schema = schema;
+    auto run = [&](std::string yaml) {
+        return YamlToJsonConverter::convert(yaml.data(), yaml.size(), "", options);
+    };
+
+    EXPECT_NO_THROW(run("hello"));
+    EXPECT_NO_THROW(run("15"));
+    EXPECT_THROW(run("7"), ConversionError);
+    EXPECT_THROW(run("forbidden"), ConversionError);
+}
+
+TEST_F(JsonSchemaTest, OneOfAndConditionals) {
+    auto schema = JsonSchema::compile(R"({
+        "type": "object",
+        "oneOf": [{"required": ["a"]}, {"required": ["b"]}],
+        "if": {"properties": {"kind": {"const": "tls"}}, "required": ["kind"]},
+        "then": {"required": ["cert"]}
+    })");
+    ConversionOptions options;
+    options.schema = schema;
+    auto run = [&](std::string yaml) {
+        return YamlToJsonConverter::convert(yaml.data(), yaml.size(), "", options);
+    };
+
+    EXPECT_NO_THROW(run("a: 1\n"));
+    EXPECT_THROW(run("a: 1\nb: 2\n"), ConversionError);
+    EXPECT_THROW(run("a: 1\nkind: tls\n"), ConversionError);
+    EXPECT_NO_THROW(run("a: 1\nkind: tls\ncert: x\n"));
+}
+
+TEST_F(JsonSchemaTest, EveryDocumentOfAStreamIsChecked) {
+    EXPECT_NE(validate("name: web\nreplicas: 1\n---\nname: db\n").find("missing required property"),
+              std::string::npos);
+}
+
+TEST_F(JsonSchemaTest, CheckModeUsesSchema) {
+    std::string yaml = "name: web\nreplicas: 0\n";
+    ConversionOptions options;
+    options.schema = schema_;
+
+    EXPECT_THROW(YamlToJsonConverter::check(&yaml[0], yaml.size(), "app.yaml", options), ConversionError);
+}
+
+TEST_F(JsonSchemaTest, InvalidSchemasAreRejected) {
+    EXPECT_THROW(JsonSchema::compile("{\"type\": \"strin\"}"), ConversionError);
+    EXPECT_THROW(JsonSchema::compile("{\"$ref\": \"other.json#/a\"}"), ConversionError);
+    EXPECT_THROW(JsonSchema::compile("{\"$ref\": \"#/$defs/missing\"}"), ConversionError);
+    EXPECT_THROW(JsonSchema::compile("{\"pattern\": \"(\"}"), ConversionError);
+    EXPECT_THROW(JsonSchema::compile("{\"minItems\": -1}"), ConversionError);
+}
+
+TEST_F(JsonSchemaTest, RecursiveReferences) {
+    auto schema = JsonSchema::compile(R"({
+        "$defs": {"node": {"type": "object", "properties": {"children": {"type": "array", "items": {"$ref": "#/$defs/node"}}}, "required": ["id"]}},
+        "$ref": "#/$defs/node"
+    })");
+    ConversionOptions options;
+    options.schema = schema;
+    std::string good = "id: 1\nchildren: [{id: 2, children: [{id: 3}]}]\n";
+    std::string bad = "id: 1\nchildren: [{id: 2, children: [{name: x}]}]\n";
+
+    EXPECT_NO_THROW(YamlToJsonConverter::convert(good.data(), good.size(), "", options));
+    EXPECT_THROW(YamlToJsonConverter::convert(bad.data(), bad.size(), "", options), ConversionError);
+}
+
+TEST_F(JsonSchemaTest, AliasExpansionIsBoundedDuringValidation) {
+    std::string yaml = "- &a [lol, lol, lol, lol, lol, lol, lol, lol, lol]\n";
+    for (char name = 'b'; name <= 'i'; ++name) {
+        std::string alias = std::string("*") + static_cast<char>(name - 1);
+        yaml += std::string("- &") + name + " [" + alias;
+        for (int i = 1; i < 9; ++i) {
+            yaml += ", " + alias;
+        }
+        yaml += "]\n";
+    }
+    ConversionOptions options;
+    options.schema = JsonSchema::compile(R"({"items": {"items": {}}, "uniqueItems": true})");
+
+    EXPECT_THROW(YamlToJsonConverter::convert(yaml.data(), yaml.size(), "", options), LimitExceededError);
+}
+
+TEST_F(JsonSchemaTest, DepthLimitAppliesDuringValidation) {
+    std::string yaml = "a: {b: {c: {d: 1}}}\n";
+    ConversionOptions options;
+    options.schema = JsonSchema::compile(R"({"additionalProperties": {"$ref": "#"}})");
+    options.limits.max_depth = 2;
+
+    try {
+        YamlToJsonConverter::convert(yaml.data(), yaml.size(), "", options);
+        FAIL() << "expected LimitExceededError";
+    } catch (const LimitExceededError& e) {
+        EXPECT_NE(std::string(e.what()).find("Nesting depth limit exceeded"), std::string::npos);
+    }
+}
+
+TEST_F(JsonSchemaTest, LongStringsAreNotHandedToTheRegexEngine) {
+    schema_ = JsonSchema::compile(R"({"items": {"pattern": "^a*$", "patternProperties": {"^x": {}}}})");
+
+    EXPECT_EQ(validate("[" + std::string(4096, 'a') + "]\n"), "");
+    EXPECT_NE(validate("[" + std::string(100000, 'a') + "]\n").find("#/0: is longer than 4096 bytes"),
+              std::string::npos);
+    EXPECT_NE(validate("[{" + std::string(100000, 'x') + ": 1}]\n").find("too long to match patternProperties"),
+              std::string::npos);
+}
+
+TEST_F(JsonSchemaTest, SelfReferenceOnTheSameValueIsBounded) {
+    std::string yaml = "a: 1\n";
+    ConversionOptions options;
+    options.schema = JsonSchema::compile(R"({"$ref": "#"})");
+
+    EXPECT_THROW(YamlToJsonConverter::convert(yaml.data(), yaml.size(), "", options), LimitExceededError);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "LayerMerger.h"
+#include "YamlToJsonConverter.h"
+#include "ErrorHandler.h"
+
+using namespace yaml2json;
+
+class LayerMergerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setup_error_handlers();
+    }
+
+    // Buffers are parsed in place, so the test keeps its own copies alive
+    std::string merge(std::vector<std::string> yamls, SequenceMerge sequences = SequenceMerge::Replace,
+                      const ConversionOptions& options = ConversionOptions{}) {
+        buffers_ = std::move(yamls);
+        std::vector<MergeInput> layers;
+        for (size_t i = 0; i < buffers_.size(); ++i) {
+            layers.push_back(MergeInput{&buffers_[i][0], buffers_[i].size(), "layer" + std::to_string(i) + ".yaml"});
+        }
+        return LayerMerger::merge(layers, options, sequences);
+    }
+
+    std::vector<std::string> buffers_;
+};
+
+TEST_F(LayerMergerTest, MapsMergeRecursively) {
+    std::string json = merge({"app: {name: web, replicas: 1, env: {LOG: info}}\nregion: eu\n",
+                              "app: {replicas: 3, env: {DEBUG: '1'}}\n",
+                              "app: {env: {LOG: debug}}\nextra: true\n"});
+
+    EXPECT_EQ(json, R"({"app": {"name": "web","replicas": 3,"env": {"LOG": "debug","DEBUG": "1"}},)"
+                    R"("region": "eu","extra": true})");
+}
+
+TEST_F(LayerMergerTest, LaterScalarsAndTypesOverride) {
+    std::string json = merge({"a: {x: 1}\nb: 1\nc: [1]\n", "a: off\nb: {y: 2}\nc: null\n"});
+
+    EXPECT_EQ(json, R"({"a": "off","b": {"y": 2},"c": null})");
+}
+
+TEST_F(LayerMergerTest, SequencesReplaceOrAppend) {
+    std::vector<std::string> layers = {"hosts: [a, b]\n", "hosts: [c]\n"};
+
+    EXPECT_EQ(merge(layers), R"({"hosts": ["c"]})");
+    EXPECT_EQ(merge(layers, SequenceMerge::Append), R"({"hosts": ["a","b","c"]})");
+}
+
+TEST_F(LayerMergerTest, EmptyLayersAreSkipped) {
+    EXPECT_EQ(merge({"a: 1\n", "", "# only a comment\n", "b: 2\n"}), R"({"a": 1,"b": 2})");
+    EXPECT_EQ(merge({"", ""}), "null");
+}
+
+TEST_F(LayerMergerTest, AliasesResolvedWithinEachLayer) {
+    std::string json = merge({"defaults: &d {retries: 2, timeout: 5}\njob: *d\n",
+                              "job: {<<: {timeout: 9}, name: build}\n"});
+
+    EXPECT_EQ(json, R"({"defaults": {"retries": 2,"timeout": 5},"job": {"retries": 2,"timeout": 9,"name": "build"}})");
+}
+
+TEST_F(LayerMergerTest, CanonicalSortsMergedKeys) {
+    ConversionOptions options;
+    options.canonical = true;
+
+    EXPECT_EQ(merge({"b: {y: 1}\na: 1\n", "b: {x: 2}\nc: 3\n"}, SequenceMerge::Replace, options),
+              R"({"a":1,"b":{"x":2,"y":1},"c":3})");
+}
+
+TEST_F(LayerMergerTest, SingleLayerMatchesConversion) {
+    std::string yaml = "name: test\nitems: [1, {k: v}]\nref: &r x\ncopy: *r\n";
+    std::string copy = yaml;
+
+    EXPECT_EQ(merge({yaml}), YamlToJsonConverter::convert(copy.data(), copy.size()));
+}
+
+TEST_F(LayerMergerTest, ParallelParsingMatchesSerial) {
+    std::vector<std::string> layers;
+    for (int i = 0; i < 16; ++i) {
+        layers.push_back("common: {layer: " + std::to_string(i) + "}\nkey" + std::to_string(i) + ": v\n");
+    }
+    ConversionOptions serial;
+    ConversionOptions parallel;
+    parallel.threads = 4;
+
+    EXPECT_EQ(merge(layers, SequenceMerge::Replace, serial), merge(layers, SequenceMerge::Replace, parallel));
+}
+
+TEST_F(LayerMergerTest, ErrorsNameTheLayer) {
+    try {
+        merge({"a: 1\n", "b: [unclosed\n"});
+        FAIL() << "expected ConversionError";
+    } catch (const ConversionError& e) {
+        EXPECT_NE(std::string(e.what()).find("layer1.yaml"), std::string::npos) << e.what();
+    }
+    EXPECT_THROW(merge({"a: 1\n", "--- {b: 1}\n--- {c: 2}\n"}), ConversionError);
+}
+
+TEST_F(LayerMergerTest, DepthLimitCountsMergedLevels) {
+    ConversionOptions options;
+    options.limits.max_depth = 2;
+
+    EXPECT_THROW(merge({"a: {b: {c: 1}}\n", "a: {b: {d: 2}}\n"}, SequenceMerge::Replace, options),
+                 LimitExceededError);
+}
+
+TEST_F(LayerMergerTest, DuplicateKeysWithinOneLayer) {
+    std::vector<std::string> layers = {"a: {x: 1}\nb: 0\na: {y: 2}\n", "b: 1\n"};
+    ConversionOptions options;
+
+    EXPECT_EQ(merge(layers), R"({"b": 1,"a": {"y": 2}})");
+    options.duplicate_keys = DuplicateKeys::FirstWins;
+    EXPECT_EQ(merge(layers, SequenceMerge::Replace, options), R"({"a": {"x": 1},"b": 1})");
+    options.duplicate_keys = DuplicateKeys::Error;
+    EXPECT_THROW(merge(layers, SequenceMerge::Replace, options), ConversionError);
+}
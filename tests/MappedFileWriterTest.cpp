@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "MappedFileWriter.h"
+#include "ErrorHandler.h"
+#include "YamlToJsonConverter.h"
+
+using namespace yaml2json;
+
+#ifndef _WIN32
+
+class MappedFileWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setup_error_handlers();
+        path_ = (std::filesystem::temp_directory_path() / "mapped_writer_test.json").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    std::string readBack() const {
+        std::ifstream file(path_, std::ios::binary);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    std::string path_;
+};
+
+TEST_F(MappedFileWriterTest, Finish_TruncatesToWrittenBytes) {
+    MappedFileWriter writer(path_);
+    writer.reserve(100000);
+    EXPECT_GE(writer.capacity(), 100000u);
+    writer.write("{\"a\": ", 6);
+    writer.write("1}", 2);
+    writer.finish();
+
+    EXPECT_EQ(writer.remaps(), 0u);
+    EXPECT_EQ(std::filesystem::file_size(path_), 8u);
+    EXPECT_EQ(readBack(), "{\"a\": 1}");
+}
+
+TEST_F(MappedFileWriterTest, Write_GrowsPastTheReservation) {
+    std::string expected;
+    MappedFileWriter writer(path_);
+    writer.reserve(10);
+    for (int i = 0; i < 50000; ++i) {
+        std::string piece = "[" + std::to_string(i) + "],";
+        writer.write(piece.data(), piece.size());
+        expected += piece;
+    }
+    writer.finish();
+
+    EXPECT_GE(writer.remaps(), 1u);
+    EXPECT_EQ(writer.size(), expected.size());
+    EXPECT_EQ(readBack(), expected);
+}
+
+TEST_F(MappedFileWriterTest, Write_LargeBlockBeyondGrowthStep) {
+    std::string block(3 * MappedFileWriter::kMinGrowBytes + 17, 'x');
+    MappedFileWriter writer(path_);
+    writer.write("[", 1);
+    writer.write(block.data(), block.size());
+    writer.finish();
+
+    EXPECT_EQ(readBack(), "[" + block);
+}
+
+TEST_F(MappedFileWriterTest, EmptyOutput_LeavesEmptyFile) {
+    {
+        std::ofstream existing(path_);
+        existing << "old content";
+    }
+    MappedFileWriter writer(path_);
+    writer.write("", 0);  // before anything is mapped
+    writer.finish();
+
+    EXPECT_TRUE(std::filesystem::exists(path_));
+    EXPECT_EQ(std::filesystem::file_size(path_), 0u);
+}
+
+TEST_F(MappedFileWriterTest, Destructor_WithoutFinishKeepsExistingFile) {
+    {
+        std::ofstream existing(path_);
+        existing << "old content";
+    }
+    {
+        MappedFileWriter writer(path_);
+        writer.reserve(1 << 20);
+        writer.write("partial", 7);
+        EXPECT_EQ(readBack(), "old content");  // written beside it until finish()
+    }
+    EXPECT_EQ(readBack(), "old content");
+
+    // The temporary is gone too
+    std::filesystem::path dir = std::filesystem::path(path_).parent_path();
+    std::string prefix = std::filesystem::path(path_).filename().string() + ".";
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        EXPECT_NE(entry.path().filename().string().rfind(prefix, 0), 0u) << entry.path();
+    }
+}
+
+TEST_F(MappedFileWriterTest, Destructor_WithoutFinishCreatesNothing) {
+    {
+        MappedFileWriter writer(path_);
+        writer.write("partial", 7);
+    }
+    EXPECT_FALSE(std::filesystem::exists(path_));
+}
+
+TEST_F(MappedFileWriterTest, CanMap_RegularFilesOnly) {
+    EXPECT_TRUE(MappedFileWriter::can_map(path_));  // does not exist yet
+    {
+        std::ofstream existing(path_);
+    }
+    EXPECT_TRUE(MappedFileWriter::can_map(path_));
+    EXPECT_FALSE(MappedFileWriter::can_map("/dev/null"));
+    EXPECT_FALSE(MappedFileWriter::can_map(std::filesystem::temp_directory_path().string()));
+}
+
+TEST_F(MappedFileWriterTest, Open_FailureThrowsConversionError) {
+    EXPECT_THROW(MappedFileWriter("/nonexistent-dir/out.json"), ConversionError);
+}
+
+TEST_F(MappedFileWriterTest, ConvertTo_MatchesConvert) {
+    std::string yaml = "name: test\nitems:\n  - 1\n  - \"two\\n\"\nnested: {a: [x, y]}\n";
+    std::string expected = YamlToJsonConverter::convert(std::string(yaml).data(), yaml.size());
+
+    MappedFileWriter writer(path_);
+    YamlToJsonConverter::convert_to(&yaml[0], yaml.size(), "", ConversionOptions{}, writer);
+    writer.finish();
+
+    // The tree estimate covers the output: no remap was needed
+    EXPECT_EQ(writer.remaps(), 0u);
+    EXPECT_EQ(readBack(), expected);
+}
+
+TEST_F(MappedFileWriterTest, ConvertTo_BinaryFormatReservesExactSize) {
+    std::string yaml = "a: [1, 2, 3]\nb: text\n";
+    ConversionOptions options;
+    options.format = OutputFormat::Cbor;
+    std::string expected = YamlToJsonConverter::convert(std::string(yaml).data(), yaml.size(), "", options);
+
+    MappedFileWriter writer(path_);
+    YamlToJsonConverter::convert_to(&yaml[0], yaml.size(), "", options, writer);
+    writer.finish();
+
+    EXPECT_EQ(writer.remaps(), 0u);
+    EXPECT_EQ(readBack(), expected);
+}
+
+#endif
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "OutputFile.h"
+#include "ErrorHandler.h"
+
+#ifndef _WIN32
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace yaml2json;
+
+#ifndef _WIN32
+
+class OutputFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = std::filesystem::temp_directory_path() / "output_file_test";
+        std::filesystem::remove_all(dir_);
+        std::filesystem::create_directory(dir_);
+        path_ = (dir_ / "out.json").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::permissions(dir_, std::filesystem::perms::owner_all);
+        std::filesystem::remove_all(dir_);
+    }
+
+    static void writeFile(const std::string& path, const std::string& content) {
+        std::ofstream file(path, std::ios::binary);
+        file << content;
+    }
+
+    static std::string readBack(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    static void writeAll(OutputFile& output, const std::string& content) {
+        ASSERT_EQ(::write(output.fd(), content.data(), content.size()), static_cast<ssize_t>(content.size()));
+    }
+
+    std::filesystem::path dir_;
+    std::string path_;
+};
+
+TEST_F(OutputFileTest, Commit_ReplacesRegularFile) {
+    writeFile(path_, "old");
+    ::chmod(path_.c_str(), 0640);
+
+    OutputFile output(path_);
+    EXPECT_TRUE(output.replaces());
+    writeAll(output, "new");
+    EXPECT_EQ(readBack(path_), "old");
+    output.commit();
+
+    EXPECT_EQ(readBack(path_), "new");
+    struct stat st;
+    ASSERT_EQ(::stat(path_.c_str(), &st), 0);
+    EXPECT_EQ(st.st_mode & 07777, 0640u);
+}
+
+TEST_F(OutputFileTest, HardLinkedTarget_IsWrittenInPlace) {
+    std::string other = (dir_ / "other.json").string();
+    writeFile(path_, "old");
+    ASSERT_EQ(::link(path_.c_str(), other.c_str()), 0);
+
+    OutputFile output(path_);
+    EXPECT_FALSE(output.replaces());
+    writeAll(output, "new");
+    output.commit();
+
+    EXPECT_EQ(readBack(path_), "new");
+    EXPECT_EQ(readBack(other), "new");
+    EXPECT_EQ(std::filesystem::hard_link_count(path_), 2u);
+}
+
+TEST_F(OutputFileTest, ReadOnlyDirectory_WritesWritableFile) {
+    writeFile(path_, "old");
+    std::filesystem::permissions(dir_, std::filesystem::perms::owner_read | std::filesystem::perms::owner_exec);
+
+    // As root the temporary can still be created; either way the output is written
+    OutputFile output(path_);
+    writeAll(output, "new");
+    output.commit();
+
+    EXPECT_EQ(readBack(path_), "new");
+    std::filesystem::permissions(dir_, std::filesystem::perms::owner_all);
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir_), std::filesystem::directory_iterator()), 1);
+}
+
+TEST_F(OutputFileTest, DanglingSymlink_CreatesItsTarget) {
+    std::string target = (dir_ / "target.json").string();
+    std::filesystem::create_symlink(target, path_);
+
+    OutputFile output(path_);
+    EXPECT_FALSE(output.replaces());
+    writeAll(output, "new");
+    output.commit();
+
+    EXPECT_TRUE(std::filesystem::is_symlink(path_));
+    EXPECT_EQ(readBack(target), "new");
+}
+
+TEST_F(OutputFileTest, SpecialFile_IsWrittenInPlace) {
+    OutputFile output("/dev/null");
+    EXPECT_FALSE(output.replaces());
+    writeAll(output, "new");
+    EXPECT_NO_THROW(output.commit());
+}
+
+TEST_F(OutputFileTest, Destructor_WithoutCommitKeepsExistingFile) {
+    writeFile(path_, "old");
+    {
+        OutputFile output(path_);
+        writeAll(output, "partial");
+    }
+    EXPECT_EQ(readBack(path_), "old");
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir_), std::filesystem::directory_iterator()), 1);
+}
+
+#endif
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "ParallelConverter.h"
+#include "YamlToJsonConverter.h"
+#include "ErrorHandler.h"
+
+using namespace yaml2json;
+
+class ParallelConverterTest : public ::testing::Test {
+protected:
+    // Large enough to pass the parallel size threshold
+    static constexpr size_t kDocumentBytes = 6 * 1024 * 1024;
+
+    void SetUp() override {
+        setup_error_handlers();
+    }
+
+    // Root sequence of small records, like the very_large benchmark file
+    static std::string recordList(size_t bytes, const std::string& indent = "") {
+        std::string yaml;
+        for (size_t i = 0; yaml.size() < bytes; ++i) {
+            std::string id = std::to_string(i);
+            yaml += indent + "- id: " + id + "\n";
+            yaml += indent + "  name: \"user " + id + "\"\n";
+            yaml += indent + "  tags: [a, 'b c', {k: v}]\n";
+            yaml += indent + "  note: |\n";
+            yaml += indent + "    - not an item\n";
+            yaml += indent + "    key: not a key\n";
+        }
+        return yaml;
+    }
+
+    static std::string convert(std::string yaml, size_t threads, const ConversionLimits& limits = {}) {
+        ConversionOptions options;
+        options.threads = threads;
+        options.limits = limits;
+        return YamlToJsonConverter::convert(yaml.data(), yaml.size(), "", options);
+    }
+
+    static size_t chunkCount(const std::vector<ParallelConverter::Piece>& pieces) {
+        return static_cast<size_t>(std::count_if(pieces.begin(), pieces.end(),
+                                                 [](const ParallelConverter::Piece& p) { return p.is_chunk; }));
+    }
+
+    // Every chunk must begin on a line that starts an entry
+    static void expectChunksStartAt(const std::string& yaml, const std::vector<ParallelConverter::Piece>& pieces,
+                                    const std::vector<std::string>& prefixes) {
+        for (const auto& piece : pieces) {
+            if (piece.is_chunk) {
+                ASSERT_TRUE(piece.begin == 0 || yaml[piece.begin - 1] == '\n');
+                EXPECT_TRUE(std::any_of(prefixes.begin(), prefixes.end(), [&](const std::string& prefix) {
+                    return yaml.compare(piece.begin, prefix.size(), prefix) == 0;
+                })) << "chunk at line " << piece.line;
+            }
+        }
+    }
+};
+
+TEST_F(ParallelConverterTest, Plan_SplitsRootSequence) {
+    std::string yaml = recordList(kDocumentBytes);
+    std::vector<ParallelConverter::Piece> pieces;
+
+    ASSERT_TRUE(ParallelConverter::plan(yaml.data(), yaml.size(), 4, pieces));
+    EXPECT_GE(chunkCount(pieces), 2u);
+    EXPECT_EQ(pieces.front().glue, "[");
+    EXPECT_EQ(pieces.back().glue, "]");
+    expectChunksStartAt(yaml, pieces, {"- id: "});
+}
+
+TEST_F(ParallelConverterTest, Plan_DescendsIntoLargeMapEntry) {
+    std::string yaml = "# header\nversion: 3\nrecords:\n" + recordList(kDocumentBytes, "  ") + "footer: done\n";
+    std::vector<ParallelConverter::Piece> pieces;
+
+    ASSERT_TRUE(ParallelConverter::plan(yaml.data(), yaml.size(), 4, pieces));
+    EXPECT_GE(chunkCount(pieces), 3u);
+    EXPECT_NE(std::find_if(pieces.begin(), pieces.end(),
+                           [](const ParallelConverter::Piece& p) { return p.glue == "\"records\": "; }),
+              pieces.end());
+}
+
+TEST_F(ParallelConverterTest, Plan_SmallInputStaysSerial) {
+    std::string small = recordList(64 * 1024);
+    std::string large = recordList(kDocumentBytes);
+    std::vector<ParallelConverter::Piece> pieces;
+
+    EXPECT_FALSE(ParallelConverter::plan(small.data(), small.size(), 4, pieces));
+    EXPECT_FALSE(ParallelConverter::plan(large.data(), large.size(), 1, pieces));
+}
+
+TEST_F(ParallelConverterTest, Plan_RejectsUnsafeDocuments) {
+    std::string half = recordList(kDocumentBytes / 2);
+    std::vector<ParallelConverter::Piece> pieces;
+
+    std::string anchors = half + "- &shared {x: 1}\n- *shared\n" + half;
+    EXPECT_FALSE(ParallelConverter::plan(anchors.data(), anchors.size(), 4, pieces));
+
+    std::string merge = half + "- <<: {x: 1}\n" + half;
+    EXPECT_FALSE(ParallelConverter::plan(merge.data(), merge.size(), 4, pieces));
+
+    std::string stream = half + "---\n" + half;
+    EXPECT_FALSE(ParallelConverter::plan(stream.data(), stream.size(), 4, pieces));
+
+    std::string flow = "[\n" + std::string(kDocumentBytes, ' ') + "1]\n";
+    EXPECT_FALSE(ParallelConverter::plan(flow.data(), flow.size(), 4, pieces));
+
+    std::string unterminated = half + half + "- \"open\n- end\n";
+    EXPECT_FALSE(ParallelConverter::plan(unterminated.data(), unterminated.size(), 4, pieces));
+}
+
+TEST_F(ParallelConverterTest, Plan_IgnoresEntriesInsideMultiLineScalars) {
+    std::string yaml;
+    while (yaml.size() < kDocumentBytes) {
+        yaml += "- 'quoted\n\n- still quoted'\n- \"double \\\"\n- escaped\"\n- [1,\n- 2]\n";
+    }
+    std::vector<ParallelConverter::Piece> pieces;
+
+    ASSERT_TRUE(ParallelConverter::plan(yaml.data(), yaml.size(), 4, pieces));
+    expectChunksStartAt(yaml, pieces, {"- 'quoted", "- \"double", "- [1,"});
+}
+
+TEST_F(ParallelConverterTest, Convert_MatchesSerialOutput) {
+    std::string sequence = recordList(kDocumentBytes);
+    EXPECT_EQ(convert(sequence, 4), convert(sequence, 1));
+
+    std::string nested = "meta: {a: 1}\nrecords:\n" + recordList(kDocumentBytes, "  ") + "more:\n- 1\n- 2\n";
+    EXPECT_EQ(convert(nested, 0), convert(nested, 1));
+}
+
+TEST_F(ParallelConverterTest, Convert_FallsBackWhenUnsafe) {
+    std::string half = recordList(kDocumentBytes / 2);
+    std::string yaml = half + "- &shared {x: 1}\n- *shared\n" + half;
+
+    EXPECT_EQ(convert(yaml, 4), convert(yaml, 1));
+}
+
+TEST_F(ParallelConverterTest, Convert_ErrorsReportSourceLines) {
+    std::string yaml = recordList(kDocumentBytes) + "- {a: 1]\n" + recordList(1024);
+    ErrorLocation serial;
+    ErrorLocation parallel;
+    try {
+        convert(yaml, 1);
+    } catch (const ConversionError& e) {
+        serial = e.location();
+    }
+    try {
+        convert(yaml, 4);
+    } catch (const ConversionError& e) {
+        parallel = e.location();
+    }
+
+    EXPECT_GT(serial.line, 1000u);
+    EXPECT_EQ(parallel.line, serial.line);
+    EXPECT_EQ(parallel.column, serial.column);
+}
+
+TEST_F(ParallelConverterTest, Convert_EnforcesLimitsAcrossChunks) {
+    std::string yaml = recordList(kDocumentBytes);
+    ConversionLimits limits;
+
+    limits.max_output_bytes = kDocumentBytes / 2;
+    EXPECT_THROW(convert(yaml, 4, limits), LimitExceededError);
+
+    limits = ConversionLimits{};
+    limits.max_nodes = 1000;
+    EXPECT_THROW(convert(yaml, 4, limits), LimitExceededError);
+
+    limits = ConversionLimits{};
+    limits.max_depth = 1;
+    EXPECT_THROW(convert(yaml, 4, limits), LimitExceededError);
+}
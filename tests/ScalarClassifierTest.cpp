@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include "ScalarClassifier.h"
+
+using namespace yaml2json;
+
+class ScalarClassifierTest : public ::testing::Test {
+protected:
+    ScalarValue decode(const char* s) {
+        return ScalarClassifier::decode(ryml::to_csubstr(s));
+    }
+
+    ScalarType classify(const char* s) {
+        return ScalarClassifier::classify(ryml::to_csubstr(s));
+    }
+};
+
+TEST_F(ScalarClassifierTest, Classify_NullAndBool) {
+    EXPECT_EQ(classify(""), ScalarType::Null);
+    EXPECT_EQ(classify("~"), ScalarType::Null);
+    EXPECT_EQ(classify("null"), ScalarType::Null);
+    EXPECT_EQ(classify("NULL"), ScalarType::Null);
+    EXPECT_EQ(classify("true"), ScalarType::Bool);
+    EXPECT_EQ(classify("False"), ScalarType::Bool);
+    EXPECT_EQ(classify("yes"), ScalarType::String);
+    EXPECT_EQ(classify("nil"), ScalarType::String);
+}
+
+TEST_F(ScalarClassifierTest, Decode_Integers) {
+    ScalarValue v = decode("8080");
+    EXPECT_EQ(v.type, ScalarType::Int);
+    EXPECT_EQ(v.magnitude, 8080u);
+    EXPECT_FALSE(v.negative);
+
+    v = decode("-42");
+    EXPECT_EQ(v.type, ScalarType::Int);
+    EXPECT_EQ(v.magnitude, 42u);
+    EXPECT_TRUE(v.negative);
+
+    v = decode("0x1F");
+    EXPECT_EQ(v.type, ScalarType::Int);
+    EXPECT_EQ(v.magnitude, 31u);
+
+    v = decode("0o17");
+    EXPECT_EQ(v.type, ScalarType::Int);
+    EXPECT_EQ(v.magnitude, 15u);
+
+    v = decode("-0");
+    EXPECT_EQ(v.type, ScalarType::Int);
+    EXPECT_FALSE(v.negative);
+}
+
+TEST_F(ScalarClassifierTest, Decode_IntegerOverflowBecomesFloat) {
+    ScalarValue v = decode("18446744073709551616");
+    EXPECT_EQ(v.type, ScalarType::Float);
+    EXPECT_DOUBLE_EQ(v.number, 18446744073709551616.0);
+}
+
+TEST_F(ScalarClassifierTest, Decode_Floats) {
+    EXPECT_DOUBLE_EQ(decode("3.14").number, 3.14);
+    EXPECT_DOUBLE_EQ(decode("-.5").number, -0.5);
+    EXPECT_DOUBLE_EQ(decode("1e3").number, 1000.0);
+    EXPECT_DOUBLE_EQ(decode("2.").number, 2.0);
+    EXPECT_EQ(decode("1e3").type, ScalarType::Float);
+
+    EXPECT_TRUE(std::isinf(decode(".inf").number));
+    EXPECT_LT(decode("-.Inf").number, 0.0);
+    EXPECT_TRUE(std::isnan(decode(".nan").number));
+}
+
+TEST_F(ScalarClassifierTest, Classify_Strings) {
+    EXPECT_EQ(classify("hello"), ScalarType::String);
+    EXPECT_EQ(classify("1.2.3"), ScalarType::String);
+    EXPECT_EQ(classify("0x"), ScalarType::String);
+    EXPECT_EQ(classify("0xZZ"), ScalarType::String);
+    EXPECT_EQ(classify("-"), ScalarType::String);
+    EXPECT_EQ(classify("."), ScalarType::String);
+    EXPECT_EQ(classify("1e"), ScalarType::String);
+    EXPECT_EQ(classify("12:30"), ScalarType::String);
+    EXPECT_EQ(classify("+.nan"), ScalarType::String);
+}
+
+TEST_F(ScalarClassifierTest, Decode_LongDecimalsUseEightDigitSteps) {
+    ScalarValue v = decode("1234567890123456789");
+    EXPECT_EQ(v.type, ScalarType::Int);
+    EXPECT_EQ(v.magnitude, 1234567890123456789u);
+
+    v = decode("-00000000000000042");
+    EXPECT_EQ(v.type, ScalarType::Int);
+    EXPECT_EQ(v.magnitude, 42u);
+    EXPECT_TRUE(v.negative);
+
+    v = decode("18446744073709551615");
+    EXPECT_EQ(v.type, ScalarType::Int);
+    EXPECT_EQ(v.magnitude, 18446744073709551615u);
+
+    EXPECT_EQ(classify("12345678x"), ScalarType::String);
+    EXPECT_EQ(classify("1234567:"), ScalarType::String);
+}
+
+TEST_F(ScalarClassifierTest, Decode_Yaml11) {
+    auto yaml11 = [](const char* s) { return ScalarClassifier::decode(ryml::to_csubstr(s), ScalarTyping::Yaml11); };
+
+    EXPECT_EQ(yaml11("yes").type, ScalarType::Bool);
+    EXPECT_TRUE(yaml11("On").boolean);
+    EXPECT_FALSE(yaml11("N").boolean);
+    EXPECT_EQ(yaml11("no").type, ScalarType::Bool);
+    EXPECT_EQ(yaml11("null").type, ScalarType::Null);
+    EXPECT_EQ(yaml11("nope").type, ScalarType::String);
+
+    EXPECT_EQ(yaml11("1_000").magnitude, 1000u);
+    EXPECT_EQ(yaml11("0b1010").magnitude, 10u);
+    EXPECT_EQ(yaml11("017").magnitude, 15u);
+    EXPECT_EQ(yaml11("-0x1F").magnitude, 31u);
+    EXPECT_TRUE(yaml11("-0x1F").negative);
+    EXPECT_DOUBLE_EQ(yaml11("1_000.5").number, 1000.5);
+    EXPECT_EQ(yaml11("08").type, ScalarType::String);
+    EXPECT_EQ(yaml11("1e3").type, ScalarType::String);
+    EXPECT_EQ(yaml11("1:30").type, ScalarType::String);
+    EXPECT_EQ(yaml11("_1").type, ScalarType::String);
+
+    // The core schema keeps these as strings
+    EXPECT_EQ(classify("1_000"), ScalarType::String);
+    EXPECT_EQ(classify("0b1010"), ScalarType::String);
+}
+
+TEST_F(ScalarClassifierTest, FormatNumber_NormalizesToJson) {
+    auto format = [](const char* s) {
+        char buf[32];
+        size_t len = ScalarClassifier::format_number(ScalarClassifier::decode(ryml::to_csubstr(s)), buf, sizeof(buf));
+        return std::string(buf, len);
+    };
+
+    EXPECT_EQ(format("0x1F"), "31");
+    EXPECT_EQ(format("+12"), "12");
+    EXPECT_EQ(format("007"), "7");
+    EXPECT_EQ(format(".5"), "0.5");
+    EXPECT_EQ(format("-2."), "-2");
+    EXPECT_EQ(format("0.1"), "0.1");
+    EXPECT_EQ(format(".inf"), "");
+    EXPECT_EQ(format("hello"), "");
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "SimdKernels.h"
+
+using namespace yaml2json;
+
+namespace {
+
+// Restores the start-up variant after a test switched it
+class SimdKernelsTest : public ::testing::Test {
+protected:
+    void SetUp() override { initial_ = SimdKernels::active(); }
+    void TearDown() override { SimdKernels::select(initial_); }
+
+private:
+    KernelVariant initial_ = KernelVariant::Scalar;
+};
+
+size_t reference_escape(const std::string& s) {
+    for (size_t i = 0; i < s.size(); ++i) {
+        auto c = static_cast<unsigned char>(s[i]);
+        if (c < 0x20 || c == '"' || c == '\\') {
+            return i;
+        }
+    }
+    return s.size();
+}
+
+} // namespace
+
+TEST_F(SimdKernelsTest, ScalarIsAlwaysSupported) {
+    std::vector<KernelVariant> variants = SimdKernels::supported();
+    ASSERT_FALSE(variants.empty());
+    EXPECT_EQ(variants.front(), KernelVariant::Scalar);
+    EXPECT_NE(std::find(variants.begin(), variants.end(), SimdKernels::active()), variants.end());
+}
+
+TEST_F(SimdKernelsTest, NamesRoundTrip) {
+    for (KernelVariant variant : {KernelVariant::Scalar, KernelVariant::Sse2, KernelVariant::Avx2,
+                                  KernelVariant::Avx512, KernelVariant::Neon}) {
+        KernelVariant parsed = KernelVariant::Scalar;
+        ASSERT_TRUE(SimdKernels::parse(SimdKernels::name(variant), parsed));
+        EXPECT_EQ(parsed, variant);
+    }
+    KernelVariant parsed = KernelVariant::Avx2;
+    EXPECT_FALSE(SimdKernels::parse("sse4", parsed));
+    EXPECT_EQ(parsed, KernelVariant::Avx2);
+}
+
+TEST_F(SimdKernelsTest, UnsupportedVariantIsRefused) {
+    std::vector<KernelVariant> variants = SimdKernels::supported();
+    KernelVariant before = SimdKernels::active();
+    for (KernelVariant variant : {KernelVariant::Sse2, KernelVariant::Avx2, KernelVariant::Avx512,
+                                  KernelVariant::Neon}) {
+        if (std::find(variants.begin(), variants.end(), variant) == variants.end()) {
+            EXPECT_FALSE(SimdKernels::select(variant)) << SimdKernels::name(variant);
+            EXPECT_EQ(SimdKernels::active(), before);
+        }
+    }
+}
+
+TEST_F(SimdKernelsTest, FindEscapeMatchesScalarAtEveryPosition) {
+    // Each special byte at each offset of buffers around the vector widths,
+    // scanned from unaligned starts
+    const std::string specials = std::string("\"\\\n\t") + '\0' + '\x1f';
+    for (KernelVariant variant : SimdKernels::supported()) {
+        ASSERT_TRUE(SimdKernels::select(variant));
+        for (size_t size : {0u, 1u, 15u, 16u, 17u, 31u, 32u, 33u, 63u, 64u, 65u, 130u}) {
+            for (size_t start = 0; start < 3; ++start) {
+                std::string clean(start + size, 'a');
+                // Bytes around the threshold that must not match
+                for (size_t i = 0; i < clean.size(); i += 7) {
+                    clean[i] = i % 2 ? ' ' : '\x7f';
+                }
+                ASSERT_EQ(SimdKernels::find_escape(clean.data() + start, size), size)
+                    << SimdKernels::name(variant) << " size " << size;
+                for (char special : specials) {
+                    for (size_t pos = 0; pos < size; ++pos) {
+                        std::string buffer = clean;
+                        buffer[start + pos] = special;
+                        std::string view = buffer.substr(start);
+                        ASSERT_EQ(SimdKernels::find_escape(buffer.data() + start, size), reference_escape(view))
+                            << SimdKernels::name(variant) << " size " << size << " pos " << pos;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_F(SimdKernelsTest, HighBytesAreNotEscaped) {
+    // UTF-8 continuation and lead bytes are >= 0x80: signed compares would catch them
+    std::string utf8;
+    for (int i = 0; i < 20; ++i) {
+        utf8 += "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80";
+    }
+    for (KernelVariant variant : SimdKernels::supported()) {
+        ASSERT_TRUE(SimdKernels::select(variant));
+        EXPECT_EQ(SimdKernels::find_escape(utf8.data(), utf8.size()), utf8.size()) << SimdKernels::name(variant);
+    }
+}
+
+TEST_F(SimdKernelsTest, CountNewlinesMatchesScalar) {
+    // Long enough that the byte counters are flushed more than once
+    std::string text;
+    for (size_t i = 0; i < 20000; ++i) {
+        text += (i * 7919) % 5 == 0 ? '\n' : static_cast<char>('a' + i % 26);
+    }
+    std::string all_newlines(9000, '\n');
+    for (KernelVariant variant : SimdKernels::supported()) {
+        ASSERT_TRUE(SimdKernels::select(variant));
+        for (size_t start = 0; start < 3; ++start) {
+            for (size_t size : {0u, 5u, 16u, 33u, 64u, 100u, 4097u, 19990u}) {
+                ASSERT_EQ(SimdKernels::count_newlines(text.data() + start, size),
+                          static_cast<size_t>(std::count(text.begin() + start, text.begin() + start + size, '\n')))
+                    << SimdKernels::name(variant) << " size " << size;
+            }
+        }
+        EXPECT_EQ(SimdKernels::count_newlines(all_newlines.data(), all_newlines.size()), all_newlines.size())
+            << SimdKernels::name(variant);
+    }
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "FileReader.h"
+#include "YamlToJsonConverter.h"
+#include "JsonFormatter.h"
+#include "ErrorHandler.h"
+
+using namespace yaml2json;
+
+// Replays tests/test_data/slow: inputs the fuzzers (fuzz/) flagged as slow or
+// allocation-heavy, kept once fixed. .yaml files go through convert and
+// pretty-printing, .json files through the formatter alone. The budget is the
+// fuzzers' default with room for debug and sanitizer builds.
+
+namespace {
+
+const char* const kDir = "tests/test_data/slow";
+
+constexpr double kNanosPerByte = 20000.0;
+constexpr double kMinNanos = 500e6;
+
+std::vector<std::filesystem::path> slow_inputs(const std::string& extension) {
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(kDir)) {
+        if (entry.path().extension() == extension) {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+// Bytes read plus written, as the fuzzers count them
+void expect_within_budget(std::chrono::steady_clock::time_point start, size_t moved) {
+    double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_LE(nanos, kMinNanos + kNanosPerByte * static_cast<double>(moved))
+        << moved << " bytes read and written";
+}
+
+} // namespace
+
+class SlowInputTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setup_error_handlers();
+    }
+};
+
+TEST_F(SlowInputTest, Directory_HasInputs) {
+    EXPECT_FALSE(slow_inputs(".yaml").empty());
+    EXPECT_FALSE(slow_inputs(".json").empty());
+}
+
+TEST_F(SlowInputTest, Convert_StaysWithinBudget) {
+    for (const std::filesystem::path& path : slow_inputs(".yaml")) {
+        SCOPED_TRACE(path.string());
+        FileContent input = FileReader::read_file(path.string());
+        size_t moved = input.size();
+        auto start = std::chrono::steady_clock::now();
+        try {
+            std::string json = YamlToJsonConverter::convert(input.data(), input.size(), path.string());
+            moved += json.size();
+            moved += JsonFormatter::pretty_print(json).size();
+        } catch (const ConversionError&) {
+            // Rejecting the input is fine, as long as it happens in time
+        }
+        expect_within_budget(start, moved);
+    }
+}
+
+TEST_F(SlowInputTest, Format_StaysWithinBudget) {
+    for (const std::filesystem::path& path : slow_inputs(".json")) {
+        SCOPED_TRACE(path.string());
+        FileContent input = FileReader::read_file(path.string());
+        std::string json(input.data(), input.size());
+        size_t moved = json.size();
+        auto start = std::chrono::steady_clock::now();
+        moved += JsonFormatter::pretty_print(json).size();
+        moved += JsonFormatter::compact(json).size();
+        expect_within_budget(start, moved);
+    }
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "StringInterner.h"
+#include "JsonEmitter.h"
+#include "YamlToJsonConverter.h"
+#include "ErrorHandler.h"
+
+using namespace yaml2json;
+
+namespace {
+
+ryml::csubstr sub(const std::string& s) {
+    return ryml::csubstr(s.data(), s.size());
+}
+
+} // namespace
+
+TEST(StringInternerTest, AppendJson_RepeatsAreServedFromTheTable) {
+    StringInterner interner;
+    std::string out;
+    std::string key = "name";
+    EXPECT_TRUE(interner.append_json(out, sub(key)));
+    EXPECT_TRUE(interner.append_json(out, sub(key)));
+    std::string other = "kind";
+    EXPECT_TRUE(interner.append_json(out, sub(other)));
+
+    EXPECT_EQ(out, "\"name\"\"name\"\"kind\"");
+    EXPECT_EQ(interner.size(), 2u);
+    EXPECT_EQ(interner.hits(), 1u);
+}
+
+TEST(StringInternerTest, AppendJson_CachesTheEscapedForm) {
+    StringInterner interner;
+    std::string s = "say \"hi\"\n\t\x01";
+    std::string expected;
+    JsonEmitter::append_string(expected, sub(s));
+    for (int i = 0; i < 3; ++i) {
+        std::string out;
+        EXPECT_TRUE(interner.append_json(out, sub(s)));
+        EXPECT_EQ(out, expected);
+    }
+}
+
+TEST(StringInternerTest, AppendJson_SkipsEmptyAndLongStrings) {
+    StringInterner interner;
+    std::string out;
+    std::string empty;
+    std::string longest(StringInterner::kMaxStringBytes, 'a');
+    std::string too_long(StringInterner::kMaxStringBytes + 1, 'a');
+
+    EXPECT_FALSE(interner.append_json(out, sub(empty)));
+    EXPECT_TRUE(interner.append_json(out, sub(longest)));
+    out.clear();
+    EXPECT_FALSE(interner.append_json(out, sub(too_long)));
+    EXPECT_TRUE(out.empty());
+}
+
+TEST(StringInternerTest, Growth_KeepsEveryEntry) {
+    StringInterner interner;
+    std::string out;
+    for (int i = 0; i < 5000; ++i) {
+        std::string s = "key_" + std::to_string(i);
+        EXPECT_TRUE(interner.append_json(out, sub(s)));
+    }
+    for (int i = 0; i < 5000; ++i) {
+        std::string s = "key_" + std::to_string(i);
+        out.clear();
+        EXPECT_TRUE(interner.append_json(out, sub(s)));
+        EXPECT_EQ(out, "\"" + s + "\"");
+    }
+    EXPECT_EQ(interner.size(), 5000u);
+    EXPECT_EQ(interner.hits(), 5000u);
+}
+
+TEST(StringInternerTest, FullTable_StillServesStoredStrings) {
+    StringInterner interner;
+    std::string out;
+    for (size_t i = 0; i < StringInterner::kMaxEntries; ++i) {
+        std::string s = "v" + std::to_string(i);
+        ASSERT_TRUE(interner.append_json(out, sub(s)));
+    }
+    out.clear();
+    std::string fresh = "not stored";
+    std::string stored = "v42";
+    EXPECT_FALSE(interner.append_json(out, sub(fresh)));
+    EXPECT_TRUE(interner.append_json(out, sub(stored)));
+    EXPECT_EQ(out, "\"v42\"");
+    EXPECT_EQ(interner.size(), StringInterner::kMaxEntries);
+}
+
+TEST(StringInternerTest, Emitter_OutputUnchanged) {
+    setup_error_handlers();
+    std::string yaml;
+    for (int i = 0; i < 200; ++i) {
+        yaml += "- id: " + std::to_string(i) + "\n  kind: \"tab\\there\"\n  status: active\n"
+                "  base: &b" + std::to_string(i) + " {zone: eu, tier: gold}\n  copy: *b" + std::to_string(i) + "\n";
+    }
+    for (bool canonical : {false, true}) {
+        ConversionOptions options;
+        options.canonical = canonical;
+        std::string plain_input = yaml;
+        std::string expected = YamlToJsonConverter::convert(&plain_input[0], plain_input.size(), "", options);
+
+        options.intern_strings = true;
+        std::string interned_input = yaml;
+        EXPECT_EQ(YamlToJsonConverter::convert(&interned_input[0], interned_input.size(), "", options), expected);
+    }
+
+    std::string input = yaml;
+    ryml::Tree tree = YamlToJsonConverter::parse_yaml(&input[0], input.size());
+    JsonEmitter emitter(tree, ConversionLimits{});
+    emitter.set_interning(true);
+    std::string json;
+    emitter.emit(json);
+    // Only the value with a tab needs escaping: stored once, then reused
+    ASSERT_NE(emitter.interner(), nullptr);
+    EXPECT_EQ(emitter.interner()->size(), 1u);
+    EXPECT_EQ(emitter.interner()->hits(), 199u);
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "ThreadPool.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace yaml2json;
+
+class ThreadPoolTest : public ::testing::Test {};
+
+TEST_F(ThreadPoolTest, Submit_RunsEveryTask) {
+    ThreadPool pool(4);
+    std::atomic<int> sum{0};
+    for (int i = 1; i <= 100; ++i) {
+        pool.submit([&sum, i] { sum += i; });
+    }
+    pool.wait();
+
+    EXPECT_EQ(sum.load(), 5050);
+    EXPECT_EQ(pool.size(), 4u);
+}
+
+TEST_F(ThreadPoolTest, ParallelFor_VisitsEachIndexOnce) {
+    ThreadPool pool(3);
+    std::vector<std::atomic<int>> visits(1000);
+    pool.parallel_for(visits.size(), [&](size_t i) { ++visits[i]; });
+
+    for (const auto& count : visits) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+
+TEST_F(ThreadPoolTest, ParallelFor_EmptyRange) {
+    ThreadPool pool(2);
+    bool called = false;
+    pool.parallel_for(0, [&](size_t) { called = true; });
+
+    EXPECT_FALSE(called);
+}
+
+TEST_F(ThreadPoolTest, ParallelFor_PropagatesException) {
+    ThreadPool pool(2);
+
+    EXPECT_THROW(pool.parallel_for(64, [](size_t i) {
+        if (i == 17) {
+            throw std::runtime_error("task failed");
+        }
+    }), std::runtime_error);
+
+    // The pool stays usable afterwards
+    std::atomic<int> count{0};
+    pool.parallel_for(10, [&](size_t) { ++count; });
+    EXPECT_EQ(count.load(), 10);
+}
+
+TEST_F(ThreadPoolTest, Wait_RethrowsTaskException) {
+    ThreadPool pool(1);
+    pool.submit([] { throw std::runtime_error("boom"); });
+
+    EXPECT_THROW(pool.wait(), std::runtime_error);
+    EXPECT_NO_THROW(pool.wait());
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "Trace.h"
+#include "FileReader.h"
+#include "JsonFormatter.h"
+#include "ThreadPool.h"
+#include "YamlToJsonConverter.h"
+#include "ErrorHandler.h"
+
+using namespace yaml2json;
+
+namespace {
+
+struct Span {
+    std::string name;
+    std::string detail;
+    double ts = 0;
+    double dur = 0;
+    int tid = 0;
+};
+
+std::string text(const ryml::Tree& tree, ryml::id_type node, const char* key) {
+    ryml::id_type child = tree.find_child(node, ryml::to_csubstr(key));
+    if (child == ryml::NONE) {
+        return "";
+    }
+    ryml::csubstr val = tree.val(child);
+    return std::string(val.str, val.len);
+}
+
+// Parses the trace as a viewer would; fails the test on malformed JSON
+struct ParsedTrace {
+    std::vector<Span> spans;
+    std::map<int, std::string> thread_names;
+};
+
+ParsedTrace parse_trace(std::string json) {
+    ParsedTrace trace;
+    ryml::Tree tree;
+    ryml::parse_json_in_place(ryml::substr(&json[0], json.size()), &tree);
+    ryml::id_type events = tree.find_child(tree.root_id(), "traceEvents");
+    EXPECT_NE(events, ryml::NONE);
+    if (events == ryml::NONE) {
+        return trace;
+    }
+    for (ryml::id_type event = tree.first_child(events); event != ryml::NONE; event = tree.next_sibling(event)) {
+        std::string phase = text(tree, event, "ph");
+        int tid = std::stoi(text(tree, event, "tid"));
+        ryml::id_type args = tree.find_child(event, "args");
+        if (phase == "M") {
+            trace.thread_names[tid] = text(tree, args, "name");
+            continue;
+        }
+        EXPECT_EQ(phase, "X");
+        Span span;
+        span.name = text(tree, event, "name");
+        span.detail = args == ryml::NONE ? "" : text(tree, args, "detail");
+        span.ts = std::stod(text(tree, event, "ts"));
+        span.dur = std::stod(text(tree, event, "dur"));
+        span.tid = tid;
+        trace.spans.push_back(span);
+    }
+    return trace;
+}
+
+} // namespace
+
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setup_error_handlers();
+        Trace::reset();
+    }
+
+    void TearDown() override {
+        Trace::reset();
+    }
+};
+
+TEST_F(TraceTest, Disabled_RecordsNothing) {
+    {
+        TraceSpan span("parse", "file.yaml");
+    }
+    EXPECT_FALSE(Trace::enabled());
+    EXPECT_TRUE(parse_trace(Trace::to_json()).spans.empty());
+}
+
+TEST_F(TraceTest, Conversion_RecordsEveryStage) {
+    std::string path = (std::filesystem::temp_directory_path() / "trace_test.yaml").string();
+    {
+        std::ofstream file(path);
+        file << "name: test\nitems: [1, 2, 3]\n";
+    }
+
+    Trace::enable();
+    Trace::set_thread_name("main");
+    FileContent input = FileReader::read_file(path);
+    std::string json = YamlToJsonConverter::convert(input.mutable_data(), input.size(), path);
+    JsonFormatter::pretty_print(json);
+    std::filesystem::remove(path);
+
+    ParsedTrace trace = parse_trace(Trace::to_json());
+    std::set<std::string> names;
+    for (const Span& span : trace.spans) {
+        names.insert(span.name);
+        EXPECT_GE(span.ts, 0.0);
+        EXPECT_GE(span.dur, 0.0);
+        if (span.name == "read" || span.name == "parse") {
+            EXPECT_EQ(span.detail, path);
+        }
+    }
+    EXPECT_EQ(names, (std::set<std::string>{"read", "parse", "check", "emit", "format"}));
+    ASSERT_EQ(trace.thread_names.size(), 1u);
+    EXPECT_EQ(trace.thread_names.begin()->second, "main");
+}
+
+TEST_F(TraceTest, NestedSpans_EndInsideTheirParent) {
+    Trace::enable();
+    {
+        TraceSpan outer("document", "a.yaml", 1);
+        TraceSpan inner("parse");
+    }
+    ParsedTrace trace = parse_trace(Trace::to_json());
+    ASSERT_EQ(trace.spans.size(), 2u);
+    const Span& outer = trace.spans[0];
+    const Span& inner = trace.spans[1];
+    EXPECT_EQ(outer.name, "document");
+    EXPECT_EQ(outer.detail, "a.yaml:1");
+    EXPECT_GE(inner.ts, outer.ts);
+    EXPECT_LE(inner.ts + inner.dur, outer.ts + outer.dur + 0.001);
+}
+
+TEST_F(TraceTest, Threads_RecordOnTheirOwnTracks) {
+    Trace::enable();
+    {
+        ThreadPool pool(3);
+        pool.parallel_for(64, [](size_t i) {
+            TraceSpan span("chunk", "input.yaml", i);
+        });
+    }
+    ParsedTrace trace = parse_trace(Trace::to_json());
+
+    EXPECT_EQ(trace.spans.size(), 64u);
+    std::set<int> tids;
+    for (const Span& span : trace.spans) {
+        tids.insert(span.tid);
+    }
+    EXPECT_GE(tids.size(), 1u);
+    // Every worker named its track, whether or not it got work
+    std::set<std::string> workers;
+    for (const auto& entry : trace.thread_names) {
+        workers.insert(entry.second);
+    }
+    EXPECT_EQ(workers, (std::set<std::string>{"worker 1", "worker 2", "worker 3"}));
+}
+
+TEST_F(TraceTest, Details_AreEscaped) {
+    Trace::enable();
+    {
+        TraceSpan span("read", "odd \"name\"\\\n.yaml");
+    }
+    ParsedTrace trace = parse_trace(Trace::to_json());
+    ASSERT_EQ(trace.spans.size(), 1u);
+    EXPECT_EQ(trace.spans[0].detail, "odd \"name\"\\\n.yaml");
+}
+
+TEST_F(TraceTest, Write_FailureThrowsConversionError) {
+    Trace::enable();
+    EXPECT_THROW(Trace::write("/nonexistent-dir/trace.json"), ConversionError);
+}
@@ -1,7 +1,13 @@
 #include <gtest/gtest.h>
+#include <cstdio>
 #include <cstring>
+#include <string>
+#include <vector>
 #include "YamlToJsonConverter.h"
 #include "ErrorHandler.h"
+#include "FileReader.h"
+#include "GatherWriter.h"
+#include "OutputSink.h"
 
 using namespace yaml2json;
 
@@ -92,4 +98,87 @@ TEST_F(YamlToJsonConverterTest, Convert_SpecialCharacters) {
     
     // Check that the string is properly quoted in JSON
     EXPECT_NE(json.find(R"("text": "Hello World")"), std::string::npos);
-}
\ No newline at end of file
+}
+
+TEST_F(YamlToJsonConverterTest, Check_ValidYaml) {
+    std::string yaml = "key: value\nlist: [1, 2]";
+    
+    EXPECT_NO_THROW(YamlToJsonConverter::check(&yaml[0], yaml.size(), "valid.yaml"));
+}
+
+TEST_F(YamlToJsonConverterTest, Check_InvalidYamlHasLocation) {
+    std::string yaml = "key: value\nother: [unclosed";
+    
+    try {
+        YamlToJsonConverter::check(&yaml[0], yaml.size(), "invalid.yaml");
+        FAIL() << "expected ConversionError";
+    } catch (const ConversionError& e) {
+        EXPECT_EQ(e.location().file, "invalid.yaml");
+        EXPECT_GT(e.location().line, 0u);
+    }
+}
+
+TEST_F(YamlToJsonConverterTest, Check_UndefinedAliasHasLocation) {
+    std::string yaml = "a: 1\nb: *missing\n";
+    
+    try {
+        YamlToJsonConverter::check(&yaml[0], yaml.size(), "alias.yaml");
+        FAIL() << "expected ConversionError";
+    } catch (const ConversionError& e) {
+        EXPECT_EQ(format_machine_error(e, "alias.yaml"), "alias.yaml:2:4: Undefined alias '*missing'");
+    }
+}
+
+TEST_F(YamlToJsonConverterTest, OutputPaths_ProduceIdenticalJson) {
+    // convert(), the writev path and sinks must agree byte for byte, on the
+    // scalars where JSON emitters tend to differ most
+    struct Collect : OutputSink {
+        void write(const char* data, size_t size) override { out.append(data, size); }
+        std::string out;
+    };
+    std::vector<std::string> documents;
+    for (const char* name : {"simple.yaml", "nested.yaml", "merge_keys.yaml"}) {
+        FileContent content = FileReader::read_file(std::string("tests/test_data/") + name);
+        documents.emplace_back(content.data(), content.size());
+    }
+    documents.push_back("n1: ~\nn2: Null\nn3: NULL\nn4:\nb: [True, FALSE, yes]\n"
+                        "num: [1.0, 1.00, 0x1F, 0o17, +5, .5, 1e3, -0, .inf, 1_000]\n"
+                        "ctl: \"a\\x01b\\tc\\u00e9\"\nfold: >\n  one\n  two\nlit: |\n  line\n");
+    documents.push_back("long: \"" + std::string(300, 'x') + "\"\n'quoted key': ['" + std::string(100, 'y') + "']\n");
+    documents.push_back("--- 1\n--- {a: [x, ~]}\n--- \"s\"\n");
+
+    for (const std::string& yaml : documents) {
+        SCOPED_TRACE(yaml.substr(0, 40));
+        std::string copy = yaml;
+        std::string converted = YamlToJsonConverter::convert(&copy[0], copy.size());
+
+        copy = yaml;
+        std::FILE* file = std::tmpfile();
+        ASSERT_NE(file, nullptr);
+        GatherWriter writer;
+        YamlToJsonConverter::write_json(&copy[0], copy.size(), "", ConversionOptions{}, writer, fileno(file));
+        std::string gathered;
+        std::rewind(file);
+        char buffer[4096];
+        for (size_t n; (n = std::fread(buffer, 1, sizeof(buffer), file)) > 0;) {
+            gathered.append(buffer, n);
+        }
+        std::fclose(file);
+
+        copy = yaml;
+        Collect sink;
+        YamlToJsonConverter::convert_to(&copy[0], copy.size(), "", ConversionOptions{}, sink);
+
+        EXPECT_EQ(gathered, converted);
+        EXPECT_EQ(sink.out, converted);
+    }
+}
+
+TEST_F(YamlToJsonConverterTest, Convert_DefaultScalarSpellings) {
+    // Pinned since every path emits through JsonEmitter; earlier releases
+    // wrote some of these differently from convert() and --pretty
+    const char* yaml = "a: ~\nb: Null\nc: NULL\nd: 0x1F\ne: !!str 12\nf: &x [1]\ng: *x\nh: .inf\ni: \"~\"";
+    std::string json = YamlToJsonConverter::convert(yaml, strlen(yaml));
+
+    EXPECT_EQ(json, R"({"a": null,"b": null,"c": null,"d": "0x1F","e": "12","f": [1],"g": [1],"h": ".inf","i": "~"})");
+}
@@ -0,0 +1,281 @@
+/* Plain C client of libyaml2json: checks the C interface as other languages see it */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "yaml2json.h"
+
+#ifndef _WIN32
+    #include <pthread.h>
+#endif
+
+static int failures = 0;
+
+#define CHECK(cond)                                                      \
+    do {                                                                 \
+        if (!(cond)) {                                                   \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++failures;                                                  \
+        }                                                                \
+    } while (0)
+
+/* Output gathered by the callback */
+typedef struct {
+    char data[4096];
+    size_t size;
+} collected;
+
+static int collect(void* user_data, const char* data, size_t size) {
+    collected* out = (collected*)user_data;
+    if (out->size + size <= sizeof(out->data)) {
+        memcpy(out->data + out->size, data, size);
+        out->size += size;
+    }
+    return 0;
+}
+
+static void test_convert_with_callback(void) {
+    const char yaml[] = "name: test\nitems: [1, 2]\n";
+    char before[sizeof(yaml)];
+    collected out = {{0}, 0};
+    y2j_error error;
+    y2j_converter* converter = y2j_converter_new(NULL, &error);
+
+    CHECK(converter != NULL);
+    memcpy(before, yaml, sizeof(yaml));
+    CHECK(y2j_convert(converter, yaml, strlen(yaml), collect, &out, &error) == Y2J_OK);
+    CHECK(error.status == Y2J_OK);
+    CHECK(out.size == strlen("{\"name\": \"test\",\"items\": [1,2]}"));
+    CHECK(memcmp(out.data, "{\"name\": \"test\",\"items\": [1,2]}", out.size) == 0);
+    /* The caller's buffer is never parsed in place */
+    CHECK(memcmp(before, yaml, sizeof(yaml)) == 0);
+    y2j_converter_free(converter);
+}
+
+static void test_caller_buffer(void) {
+    const char yaml[] = "key: value\n";
+    const char expected[] = "{\"key\": \"value\"}";
+    char small[4];
+    char large[64];
+    size_t size = 0;
+    y2j_error error;
+    y2j_converter* converter = y2j_converter_new(NULL, NULL);
+
+    CHECK(y2j_convert_to_buffer(converter, yaml, strlen(yaml), small, sizeof(small), &size, &error) ==
+          Y2J_ERR_BUFFER_TOO_SMALL);
+    CHECK(error.status == Y2J_ERR_BUFFER_TOO_SMALL);
+    CHECK(size == strlen(expected));
+    CHECK(memcmp(small, expected, sizeof(small)) == 0);
+
+    CHECK(y2j_convert_to_buffer(converter, yaml, strlen(yaml), large, size, &size, &error) == Y2J_OK);
+    CHECK(size == strlen(expected));
+    CHECK(memcmp(large, expected, size) == 0);
+
+    /* A size query without a buffer */
+    CHECK(y2j_convert_to_buffer(converter, yaml, strlen(yaml), NULL, 0, &size, NULL) == Y2J_ERR_BUFFER_TOO_SMALL);
+    CHECK(size == strlen(expected));
+    y2j_converter_free(converter);
+}
+
+static void test_parse_error_location(void) {
+    const char yaml[] = "a: 1\nb: [1, 2\n";
+    collected out = {{0}, 0};
+    y2j_error error;
+    y2j_converter* converter = y2j_converter_new(NULL, NULL);
+
+    CHECK(y2j_convert(converter, yaml, strlen(yaml), collect, &out, &error) == Y2J_ERR_PARSE);
+    CHECK(error.status == Y2J_ERR_PARSE);
+    CHECK(error.line >= 2);
+    CHECK(strlen(error.message) > 0);
+    CHECK(strcmp(y2j_status_string(error.status), "conversion error") == 0);
+    y2j_converter_free(converter);
+}
+
+static void test_options(void) {
+    const char yaml[] = "b: 0x1F\na: yes\nb: 2\n";
+    char json[64];
+    size_t size = 0;
+    y2j_options options;
+    y2j_error error;
+    y2j_converter* converter;
+
+    y2j_options_init(&options);
+    options.scalars = Y2J_SCALARS_YAML11;
+    options.duplicate_keys = Y2J_DUPLICATE_KEYS_LAST_WINS;
+    options.canonical = 1;
+    converter = y2j_converter_new(&options, &error);
+    CHECK(converter != NULL);
+    CHECK(y2j_convert_to_buffer(converter, yaml, strlen(yaml), json, sizeof(json), &size, &error) == Y2J_OK);
+    CHECK(size == strlen("{\"a\":true,\"b\":2}"));
+    CHECK(memcmp(json, "{\"a\":true,\"b\":2}", size) == 0);
+    y2j_converter_free(converter);
+
+    y2j_options_init(&options);
+    options.duplicate_keys = Y2J_DUPLICATE_KEYS_ERROR;
+    converter = y2j_converter_new(&options, NULL);
+    CHECK(y2j_convert_to_buffer(converter, yaml, strlen(yaml), json, sizeof(json), &size, &error) == Y2J_ERR_PARSE);
+    CHECK(error.line == 3);
+    y2j_converter_free(converter);
+
+    y2j_options_init(&options);
+    options.format = 42;
+    CHECK(y2j_converter_new(&options, &error) == NULL);
+    CHECK(error.status == Y2J_ERR_INVALID_ARGUMENT);
+
+    /* Options from a newer header than the library are refused */
+    y2j_options_init(&options);
+    options.struct_size = sizeof(options) + 8;
+    CHECK(y2j_converter_new(&options, &error) == NULL);
+    CHECK(error.status == Y2J_ERR_INVALID_ARGUMENT);
+}
+
+/* A caller built against an older, shorter y2j_options gets the defaults for the fields it lacks */
+static void test_older_options_size(void) {
+    const char yaml[] = "a: 1\n";
+    char json[64];
+    size_t size = 0;
+    y2j_options options;
+    y2j_error error;
+    y2j_converter* converter;
+
+    /* The layout before intern_strings was appended: whatever follows is not read */
+    y2j_options_init(&options);
+    options.struct_size = offsetof(y2j_options, intern_strings);
+    options.intern_strings = 0x5a5a5a5a;
+    converter = y2j_converter_new(&options, &error);
+    CHECK(converter != NULL);
+    CHECK(y2j_convert_to_buffer(converter, yaml, strlen(yaml), json, sizeof(json), &size, &error) == Y2J_OK);
+    CHECK(size == strlen("{\"a\": 1}") && memcmp(json, "{\"a\": 1}", size) == 0);
+    y2j_converter_free(converter);
+
+    /* Shorter still: a schema past the end is ignored rather than applied */
+    y2j_options_init(&options);
+    options.struct_size = offsetof(y2j_options, schema);
+    options.schema = "{\"type\": \"string\"}";
+    options.intern_strings = 1;
+    converter = y2j_converter_new(&options, &error);
+    CHECK(converter != NULL);
+    CHECK(y2j_convert_to_buffer(converter, yaml, strlen(yaml), json, sizeof(json), &size, &error) == Y2J_OK);
+    y2j_converter_free(converter);
+}
+
+static void test_limits_and_schema(void) {
+    const char laughs[] = "a: &a [x, x, x, x, x, x, x, x, x, x]\n"
+                          "b: &b [*a, *a, *a, *a, *a, *a, *a, *a, *a, *a]\n"
+                          "c: &c [*b, *b, *b, *b, *b, *b, *b, *b, *b, *b]\n"
+                          "d: [*c, *c, *c, *c, *c, *c, *c, *c, *c, *c]\n";
+    const char manifest[] = "replicas: many\n";
+    char json[64];
+    size_t size = 0;
+    y2j_options options;
+    y2j_error error;
+    y2j_converter* converter;
+
+    y2j_options_init(&options);
+    options.max_alias_expansion = 2.0;
+    options.max_nodes = 10;
+    converter = y2j_converter_new(&options, NULL);
+    CHECK(y2j_convert_to_buffer(converter, laughs, strlen(laughs), json, sizeof(json), &size, &error) ==
+          Y2J_ERR_LIMIT);
+    CHECK(error.status == Y2J_ERR_LIMIT);
+    y2j_converter_free(converter);
+
+    y2j_options_init(&options);
+    options.schema = "{\"properties\": {\"replicas\": {\"type\": \"integer\"}}}";
+    converter = y2j_converter_new(&options, &error);
+    CHECK(converter != NULL);
+    CHECK(y2j_convert_to_buffer(converter, manifest, strlen(manifest), json, sizeof(json), &size, &error) ==
+          Y2J_ERR_PARSE);
+    CHECK(error.line == 1 && error.column == 11);
+    y2j_converter_free(converter);
+
+    options.schema = "{\"type\": ";
+    CHECK(y2j_converter_new(&options, &error) == NULL);
+    CHECK(error.status == Y2J_ERR_PARSE);
+}
+
+static int refuse(void* user_data, const char* data, size_t size) {
+    (void)data;
+    (void)size;
+    ++*(int*)user_data;
+    return 1;
+}
+
+static void test_callback_stop(void) {
+    const char yaml[] = "items: [a, b, c]\n";
+    int calls = 0;
+    y2j_error error;
+    y2j_converter* converter = y2j_converter_new(NULL, NULL);
+
+    CHECK(y2j_convert(converter, yaml, strlen(yaml), refuse, &calls, &error) == Y2J_ERR_CALLBACK);
+    CHECK(error.status == Y2J_ERR_CALLBACK);
+    CHECK(calls == 1);
+    y2j_converter_free(converter);
+}
+
+#ifndef _WIN32
+typedef struct {
+    const y2j_converter* converter;
+    int ok;
+} worker_args;
+
+static void* convert_many(void* arg) {
+    worker_args* args = (worker_args*)arg;
+    char json[64];
+    char yaml[32];
+    size_t size = 0;
+    int i;
+    args->ok = 1;
+    for (i = 0; i < 2000; ++i) {
+        int n = snprintf(yaml, sizeof(yaml), "n: %d\n", i);
+        char expected[32];
+        int m = snprintf(expected, sizeof(expected), "{\"n\": %d}", i);
+        if (y2j_convert_to_buffer(args->converter, yaml, (size_t)n, json, sizeof(json), &size, NULL) != Y2J_OK ||
+            size != (size_t)m || memcmp(json, expected, size) != 0) {
+            args->ok = 0;
+        }
+    }
+    return NULL;
+}
+
+static void test_shared_converter_across_threads(void) {
+    pthread_t threads[8];
+    worker_args args[8];
+    int i;
+    y2j_converter* converter = y2j_converter_new(NULL, NULL);
+
+    for (i = 0; i < 8; ++i) {
+        args[i].converter = converter;
+        args[i].ok = 0;
+        CHECK(pthread_create(&threads[i], NULL, convert_many, &args[i]) == 0);
+    }
+    for (i = 0; i < 8; ++i) {
+        pthread_join(threads[i], NULL);
+        CHECK(args[i].ok);
+    }
+    y2j_converter_free(converter);
+}
+#endif
+
+int main(void) {
+    CHECK(y2j_abi_version() == Y2J_ABI_VERSION);
+    test_convert_with_callback();
+    test_caller_buffer();
+    test_parse_error_location();
+    test_options();
+    test_older_options_size();
+    test_limits_and_schema();
+    test_callback_stop();
+#ifndef _WIN32
+    test_shared_converter_across_threads();
+#endif
+    y2j_converter_free(NULL);
+
+    if (failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All C API checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+"""Tests of the yaml2json Python extension (run by ctest with the module on PYTHONPATH)."""
+
+import gzip
+import json
+import pathlib
+import tempfile
+import threading
+import unittest
+
+import yaml2json
+
+
+class ConvertTest(unittest.TestCase):
+    def test_bytes_and_buffers(self):
+        yaml = b"name: test\nitems: [1, 2]\n"
+        expected = {"name": "test", "items": [1, 2]}
+        self.assertEqual(json.loads(yaml2json.convert(yaml)), expected)
+        self.assertEqual(json.loads(yaml2json.convert(bytearray(yaml))), expected)
+        self.assertEqual(json.loads(yaml2json.convert(memoryview(b"xx" + yaml)[2:])), expected)
+
+    def test_source_is_not_modified(self):
+        yaml = bytearray(b'key: "quoted \\t value"\n')
+        before = bytes(yaml)
+        self.assertEqual(json.loads(yaml2json.convert(yaml)), {"key": "quoted \t value"})
+        self.assertEqual(bytes(yaml), before)
+
+    def test_in_place_parsing(self):
+        yaml = bytearray(b"key: value\n")
+        self.assertEqual(json.loads(yaml2json.convert(yaml, in_place=True)), {"key": "value"})
+        with self.assertRaises(TypeError):
+            yaml2json.convert(b"key: value\n", in_place=True)
+
+    def test_paths(self):
+        with tempfile.TemporaryDirectory() as directory:
+            plain = pathlib.Path(directory, "a.yaml")
+            plain.write_bytes(b"a: 1\n")
+            packed = pathlib.Path(directory, "b.yaml.gz")
+            packed.write_bytes(gzip.compress(b"b: 2\n"))
+            self.assertEqual(json.loads(yaml2json.convert(plain)), {"a": 1})
+            self.assertEqual(json.loads(yaml2json.convert(str(plain))), {"a": 1})
+            try:
+                self.assertEqual(json.loads(yaml2json.convert(packed)), {"b": 2})
+            except yaml2json.ConversionError as error:
+                self.assertIn("gzip", str(error))  # built without zlib
+            with self.assertRaises(yaml2json.ConversionError):
+                yaml2json.convert(pathlib.Path(directory, "missing.yaml"))
+
+    def test_options(self):
+        self.assertEqual(yaml2json.convert(b"b: 0x1F\na: yes\n", scalars="yaml11", canonical=True),
+                         b'{"a":true,"b":31}')
+        pretty = yaml2json.convert(b"a: [1]\n", pretty=True)
+        self.assertIn(b"\n  ", pretty)
+        self.assertEqual(json.loads(pretty), {"a": [1]})
+        with self.assertRaises(ValueError):
+            yaml2json.convert(b"a: 1\n", scalars="yaml12")
+        with self.assertRaises(ValueError):
+            yaml2json.convert(b"a: 1\n", canonical=True, pretty=True)
+
+    def test_output_buffer(self):
+        out = bytearray(64)
+        written = yaml2json.convert(b"key: value\n", out=out)
+        self.assertEqual(bytes(out[:written]), yaml2json.convert(b"key: value\n"))
+        with self.assertRaisesRegex(ValueError, "needs 16 bytes"):
+            yaml2json.convert(b"key: value\n", out=bytearray(4))
+        with self.assertRaises(TypeError):
+            yaml2json.convert(b"key: value\n", out=b"read-only")
+
+    def test_errors_carry_location(self):
+        with self.assertRaises(yaml2json.ConversionError) as caught:
+            yaml2json.convert(b"a: 1\nb: [1, 2\n")
+        self.assertIsInstance(caught.exception, ValueError)
+        self.assertGreaterEqual(caught.exception.line, 2)
+        laughs = b"a: &a [x, x, x, x, x, x, x, x, x, x]\n" + b"".join(
+            b"%c: &%c [%s]\n" % (name, name, b", ".join([b"*" + bytes([name - 1])] * 10)) for name in b"bcdefg")
+        with self.assertRaises(yaml2json.LimitExceededError):
+            yaml2json.convert(laughs)
+
+    def test_threads_share_the_module(self):
+        results = []
+
+        def work():
+            results.append(all(json.loads(yaml2json.convert(b"n: %d\n" % i)) == {"n": i} for i in range(2000)))
+
+        threads = [threading.Thread(target=work) for _ in range(8)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        self.assertEqual(results, [True] * 8)
+
+
+if __name__ == "__main__":
+    unittest.main()